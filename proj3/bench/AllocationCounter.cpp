@@ -0,0 +1,193 @@
+// AllocationCounter.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "AllocationCounter.hpp"
+
+
+
+namespace
+{
+    // The size is kept just in front of the memory that's handed out, in a
+    // header as large as the alignment that was asked for (or that operator
+    // new promises), so the memory after it is still suitably aligned.
+    constexpr std::size_t MIN_HEADER_SIZE = alignof(std::max_align_t);
+
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> liveAllocations{0};
+    std::atomic<std::size_t> liveBytes{0};
+
+
+    std::size_t headerSize(std::size_t alignment) noexcept
+    {
+        return alignment > MIN_HEADER_SIZE ? alignment : MIN_HEADER_SIZE;
+    }
+
+
+    void* countedAllocate(std::size_t bytes, std::size_t alignment = MIN_HEADER_SIZE) noexcept
+    {
+        std::size_t header = headerSize(alignment);
+        char* memory;
+
+        if (alignment > MIN_HEADER_SIZE)
+        {
+            std::size_t total = (header + bytes + alignment - 1) / alignment * alignment;
+            memory = static_cast<char*>(std::aligned_alloc(alignment, total));
+        }
+        else
+        {
+            memory = static_cast<char*>(std::malloc(header + bytes));
+        }
+
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+
+        reinterpret_cast<std::size_t*>(memory + header)[-1] = bytes;
+
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        liveAllocations.fetch_add(1, std::memory_order_relaxed);
+        liveBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+        return memory + header;
+    }
+
+
+    void countedFree(void* p, std::size_t alignment = MIN_HEADER_SIZE) noexcept
+    {
+        if (p == nullptr)
+        {
+            return;
+        }
+
+        liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+        liveBytes.fetch_sub(static_cast<std::size_t*>(p)[-1], std::memory_order_relaxed);
+
+        std::free(static_cast<char*>(p) - headerSize(alignment));
+    }
+
+
+    void* countedAllocateOrThrow(std::size_t bytes, std::size_t alignment = MIN_HEADER_SIZE)
+    {
+        void* p = countedAllocate(bytes, alignment);
+
+        if (p == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+
+        return p;
+    }
+}
+
+
+
+AllocationCounts currentAllocationCounts() noexcept
+{
+    return AllocationCounts{
+        allocations.load(std::memory_order_relaxed),
+        liveAllocations.load(std::memory_order_relaxed),
+        liveBytes.load(std::memory_order_relaxed)};
+}
+
+
+
+void* operator new(std::size_t bytes)
+{
+    return countedAllocateOrThrow(bytes);
+}
+
+
+void* operator new[](std::size_t bytes)
+{
+    return countedAllocateOrThrow(bytes);
+}
+
+
+void* operator new(std::size_t bytes, std::align_val_t alignment)
+{
+    return countedAllocateOrThrow(bytes, static_cast<std::size_t>(alignment));
+}
+
+
+void* operator new[](std::size_t bytes, std::align_val_t alignment)
+{
+    return countedAllocateOrThrow(bytes, static_cast<std::size_t>(alignment));
+}
+
+
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(bytes);
+}
+
+
+void* operator new[](std::size_t bytes, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(bytes);
+}
+
+
+void operator delete(void* p) noexcept
+{
+    countedFree(p);
+}
+
+
+void operator delete[](void* p) noexcept
+{
+    countedFree(p);
+}
+
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    countedFree(p);
+}
+
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    countedFree(p);
+}
+
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+    countedFree(p, static_cast<std::size_t>(alignment));
+}
+
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+    countedFree(p, static_cast<std::size_t>(alignment));
+}
+
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    countedFree(p, static_cast<std::size_t>(alignment));
+}
+
+
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    countedFree(p, static_cast<std::size_t>(alignment));
+}
+
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    countedFree(p);
+}
+
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    countedFree(p);
+}
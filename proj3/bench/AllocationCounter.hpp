@@ -0,0 +1,41 @@
+// AllocationCounter.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// The benchmark replaces the global operator new and operator delete, so
+// that it can count every allocation made by the sets it measures, along
+// with the bytes they ask for.  Each allocation is made a little larger,
+// so that its size can be kept just in front of it, since not every
+// operator delete is told the size.  Allocations with extra alignment
+// (such as the blocks of a BloomFilterSet) and allocations on other
+// threads are counted, too.  What the heap itself adds to each allocation
+// isn't counted.
+
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <cstddef>
+
+
+
+struct AllocationCounts
+{
+    // The number of allocations made so far.
+    std::size_t allocations;
+
+    // The number of allocations, and the bytes they asked for, that haven't
+    // been freed yet.
+    std::size_t liveAllocations;
+    std::size_t liveBytes;
+};
+
+
+// currentAllocationCounts() returns the counts as they are now; subtracting
+// the counts from before something from those after it gives the counts
+// for that thing.
+AllocationCounts currentAllocationCounts() noexcept;
+
+
+
+#endif // ALLOCATIONCOUNTER_HPP
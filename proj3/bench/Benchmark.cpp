@@ -0,0 +1,500 @@
+// Benchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <utility>
+#include "Benchmark.hpp"
+#include "AllocationCounter.hpp"
+#include "Set.hpp"
+#include "Stopwatch.hpp"
+#include "WordSetLoader.hpp"
+#include "WordSets.hpp"
+
+
+
+BenchmarkException::BenchmarkException(const std::string& reason)
+    : reason_{reason}
+{
+}
+
+
+std::string BenchmarkException::reason() const
+{
+    return reason_;
+}
+
+
+
+namespace
+{
+    struct Iteration
+    {
+        double loadDuration;
+        double lookupDuration;
+        AllocationCounts beforeLoad;
+        AllocationCounts afterLoad;
+        AllocationCounts afterLookups;
+        unsigned int elementCount;
+        std::size_t found;
+        PerfSample loadCounts;
+        PerfSample lookupCounts;
+    };
+
+
+    // When there are counters, they're started and stopped along with the
+    // Stopwatch, so they count the same things it times.
+    Iteration runIteration(
+        const std::string& setType, const BenchmarkWorkload& workload, PerfCounters* counters)
+    {
+        Iteration iteration;
+        Stopwatch stopwatch = counters != nullptr ? Stopwatch{*counters} : Stopwatch{};
+
+        iteration.beforeLoad = currentAllocationCounts();
+
+        std::unique_ptr<Set<std::string>> set = makeWordSet(setType);
+
+        stopwatch.start();
+        set->addAll(workload.words.data(), workload.words.data() + workload.words.size(), workload.presorted);
+        stopwatch.stop();
+
+        iteration.loadDuration = stopwatch.lastDuration();
+        iteration.loadCounts = stopwatch.lastCounts();
+        iteration.afterLoad = currentAllocationCounts();
+
+        std::size_t found = 0;
+
+        stopwatch.start();
+
+        for (const std::string& lookup : workload.lookups)
+        {
+            found += set->contains(lookup) ? 1 : 0;
+        }
+
+        stopwatch.stop();
+
+        iteration.lookupDuration = stopwatch.lastDuration();
+        iteration.lookupCounts = stopwatch.lastCounts();
+        iteration.afterLookups = currentAllocationCounts();
+        iteration.elementCount = set->size();
+        iteration.found = found;
+
+        return iteration;
+    }
+
+
+    const PerfEvent events[PERF_EVENT_COUNT] = {
+        PerfEvent::Cycles,
+        PerfEvent::Instructions,
+        PerfEvent::L1DataMisses,
+        PerfEvent::LastLevelCacheMisses,
+        PerfEvent::BranchMisses
+    };
+
+
+    double perElement(double value, std::size_t elementCount)
+    {
+        return elementCount > 0 ? value / elementCount : 0.0;
+    }
+
+
+    bool anyCounts(const std::vector<BenchmarkResult>& results)
+    {
+        for (const BenchmarkResult& result : results)
+        {
+            if (!result.loadCounts.empty() || !result.lookupCounts.empty())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    void writeCountsPerOperation(std::ostream& out, const PerfSample& counts, std::size_t operations)
+    {
+        for (PerfEvent event : events)
+        {
+            out << std::setw(11);
+
+            if (counts.has(event))
+            {
+                out << perElement(counts.count(event), operations);
+            }
+            else
+            {
+                out << "-";
+            }
+        }
+    }
+
+
+    void writeCountsTable(std::ostream& out, const std::vector<BenchmarkResult>& results)
+    {
+        out << std::endl << "Hardware events per add() (by addAll()), then per contains()" << std::endl;
+        out << std::left << std::setw(18) << "Set" << std::right;
+
+        for (unsigned int phase = 0; phase < 2; ++phase)
+        {
+            for (PerfEvent event : events)
+            {
+                out << std::setw(11) << perfEventName(event);
+            }
+        }
+
+        out << std::endl;
+
+        for (const BenchmarkResult& result : results)
+        {
+            out << std::left << std::setw(18) << result.setType
+                << std::right << std::fixed << std::setprecision(2);
+
+            writeCountsPerOperation(out, result.loadCounts, result.elementCount);
+            writeCountsPerOperation(out, result.lookupCounts, result.lookupCount);
+            out << std::endl;
+        }
+    }
+
+
+    void writeTable(
+        std::ostream& out, const std::vector<BenchmarkResult>& results,
+        const BenchmarkOptions& options)
+    {
+        out << options.warmUpIterations << " warm-up and " << options.measuredIterations
+            << " measured iterations; durations in usec (min / median / p99)" << std::endl;
+
+        out << std::left << std::setw(18) << "Set"
+            << std::right << std::setw(28) << "load"
+            << std::setw(28) << "lookups"
+            << std::setw(12) << "nsec/lookup"
+            << std::setw(12) << "bytes/elem"
+            << std::setw(12) << "allocs/elem"
+            << std::setw(12) << "load allocs"
+            << std::setw(14) << "lookup allocs"
+            << std::setw(10) << "found" << std::endl;
+
+        for (const BenchmarkResult& result : results)
+        {
+            out << std::left << std::setw(18) << result.setType
+                << std::right << std::fixed << std::setprecision(0)
+                << std::setw(10) << result.load.min
+                << std::setw(9) << result.load.median
+                << std::setw(9) << result.load.p99
+                << std::setw(10) << result.lookup.min
+                << std::setw(9) << result.lookup.median
+                << std::setw(9) << result.lookup.p99
+                << std::setprecision(1)
+                << std::setw(12) << result.lookup.median * 1000.0 / result.lookupCount
+                << std::setw(12) << perElement(result.liveBytes, result.elementCount)
+                << std::setprecision(2)
+                << std::setw(12) << perElement(result.liveAllocations, result.elementCount)
+                << std::setw(12) << result.loadAllocations
+                << std::setw(14) << result.lookupAllocations
+                << std::setw(10) << result.found << std::endl;
+        }
+
+        if (anyCounts(results))
+        {
+            writeCountsTable(out, results);
+        }
+        else if (options.countEvents)
+        {
+            out << std::endl << "Hardware event counters aren't available here; "
+                << "only durations are reported" << std::endl;
+        }
+    }
+
+
+    std::vector<std::string> columnNames()
+    {
+        std::vector<std::string> names{
+            "set", "elements", "lookups",
+            "load_min_usec", "load_median_usec", "load_p99_usec",
+            "lookup_min_usec", "lookup_median_usec", "lookup_p99_usec",
+            "nsec_per_lookup", "bytes_per_element",
+            "load_allocations", "live_allocations", "live_bytes", "lookup_allocations",
+            "found"
+        };
+
+        for (const char* phase : {"add_", "contains_"})
+        {
+            for (PerfEvent event : events)
+            {
+                names.push_back(phase + std::string{perfEventName(event)});
+            }
+        }
+
+        return names;
+    }
+
+
+    // Quotes and backslashes are the only characters a set type could
+    // have that would need escaping in either format.
+    std::string quoted(const std::string& s, char escape)
+    {
+        std::string result = "\"";
+
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                result += c == '"' ? escape : '\\';
+            }
+
+            result += c;
+        }
+
+        return result + "\"";
+    }
+
+
+    // writeValues() passes each value after the set type to writeValue(),
+    // in the same order as the columns, calling writeMissing() instead for
+    // the events that weren't counted.
+    template <typename WriteValue, typename WriteMissing>
+    void writeValues(const BenchmarkResult& result, WriteValue writeValue, WriteMissing writeMissing)
+    {
+        writeValue(result.elementCount);
+        writeValue(result.lookupCount);
+        writeValue(result.load.min);
+        writeValue(result.load.median);
+        writeValue(result.load.p99);
+        writeValue(result.lookup.min);
+        writeValue(result.lookup.median);
+        writeValue(result.lookup.p99);
+        writeValue(result.lookup.median * 1000.0 / result.lookupCount);
+        writeValue(perElement(result.liveBytes, result.elementCount));
+        writeValue(result.loadAllocations);
+        writeValue(result.liveAllocations);
+        writeValue(result.liveBytes);
+        writeValue(result.lookupAllocations);
+        writeValue(result.found);
+
+        const std::pair<const PerfSample*, std::size_t> phases[] = {
+            {&result.loadCounts, result.elementCount},
+            {&result.lookupCounts, result.lookupCount}
+        };
+
+        for (const auto& phase : phases)
+        {
+            for (PerfEvent event : events)
+            {
+                if (phase.first->has(event))
+                {
+                    writeValue(perElement(phase.first->count(event), phase.second));
+                }
+                else
+                {
+                    writeMissing();
+                }
+            }
+        }
+    }
+
+
+    void writeCsv(std::ostream& out, const std::vector<BenchmarkResult>& results)
+    {
+        out << std::fixed << std::setprecision(3);
+
+        std::vector<std::string> names = columnNames();
+
+        for (std::size_t i = 0; i < names.size(); ++i)
+        {
+            out << (i > 0 ? "," : "") << names[i];
+        }
+
+        out << std::endl;
+
+        for (const BenchmarkResult& result : results)
+        {
+            out << quoted(result.setType, '"');
+
+            writeValues(
+                result,
+                [&](auto value) { out << "," << value; },
+                [&]() { out << ","; });
+
+            out << std::endl;
+        }
+    }
+
+
+    void writeJson(
+        std::ostream& out, const std::vector<BenchmarkResult>& results,
+        const BenchmarkOptions& options)
+    {
+        out << std::fixed << std::setprecision(3);
+        out << "{" << std::endl;
+        out << "  \"warm_up_iterations\": " << options.warmUpIterations << "," << std::endl;
+        out << "  \"measured_iterations\": " << options.measuredIterations << "," << std::endl;
+        out << "  \"results\": [";
+
+        std::vector<std::string> names = columnNames();
+
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            out << (i > 0 ? "," : "") << std::endl;
+            out << "    {\"" << names[0] << "\": " << quoted(results[i].setType, '\\');
+
+            unsigned int column = 1;
+
+            writeValues(
+                results[i],
+                [&](auto value) { out << ", \"" << names[column++] << "\": " << value; },
+                [&]() { out << ", \"" << names[column++] << "\": null"; });
+
+            out << "}";
+        }
+
+        out << std::endl << "  ]" << std::endl << "}" << std::endl;
+    }
+}
+
+
+
+BenchmarkWorkload makeWorkload(const std::string& wordFilePath)
+{
+    BenchmarkWorkload workload;
+    workload.presorted = WordSetLoader{}.readWords(wordFilePath, workload.words);
+
+    std::vector<std::string> distinct = workload.words;
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+    for (const std::string& word : distinct)
+    {
+        workload.lookups.push_back(word);
+        workload.lookups.push_back(word + "#");
+    }
+
+    std::shuffle(workload.lookups.begin(), workload.lookups.end(), std::mt19937{46});
+
+    return workload;
+}
+
+
+DurationSummary summarize(std::vector<double> durations)
+{
+    std::sort(durations.begin(), durations.end());
+
+    std::size_t count = durations.size();
+    std::size_t p99Index = static_cast<std::size_t>(std::ceil(count * 0.99)) - 1;
+
+    double median = count % 2 == 1
+        ? durations[count / 2]
+        : (durations[count / 2 - 1] + durations[count / 2]) / 2.0;
+
+    return DurationSummary{durations.front(), median, durations[p99Index]};
+}
+
+
+PerfSample medianCounts(const std::vector<PerfSample>& samples)
+{
+    PerfSample median;
+
+    for (PerfEvent event : events)
+    {
+        std::vector<double> counts;
+
+        for (const PerfSample& sample : samples)
+        {
+            if (sample.has(event))
+            {
+                counts.push_back(sample.count(event));
+            }
+        }
+
+        if (!counts.empty() && counts.size() == samples.size())
+        {
+            median.setCount(event, static_cast<std::uint64_t>(summarize(counts).median));
+        }
+    }
+
+    return median;
+}
+
+
+BenchmarkResult runBenchmark(
+    const std::string& setType, const BenchmarkWorkload& workload,
+    const BenchmarkOptions& options)
+{
+    if (setType == "IMAGE")
+    {
+        throw BenchmarkException{"An image can't be loaded from a word file"};
+    }
+
+    if (options.measuredIterations == 0)
+    {
+        throw BenchmarkException{"At least one measured iteration is needed"};
+    }
+
+    std::unique_ptr<PerfCounters> counters;
+
+    if (options.countEvents)
+    {
+        counters = std::make_unique<PerfCounters>();
+    }
+
+    for (unsigned int i = 0; i < options.warmUpIterations; ++i)
+    {
+        runIteration(setType, workload, counters.get());
+    }
+
+    std::vector<double> loadDurations;
+    std::vector<double> lookupDurations;
+    std::vector<PerfSample> loadCounts;
+    std::vector<PerfSample> lookupCounts;
+    Iteration last;
+
+    for (unsigned int i = 0; i < options.measuredIterations; ++i)
+    {
+        last = runIteration(setType, workload, counters.get());
+        loadDurations.push_back(last.loadDuration);
+        lookupDurations.push_back(last.lookupDuration);
+        loadCounts.push_back(last.loadCounts);
+        lookupCounts.push_back(last.lookupCounts);
+    }
+
+    BenchmarkResult result;
+    result.setType = setType;
+    result.elementCount = last.elementCount;
+    result.lookupCount = workload.lookups.size();
+    result.load = summarize(loadDurations);
+    result.lookup = summarize(lookupDurations);
+    result.loadAllocations = last.afterLoad.allocations - last.beforeLoad.allocations;
+    result.liveAllocations = last.afterLoad.liveAllocations - last.beforeLoad.liveAllocations;
+    result.liveBytes = last.afterLoad.liveBytes - last.beforeLoad.liveBytes;
+    result.lookupAllocations = last.afterLookups.allocations - last.afterLoad.allocations;
+    result.found = last.found;
+    result.loadCounts = medianCounts(loadCounts);
+    result.lookupCounts = medianCounts(lookupCounts);
+
+    return result;
+}
+
+
+void writeResults(
+    std::ostream& out, const std::vector<BenchmarkResult>& results,
+    const BenchmarkOptions& options, BenchmarkFormat format)
+{
+    switch (format)
+    {
+    case BenchmarkFormat::Table:
+        writeTable(out, results, options);
+        break;
+
+    case BenchmarkFormat::Csv:
+        writeCsv(out, results);
+        break;
+
+    case BenchmarkFormat::Json:
+        writeJson(out, results, options);
+        break;
+    }
+}
@@ -0,0 +1,147 @@
+// Benchmark.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Runs the benchmark for one kind of word set: loading the words of a
+// word file into a new set of that kind (with addAll(), as the
+// WordSetLoader does, but with the file already read), then looking up
+// every word along with as many words that aren't present.  This is done
+// a number of times to warm up (filling the caches and letting the heap
+// settle), which aren't recorded, then a number of times that are.  Rather
+// than one duration, which would be as noisy as a single run, each is
+// summarized by its minimum, median, and 99th percentile.
+//
+// The memory the set uses, and how many allocations it makes, are counted
+// while it's loaded, and so are the allocations the lookups make, which
+// should be none at all.  Optionally, hardware events (see PerfCounters.hpp) are
+// counted during the loads and the lookups, too, where the processor and
+// the kernel allow it; otherwise, only durations are reported.
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "PerfCounters.hpp"
+
+
+
+struct BenchmarkOptions
+{
+    unsigned int warmUpIterations;
+    unsigned int measuredIterations;
+    bool countEvents;
+};
+
+
+// The words are loaded into each set; the lookups are every distinct word,
+// along with each with a '#' appended (which can't be in a set), in a
+// shuffled order (with a fixed seed).
+struct BenchmarkWorkload
+{
+    std::vector<std::string> words;
+    bool presorted;
+    std::vector<std::string> lookups;
+};
+
+
+// A DurationSummary summarizes the durations of the measured iterations,
+// in microseconds.  The 99th percentile is the smallest duration that at
+// least 99% of them are no longer than, so it's the maximum when there are
+// fewer than 100 iterations.
+struct DurationSummary
+{
+    double min;
+    double median;
+    double p99;
+};
+
+
+struct BenchmarkResult
+{
+    std::string setType;
+    unsigned int elementCount;
+    std::size_t lookupCount;
+    DurationSummary load;
+    DurationSummary lookup;
+
+    // The allocations made while the set was made and loaded, then the
+    // allocations and bytes still live once it was loaded (which are what
+    // the set uses to store its elements), and the allocations made while
+    // looking up the words.  They're counted in the last iteration.
+    std::size_t loadAllocations;
+    std::size_t liveAllocations;
+    std::size_t liveBytes;
+    std::size_t lookupAllocations;
+
+    // The number of lookups that found their word, which should be half.
+    std::size_t found;
+
+    // The median count of each hardware event while loading and while
+    // looking up, when they were counted.  Dividing by the number of
+    // elements or lookups gives the count per add() (as made by addAll())
+    // or per contains().
+    PerfSample loadCounts;
+    PerfSample lookupCounts;
+};
+
+
+enum class BenchmarkFormat
+{
+    Table,
+    Csv,
+    Json
+};
+
+
+class BenchmarkException
+{
+public:
+    BenchmarkException(const std::string& reason);
+
+    std::string reason() const;
+
+private:
+    std::string reason_;
+};
+
+
+
+// makeWorkload() reads the words from a word file, the same way the
+// WordSetLoader reads them, and makes the lookups from them.
+BenchmarkWorkload makeWorkload(const std::string& wordFilePath);
+
+
+// summarize() returns a summary of the given durations, of which there
+// must be at least one.
+DurationSummary summarize(std::vector<double> durations);
+
+
+// medianCounts() returns the median count of each event that was counted
+// in every one of the given samples.
+PerfSample medianCounts(const std::vector<PerfSample>& samples);
+
+
+// runBenchmark() runs the benchmark for the given type of word set (which
+// is anything the SpellCheckShell accepts, other than IMAGE).
+BenchmarkResult runBenchmark(
+    const std::string& setType, const BenchmarkWorkload& workload,
+    const BenchmarkOptions& options);
+
+
+// writeResults() writes the results in the given format: a table to be
+// read, or CSV (one line per set type, after a line of column names) or
+// JSON (an object with the options and an array of results) to be kept
+// and compared against the results from other commits.  The CSV and JSON
+// always have columns for the hardware events, which are empty (or null)
+// when they weren't counted, so that every run has the same columns.
+void writeResults(
+    std::ostream& out, const std::vector<BenchmarkResult>& results,
+    const BenchmarkOptions& options, BenchmarkFormat format);
+
+
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,206 @@
+// benchmain.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Runs the benchmark (see Benchmark.hpp) for several kinds of word set and
+// writes the results.  Like the other programs, it reads its input from
+// the standard input, one line at a time:
+//
+//   * The path to the word file.
+//
+//   * The number of warm-up iterations, then the number of measured
+//     iterations, separated by a space.  An empty line means 1 and 10.
+//
+//   * The format of the results: TABLE, CSV, or JSON, optionally followed
+//     by COUNTERS, to count hardware events, too (e.g., "CSV COUNTERS").
+//     An empty line means TABLE, without counters.
+//
+//   * The search structure types to measure, one per line, as they're
+//     given to the SpellCheckShell, ending with an empty line or the end of
+//     the input.  If there are none, every type that can load the whole
+//     word file in reasonable time is measured; LIST and HASH ZERO take
+//     quadratic time, so they're only measured when they're asked for.
+//
+// So that the results can be redirected into a file, any errors are
+// written to the standard error, along with a warning for each set whose
+// lookups allocated memory, which none of them should.
+
+#include <iostream>
+#include <utility>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Benchmark.hpp"
+#include "DictionaryImage.hpp"
+#include "SpellCheckShell.hpp"
+
+
+
+namespace
+{
+    const std::vector<std::string> defaultSetTypes{
+        "EMPTY",
+        "AVL",
+        "SKIPLIST",
+        "HASH SUM",
+        "HASH PRODUCT",
+        "HASH FNV1A",
+        "HASH WYMIX",
+        "HASH CRC32C",
+        "HASH FLAT",
+        "TRIE",
+        "BLOOM HASH FLAT"
+    };
+
+
+    std::string readLine()
+    {
+        std::string line;
+        std::getline(std::cin, line);
+        return line;
+    }
+
+
+    BenchmarkOptions readOptions()
+    {
+        std::string line = readLine();
+
+        if (line.empty())
+        {
+            return BenchmarkOptions{1, 10, false};
+        }
+
+        std::istringstream in{line};
+        BenchmarkOptions options{0, 0, false};
+        std::string rest;
+
+        if (!(in >> options.warmUpIterations >> options.measuredIterations) || (in >> rest)
+            || options.measuredIterations == 0)
+        {
+            throw BenchmarkException{"Invalid iteration counts: " + line};
+        }
+
+        return options;
+    }
+
+
+    BenchmarkFormat makeFormat(const std::string& format)
+    {
+        if (format.empty() || format == "TABLE")
+        {
+            return BenchmarkFormat::Table;
+        }
+        else if (format == "CSV")
+        {
+            return BenchmarkFormat::Csv;
+        }
+        else if (format == "JSON")
+        {
+            return BenchmarkFormat::Json;
+        }
+        else
+        {
+            throw BenchmarkException{"Invalid format: " + format};
+        }
+    }
+
+
+    // readFormat() returns the format, and whether hardware events are to
+    // be counted.
+    std::pair<BenchmarkFormat, bool> readFormat()
+    {
+        std::string line = readLine();
+        std::istringstream in{line};
+        std::string format;
+        std::string option;
+
+        in >> format;
+        bool countEvents = false;
+
+        while (in >> option)
+        {
+            if (option == "COUNTERS")
+            {
+                countEvents = true;
+            }
+            else
+            {
+                throw BenchmarkException{"Invalid option: " + option};
+            }
+        }
+
+        return {makeFormat(format), countEvents};
+    }
+
+
+    std::vector<std::string> readSetTypes()
+    {
+        std::vector<std::string> setTypes;
+        std::string setType;
+
+        while (std::getline(std::cin, setType) && !setType.empty())
+        {
+            setTypes.push_back(setType);
+        }
+
+        return setTypes.empty() ? defaultSetTypes : setTypes;
+    }
+}
+
+
+
+int main()
+{
+    try
+    {
+        std::string wordFilePath = readLine();
+        BenchmarkOptions options = readOptions();
+        std::pair<BenchmarkFormat, bool> format = readFormat();
+        options.countEvents = format.second;
+        std::vector<std::string> setTypes = readSetTypes();
+
+        BenchmarkWorkload workload = makeWorkload(wordFilePath);
+
+        if (workload.words.empty())
+        {
+            throw BenchmarkException{"No words in word file: " + wordFilePath};
+        }
+
+        std::vector<BenchmarkResult> results;
+
+        for (const std::string& setType : setTypes)
+        {
+            try
+            {
+                results.push_back(runBenchmark(setType, workload, options));
+
+                if (results.back().lookupAllocations > 0)
+                {
+                    std::cerr << "WARNING: " << setType << ": lookups made "
+                              << results.back().lookupAllocations << " allocations" << std::endl;
+                }
+            }
+            catch (SpellCheckShell::ShellException& e)
+            {
+                std::cerr << "ERROR: " << setType << ": " << e.reason() << std::endl;
+            }
+            catch (DictionaryImage::ImageException& e)
+            {
+                std::cerr << "ERROR: " << setType << ": " << e.reason() << std::endl;
+            }
+            catch (BenchmarkException& e)
+            {
+                std::cerr << "ERROR: " << setType << ": " << e.reason() << std::endl;
+            }
+        }
+
+        writeResults(std::cout, results, options, format.first);
+    }
+    catch (BenchmarkException& e)
+    {
+        std::cerr << "ERROR: " << e.reason() << std::endl;
+    }
+
+    return 0;
+}
@@ -11,6 +11,35 @@
 // the AVL tree acts like a binary search tree (e.g., it will become
 // degenerate if elements are added in ascending order).
 //
+// Rather than allocating each node separately and linking them with
+// pointers, the nodes are kept in one array and linked by their 32-bit
+// indexes in it, so that they're packed together in memory, the links take
+// half the space, and a copy of the whole tree is a copy of the array.
+// Each node also records the height of its subtree, so keeping the tree
+// balanced takes O(log n) time per addition, and the number of nodes in
+// it, so that the set can find the rank of an element (how many elements
+// are less than it) or the element with a given rank in O(log n) time.
+// The array is allocated with a NodeAllocator (see NodeAllocator.hpp),
+// which is given by the second template argument, and doubles in size
+// whenever it fills up.  (With an ArenaNodeAllocator, the memory of the
+// arrays it outgrows is reclaimed only when the set is destroyed.)
+//
+// Once a set is finished, freeze() can rearrange its nodes so that they
+// form a complete tree stored in breadth-first ("Eytzinger") order: the
+// root first, then the two nodes at depth 1, then the four at depth 2, and
+// so on.  The children of the node at position k (counting from 1) are
+// then at positions 2k and 2k + 1, so contains() can descend the tree with
+// arithmetic rather than by following links, choosing between the two
+// children without a branch, and the nodes near the root -- which every
+// search visits -- share a handful of cache lines.  A frozen set can still
+// be added to, but the first addition ends the special layout (though not
+// the tree's balance) until freeze() is called again.
+//
+// Without balancing, a tree can be as deep as it has nodes, so nothing
+// walks it recursively: the traversals keep their own stack of indexes
+// instead, and so does the ConstIterator, which visits the elements in
+// ascending order so that the set can be used in a range-based for loop.
+//
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector) to store the information
 // in your data structure.  Instead, you'll need to implement your AVL tree
@@ -20,12 +49,26 @@
 #ifndef AVLSET_HPP
 #define AVLSET_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "NodeAllocator.hpp"
 #include "Set.hpp"
+#include "SortedRange.hpp"
 
-template <typename ElementType>
+template <typename ElementType, typename NodeAllocator = HeapNodeAllocator>
 class AVLSet : public Set<ElementType>
 {
+private:
+    struct Node;
+
 public:
     // A VisitFunction is a function that takes a reference to a const
     // ElementType and returns no value.
@@ -63,6 +106,21 @@ public:
     virtual void add(const ElementType& element) override;
 
 
+    // addAll() adds every element in the range [begin, end) to the set.
+    // When the set is empty and balancing is on, the tree is built directly
+    // as a perfectly balanced one: in O(n) time if the elements are in
+    // ascending order (and presorted is true), O(n log n) otherwise.  In
+    // any other case, the elements are added one at a time with add().
+    virtual void addAll(const ElementType* begin, const ElementType* end, bool presorted) override;
+
+
+    // remove() removes an element from the set, rebalancing the tree as
+    // add() does.  This function always runs in O(log n) time when there
+    // are n elements in the AVL tree.  Removing an element from a frozen
+    // set ends the special layout, as adding does.
+    virtual bool remove(const ElementType& element) override;
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function always runs in O(log n) time when
     // there are n elements in the AVL tree.
@@ -73,11 +131,25 @@ public:
     virtual unsigned int size() const noexcept override;
 
 
+    // statistics() also reports the number of levels of the tree (one more
+    // than its height) and the memory taken by its array of nodes.  Each
+    // node visited by contains() is a probe, and each element comparison
+    // is counted.
+    virtual SetStatistics statistics() const override;
+
+
     // height() returns the height of the AVL tree.  Note that, by definition,
     // the height of an empty tree is -1.
     int height() const;
 
 
+    // freeze() rearranges the nodes into a complete tree in breadth-first
+    // order, as described above, in O(n) time.  isFrozen() returns true if
+    // the nodes are in that order and nothing has been added since.
+    void freeze();
+    bool isFrozen() const noexcept;
+
+
     // preorder() calls the given "visit" function for each of the elements
     // in the set, in the order determined by a preorder traversal of the AVL
     // tree.
@@ -96,392 +168,1274 @@ public:
     void postorder(VisitFunction visit) const;
 
 
+    // A ConstIterator refers to one of the elements of an AVLSet, and
+    // advances through them in ascending order.  It keeps a stack of the
+    // nodes whose elements are still to come, so copying one takes time
+    // proportional to the height of the tree.  Adding an element to the
+    // set, removing one (which moves the last node in the array into the
+    // removed one's place), or freezing the set invalidates every
+    // ConstIterator referring to it.
+    class ConstIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ElementType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ElementType*;
+        using reference = const ElementType&;
+
+    public:
+        // Initializes a ConstIterator that refers to nothing, like the one
+        // returned by end().
+        ConstIterator() noexcept;
+
+        ~ConstIterator() noexcept;
+        ConstIterator(const ConstIterator& i);
+        ConstIterator(ConstIterator&& i) noexcept;
+        ConstIterator& operator=(const ConstIterator& i);
+        ConstIterator& operator=(ConstIterator&& i) noexcept;
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+
+        ConstIterator& operator++() noexcept;
+        ConstIterator operator++(int);
+
+        bool operator==(const ConstIterator& i) const noexcept;
+        bool operator!=(const ConstIterator& i) const noexcept;
+
+    private:
+        friend class AVLSet;
+
+        // Initializes a ConstIterator with an empty stack that has room
+        // for capacity indexes.
+        ConstIterator(const Node* nodes, unsigned int capacity);
+
+        // pushLeftmost() pushes the node and its left descendants, the last
+        // of which holds the smallest element in the node's subtree.
+        void pushLeftmost(std::uint32_t node) noexcept;
+
+        const Node* nodes;
+
+        // The index of the node whose element the iterator refers to is on
+        // top of the stack, with the nodes whose elements come after it
+        // (and before those of their right subtrees) beneath it.  The
+        // stack is empty at the end.
+        std::uint32_t* stack;
+        unsigned int depth;
+        unsigned int capacity;
+    };
+
+    using iterator = ConstIterator;
+    using const_iterator = ConstIterator;
+
+
+    // begin() returns a ConstIterator referring to the smallest element in
+    // the set, and end() one referring to nothing, which is where a
+    // ConstIterator ends up after it advances past the largest element.
+    ConstIterator begin() const;
+    ConstIterator end() const noexcept;
+
+
+    // lowerBound() returns a ConstIterator referring to the smallest element
+    // not less than the given one, and upperBound() one referring to the
+    // smallest element greater than it; either returns end() if there's no
+    // such element.  Both run in O(log n) time.
+    ConstIterator lowerBound(const ElementType& element) const;
+    ConstIterator upperBound(const ElementType& element) const;
+
+
+    // range() returns the elements not less than low and less than high,
+    // which can be iterated in ascending order in a range-based for loop.
+    SortedRange<ConstIterator> range(const ElementType& low, const ElementType& high) const;
+
+
+    // rank() returns the number of elements less than the given one, which
+    // (when it's in the set) is its position in ascending order, counting
+    // from 0.  select() returns the element at the given position, throwing
+    // a std::out_of_range if there's no such position.  Both run in
+    // O(log n) time.
+    unsigned int rank(const ElementType& element) const;
+    const ElementType& select(unsigned int position) const;
+
+
 private:
-    // You'll no doubt want to add member variables and "helper" member
-    // functions here.
+    // The index that stands for "no node," in place of a null pointer.
+    static constexpr std::uint32_t NONE = 0xFFFFFFFF;
+
+    // The smallest array allocated once something has been added.
+    static constexpr std::uint32_t MINIMUM_CAPACITY = 16;
+
     struct Node
     {
         ElementType key;
-        Node* right;
-        Node* left;
+        std::uint32_t left;
+        std::uint32_t right;
+        std::uint32_t size;
+        std::int32_t height;
     };
 
-    int treeHeight; // the height of the tree
-    int treeSize; // the size of the tree
-
-    Node* root; // root of the tree
-    Node* current;  // current node
+    Node* nodes;              // the array of nodes
+    std::uint32_t nodeCount;  // the number of nodes in use, at the front of it
+    std::uint32_t capacity;   // the number of nodes the array can hold
+    std::uint32_t root;       // the index of the root, or NONE
     bool balanced;
-
-    void leftRotate(Node*& n);
-    void rightRotate(Node*& n);
-    void deleteAllNodes(Node* n); // delete all nodes existing in the tree
-    void copyAllNodes(const Node* source, Node*& current);
-    bool exists(const ElementType& element, Node* node) const;
-    void insertBalenced(const ElementType& element, Node*& node);
-    void insertUnBalenced(const ElementType& element, Node*& node);
-    int getHeight(Node* node) const;
-    void rotateLeftOnce(Node*& current);
-    void rotateLeftTwice(Node*& current);
-    void rotateRightOnce(Node*& current);
-    void rotateRightTwice(Node*& current);
-
-    void preorderCall(VisitFunction visit, Node* node) const;
-    void inorderCall(VisitFunction visit, Node* node) const;
-    void postorderCall(VisitFunction visit, Node* node) const;
-
+    bool frozen;
+
+    // The indexes of the nodes on the way down to where an element is being
+    // added, so that their heights can be fixed on the way back up; there's
+    // room for pathCapacity of them.
+    std::uint32_t* path;
+    unsigned int pathCapacity;
+
+    NodeAllocator nodeAllocator;
+
+    int heightOf(std::uint32_t node) const noexcept;
+    std::uint32_t sizeOf(std::uint32_t node) const noexcept;
+    void update(std::uint32_t node) noexcept;
+    std::uint32_t rotateRight(std::uint32_t node) noexcept;
+    std::uint32_t rotateLeft(std::uint32_t node) noexcept;
+    std::uint32_t rebalance(std::uint32_t node) noexcept;
+
+    std::uint32_t newNode(const ElementType& element);
+    void removeNode(std::uint32_t node) noexcept;
+    void fixUpward(unsigned int length) noexcept;
+    void reserve(std::uint32_t newCapacity);
+    void reservePath(unsigned int length);
+    void destroyAll() noexcept;
+
+    int buildBalanced(const ElementType** sorted, std::uint32_t count, std::uint32_t& node);
+    bool containsFrozen(const ElementType& element) const;
+    void rankPositions(std::uint64_t position, std::uint32_t* ranks, std::uint32_t& next) const noexcept;
+
+    // stackCapacity() returns the number of indexes a traversal's stack
+    // might ever need to hold at once.
+    unsigned int stackCapacity() const noexcept;
 };
 
 
 
-template <typename ElementType>
-AVLSet<ElementType>::AVLSet(bool shouldBalance)
-: treeSize{0}, root{nullptr}, balanced{shouldBalance}
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::AVLSet(bool shouldBalance)
+: nodes{nullptr}, nodeCount{0}, capacity{0}, root{NONE}, balanced{shouldBalance}, frozen{false},
+  path{nullptr}, pathCapacity{0}
 {
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>::~AVLSet() noexcept
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::~AVLSet() noexcept
 {
-    // delete all elements on the tree
-    deleteAllNodes(root);
+    destroyAll();
+    delete[] path;
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>::AVLSet(const AVLSet& s)
+// Since the links are indexes, copying the nodes one by one, in the order
+// they're in, gives a copy of the tree with exactly the same shape.
+
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::AVLSet(const AVLSet& s)
+: nodes{nullptr}, nodeCount{0}, capacity{0}, root{s.root}, balanced{s.balanced}, frozen{s.frozen},
+  path{nullptr}, pathCapacity{0}
 {
-    treeHeight = s.treeHeight;
-    treeSize = s.treeSize;
-    copyAllNodes(s.root, root);
+    if (s.nodeCount == 0)
+    {
+        return;
+    }
+
+    reserve(s.nodeCount);
+
+    try
+    {
+        for (; nodeCount < s.nodeCount; ++nodeCount)
+        {
+            new (nodes + nodeCount) Node{s.nodes[nodeCount]};
+        }
+    }
+    catch (...)
+    {
+        destroyAll();
+        throw;
+    }
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>::AVLSet(AVLSet&& s) noexcept
+// The nodes of a moved AVLSet stay in the memory of its allocator, so the
+// allocator moves along with them.
+
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::AVLSet(AVLSet&& s) noexcept
+: nodes{s.nodes}, nodeCount{s.nodeCount}, capacity{s.capacity}, root{s.root},
+  balanced{s.balanced}, frozen{s.frozen}, path{nullptr}, pathCapacity{0},
+  nodeAllocator{std::move(s.nodeAllocator)}
 {
-    treeHeight = s.treeHeight;
-    treeSize = s.treeSize;
-    copyAllNodes(s.root, root);
-    deleteAllNodes(s.root);
+    s.nodes = nullptr;
+    s.nodeCount = 0;
+    s.capacity = 0;
+    s.root = NONE;
+    s.frozen = false;
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>& AVLSet<ElementType>::operator=(const AVLSet& s)
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>& AVLSet<ElementType, NodeAllocator>::operator=(const AVLSet& s)
 {
     if(this != &s)
     {
-        deleteAllNodes(this->root);
-        treeHeight = s.treeHeight;
-        treeSize = s.treeSize;
-        copyAllNodes(s.root, root);    
+        AVLSet copy{s};
+        *this = std::move(copy);
     }
 
     return *this;
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>& AVLSet<ElementType>::operator=(AVLSet&& s) noexcept
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>& AVLSet<ElementType, NodeAllocator>::operator=(AVLSet&& s) noexcept
 {
     if(this != &s)
     {
-        deleteAllNodes(this->root);
-        treeHeight = s.treeHeight;
-        treeSize = s.treeSize;
-        copyAllNodes(s.root, root);  
-        deleteAllNodes(s.root);  
+        std::swap(nodes, s.nodes);
+        std::swap(nodeCount, s.nodeCount);
+        std::swap(capacity, s.capacity);
+        std::swap(root, s.root);
+        std::swap(balanced, s.balanced);
+        std::swap(frozen, s.frozen);
+        std::swap(nodeAllocator, s.nodeAllocator);
     }
 
     return *this;
 }
 
 
-template <typename ElementType>
-bool AVLSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::isImplemented() const noexcept
 {
     return true;
 }
 
-template <typename ElementType>
-void AVLSet<ElementType>::rightRotate(Node*& n)
+
+// The element is added by walking down from the root, remembering the way,
+// to where it belongs; linking a new node there; and then walking back up
+// with fixUpward().  Everything that can throw happens before the tree is
+// changed.  Every node on the way down gains a node in its subtree, so its
+// size is increased even if its height doesn't change.
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::add(const ElementType& element)
 {
-    Node* temp;
+    if(root == NONE)
+    {
+        root = newNode(element);
+        return;
+    }
+
+    reservePath(static_cast<unsigned int>(heightOf(root)) + 1);
 
-    temp = n->right;
-    n->right = temp->left;
-    temp->left = n;
-    n = temp;
+    unsigned int length = 0;
+    std::uint32_t node = root;
+    bool goLeft = false;
+
+    while(node != NONE)
+    {
+        path[length++] = node;
+
+        if(element < nodes[node].key)
+        {
+            goLeft = true;
+            node = nodes[node].left;
+        }
+        else if(nodes[node].key < element)
+        {
+            goLeft = false;
+            node = nodes[node].right;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    std::uint32_t added = newNode(element);
+    std::uint32_t parent = path[length - 1];
+
+    for(unsigned int i = 0; i < length; i++)
+        nodes[path[i]].size++;
+
+    frozen = false;
+
+    if(goLeft)
+        nodes[parent].left = added;
+    else
+        nodes[parent].right = added;
+
+    fixUpward(length);
 }
 
-template <typename ElementType>
-void AVLSet<ElementType>::leftRotate(Node*& n)
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::addAll(const ElementType* begin, const ElementType* end, bool presorted)
 {
-    Node* temp;
+    if(root != NONE || !balanced)
+    {
+        for(; begin != end; ++begin)
+            add(*begin);
+        return;
+    }
+
+    if(begin == end)
+        return;
+
+    const ElementType** sorted = new const ElementType*[end - begin];
+
+    try
+    {
+        std::uint32_t count = sortDistinct(begin, end, presorted, sorted);
+        reserve(count);
+        buildBalanced(sorted, count, root);
+    }
+    catch (...)
+    {
+        delete[] sorted;
+        destroyAll();
+        throw;
+    }
 
-    temp = n->left;
-    n->left = temp->right;
-    temp->right = n;
-    n = temp;
+    delete[] sorted;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::add(const ElementType& element)
+// The element's node is found the same way add() finds where an element
+// belongs, remembering the way.  A node with two children can't simply be
+// unlinked, so the smallest element in its right subtree (which has no left
+// child) takes its place, and that node is unlinked instead: its child, if
+// it has one, takes its place in the tree.  Every node on the way down to
+// the unlinked one loses a node from its subtree, and the walk back up
+// fixes heights and balance as add()'s does.  Finally, the unlinked node's
+// place in the array is filled by the last node in it, so that the nodes
+// in use stay together at the front.
+
+template <typename ElementType, typename NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::remove(const ElementType& element)
 {
-    // check if the element is in the tree by "contain"
-    if(contains(element))
-        return;
-    
-    // insert the element in the tree
-    if(balanced == false)
-        insertUnBalenced(element, root);  
+    if(root == NONE)
+        return false;
+
+    reservePath(static_cast<unsigned int>(heightOf(root)) + 1);
+
+    unsigned int length = 0;
+    std::uint32_t node = root;
+
+    while(node != NONE)
+    {
+        path[length++] = node;
+
+        if(element < nodes[node].key)
+            node = nodes[node].left;
+        else if(nodes[node].key < element)
+            node = nodes[node].right;
+        else
+            break;
+    }
+
+    if(node == NONE)
+        return false;
+
+    if(nodes[node].left != NONE && nodes[node].right != NONE)
+    {
+        std::uint32_t successor = nodes[node].right;
+
+        while(successor != NONE)
+        {
+            path[length++] = successor;
+            successor = nodes[successor].left;
+        }
+
+        nodes[node].key = std::move(nodes[path[length - 1]].key);
+    }
+
+    std::uint32_t unlinked = path[--length];
+    std::uint32_t child = nodes[unlinked].left != NONE ? nodes[unlinked].left : nodes[unlinked].right;
+
+    if(length == 0)
+        root = child;
+    else if(nodes[path[length - 1]].left == unlinked)
+        nodes[path[length - 1]].left = child;
     else
-        insertBalenced(element, root);
-    treeSize++;  
-    
-    // if the tree is balanced
-    // rotate the tree to make the tree to accept new Node balencly
-   
+        nodes[path[length - 1]].right = child;
+
+    for(unsigned int i = 0; i < length; i++)
+        nodes[path[i]].size--;
+
+    frozen = false;
+
+    fixUpward(length);
+    removeNode(unlinked);
+
+    return true;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::contains(const ElementType& element) const
+{
+    if(frozen)
+        return containsFrozen(element);
+
+    LookupCounter::Lookup lookup{this};
+    std::uint32_t node = root;
+
+    while(node != NONE)
+    {
+        const Node& n = nodes[node];
+        lookup.probed();
+        lookup.compared();
+
+        if(element < n.key)
+        {
+            node = n.left;
+            continue;
+        }
+
+        lookup.compared();
+
+        if(n.key < element)
+            node = n.right;
+        else
+            return true;
+    }
+
+    return false;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+unsigned int AVLSet<ElementType, NodeAllocator>::size() const noexcept
+{
+    return nodeCount;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+SetStatistics AVLSet<ElementType, NodeAllocator>::statistics() const
+{
+    SetStatistics statistics = Set<ElementType>::statistics();
+    statistics.levels = static_cast<unsigned int>(heightOf(root) + 1);
+    statistics.memoryBytes =
+        sizeof(*this) + capacity * sizeof(Node) + pathCapacity * sizeof(std::uint32_t);
+
+    return statistics;
 }
 
 
-template <typename ElementType>
-bool AVLSet<ElementType>::contains(const ElementType& element) const
-{   
-    return exists(element, root);
+template <typename ElementType, typename NodeAllocator>
+int AVLSet<ElementType, NodeAllocator>::height() const
+{
+    return heightOf(root);
 }
 
 
-template <typename ElementType>
-unsigned int AVLSet<ElementType>::size() const noexcept
+// The nodes' indexes are listed in ascending order of their elements (by
+// an inorder traversal, with an explicit stack, since an unbalanced tree
+// can be very deep), and each position of the complete tree is matched
+// with the rank of the element that belongs there (by an inorder traversal
+// of the positions).  The nodes are then moved into a new array, position
+// by position, with their links computed from the positions.
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::freeze()
 {
-    return treeSize;
+    if(frozen || nodeCount == 0)
+    {
+        frozen = nodeCount > 0;
+        return;
+    }
+
+    std::uint32_t* order = new std::uint32_t[nodeCount];
+    std::uint32_t* ranks = nullptr;
+    Node* newNodes = nullptr;
+    std::uint32_t constructed = 0;
+
+    try
+    {
+        ranks = new std::uint32_t[nodeCount];
+        reservePath(static_cast<unsigned int>(heightOf(root)) + 1);
+
+        std::uint32_t count = 0;
+        unsigned int depth = 0;
+        std::uint32_t node = root;
+
+        while(node != NONE || depth > 0)
+        {
+            if(node != NONE)
+            {
+                path[depth++] = node;
+                node = nodes[node].left;
+            }
+            else
+            {
+                node = path[--depth];
+                order[count++] = node;
+                node = nodes[node].right;
+            }
+        }
+
+        std::uint32_t next = 0;
+        rankPositions(1, ranks, next);
+
+        newNodes = static_cast<Node*>(nodeAllocator.allocate(sizeof(Node) * capacity));
+
+        for(; constructed < nodeCount; ++constructed)
+        {
+            std::uint64_t left = 2 * static_cast<std::uint64_t>(constructed) + 1;
+
+            new (newNodes + constructed) Node{
+                std::move_if_noexcept(nodes[order[ranks[constructed]]].key),
+                left < nodeCount ? static_cast<std::uint32_t>(left) : NONE,
+                left + 1 < nodeCount ? static_cast<std::uint32_t>(left + 1) : NONE,
+                1, 0};
+        }
+    }
+    catch (...)
+    {
+        if(newNodes != nullptr)
+        {
+            while(constructed > 0)
+                newNodes[--constructed].~Node();
+
+            nodeAllocator.deallocate(newNodes, sizeof(Node) * capacity);
+        }
+
+        delete[] ranks;
+        delete[] order;
+        throw;
+    }
+
+    delete[] ranks;
+    delete[] order;
+
+    for(std::uint32_t i = 0; i < nodeCount; ++i)
+        nodes[i].~Node();
+
+    nodeAllocator.deallocate(nodes, sizeof(Node) * capacity);
+    nodes = newNodes;
+
+    for(std::uint32_t i = nodeCount; i > 0; --i)
+        update(i - 1);
+
+    root = 0;
+    frozen = true;
 }
 
 
-template <typename ElementType>
-int AVLSet<ElementType>::height() const
+template <typename ElementType, typename NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::isFrozen() const noexcept
 {
-    return getHeight(root);
+    return frozen;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::preorder(VisitFunction visit) const
+// The traversals keep a stack of indexes rather than calling themselves
+// recursively.  The preorder traversal visits each node on its way down
+// the left side of a subtree, stacking the right children it passes to be
+// traversed afterward; the inorder traversal stacks the nodes themselves,
+// visiting each one as it's popped; and the postorder traversal leaves
+// each node on the stack until its right subtree is done, which it can
+// tell by whether the right child was the last node visited.
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::preorder(VisitFunction visit) const
 {
-    preorderCall(visit, root);
+    std::unique_ptr<std::uint32_t[]> stack{new std::uint32_t[stackCapacity()]};
+    unsigned int depth = 0;
+    std::uint32_t node = root;
+
+    while(true)
+    {
+        while(node != NONE)
+        {
+            visit(nodes[node].key);
+
+            if(nodes[node].right != NONE)
+                stack[depth++] = nodes[node].right;
 
+            node = nodes[node].left;
+        }
+
+        if(depth == 0)
+            break;
+
+        node = stack[--depth];
+    }
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::inorder(VisitFunction visit) const
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::inorder(VisitFunction visit) const
 {
-    inorderCall(visit, root);
+    for(const ElementType& element : *this)
+        visit(element);
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::postorder(VisitFunction visit) const
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::postorder(VisitFunction visit) const
 {
-    postorderCall(visit, root);
+    std::unique_ptr<std::uint32_t[]> stack{new std::uint32_t[stackCapacity()]};
+    unsigned int depth = 0;
+    std::uint32_t node = root;
+    std::uint32_t last = NONE;
+
+    while(node != NONE || depth > 0)
+    {
+        if(node != NONE)
+        {
+            stack[depth++] = node;
+            node = nodes[node].left;
+        }
+        else
+        {
+            std::uint32_t top = stack[depth - 1];
+
+            if(nodes[top].right != NONE && nodes[top].right != last)
+            {
+                node = nodes[top].right;
+            }
+            else
+            {
+                visit(nodes[top].key);
+                last = top;
+                --depth;
+            }
+        }
+    }
 }
 
 
-// ===========================
-// ADDITIONAL MEMBER FUNCTIONS
-// ===========================
+template <typename ElementType, typename NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::ConstIterator AVLSet<ElementType, NodeAllocator>::begin() const
+{
+    ConstIterator i{nodes, stackCapacity()};
+    i.pushLeftmost(root);
+    return i;
+}
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::deleteAllNodes(Node* n){
-    if(n == nullptr)
-        return;
-    deleteAllNodes(n->left);
-    deleteAllNodes(n->right);
-    delete n;
+template <typename ElementType, typename NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::ConstIterator AVLSet<ElementType, NodeAllocator>::end() const noexcept
+{
+    return ConstIterator{};
 }
 
 
-template<typename ElementType>
-void AVLSet<ElementType>::copyAllNodes(const Node* source, Node*& current)
+// Searching for an element stacks each node where the search goes left,
+// which is exactly what a ConstIterator's stack would hold when it reached
+// the last of them: the nodes whose elements are greater than the ones
+// passed on the way down.  The search stops early (with the node on top of
+// the stack) when lowerBound() finds the element itself.
+
+template <typename ElementType, typename NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::ConstIterator
+AVLSet<ElementType, NodeAllocator>::lowerBound(const ElementType& element) const
 {
-    if(source == nullptr)
-        current = nullptr;
-    else
+    ConstIterator i{nodes, stackCapacity()};
+    std::uint32_t node = root;
+
+    while(node != NONE)
     {
-        current = new Node{source->key};
-        if(source->left == nullptr && source->right == nullptr)
-            return;
-        copyAllNodes(source->left, current->left);
-        copyAllNodes(source->right, current->right);
+        if(nodes[node].key < element)
+        {
+            node = nodes[node].right;
+        }
+        else
+        {
+            i.stack[i.depth++] = node;
+
+            if(!(element < nodes[node].key))
+                break;
+
+            node = nodes[node].left;
+        }
     }
+
+    return i;
 }
 
 
-template <typename ElementType>
-bool AVLSet<ElementType>::exists(const ElementType& element, Node* node) const
+template <typename ElementType, typename NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::ConstIterator
+AVLSet<ElementType, NodeAllocator>::upperBound(const ElementType& element) const
 {
-    if (node == nullptr)
-        return false;
-    else if(node->key == element)
-        return true;
-    else if (node->key > element)
-        return exists(element, node->left);
-    else
-        return exists(element, node->right);
+    ConstIterator i{nodes, stackCapacity()};
+    std::uint32_t node = root;
 
-    // return true;
+    while(node != NONE)
+    {
+        if(element < nodes[node].key)
+        {
+            i.stack[i.depth++] = node;
+            node = nodes[node].left;
+        }
+        else
+        {
+            node = nodes[node].right;
+        }
+    }
 
+    return i;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::insertBalenced(const ElementType& element, Node*& current)
+template <typename ElementType, typename NodeAllocator>
+SortedRange<typename AVLSet<ElementType, NodeAllocator>::ConstIterator>
+AVLSet<ElementType, NodeAllocator>::range(const ElementType& low, const ElementType& high) const
 {
-    if(current == nullptr)
-        current = new Node{element};
-    else if(element > current->key)
+    if(!(low < high))
+        return SortedRange<ConstIterator>{end(), end()};
+
+    return SortedRange<ConstIterator>{lowerBound(low), lowerBound(high)};
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+unsigned int AVLSet<ElementType, NodeAllocator>::rank(const ElementType& element) const
+{
+    std::uint32_t less = 0;
+    std::uint32_t node = root;
+
+    while(node != NONE)
     {
-        insertBalenced(element, current->right);
-        if(getHeight(current->right)-getHeight(current->left) == 2)
+        if(nodes[node].key < element)
         {
-            if(element > current->right->key)
-                rotateRightOnce(current);
-            else
-                rotateRightTwice(current);
+            less += sizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        }
+        else
+        {
+            node = nodes[node].left;
         }
     }
-    else if(element < current->key)
+
+    return less;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+const ElementType& AVLSet<ElementType, NodeAllocator>::select(unsigned int position) const
+{
+    if(position >= nodeCount)
+        throw std::out_of_range{"AVLSet::select(): no element at that position"};
+
+    std::uint32_t node = root;
+
+    while(true)
     {
-        insertBalenced(element, current->left);
-        if(getHeight(current->left)-getHeight(current->right) == 2)
+        std::uint32_t leftSize = sizeOf(nodes[node].left);
+
+        if(position < leftSize)
         {
-            if(element < current->left->key)
-                rotateLeftOnce(current);
-            else
-                rotateLeftTwice(current);
+            node = nodes[node].left;
+        }
+        else if(position > leftSize)
+        {
+            position -= leftSize + 1;
+            node = nodes[node].right;
+        }
+        else
+        {
+            return nodes[node].key;
         }
     }
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::insertUnBalenced(const ElementType& element, Node*& node)
+
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::ConstIterator::ConstIterator() noexcept
+: nodes{nullptr}, stack{nullptr}, depth{0}, capacity{0}
+{
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::ConstIterator::ConstIterator(const Node* nodes, unsigned int capacity)
+: nodes{nodes}, stack{nullptr}, depth{0}, capacity{0}
 {
-    if(node == nullptr)
+    if(capacity > 0)
     {
-        node = new Node{element};
+        stack = new std::uint32_t[capacity];
+        this->capacity = capacity;
     }
+}
 
-    else if(element < node->key)
+
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::ConstIterator::~ConstIterator() noexcept
+{
+    delete[] stack;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::ConstIterator::ConstIterator(const ConstIterator& i)
+: nodes{i.nodes}, stack{nullptr}, depth{i.depth}, capacity{i.capacity}
+{
+    if(i.stack != nullptr)
     {
-        insertUnBalenced(element, node->left);
+        stack = new std::uint32_t[capacity];
+        std::copy(i.stack, i.stack + depth, stack);
     }
+}
 
-    else
+
+template <typename ElementType, typename NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::ConstIterator::ConstIterator(ConstIterator&& i) noexcept
+: nodes{i.nodes}, stack{i.stack}, depth{i.depth}, capacity{i.capacity}
+{
+    i.stack = nullptr;
+    i.depth = 0;
+    i.capacity = 0;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::ConstIterator&
+AVLSet<ElementType, NodeAllocator>::ConstIterator::operator=(const ConstIterator& i)
+{
+    if(this != &i)
     {
-        insertUnBalenced(element, node->right);
+        ConstIterator copy{i};
+        *this = std::move(copy);
     }
 
-    // treeSize++;
+    return *this;
 }
 
 
-template <typename ElementType>
-int AVLSet<ElementType>::getHeight(Node* node) const
+template <typename ElementType, typename NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::ConstIterator&
+AVLSet<ElementType, NodeAllocator>::ConstIterator::operator=(ConstIterator&& i) noexcept
 {
-    // if the tree is balanced
-    // or not
+    if(this != &i)
+    {
+        std::swap(nodes, i.nodes);
+        std::swap(stack, i.stack);
+        std::swap(depth, i.depth);
+        std::swap(capacity, i.capacity);
+    }
 
-    if(node == nullptr)
-        return -1;
+    return *this;
+}
 
-    int l = getHeight(node->left);
-    int r = getHeight(node->right);
 
-    if(l>r)
-        return l+1;
-    else
-        return r+1;
+template <typename ElementType, typename NodeAllocator>
+const ElementType& AVLSet<ElementType, NodeAllocator>::ConstIterator::operator*() const noexcept
+{
+    return nodes[stack[depth - 1]].key;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+const ElementType* AVLSet<ElementType, NodeAllocator>::ConstIterator::operator->() const noexcept
+{
+    return &nodes[stack[depth - 1]].key;
+}
+
+
+// The next element after a node's is the smallest one in its right
+// subtree, if it has one, or else the one in the node beneath it on the
+// stack.
+
+template <typename ElementType, typename NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::ConstIterator&
+AVLSet<ElementType, NodeAllocator>::ConstIterator::operator++() noexcept
+{
+    std::uint32_t node = stack[--depth];
+    pushLeftmost(nodes[node].right);
+    return *this;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::ConstIterator
+AVLSet<ElementType, NodeAllocator>::ConstIterator::operator++(int)
+{
+    ConstIterator old{*this};
+    ++*this;
+    return old;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::ConstIterator::operator==(const ConstIterator& i) const noexcept
+{
+    if(depth == 0 || i.depth == 0)
+        return depth == i.depth;
+
+    return nodes == i.nodes && stack[depth - 1] == i.stack[i.depth - 1];
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::ConstIterator::operator!=(const ConstIterator& i) const noexcept
+{
+    return !(*this == i);
+}
 
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::ConstIterator::pushLeftmost(std::uint32_t node) noexcept
+{
+    while(node != NONE)
+    {
+        stack[depth++] = node;
+        node = nodes[node].left;
+    }
 }
 
 
+// ===========================
+// ADDITIONAL MEMBER FUNCTIONS
+// ===========================
 
-template <typename ElementType>
-void AVLSet<ElementType>::rotateLeftOnce(Node*& current){
-     Node* temp;
 
-     temp = current->left;
-     current->left = temp->right;
-     temp->right = current;
-     current = temp;
+template <typename ElementType, typename NodeAllocator>
+int AVLSet<ElementType, NodeAllocator>::heightOf(std::uint32_t node) const noexcept
+{
+    return node == NONE ? -1 : nodes[node].height;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::rotateLeftTwice(Node*& current){
-     rotateRightOnce(current->left);
-     rotateLeftOnce(current);
+template <typename ElementType, typename NodeAllocator>
+std::uint32_t AVLSet<ElementType, NodeAllocator>::sizeOf(std::uint32_t node) const noexcept
+{
+    return node == NONE ? 0 : nodes[node].size;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::rotateRightOnce(Node*& current){
-     Node* temp;
+// update() recomputes the node's height and size from its children's.
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::update(std::uint32_t node) noexcept
+{
+    int l = heightOf(nodes[node].left);
+    int r = heightOf(nodes[node].right);
 
-     temp = current->right;
-     current->right = temp->left;
-     temp->left = current;
-     current = temp;
+    nodes[node].height = (l > r ? l : r) + 1;
+    nodes[node].size = sizeOf(nodes[node].left) + sizeOf(nodes[node].right) + 1;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::rotateRightTwice(Node*& current){
-     rotateLeftOnce(current->right);
-     rotateRightOnce(current);
+// rotateRight() makes the node's left child the root of its subtree, and
+// rotateLeft() its right child, returning the index of the new root.
+
+template <typename ElementType, typename NodeAllocator>
+std::uint32_t AVLSet<ElementType, NodeAllocator>::rotateRight(std::uint32_t node) noexcept
+{
+    std::uint32_t newRoot = nodes[node].left;
+
+    nodes[node].left = nodes[newRoot].right;
+    nodes[newRoot].right = node;
+
+    update(node);
+    update(newRoot);
+
+    return newRoot;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+std::uint32_t AVLSet<ElementType, NodeAllocator>::rotateLeft(std::uint32_t node) noexcept
+{
+    std::uint32_t newRoot = nodes[node].right;
+
+    nodes[node].right = nodes[newRoot].left;
+    nodes[newRoot].left = node;
+
+    update(node);
+    update(newRoot);
+
+    return newRoot;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::preorderCall(VisitFunction visit, Node* node) const
+// rebalance() rotates the node's subtree (once or twice) if the heights of
+// its children differ by 2, returning the index of its root afterward.
+
+template <typename ElementType, typename NodeAllocator>
+std::uint32_t AVLSet<ElementType, NodeAllocator>::rebalance(std::uint32_t node) noexcept
 {
-    if(node == nullptr)
+    Node& n = nodes[node];
+    int balance = heightOf(n.left) - heightOf(n.right);
+
+    if(balance > 1)
+    {
+        if(heightOf(nodes[n.left].left) < heightOf(nodes[n.left].right))
+            n.left = rotateLeft(n.left);
+
+        return rotateRight(node);
+    }
+    else if(balance < -1)
+    {
+        if(heightOf(nodes[n.right].right) < heightOf(nodes[n.right].left))
+            n.right = rotateRight(n.right);
+
+        return rotateLeft(node);
+    }
+
+    return node;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+std::uint32_t AVLSet<ElementType, NodeAllocator>::newNode(const ElementType& element)
+{
+    if(nodeCount == capacity)
+        reserve(capacity < MINIMUM_CAPACITY ? MINIMUM_CAPACITY : capacity * 2);
+
+    new (nodes + nodeCount) Node{element, NONE, NONE, 1, 0};
+    return nodeCount++;
+}
+
+
+// removeNode() destroys a node that's no longer linked into the tree, and
+// moves the last node in the array into its place, relinking it from its
+// parent (which is found by searching for its element).
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::removeNode(std::uint32_t node) noexcept
+{
+    std::uint32_t last = nodeCount - 1;
+
+    if(node != last)
+    {
+        if(root == last)
+        {
+            root = node;
+        }
+        else
+        {
+            std::uint32_t parent = root;
+
+            while(true)
+            {
+                std::uint32_t next = nodes[last].key < nodes[parent].key ? nodes[parent].left : nodes[parent].right;
+
+                if(next == last)
+                    break;
+
+                parent = next;
+            }
+
+            if(nodes[parent].left == last)
+                nodes[parent].left = node;
+            else
+                nodes[parent].right = node;
+        }
+
+        nodes[node] = std::move(nodes[last]);
+    }
+
+    nodes[last].~Node();
+    nodeCount--;
+}
+
+
+// fixUpward() walks back up the first length nodes of the path, from the
+// bottom, fixing their heights and (when balancing) rotating any node that
+// has become unbalanced.  Once a node's subtree comes out the same height
+// as it was, nothing above it can have changed, so the walk stops there.
+// (The sizes along the path must already be right.)
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::fixUpward(unsigned int length) noexcept
+{
+    for(unsigned int i = length; i-- > 0; )
+    {
+        std::uint32_t current = path[i];
+        int oldHeight = nodes[current].height;
+
+        update(current);
+        std::uint32_t replacement = balanced ? rebalance(current) : current;
+
+        if(replacement != current)
+        {
+            if(i == 0)
+                root = replacement;
+            else if(nodes[path[i - 1]].left == current)
+                nodes[path[i - 1]].left = replacement;
+            else
+                nodes[path[i - 1]].right = replacement;
+        }
+
+        if(nodes[replacement].height == oldHeight)
+            break;
+    }
+}
+
+
+// reserve() moves the nodes to an array with room for newCapacity of them,
+// if the current one is smaller.
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::reserve(std::uint32_t newCapacity)
+{
+    if(newCapacity <= capacity)
         return;
-    visit(node->key);
-    preorderCall(visit, node->left);
-    preorderCall(visit, node->right);
 
+    Node* newNodes = static_cast<Node*>(nodeAllocator.allocate(sizeof(Node) * newCapacity));
+    std::uint32_t moved = 0;
+
+    try
+    {
+        for(; moved < nodeCount; ++moved)
+            new (newNodes + moved) Node{std::move_if_noexcept(nodes[moved])};
+    }
+    catch (...)
+    {
+        while(moved > 0)
+            newNodes[--moved].~Node();
+
+        nodeAllocator.deallocate(newNodes, sizeof(Node) * newCapacity);
+        throw;
+    }
+
+    for(std::uint32_t i = 0; i < nodeCount; ++i)
+        nodes[i].~Node();
+
+    if(nodes != nullptr)
+        nodeAllocator.deallocate(nodes, sizeof(Node) * capacity);
+
+    nodes = newNodes;
+    capacity = newCapacity;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::inorderCall(VisitFunction visit, Node* node) const
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::reservePath(unsigned int length)
 {
-    if(node == nullptr)
+    if(length <= pathCapacity)
         return;
-    inorderCall(visit, node->left);
-    visit(node->key);
-    inorderCall(visit, node->right);
 
+    unsigned int newCapacity = pathCapacity < 32 ? 32 : pathCapacity;
+
+    while(newCapacity < length)
+        newCapacity *= 2;
+
+    std::uint32_t* newPath = new std::uint32_t[newCapacity];
+    delete[] path;
+
+    path = newPath;
+    pathCapacity = newCapacity;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::postorderCall(VisitFunction visit, Node* node) const
+// destroyAll() destroys every node, unless the allocator can release them
+// all at once without visiting them, and leaves the set empty.
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::destroyAll() noexcept
 {
-    if(node == nullptr)
+    if constexpr (!std::is_trivially_destructible_v<Node>)
+    {
+        for(std::uint32_t i = 0; i < nodeCount; ++i)
+            nodes[i].~Node();
+    }
+
+    if(nodes != nullptr)
+        nodeAllocator.deallocate(nodes, sizeof(Node) * capacity);
+
+    nodes = nullptr;
+    nodeCount = 0;
+    capacity = 0;
+    root = NONE;
+    frozen = false;
+}
+
+
+// buildBalanced() builds a perfectly balanced tree from count distinct
+// elements in ascending order, making the middle one the root and building
+// its subtrees the same way from the elements on either side, and returns
+// its height.  The array must already have room for all of the nodes.
+// Each node is linked into the tree before its subtrees are built, so a
+// partially-built tree can still be destroyed if an exception is thrown.
+
+template <typename ElementType, typename NodeAllocator>
+int AVLSet<ElementType, NodeAllocator>::buildBalanced(const ElementType** sorted, std::uint32_t count, std::uint32_t& node)
+{
+    if(count == 0)
+        return -1;
+
+    std::uint32_t middle = count / 2;
+
+    node = newNode(*sorted[middle]);
+    int l = buildBalanced(sorted, middle, nodes[node].left);
+    int r = buildBalanced(sorted + middle + 1, count - middle - 1, nodes[node].right);
+
+    nodes[node].size = count;
+    nodes[node].height = (l > r ? l : r) + 1;
+    return nodes[node].height;
+}
+
+
+// In a frozen set, the search keeps a position k (counting from 1) and
+// moves to 2k or 2k + 1 depending on a comparison, until it falls off the
+// bottom of the tree.  The bits of k then record the path taken: every 1
+// is a step to the right.  Stripping the trailing 1s (and the 0 before
+// them) leads back to the last node where the search went left, which is
+// the smallest element not less than the one sought.
+
+template <typename ElementType, typename NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::containsFrozen(const ElementType& element) const
+{
+    LookupCounter::Lookup lookup{this};
+    std::uint64_t k = 1;
+
+    while(k <= nodeCount)
+    {
+        lookup.probed();
+        lookup.compared();
+        k = 2 * k + (nodes[k - 1].key < element ? 1 : 0);
+    }
+
+    while(k & 1)
+        k >>= 1;
+
+    k >>= 1;
+
+    if(k == 0)
+        return false;
+
+    lookup.compared();
+    return !(element < nodes[k - 1].key);
+}
+
+
+// rankPositions() visits the positions of the subtree of a complete tree
+// of nodeCount nodes rooted at the given position in inorder, recording
+// the rank of the element that belongs at each one.
+
+template <typename ElementType, typename NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::rankPositions(
+    std::uint64_t position, std::uint32_t* ranks, std::uint32_t& next) const noexcept
+{
+    if(position > nodeCount)
         return;
-    postorderCall(visit, node->left);
-    postorderCall(visit, node->right);
-    visit(node->key);
 
+    rankPositions(2 * position, ranks, next);
+    ranks[position - 1] = next++;
+    rankPositions(2 * position + 1, ranks, next);
 }
 
-#endif // AVLSET_HPP
 
+// A path from the root down never has more than height + 1 nodes on it,
+// and no traversal stacks more than one node at each depth.
+
+template <typename ElementType, typename NodeAllocator>
+unsigned int AVLSet<ElementType, NodeAllocator>::stackCapacity() const noexcept
+{
+    return static_cast<unsigned int>(heightOf(root) + 1);
+}
+
+#endif // AVLSET_HPP
@@ -0,0 +1,507 @@
+// BloomFilterSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A BloomFilterSet is a Set that stands in front of another Set, keeping a
+// Bloom filter of everything that has been added to it.  A Bloom filter
+// answers "is this element present?" with either "definitely not" or
+// "maybe," using only a few bits per element; contains() asks the other
+// Set only when the answer is "maybe," so most lookups of elements that
+// aren't present -- such as the candidates tried by a WordChecker looking
+// for suggestions, nearly all of which are misspelled -- never touch it.
+// The proportion of missing elements that get a "maybe" anyway (the false
+// positive rate) can be passed to the constructor; the lower it is, the
+// more bits the filter needs.
+//
+// The filter is a "blocked" one: its bits are divided into 512-bit blocks,
+// each the size of a cache line, and all of the bits for a given element
+// are in the same block, chosen by the element's hash.  A lookup, then,
+// costs one cache miss, rather than one for each bit.  (A blocked filter
+// needs slightly more bits than an ordinary one for the same false
+// positive rate, which is accounted for when sizing it.)
+//
+// Because a Bloom filter can't be resized without adding everything to it
+// again, and a Set has no way to list its elements, the filter grows in
+// stages: when a stage is full, a new one twice its size is started, and
+// lookups check every stage.  addAll() sizes a new stage to hold all of
+// the elements it's given, so a set filled with a single call to addAll()
+// (as the WordSetLoader does) has just one stage, built for exactly the
+// configured rate.  Each later stage is built for half the rate of the one
+// before, so the overall rate never exceeds twice the configured one.
+//
+// Elements can be removed, but a Bloom filter can't forget an element, so
+// the filter goes on answering "maybe" for each removed one, and lookups of
+// it reach the other Set just as false positives do.  A set with a lot of
+// turnover is better off without a filter, or with one rebuilt from time
+// to time by adding its elements to a new BloomFilterSet.
+//
+// The other Set must be empty when it's given to the BloomFilterSet, since
+// the filter can only know about elements that were added through it.  If
+// it isn't, the filter is bypassed, and every lookup goes to the Set.
+
+#ifndef BLOOMFILTERSET_HPP
+#define BLOOMFILTERSET_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include "Set.hpp"
+
+
+
+template <typename ElementType, typename Hasher = std::function<unsigned int(const ElementType&)>>
+class BloomFilterSet : public Set<ElementType>
+{
+public:
+    // The false positive rate used when none is passed to the constructor.
+    static constexpr double DEFAULT_FALSE_POSITIVE_RATE = 0.01;
+
+    // False positive rates outside of this range are clamped into it.  (At
+    // rates much below 0.1%, so many elements share each block that a
+    // blocked filter needs disproportionately many bits to keep up.)
+    static constexpr double MIN_FALSE_POSITIVE_RATE = 0.001;
+    static constexpr double MAX_FALSE_POSITIVE_RATE = 0.5;
+
+    // The number of bits in each block of the filter.
+    static constexpr unsigned int BLOCK_BITS = 512;
+
+    // The capacity of the first stage when it's started by add() rather
+    // than addAll().
+    static constexpr unsigned int MINIMUM_STAGE_CAPACITY = 1024;
+
+public:
+    // Initializes a BloomFilterSet in front of the given set, which must be
+    // empty, using the given hash function whenever it needs to hash an
+    // element, with a filter built for the given false positive rate.
+    BloomFilterSet(
+        std::unique_ptr<Set<ElementType>> set, Hasher hashFunction,
+        double falsePositiveRate = DEFAULT_FALSE_POSITIVE_RATE);
+
+    // Cleans up the BloomFilterSet, along with the set in front of which
+    // it stands, so that it leaks no memory.
+    virtual ~BloomFilterSet() noexcept;
+
+    // A BloomFilterSet can be neither copied nor moved, since the set in
+    // front of which it stands can't be copied without knowing its type.
+    BloomFilterSet(const BloomFilterSet& s) = delete;
+    BloomFilterSet& operator=(const BloomFilterSet& s) = delete;
+
+
+    // isImplemented() returns true if the set in front of which the
+    // BloomFilterSet stands is implemented.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set and to the filter, starting a new
+    // stage of the filter first if the last one is full.
+    virtual void add(const ElementType& element) override;
+
+
+    // addAll() adds every element in the range [begin, end) to the set
+    // (passing the presorted hint along) and to the filter, starting a new
+    // stage first if the last one can't hold them all.
+    virtual void addAll(const ElementType* begin, const ElementType* end, bool presorted) override;
+
+
+    // remove() removes an element from the set, leaving the filter as it
+    // is.
+    virtual bool remove(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise, asking the set only if the filter says that the element
+    // might be present.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // statistics() reports the set's statistics, with the filter's memory
+    // added in.  Every call to contains() is counted as a lookup, but only
+    // the ones that get past the filter compare anything, so the filter's
+    // effect shows up as fewer comparisons and probes per lookup.
+    virtual SetStatistics statistics() const override;
+
+
+    // resetStatistics() starts counting lookups, including the set's, from
+    // zero again.
+    virtual void resetStatistics() noexcept override;
+
+
+    // mightContain() returns false if the filter says that the given
+    // element is definitely not in the set, true otherwise.
+    bool mightContain(const ElementType& element) const;
+
+
+    // falsePositiveRate() returns the rate for which the filter was built.
+    double falsePositiveRate() const noexcept;
+
+
+    // stageCount() returns the number of stages in the filter, and
+    // filterSize() the number of bytes that all of them take up.
+    unsigned int stageCount() const noexcept;
+    unsigned long long filterSize() const noexcept;
+
+
+private:
+    // Each stage has at most twice the capacity of the one before, so this
+    // many stages can hold more elements than a Set can.
+    static constexpr unsigned int MAX_STAGE_COUNT = 33;
+
+    // The largest number of bits set for each element.
+    static constexpr unsigned int MAX_HASH_COUNT = 16;
+
+    // A blocked filter's false positive rate is higher than an ordinary
+    // one's with the same number of bits, because some blocks get more
+    // than their share of elements, and the difference grows as the rate
+    // falls.  Measured with a dictionary's worth of words, giving it 10%
+    // more bits than the ordinary formula calls for for each factor of ten
+    // below a rate of 10% makes up the difference.
+    static constexpr double BLOCKING_OVERHEAD_PER_DIGIT = 0.1;
+
+    struct alignas(64) Block
+    {
+        std::uint64_t words[BLOCK_BITS / 64];
+    };
+
+    struct Stage
+    {
+        Block* blocks;
+        unsigned int blockCount;
+        unsigned int hashCount;
+        unsigned int capacity;
+        unsigned int count;
+    };
+
+    std::unique_ptr<Set<ElementType>> set;
+    Hasher hashFunction;
+    double rate;
+    bool bypassed;
+
+    Stage stages[MAX_STAGE_COUNT];
+    unsigned int stageCount_;
+
+private:
+    static std::uint64_t mixHash(unsigned int hash) noexcept;
+    static unsigned int blockIndex(const Stage& stage, std::uint64_t mixed) noexcept;
+    static void insert(Stage& stage, std::uint64_t mixed) noexcept;
+    static bool test(const Stage& stage, std::uint64_t mixed) noexcept;
+
+    std::uint64_t hashOf(const ElementType& element) const;
+    void reserve(unsigned int additional);
+    void addStage(unsigned int capacity);
+};
+
+
+
+template <typename ElementType, typename Hasher>
+BloomFilterSet<ElementType, Hasher>::BloomFilterSet(
+    std::unique_ptr<Set<ElementType>> set, Hasher hashFunction, double falsePositiveRate)
+    : set{std::move(set)}, hashFunction{std::move(hashFunction)},
+      rate{falsePositiveRate}, bypassed{false}, stageCount_{0}
+{
+    if (!(rate > 0.0))
+    {
+        rate = DEFAULT_FALSE_POSITIVE_RATE;
+    }
+    else if (rate < MIN_FALSE_POSITIVE_RATE)
+    {
+        rate = MIN_FALSE_POSITIVE_RATE;
+    }
+    else if (rate > MAX_FALSE_POSITIVE_RATE)
+    {
+        rate = MAX_FALSE_POSITIVE_RATE;
+    }
+
+    bypassed = this->set->size() > 0;
+}
+
+
+template <typename ElementType, typename Hasher>
+BloomFilterSet<ElementType, Hasher>::~BloomFilterSet() noexcept
+{
+    for (unsigned int i = 0; i < stageCount_; ++i)
+    {
+        delete[] stages[i].blocks;
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+bool BloomFilterSet<ElementType, Hasher>::isImplemented() const noexcept
+{
+    return set->isImplemented();
+}
+
+
+template <typename ElementType, typename Hasher>
+void BloomFilterSet<ElementType, Hasher>::add(const ElementType& element)
+{
+    std::uint64_t mixed = hashOf(element);
+    unsigned int oldSize = set->size();
+
+    reserve(1);
+    set->add(element);
+
+    if (set->size() != oldSize)
+    {
+        Stage& stage = stages[stageCount_ - 1];
+        insert(stage, mixed);
+        ++stage.count;
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+void BloomFilterSet<ElementType, Hasher>::addAll(
+    const ElementType* begin, const ElementType* end, bool presorted)
+{
+    if (begin == end)
+    {
+        return;
+    }
+
+    unsigned int oldSize = set->size();
+
+    reserve(static_cast<unsigned int>(end - begin));
+    set->addAll(begin, end, presorted);
+
+    // Duplicates set the same bits twice, which does no harm, but only the
+    // elements that were new to the set count against the stage's capacity.
+
+    Stage& stage = stages[stageCount_ - 1];
+
+    for (const ElementType* element = begin; element != end; ++element)
+    {
+        insert(stage, hashOf(*element));
+    }
+
+    stage.count += set->size() - oldSize;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool BloomFilterSet<ElementType, Hasher>::remove(const ElementType& element)
+{
+    return set->remove(element);
+}
+
+
+template <typename ElementType, typename Hasher>
+bool BloomFilterSet<ElementType, Hasher>::contains(const ElementType& element) const
+{
+    LookupCounter::Lookup lookup{this};
+    return mightContain(element) && set->contains(element);
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int BloomFilterSet<ElementType, Hasher>::size() const noexcept
+{
+    return set->size();
+}
+
+
+template <typename ElementType, typename Hasher>
+SetStatistics BloomFilterSet<ElementType, Hasher>::statistics() const
+{
+    SetStatistics statistics = set->statistics();
+    statistics.memoryBytes += sizeof(*this) + filterSize();
+
+    SetStatistics filtered;
+    this->addTo(filtered);
+    statistics.lookups = filtered.lookups;
+
+    return statistics;
+}
+
+
+template <typename ElementType, typename Hasher>
+void BloomFilterSet<ElementType, Hasher>::resetStatistics() noexcept
+{
+    this->reset();
+    set->resetStatistics();
+}
+
+
+template <typename ElementType, typename Hasher>
+bool BloomFilterSet<ElementType, Hasher>::mightContain(const ElementType& element) const
+{
+    if (bypassed)
+    {
+        return true;
+    }
+
+    if (stageCount_ == 0)
+    {
+        return false;
+    }
+
+    std::uint64_t mixed = hashOf(element);
+
+    for (unsigned int i = 0; i < stageCount_; ++i)
+    {
+        if (test(stages[i], mixed))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template <typename ElementType, typename Hasher>
+double BloomFilterSet<ElementType, Hasher>::falsePositiveRate() const noexcept
+{
+    return rate;
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int BloomFilterSet<ElementType, Hasher>::stageCount() const noexcept
+{
+    return stageCount_;
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned long long BloomFilterSet<ElementType, Hasher>::filterSize() const noexcept
+{
+    unsigned long long total = 0;
+
+    for (unsigned int i = 0; i < stageCount_; ++i)
+    {
+        total += static_cast<unsigned long long>(stages[i].blockCount) * sizeof(Block);
+    }
+
+    return total;
+}
+
+
+// The hash is spread across 64 bits with a multiply-xorshift mix: the high
+// 32 bits choose the block, and the low 32 bits the bits within it.
+
+template <typename ElementType, typename Hasher>
+std::uint64_t BloomFilterSet<ElementType, Hasher>::mixHash(unsigned int hash) noexcept
+{
+    std::uint64_t mixed = (static_cast<std::uint64_t>(hash) + 1) * 0x9E3779B97F4A7C15ull;
+    mixed ^= mixed >> 32;
+    mixed *= 0xD6E8FEB86659FD93ull;
+    mixed ^= mixed >> 32;
+
+    return mixed;
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int BloomFilterSet<ElementType, Hasher>::blockIndex(
+    const Stage& stage, std::uint64_t mixed) noexcept
+{
+    return static_cast<unsigned int>(((mixed >> 32) * stage.blockCount) >> 32);
+}
+
+
+// The bits within the block are chosen by double hashing: the i-th bit is
+// the top 9 bits of probe + i * step, where probe and step are 32 bits
+// taken from the hash (with step made odd, so that the bits differ).
+
+template <typename ElementType, typename Hasher>
+void BloomFilterSet<ElementType, Hasher>::insert(Stage& stage, std::uint64_t mixed) noexcept
+{
+    Block& block = stage.blocks[blockIndex(stage, mixed)];
+    std::uint32_t probe = static_cast<std::uint32_t>(mixed);
+    std::uint32_t step = static_cast<std::uint32_t>((mixed * 0x9E3779B97F4A7C15ull) >> 32) | 1;
+
+    for (unsigned int i = 0; i < stage.hashCount; ++i, probe += step)
+    {
+        unsigned int bit = probe >> 23;
+        block.words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+bool BloomFilterSet<ElementType, Hasher>::test(const Stage& stage, std::uint64_t mixed) noexcept
+{
+    const Block& block = stage.blocks[blockIndex(stage, mixed)];
+    std::uint32_t probe = static_cast<std::uint32_t>(mixed);
+    std::uint32_t step = static_cast<std::uint32_t>((mixed * 0x9E3779B97F4A7C15ull) >> 32) | 1;
+
+    for (unsigned int i = 0; i < stage.hashCount; ++i, probe += step)
+    {
+        unsigned int bit = probe >> 23;
+
+        if ((block.words[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+template <typename ElementType, typename Hasher>
+std::uint64_t BloomFilterSet<ElementType, Hasher>::hashOf(const ElementType& element) const
+{
+    return mixHash(static_cast<unsigned int>(hashFunction(element)));
+}
+
+
+template <typename ElementType, typename Hasher>
+void BloomFilterSet<ElementType, Hasher>::reserve(unsigned int additional)
+{
+    if (stageCount_ == 0)
+    {
+        addStage(additional > MINIMUM_STAGE_CAPACITY ? additional : MINIMUM_STAGE_CAPACITY);
+    }
+    else
+    {
+        const Stage& last = stages[stageCount_ - 1];
+
+        if (additional > last.capacity - last.count && stageCount_ < MAX_STAGE_COUNT)
+        {
+            unsigned long long doubled = 2ull * last.capacity;
+            addStage(static_cast<unsigned int>(
+                additional > doubled ? additional : (doubled > 0xFFFFFFFFull ? 0xFFFFFFFFull : doubled)));
+        }
+    }
+}
+
+
+// A Bloom filter with the lowest false positive rate p for n elements has
+// n * -ln(p) / (ln 2)^2 bits and sets -log2(p) of them for each element.
+
+template <typename ElementType, typename Hasher>
+void BloomFilterSet<ElementType, Hasher>::addStage(unsigned int capacity)
+{
+    double stageRate = std::ldexp(rate, -static_cast<int>(stageCount_));
+    double ln2 = std::log(2.0);
+    double digitsBelowTenPercent = -std::log10(stageRate) - 1.0;
+    double overhead = 1.0 + BLOCKING_OVERHEAD_PER_DIGIT * (digitsBelowTenPercent > 0.0 ? digitsBelowTenPercent : 0.0);
+    double bitsPerElement = -std::log(stageRate) / (ln2 * ln2) * overhead;
+
+    unsigned long long blockCount = static_cast<unsigned long long>(
+        std::ceil(capacity * bitsPerElement / BLOCK_BITS));
+
+    unsigned int hashCount = static_cast<unsigned int>(std::lround(-std::log2(stageRate)));
+
+    Stage& stage = stages[stageCount_];
+    stage.blockCount = static_cast<unsigned int>(blockCount > 0 ? blockCount : 1);
+    stage.hashCount = hashCount < 1 ? 1 : (hashCount > MAX_HASH_COUNT ? MAX_HASH_COUNT : hashCount);
+    stage.capacity = capacity;
+    stage.count = 0;
+    stage.blocks = new Block[stage.blockCount]{};
+
+    ++stageCount_;
+}
+
+
+
+#endif // BLOOMFILTERSET_HPP
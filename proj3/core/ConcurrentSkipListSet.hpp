@@ -0,0 +1,636 @@
+// ConcurrentSkipListSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A ConcurrentSkipListSet is a skip list that any number of threads can
+// add to, remove from, and look up in at the same time, without locks.
+// It's laid out like a SkipListSet (one node per element, allocated along
+// with an array of its links, and a link that leads nowhere at the end of
+// each level), except that its links are atomic, and each one can be
+// marked, which means that the node it leaves from is being removed.
+//
+//   * contains() never waits for, or changes anything on behalf of, any
+//     other thread: it follows the links down to where the element would
+//     be, stepping over marked nodes, so it finishes in a number of steps
+//     that depends only on what it passes.
+//
+//   * add() finds the last link before where the element belongs on each
+//     level, then links the new node in on the bottom level with a single
+//     compare-and-swap, which is the moment the element is in the set.  It
+//     then links the node in on the levels above, one at a time, finding
+//     the links again whenever another thread has changed one first.  If
+//     a compare-and-swap fails, it's only because some other thread's did
+//     succeed, so the set as a whole always makes progress.
+//
+//   * remove() marks the links of the element's node, from the top level
+//     down; whichever thread marks the bottom level's link is the one that
+//     removed the element.  Marked nodes are unlinked by whichever thread
+//     next passes them looking for somewhere to add or remove an element,
+//     including the one that marked them.
+//
+// A removed node may still be in use by a thread that reached it before
+// it was unlinked, so it's handed to an EpochReclaimer (see
+// EpochReclaimer.hpp) to be freed once that can no longer be so.  It's
+// only handed over once both the thread that added it has finished
+// linking it in and the thread that removed it has finished unlinking it,
+// since either one can still be linking it in (or out) after the other is
+// done with it.
+//
+// The number of levels an element occupies is decided, up to
+// MAX_LEVEL_COUNT, by a FastSkipListLevelTester belonging to the current
+// thread (see SkipListSet.hpp).  The skip list starts out with all
+// MAX_LEVEL_COUNT levels, though the way down begins on the highest level
+// that any element has occupied so far.
+//
+// Nodes are allocated from the heap, since neither kind of NodeAllocator
+// can be shared between threads.  A ConcurrentSkipListSet can be neither
+// copied nor moved, since there's no way to do either while other threads
+// are using it; and it mustn't be destroyed while they are.
+
+#ifndef CONCURRENTSKIPLISTSET_HPP
+#define CONCURRENTSKIPLISTSET_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "EpochReclaimer.hpp"
+#include "Set.hpp"
+#include "SkipListSet.hpp"
+
+
+
+template <typename ElementType>
+class ConcurrentSkipListSet : public Set<ElementType>
+{
+public:
+    // The most levels that a ConcurrentSkipListSet has.
+    static constexpr unsigned int MAX_LEVEL_COUNT = 32;
+
+public:
+    ConcurrentSkipListSet();
+    virtual ~ConcurrentSkipListSet() noexcept;
+
+    ConcurrentSkipListSet(const ConcurrentSkipListSet&) = delete;
+    ConcurrentSkipListSet& operator=(const ConcurrentSkipListSet&) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set, if it isn't there already.  It's
+    // lock-free, and runs in an expected time of O(log n) when no other
+    // thread gets in its way.
+    virtual void add(const ElementType& element) override;
+
+
+    // remove() removes an element from the set, returning false if it
+    // wasn't there (including when another thread removed it first).
+    // It's lock-free, and runs in an expected time of O(log n) when no
+    // other thread gets in its way.
+    virtual bool remove(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise.  It's wait-free, and runs in an expected time of O(log n).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.  While other
+    // threads are adding and removing elements, it may be out of date by
+    // the time it's returned.
+    virtual unsigned int size() const noexcept override;
+
+
+    // statistics() also reports the number of levels.  It doesn't report
+    // memory, which other threads may be changing as it's counted.  Each
+    // node that contains() visits is a probe.
+    virtual SetStatistics statistics() const override;
+
+
+    // levelCount() returns the number of levels on which any element has
+    // been placed, which is where the way down begins.
+    unsigned int levelCount() const noexcept;
+
+
+    // elementsOnLevel() returns the number of nodes linked in on the given
+    // level, including any that are being removed.  It's only accurate
+    // when no other thread is using the set.
+    unsigned int elementsOnLevel(unsigned int level) const;
+
+
+    // pendingCount() returns how many removed nodes are waiting to be
+    // freed.  It's only accurate when no other thread is using the set.
+    std::size_t pendingCount() const noexcept;
+
+
+private:
+    struct Node;
+
+    // A Link holds a pointer to the next node on its level (or nullptr),
+    // with its lowest bit set when the link is marked.
+    using Link = std::atomic<std::uintptr_t>;
+
+    struct Node
+    {
+        ElementType value;
+        unsigned int height;
+
+        // The number of threads that still have work to do on the node:
+        // the one that added it, and the one that removes it.
+        std::atomic<unsigned int> claims;
+
+        Link* links() noexcept;
+    };
+
+    static constexpr std::uintptr_t MARK = 1;
+
+    // The distance from the beginning of a Node to its links.
+    static constexpr std::size_t LINKS_OFFSET =
+        (sizeof(Node) + alignof(Link) - 1) / alignof(Link) * alignof(Link);
+
+    Link head[MAX_LEVEL_COUNT];
+    std::atomic<unsigned int> levels;
+    std::atomic<unsigned int> elementCount;
+    mutable EpochReclaimer reclaimer;
+
+private:
+    bool find(const ElementType& element, Link** before, Node** after, unsigned int levelCount);
+    bool tryFind(const ElementType& element, Link** before, Node** after, unsigned int levelCount);
+    void linkUpperLevels(Node* node, Link** before, Node** after, unsigned int levelCount);
+    void releaseClaim(Node* node);
+
+    void raiseLevels(unsigned int height) noexcept;
+    static unsigned int randomHeight();
+
+    static Node* makeNode(const ElementType& element, unsigned int height);
+    static void freeNode(void* p) noexcept;
+
+    static Node* nodeOf(std::uintptr_t link) noexcept;
+    static bool isMarked(std::uintptr_t link) noexcept;
+    static std::uintptr_t linkTo(Node* node) noexcept;
+};
+
+
+
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>::ConcurrentSkipListSet()
+    : levels{1}, elementCount{0}
+{
+    for (Link& link : head)
+    {
+        link.store(0, std::memory_order_relaxed);
+    }
+}
+
+
+// No other thread is using the set anymore, so every node still linked in
+// on the bottom level is unmarked and has nobody else to free it; the ones
+// that were removed belong to the EpochReclaimer, which frees them itself.
+
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>::~ConcurrentSkipListSet() noexcept
+{
+    Node* node = nodeOf(head[0].load(std::memory_order_acquire));
+
+    while (node != nullptr)
+    {
+        Node* next = nodeOf(node->links()[0].load(std::memory_order_relaxed));
+        freeNode(node);
+        node = next;
+    }
+}
+
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+// If the bottom level's compare-and-swap fails, the links are found again
+// and the new node's links are pointed at the new successors before trying
+// again.  A node whose bottom level was linked in is in the set, no matter
+// what happens to the levels above it.
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::add(const ElementType& element)
+{
+    EpochReclaimer::Guard guard{reclaimer};
+
+    unsigned int height = randomHeight();
+    raiseLevels(height);
+    unsigned int levelCount = levels.load(std::memory_order_acquire);
+
+    Link* before[MAX_LEVEL_COUNT];
+    Node* after[MAX_LEVEL_COUNT];
+    Node* node = nullptr;
+
+    while (true)
+    {
+        if (find(element, before, after, levelCount))
+        {
+            if (node != nullptr)
+            {
+                freeNode(node);
+            }
+
+            return;
+        }
+
+        if (node == nullptr)
+        {
+            node = makeNode(element, height);
+        }
+
+        for (unsigned int lvl = 0; lvl < height; ++lvl)
+        {
+            node->links()[lvl].store(linkTo(after[lvl]), std::memory_order_relaxed);
+        }
+
+        std::uintptr_t expected = linkTo(after[0]);
+
+        if (before[0]->compare_exchange_strong(expected, linkTo(node)))
+        {
+            break;
+        }
+    }
+
+    elementCount.fetch_add(1, std::memory_order_relaxed);
+    linkUpperLevels(node, before, after, levelCount);
+    releaseClaim(node);
+}
+
+
+// Only the thread that marks the bottom level's link has removed the
+// element; it then goes down the skip list again, which unlinks the node
+// on every level it's linked in on.  The node may be taller than the
+// number of levels there were when remove() began, if it was added in the
+// meantime, so the way down begins on whichever is higher; otherwise, the
+// node would be freed while it was still linked in on its upper levels.
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::remove(const ElementType& element)
+{
+    EpochReclaimer::Guard guard{reclaimer};
+
+    unsigned int levelCount = levels.load(std::memory_order_acquire);
+    Link* before[MAX_LEVEL_COUNT];
+    Node* after[MAX_LEVEL_COUNT];
+
+    if (!find(element, before, after, levelCount))
+    {
+        return false;
+    }
+
+    Node* node = after[0];
+
+    for (unsigned int lvl = node->height; lvl-- > 1; )
+    {
+        node->links()[lvl].fetch_or(MARK);
+    }
+
+    if (isMarked(node->links()[0].fetch_or(MARK)))
+    {
+        return false;
+    }
+
+    elementCount.fetch_sub(1, std::memory_order_relaxed);
+    find(element, before, after, std::max(levelCount, node->height));
+    releaseClaim(node);
+    return true;
+}
+
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::contains(const ElementType& element) const
+{
+    EpochReclaimer::Guard guard{reclaimer};
+    LookupCounter::Lookup lookup{this};
+
+    const Link* links = head;
+    Node* current = nullptr;
+
+    for (unsigned int lvl = levels.load(std::memory_order_acquire); lvl-- > 0; )
+    {
+        current = nodeOf(links[lvl].load(std::memory_order_acquire));
+
+        while (current != nullptr)
+        {
+            std::uintptr_t next = current->links()[lvl].load(std::memory_order_acquire);
+            lookup.probed();
+
+            if (isMarked(next))
+            {
+                current = nodeOf(next);
+                continue;
+            }
+
+            lookup.compared();
+
+            if (current->value < element)
+            {
+                links = current->links();
+                current = nodeOf(next);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    if (current == nullptr)
+    {
+        return false;
+    }
+
+    lookup.compared();
+    return !(element < current->value);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::size() const noexcept
+{
+    return elementCount.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+SetStatistics ConcurrentSkipListSet<ElementType>::statistics() const
+{
+    SetStatistics statistics = Set<ElementType>::statistics();
+    statistics.levels = levelCount();
+
+    return statistics;
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::levelCount() const noexcept
+{
+    return levels.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::elementsOnLevel(unsigned int level) const
+{
+    if (level >= MAX_LEVEL_COUNT)
+    {
+        return 0;
+    }
+
+    EpochReclaimer::Guard guard{reclaimer};
+    unsigned int count = 0;
+
+    for (Node* node = nodeOf(head[level].load(std::memory_order_acquire));
+         node != nullptr;
+         node = nodeOf(node->links()[level].load(std::memory_order_acquire)))
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+
+template <typename ElementType>
+std::size_t ConcurrentSkipListSet<ElementType>::pendingCount() const noexcept
+{
+    return reclaimer.pendingCount();
+}
+
+
+
+// find() fills before with the last link before where the element is (or
+// would be) on each of the given number of levels, and after with the node
+// each of those links leads to, unlinking every marked node it passes
+// along the way.  It returns true if the element is in the set.
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::find(
+    const ElementType& element, Link** before, Node** after, unsigned int levelCount)
+{
+    while (!tryFind(element, before, after, levelCount))
+    {
+    }
+
+    return after[0] != nullptr && !(element < after[0]->value);
+}
+
+
+// tryFind() is one attempt at what find() does, which fails (returning
+// false) when a marked node can't be unlinked because the link leading to
+// it has changed since it was read.
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::tryFind(
+    const ElementType& element, Link** before, Node** after, unsigned int levelCount)
+{
+    Link* links = head;
+
+    for (unsigned int lvl = levelCount; lvl-- > 0; )
+    {
+        Node* current = nodeOf(links[lvl].load());
+
+        while (current != nullptr)
+        {
+            std::uintptr_t next = current->links()[lvl].load();
+
+            if (isMarked(next))
+            {
+                std::uintptr_t expected = linkTo(current);
+
+                if (!links[lvl].compare_exchange_strong(expected, next & ~MARK))
+                {
+                    return false;
+                }
+
+                current = nodeOf(next);
+            }
+            else if (current->value < element)
+            {
+                links = current->links();
+                current = nodeOf(next);
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        before[lvl] = &links[lvl];
+        after[lvl] = current;
+    }
+
+    return true;
+}
+
+
+// linkUpperLevels() links a node that's been linked in on the bottom level
+// in on the rest of its levels.  Before each level's link is changed to
+// lead to the node, the node's own link on that level is pointed at the
+// right successor, unless it's been marked, which means the node is being
+// removed, so there's no point in going on.  If a thread removing the node
+// has finished unlinking it before this thread linked it in somewhere,
+// find() unlinks it again.
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::linkUpperLevels(
+    Node* node, Link** before, Node** after, unsigned int levelCount)
+{
+    Link* nodeLinks = node->links();
+
+    for (unsigned int lvl = 1; lvl < node->height; ++lvl)
+    {
+        while (true)
+        {
+            std::uintptr_t own = nodeLinks[lvl].load();
+
+            if (isMarked(own))
+            {
+                lvl = node->height;
+                break;
+            }
+
+            if (own != linkTo(after[lvl])
+                && !nodeLinks[lvl].compare_exchange_strong(own, linkTo(after[lvl])))
+            {
+                continue;
+            }
+
+            std::uintptr_t expected = linkTo(after[lvl]);
+
+            if (before[lvl]->compare_exchange_strong(expected, linkTo(node)))
+            {
+                break;
+            }
+
+            find(node->value, before, after, levelCount);
+
+            if (after[0] != node)
+            {
+                lvl = node->height;
+                break;
+            }
+        }
+    }
+
+    if (isMarked(nodeLinks[0].load()))
+    {
+        find(node->value, before, after, levelCount);
+    }
+}
+
+
+// releaseClaim() is called by the thread that added a node and the thread
+// that removed it when each has finished with it; the second of them
+// retires it.
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::releaseClaim(Node* node)
+{
+    if (node->claims.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        reclaimer.retire(node, freeNode);
+    }
+}
+
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::raiseLevels(unsigned int height) noexcept
+{
+    unsigned int current = levels.load(std::memory_order_relaxed);
+
+    while (current < height
+        && !levels.compare_exchange_weak(current, height, std::memory_order_acq_rel))
+    {
+    }
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::randomHeight()
+{
+    thread_local FastSkipListLevelTester<unsigned int> levelTester;
+    return levelTester.chooseHeight(0, MAX_LEVEL_COUNT);
+}
+
+
+// makeNode() allocates a node with room for the given number of links
+// after it, and constructs the node in it, with every link leading
+// nowhere and both of its claims outstanding.
+
+template <typename ElementType>
+typename ConcurrentSkipListSet<ElementType>::Node*
+ConcurrentSkipListSet<ElementType>::makeNode(const ElementType& element, unsigned int height)
+{
+    std::size_t bytes = LINKS_OFFSET + height * sizeof(Link);
+    void* memory = ::operator new(bytes);
+    Node* node = nullptr;
+
+    try
+    {
+        node = new (memory) Node{element, height, {2}};
+    }
+    catch (...)
+    {
+        ::operator delete(memory);
+        throw;
+    }
+
+    for (unsigned int lvl = 0; lvl < height; ++lvl)
+    {
+        new (&node->links()[lvl]) Link{0};
+    }
+
+    return node;
+}
+
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::freeNode(void* p) noexcept
+{
+    Node* node = static_cast<Node*>(p);
+    node->~Node();
+    ::operator delete(p);
+}
+
+
+template <typename ElementType>
+typename ConcurrentSkipListSet<ElementType>::Link*
+ConcurrentSkipListSet<ElementType>::Node::links() noexcept
+{
+    return reinterpret_cast<Link*>(reinterpret_cast<char*>(this) + LINKS_OFFSET);
+}
+
+
+template <typename ElementType>
+typename ConcurrentSkipListSet<ElementType>::Node*
+ConcurrentSkipListSet<ElementType>::nodeOf(std::uintptr_t link) noexcept
+{
+    return reinterpret_cast<Node*>(link & ~MARK);
+}
+
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::isMarked(std::uintptr_t link) noexcept
+{
+    return (link & MARK) != 0;
+}
+
+
+template <typename ElementType>
+std::uintptr_t ConcurrentSkipListSet<ElementType>::linkTo(Node* node) noexcept
+{
+    return reinterpret_cast<std::uintptr_t>(node);
+}
+
+
+
+#endif // CONCURRENTSKIPLISTSET_HPP
@@ -0,0 +1,343 @@
+// DeletionIndex.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <memory>
+#include "DeletionIndex.hpp"
+#include "SortedRange.hpp"
+
+
+
+namespace
+{
+    // The bucket table has about one bucket for every this many entries.
+    constexpr std::size_t ENTRIES_PER_BUCKET = 2;
+
+
+    std::uint32_t hashVariant(std::string_view variant) noexcept
+    {
+        std::uint32_t hash = 2166136261u;
+
+        for (char c : variant)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
+
+    // addDeletions() adds the hashes of the strings made by deleting from 1
+    // to the given number of characters from s, deleting characters only at
+    // or after the given position (so that each set of positions is deleted
+    // only once).  Deleting either of two equal adjacent characters gives
+    // the same string, so only the first of them is deleted.  The variants
+    // are built in the scratch strings, one for each level of deletion.
+
+    void addDeletions(
+        std::string_view s, std::size_t start, unsigned int deletions,
+        std::string* scratch, std::vector<std::uint32_t>& hashes)
+    {
+        if (deletions == 0)
+        {
+            return;
+        }
+
+        std::string& variant = scratch[deletions - 1];
+
+        for (std::size_t i = start; i < s.length(); ++i)
+        {
+            if (i > start && s[i] == s[i - 1])
+            {
+                continue;
+            }
+
+            variant.assign(s.data(), i);
+            variant.append(s.data() + i + 1, s.length() - i - 1);
+
+            hashes.push_back(hashVariant(variant));
+            addDeletions(variant, i, deletions - 1, scratch, hashes);
+        }
+    }
+
+
+    // variantHashes() fills hashes with the distinct hashes of the delete
+    // variants of the given word, including the word itself.
+
+    void variantHashes(
+        std::string_view word, unsigned int maxDistance,
+        std::string* scratch, std::vector<std::uint32_t>& hashes)
+    {
+        hashes.clear();
+        hashes.push_back(hashVariant(word));
+        addDeletions(word, 0, maxDistance, scratch, hashes);
+
+        std::sort(hashes.begin(), hashes.end());
+        hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+    }
+
+
+    // variantCountBound() returns the largest number of delete variants a
+    // word of the given length can have: the number of ways to delete up to
+    // maxDistance of its characters.
+
+    std::size_t variantCountBound(std::size_t length, unsigned int maxDistance) noexcept
+    {
+        std::size_t ways = 1;
+        std::size_t total = 1;
+
+        for (unsigned int k = 1; k <= maxDistance && k <= length; ++k)
+        {
+            ways = ways * (length - k + 1) / k;
+            total += ways;
+        }
+
+        return total;
+    }
+
+
+    // boundedDistance() returns the optimal string alignment distance
+    // between a and b if it's at most bound, or bound + 1 otherwise.  The
+    // rows of the dynamic programming table are kept in the given vector,
+    // so that it can be reused from one call to the next.
+
+    unsigned int boundedDistance(
+        std::string_view a, std::string_view b, unsigned int bound,
+        std::vector<unsigned int>& rows)
+    {
+        std::size_t lengthDifference =
+            a.length() > b.length() ? a.length() - b.length() : b.length() - a.length();
+
+        if (lengthDifference > bound)
+        {
+            return bound + 1;
+        }
+
+        std::size_t width = b.length() + 1;
+        rows.resize(3 * width);
+
+        unsigned int* twoBack = rows.data();
+        unsigned int* previous = twoBack + width;
+        unsigned int* current = previous + width;
+
+        for (std::size_t j = 0; j < width; ++j)
+        {
+            previous[j] = static_cast<unsigned int>(j);
+        }
+
+        for (std::size_t i = 1; i <= a.length(); ++i)
+        {
+            current[0] = static_cast<unsigned int>(i);
+            unsigned int rowMinimum = current[0];
+
+            for (std::size_t j = 1; j < width; ++j)
+            {
+                unsigned int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+
+                unsigned int distance = std::min({
+                    previous[j] + 1,
+                    current[j - 1] + 1,
+                    previous[j - 1] + cost});
+
+                if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                {
+                    distance = std::min(distance, twoBack[j - 2] + 1);
+                }
+
+                current[j] = distance;
+                rowMinimum = std::min(rowMinimum, distance);
+            }
+
+            // No later row can be smaller than the smallest value in this
+            // one (a swap reaching back past it costs no less than the
+            // substitution through it).
+            if (rowMinimum > bound)
+            {
+                return bound + 1;
+            }
+
+            unsigned int* oldest = twoBack;
+            twoBack = previous;
+            previous = current;
+            current = oldest;
+        }
+
+        return std::min(previous[b.length()], bound + 1);
+    }
+}
+
+
+
+DeletionIndex::DeletionIndex(
+    const std::string* begin, const std::string* end, bool presorted,
+    unsigned int maxDistance)
+    : maxDistance_{std::min(maxDistance, MAX_DISTANCE)}, bucketMask{0}
+{
+    std::unique_ptr<const std::string*[]> sorted{new const std::string*[end - begin]};
+    unsigned int count = sortDistinct(begin, end, presorted, sorted.get());
+
+    std::size_t totalLength = 0;
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        totalLength += sorted[i]->length();
+    }
+
+    words.reserve(totalLength);
+    wordStarts.reserve(count + 1);
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        wordStarts.push_back(static_cast<std::uint32_t>(words.length()));
+        words.append(*sorted[i]);
+    }
+
+    wordStarts.push_back(static_cast<std::uint32_t>(words.length()));
+
+    sorted.reset();
+
+    // The entries are gathered in word order first, then placed into their
+    // buckets with a counting sort.
+
+    std::string scratch[MAX_DISTANCE];
+    std::vector<std::uint32_t> hashes;
+    std::vector<Entry> unbucketed;
+    std::size_t variantBound = 0;
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        variantBound += variantCountBound(wordAt(i).length(), maxDistance_);
+    }
+
+    unbucketed.reserve(variantBound);
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        variantHashes(wordAt(i), maxDistance_, scratch, hashes);
+
+        for (std::uint32_t hash : hashes)
+        {
+            unbucketed.push_back(Entry{hash, i});
+        }
+    }
+
+    std::size_t bucketCount = 1;
+
+    while (bucketCount * ENTRIES_PER_BUCKET < unbucketed.size())
+    {
+        bucketCount *= 2;
+    }
+
+    bucketMask = static_cast<std::uint32_t>(bucketCount - 1);
+    bucketStarts.assign(bucketCount + 1, 0);
+
+    for (const Entry& entry : unbucketed)
+    {
+        ++bucketStarts[(entry.hash & bucketMask) + 1];
+    }
+
+    for (std::size_t b = 0; b < bucketCount; ++b)
+    {
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+
+    entries.resize(unbucketed.size());
+    std::vector<std::uint32_t> next{bucketStarts.begin(), bucketStarts.end() - 1};
+
+    for (const Entry& entry : unbucketed)
+    {
+        entries[next[entry.hash & bucketMask]++] = entry;
+    }
+}
+
+
+std::vector<std::string> DeletionIndex::suggestionsFor(const std::string& word) const
+{
+    std::string scratch[MAX_DISTANCE];
+    std::vector<std::uint32_t> hashes;
+    variantHashes(word, maxDistance_, scratch, hashes);
+
+    std::vector<std::uint32_t> candidates;
+
+    for (std::uint32_t hash : hashes)
+    {
+        std::uint32_t bucket = hash & bucketMask;
+
+        for (std::uint32_t i = bucketStarts[bucket]; i < bucketStarts[bucket + 1]; ++i)
+        {
+            if (entries[i].hash == hash)
+            {
+                candidates.push_back(entries[i].wordIndex);
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Once some words have been found at a given distance, only words at
+    // that distance or closer are of interest, so the bound shrinks.
+
+    std::vector<std::string> suggestions;
+    std::vector<unsigned int> rows;
+    unsigned int bestDistance = maxDistance_;
+
+    for (std::uint32_t candidate : candidates)
+    {
+        std::string_view candidateWord = wordAt(candidate);
+        unsigned int distance = boundedDistance(word, candidateWord, bestDistance, rows);
+
+        if (distance == 0 || distance > bestDistance)
+        {
+            continue;
+        }
+
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            suggestions.clear();
+        }
+
+        suggestions.emplace_back(candidateWord);
+    }
+
+    return suggestions;
+}
+
+
+unsigned int DeletionIndex::maxDistance() const noexcept
+{
+    return maxDistance_;
+}
+
+
+unsigned int DeletionIndex::wordCount() const noexcept
+{
+    return static_cast<unsigned int>(wordStarts.size() - 1);
+}
+
+
+std::size_t DeletionIndex::entryCount() const noexcept
+{
+    return entries.size();
+}
+
+
+std::size_t DeletionIndex::memoryUsage() const noexcept
+{
+    return sizeof(DeletionIndex)
+        + words.capacity()
+        + wordStarts.capacity() * sizeof(std::uint32_t)
+        + bucketStarts.capacity() * sizeof(std::uint32_t)
+        + entries.capacity() * sizeof(Entry);
+}
+
+
+std::string_view DeletionIndex::wordAt(std::uint32_t wordIndex) const noexcept
+{
+    return std::string_view{words}.substr(
+        wordStarts[wordIndex], wordStarts[wordIndex + 1] - wordStarts[wordIndex]);
+}
@@ -0,0 +1,109 @@
+// DeletionIndex.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A DeletionIndex finds the words in a dictionary that are within a small
+// edit distance of a given word, using the "symmetric delete" approach
+// popularized by SymSpell.  Two words are within edit distance d of one
+// another only if deleting at most d characters from each of them can
+// make them the same, so the index maps every "delete variant" of every
+// dictionary word (the word itself, and every string made by deleting up
+// to maxDistance of its characters) to the words it came from.  Finding
+// suggestions for a word, then, means generating its own delete variants
+// and looking each one up -- a few dozen hash lookups, rather than the
+// thousands of Set lookups needed to try every possible edit of the word
+// to distance 2 -- and then checking the true distance to each candidate.
+//
+// Distances are measured in single-character deletions, insertions,
+// substitutions, and swaps of adjacent characters (the "optimal string
+// alignment" distance).
+//
+// The index stores 32-bit hashes of the delete variants rather than the
+// variants themselves: a table of (hash, word index) entries, grouped by
+// bucket the way a DictionaryImage groups its words, plus one copy of
+// each distinct word.  A hash collision can only add a candidate, which
+// the distance check then rejects.
+//
+// Building an index takes time and memory proportional to the number of
+// delete variants, which grows with the square of the word length when
+// maxDistance is 2; memoryUsage() reports how much was needed.  Once
+// built, an index is never changed, so it can be searched from several
+// threads at once.
+
+#ifndef DELETIONINDEX_HPP
+#define DELETIONINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SuggestionSource.hpp"
+
+
+
+class DeletionIndex : public SuggestionSource
+{
+public:
+    static constexpr unsigned int DEFAULT_MAX_DISTANCE = 2;
+
+    // The largest maxDistance allowed; each additional unit multiplies the
+    // size of the index by roughly the average word length.
+    static constexpr unsigned int MAX_DISTANCE = 3;
+
+public:
+    // Builds an index of the distinct words in [begin, end), for finding
+    // words up to the given distance (which is clamped to MAX_DISTANCE)
+    // away from a misspelling.  When presorted is true, the words are
+    // checked and not sorted again if they really are in ascending order.
+    DeletionIndex(
+        const std::string* begin, const std::string* end, bool presorted = false,
+        unsigned int maxDistance = DEFAULT_MAX_DISTANCE);
+
+
+    // suggestionsFor() returns the dictionary words closest to the given
+    // word: every word at the smallest distance (from 1 to maxDistance)
+    // at which any words can be found, in alphabetical order.  The word
+    // itself is never suggested, and nothing is returned if there are no
+    // words within maxDistance.
+    virtual std::vector<std::string> suggestionsFor(const std::string& word) const override;
+
+
+    unsigned int maxDistance() const noexcept;
+
+    // wordCount() returns the number of distinct words in the index, and
+    // entryCount() the number of (delete variant, word) entries.
+    unsigned int wordCount() const noexcept;
+    std::size_t entryCount() const noexcept;
+
+    virtual std::size_t memoryUsage() const noexcept override;
+
+
+private:
+    struct Entry
+    {
+        std::uint32_t hash;
+        std::uint32_t wordIndex;
+    };
+
+    unsigned int maxDistance_;
+
+    // The distinct words, in ascending order, one after another in a blob,
+    // with word i starting at wordStarts[i] and ending at wordStarts[i + 1].
+    std::string words;
+    std::vector<std::uint32_t> wordStarts;
+
+    // The entries in bucket b are entries[bucketStarts[b]] up to (but not
+    // including) entries[bucketStarts[b + 1]].
+    std::uint32_t bucketMask;
+    std::vector<std::uint32_t> bucketStarts;
+    std::vector<Entry> entries;
+
+private:
+    std::string_view wordAt(std::uint32_t wordIndex) const noexcept;
+};
+
+
+
+#endif // DELETIONINDEX_HPP
@@ -0,0 +1,319 @@
+// DictionaryImage.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <vector>
+#include "DictionaryImage.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    constexpr char MAGIC[8] = {'I', 'C', 'S', '4', '6', 'D', 'I', 'C'};
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrderMark;
+        std::uint32_t wordCount;
+        std::uint32_t bucketCount;
+        std::uint32_t blobSize;
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 32, "image header must be 32 bytes");
+
+
+    std::uint32_t bucketCountFor(std::size_t wordCount)
+    {
+        std::uint32_t bucketCount = 1;
+
+        while (bucketCount < wordCount)
+        {
+            bucketCount *= 2;
+        }
+
+        return bucketCount;
+    }
+
+
+    template <typename T>
+    void writeArray(std::ofstream& imageFile, const T* data, std::size_t count)
+    {
+        imageFile.write(reinterpret_cast<const char*>(data), sizeof(T) * count);
+    }
+}
+
+
+
+DictionaryImage::ImageException::ImageException(const std::string& reason)
+    : reason_{reason}
+{
+}
+
+
+std::string DictionaryImage::ImageException::reason() const
+{
+    return reason_;
+}
+
+
+
+DictionaryImage::DictionaryImage() noexcept
+    : file{}, wordCount{0}, bucketMask{0}, blobSize{0},
+      bucketStarts{nullptr}, entries{nullptr}, blob{nullptr}
+{
+}
+
+
+DictionaryImage::DictionaryImage(const std::string& imagePath)
+    : DictionaryImage{}
+{
+    open(imagePath);
+}
+
+
+void DictionaryImage::open(const std::string& imagePath)
+{
+    std::unique_ptr<MappedFile> newFile = std::make_unique<MappedFile>(imagePath);
+
+    if (!newFile->isOpen())
+    {
+        throw ImageException{"Cannot open dictionary image: " + imagePath};
+    }
+
+    std::string_view contents = newFile->contents();
+
+    if (contents.length() < sizeof(Header))
+    {
+        throw ImageException{"Not a dictionary image: " + imagePath};
+    }
+
+    Header header;
+    std::memcpy(&header, contents.data(), sizeof(Header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        throw ImageException{"Not a dictionary image: " + imagePath};
+    }
+
+    if (header.byteOrderMark != BYTE_ORDER_MARK)
+    {
+        throw ImageException{"Dictionary image has the wrong byte order: " + imagePath};
+    }
+
+    if (header.version != VERSION)
+    {
+        throw ImageException{
+            "Dictionary image has version " + std::to_string(header.version)
+            + " rather than " + std::to_string(VERSION) + ": " + imagePath};
+    }
+
+    std::uint64_t tableSize = sizeof(std::uint32_t) * (std::uint64_t{header.bucketCount} + 1);
+    std::uint64_t entriesSize = sizeof(Entry) * std::uint64_t{header.wordCount};
+
+    if (header.bucketCount == 0
+        || (header.bucketCount & (header.bucketCount - 1)) != 0
+        || sizeof(Header) + tableSize + entriesSize + header.blobSize != contents.length())
+    {
+        throw ImageException{"Dictionary image is corrupt: " + imagePath};
+    }
+
+    const char* base = contents.data();
+
+    file = std::move(newFile);
+    wordCount = header.wordCount;
+    bucketMask = header.bucketCount - 1;
+    blobSize = header.blobSize;
+    bucketStarts = reinterpret_cast<const std::uint32_t*>(base + sizeof(Header));
+    entries = reinterpret_cast<const Entry*>(base + sizeof(Header) + tableSize);
+    blob = base + sizeof(Header) + tableSize + entriesSize;
+}
+
+
+
+// The words are sorted by bucket (breaking ties by hash and then by the
+// words themselves), so duplicates end up next to each other and can be
+// skipped, and each bucket's entries end up contiguous, along with their
+// words in the blob.
+
+void DictionaryImage::write(
+    const std::string& imagePath, const std::string* begin, const std::string* end)
+{
+    std::size_t count = static_cast<std::size_t>(end - begin);
+    std::uint32_t bucketCount = bucketCountFor(count);
+    std::uint32_t mask = bucketCount - 1;
+
+    StringHashAsFnv1a hash;
+    std::vector<std::pair<std::uint32_t, const std::string*>> words;
+    words.reserve(count);
+
+    for (const std::string* word = begin; word != end; ++word)
+    {
+        words.emplace_back(hash(*word), word);
+    }
+
+    std::sort(
+        words.begin(), words.end(),
+        [mask](const auto& a, const auto& b)
+        {
+            if ((a.first & mask) != (b.first & mask))
+            {
+                return (a.first & mask) < (b.first & mask);
+            }
+            else if (a.first != b.first)
+            {
+                return a.first < b.first;
+            }
+            else
+            {
+                return *a.second < *b.second;
+            }
+        });
+
+    std::vector<std::uint32_t> bucketStarts(bucketCount + 1, 0);
+    std::vector<Entry> entries;
+    std::string blob;
+
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        if (i > 0 && words[i].first == words[i - 1].first && *words[i].second == *words[i - 1].second)
+        {
+            continue;
+        }
+
+        const std::string& word = *words[i].second;
+
+        if (blob.length() + word.length() > UINT32_MAX)
+        {
+            throw ImageException{"Too many words for a dictionary image: " + imagePath};
+        }
+
+        entries.push_back(Entry{
+            words[i].first,
+            static_cast<std::uint32_t>(blob.length()),
+            static_cast<std::uint32_t>(word.length())});
+
+        blob += word;
+        ++bucketStarts[(words[i].first & mask) + 1];
+    }
+
+    for (std::uint32_t b = 0; b < bucketCount; ++b)
+    {
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.wordCount = static_cast<std::uint32_t>(entries.size());
+    header.bucketCount = bucketCount;
+    header.blobSize = static_cast<std::uint32_t>(blob.length());
+    header.reserved = 0;
+
+    std::ofstream imageFile{imagePath, std::ios::binary | std::ios::trunc};
+
+    writeArray(imageFile, &header, 1);
+    writeArray(imageFile, bucketStarts.data(), bucketStarts.size());
+    writeArray(imageFile, entries.data(), entries.size());
+    writeArray(imageFile, blob.data(), blob.length());
+
+    imageFile.close();
+
+    if (!imageFile)
+    {
+        throw ImageException{"Cannot write dictionary image: " + imagePath};
+    }
+}
+
+
+bool DictionaryImage::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void DictionaryImage::add(const std::string& element)
+{
+    throw ImageException{"Cannot add words to a dictionary image"};
+}
+
+
+void DictionaryImage::addAll(const std::string* begin, const std::string* end, bool presorted)
+{
+    throw ImageException{"Cannot add words to a dictionary image"};
+}
+
+
+bool DictionaryImage::remove(const std::string& element)
+{
+    throw ImageException{"Cannot remove words from a dictionary image"};
+}
+
+
+bool DictionaryImage::contains(const std::string& element) const
+{
+    if (wordCount == 0)
+    {
+        return false;
+    }
+
+    LookupCounter::Lookup lookup{this};
+    std::uint32_t hash = StringHashAsFnv1a{}(element);
+    std::uint32_t bucket = hash & bucketMask;
+    std::uint32_t bucketEnd = std::min(bucketStarts[bucket + 1], wordCount);
+
+    for (std::uint32_t i = bucketStarts[bucket]; i < bucketEnd; ++i)
+    {
+        const Entry& entry = entries[i];
+        lookup.probed();
+
+        if (entry.hash != hash)
+        {
+            continue;
+        }
+
+        lookup.compared();
+
+        if (entry.length == element.length()
+            && entry.offset <= blobSize && entry.length <= blobSize - entry.offset
+            && std::memcmp(blob + entry.offset, element.data(), entry.length) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+unsigned int DictionaryImage::size() const noexcept
+{
+    return wordCount;
+}
+
+
+SetStatistics DictionaryImage::statistics() const
+{
+    SetStatistics statistics = Set<std::string>::statistics();
+    statistics.memoryBytes =
+        sizeof(*this) + (file != nullptr ? sizeof(MappedFile) : 0) + imageSize();
+
+    return statistics;
+}
+
+
+unsigned int DictionaryImage::imageSize() const noexcept
+{
+    return file == nullptr ? 0 : static_cast<unsigned int>(file->contents().length());
+}
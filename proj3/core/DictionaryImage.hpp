@@ -0,0 +1,140 @@
+// DictionaryImage.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A DictionaryImage is a read-only Set<std::string> whose contents live in
+// a binary "image" file, which is mapped into memory (see MappedFile.hpp)
+// and searched in place.  Opening one takes about as long as mapping the
+// file, no matter how many words it holds, and contains() neither parses
+// nor allocates anything.
+//
+// Images are written by DictionaryImage::write() (and the MAKE IMAGE tool,
+// which calls it).  An image is a hash table of the distinct words, laid
+// out as follows, with every integer stored as a 32-bit unsigned value in
+// the byte order of the machine that wrote it (which the byte order mark
+// in the header lets open() check):
+//
+//   * A header: the eight characters "ICS46DIC", the format version, a
+//     byte order mark (0x01020304), the number of words, the number of
+//     buckets (a power of two), the size of the string blob, and a
+//     reserved 0.
+//
+//   * The bucket table: one integer per bucket, plus one more, giving the
+//     index of the first entry in each bucket; the entries in bucket b are
+//     the ones from table[b] up to (but not including) table[b + 1].
+//
+//   * The entries, grouped by bucket: three integers for each word, giving
+//     its FNV-1a hash and the offset and length of its characters in the
+//     string blob.
+//
+//   * The string blob: the characters of every word, one after another,
+//     with each distinct word stored only once.
+//
+// A word's bucket is its FNV-1a hash modulo the number of buckets.
+
+#ifndef DICTIONARYIMAGE_HPP
+#define DICTIONARYIMAGE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "MappedFile.hpp"
+#include "Set.hpp"
+
+
+
+class DictionaryImage : public Set<std::string>
+{
+public:
+    // An ImageException is thrown when an image can't be read or written,
+    // or when there's an attempt to add words to a DictionaryImage.
+    class ImageException
+    {
+    public:
+        ImageException(const std::string& reason);
+        std::string reason() const;
+
+    private:
+        std::string reason_;
+    };
+
+    // The version of the image format written by write(); open() accepts
+    // only images with this version.
+    static constexpr std::uint32_t VERSION = 1;
+
+public:
+    // Initializes a DictionaryImage that holds no words until open() is
+    // called.
+    DictionaryImage() noexcept;
+
+    // Initializes a DictionaryImage by opening the image at the given path.
+    explicit DictionaryImage(const std::string& imagePath);
+
+    // open() maps the image at the given path, replacing whatever image was
+    // open before.  Only the header is read, so this takes constant time;
+    // the rest of the file is read by the operating system as contains()
+    // touches it.  An ImageException is thrown if the file can't be opened,
+    // isn't an image, has the wrong version or byte order, or isn't the
+    // size its header says it should be.  (A corrupt image whose size is
+    // right can't crash contains(), though it can give wrong answers.)
+    void open(const std::string& imagePath);
+
+    // write() writes an image holding the distinct elements of the range
+    // [begin, end) to the given path, throwing an ImageException if the
+    // file can't be written.
+    static void write(
+        const std::string& imagePath, const std::string* begin, const std::string* end);
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add(), addAll(), and remove() always throw an ImageException, since
+    // the image can't be changed.
+    virtual void add(const std::string& element) override;
+    virtual void addAll(const std::string* begin, const std::string* end, bool presorted) override;
+    virtual bool remove(const std::string& element) override;
+
+
+    // contains() returns true if the given word is in the image, false
+    // otherwise.  This function runs in constant time.
+    virtual bool contains(const std::string& element) const override;
+
+
+    // size() returns the number of words in the image.
+    virtual unsigned int size() const noexcept override;
+
+
+    // statistics() also reports the size of the image, which is mapped
+    // rather than allocated but takes up memory all the same.  Each entry
+    // that contains() visits is a probe; a word is compared only when its
+    // hash matches.
+    virtual SetStatistics statistics() const override;
+
+
+    // imageSize() returns the size, in bytes, of the open image.
+    unsigned int imageSize() const noexcept;
+
+
+private:
+    struct Entry
+    {
+        std::uint32_t hash;
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    std::unique_ptr<MappedFile> file;
+
+    std::uint32_t wordCount;
+    std::uint32_t bucketMask;
+    std::uint32_t blobSize;
+    const std::uint32_t* bucketStarts;
+    const Entry* entries;
+    const char* blob;
+};
+
+
+
+#endif // DICTIONARYIMAGE_HPP
@@ -0,0 +1,188 @@
+// EpochReclaimer.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <mutex>
+#include <stdexcept>
+#include "EpochReclaimer.hpp"
+
+
+
+namespace
+{
+    std::mutex slotNumbersMutex;
+    std::vector<unsigned int> freeSlotNumbers;
+    unsigned int nextSlotNumber = 0;
+
+
+    // A ThreadSlot holds the slot number of the thread it belongs to,
+    // giving it back to be reused when the thread ends.
+    class ThreadSlot
+    {
+    public:
+        ThreadSlot()
+        {
+            std::lock_guard<std::mutex> lock{slotNumbersMutex};
+
+            if (!freeSlotNumbers.empty())
+            {
+                number = freeSlotNumbers.back();
+                freeSlotNumbers.pop_back();
+            }
+            else if (nextSlotNumber < EpochReclaimer::MAX_THREADS)
+            {
+                number = nextSlotNumber++;
+            }
+            else
+            {
+                throw std::length_error{"EpochReclaimer: too many threads"};
+            }
+        }
+
+        ~ThreadSlot() noexcept
+        {
+            std::lock_guard<std::mutex> lock{slotNumbersMutex};
+            freeSlotNumbers.push_back(number);
+        }
+
+        unsigned int number;
+    };
+}
+
+
+
+EpochReclaimer::Guard::Guard(EpochReclaimer& reclaimer)
+    : reclaimer{reclaimer}, slot{threadSlot()}
+{
+    reclaimer.pin(reclaimer.slots[slot]);
+}
+
+
+EpochReclaimer::Guard::~Guard() noexcept
+{
+    reclaimer.unpin(reclaimer.slots[slot]);
+}
+
+
+
+EpochReclaimer::EpochReclaimer()
+    : globalEpoch{0}, slots{std::make_unique<Slot[]>(MAX_THREADS)}
+{
+}
+
+
+EpochReclaimer::~EpochReclaimer() noexcept
+{
+    for (unsigned int i = 0; i < MAX_THREADS; ++i)
+    {
+        for (const Retired& retired : slots[i].retired)
+        {
+            retired.deleter(retired.p);
+        }
+    }
+}
+
+
+// The global epoch can have advanced once since the thread was pinned, so
+// threads pinned in the epoch after this thread's may also have reached
+// the memory; it's tagged with that later epoch, to be safe.
+
+void EpochReclaimer::retire(void* p, Deleter deleter)
+{
+    Slot& slot = slots[threadSlot()];
+    std::uint64_t epoch = (slot.state.load(std::memory_order_relaxed) >> 1) + 1;
+
+    slot.retired.push_back(Retired{p, deleter, epoch});
+
+    if (++slot.retiresSinceAdvance >= ADVANCE_INTERVAL)
+    {
+        slot.retiresSinceAdvance = 0;
+        tryAdvance();
+        freeExpired(slot);
+    }
+}
+
+
+std::size_t EpochReclaimer::pendingCount() const noexcept
+{
+    std::size_t count = 0;
+
+    for (unsigned int i = 0; i < MAX_THREADS; ++i)
+    {
+        count += slots[i].retired.size();
+    }
+
+    return count;
+}
+
+
+std::uint64_t EpochReclaimer::epoch() const noexcept
+{
+    return globalEpoch.load();
+}
+
+
+// The fence keeps the loads of the structure that follow pinning from
+// happening before the new state is visible to a thread trying to advance
+// the global epoch.
+
+void EpochReclaimer::pin(Slot& slot) noexcept
+{
+    std::uint64_t epoch = globalEpoch.load(std::memory_order_relaxed);
+    slot.state.store((epoch << 1) | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+
+void EpochReclaimer::unpin(Slot& slot) noexcept
+{
+    slot.state.store(0, std::memory_order_release);
+}
+
+
+bool EpochReclaimer::tryAdvance() noexcept
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::uint64_t epoch = globalEpoch.load(std::memory_order_relaxed);
+
+    for (unsigned int i = 0; i < MAX_THREADS; ++i)
+    {
+        std::uint64_t state = slots[i].state.load(std::memory_order_acquire);
+
+        if ((state & 1) != 0 && (state >> 1) != epoch)
+        {
+            return false;
+        }
+    }
+
+    return globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+}
+
+
+void EpochReclaimer::freeExpired(Slot& slot) noexcept
+{
+    std::uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+    std::size_t kept = 0;
+
+    for (const Retired& retired : slot.retired)
+    {
+        if (retired.epoch + 2 <= epoch)
+        {
+            retired.deleter(retired.p);
+        }
+        else
+        {
+            slot.retired[kept++] = retired;
+        }
+    }
+
+    slot.retired.resize(kept);
+}
+
+
+unsigned int EpochReclaimer::threadSlot()
+{
+    thread_local ThreadSlot slot;
+    return slot.number;
+}
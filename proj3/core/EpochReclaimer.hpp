@@ -0,0 +1,131 @@
+// EpochReclaimer.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// An EpochReclaimer decides when memory that has been unlinked from a
+// lock-free structure (such as the nodes of a ConcurrentSkipListSet) can
+// safely be freed.  Another thread may have reached an unlinked node just
+// before it was unlinked, and still be looking at it, so it can't be
+// freed right away; instead, it's retired, and freed once every thread
+// that might have reached it has finished what it was doing.
+//
+// Every operation on the structure happens while its thread is pinned,
+// which it is for as long as it holds a Guard.  The reclaimer keeps a
+// global epoch, and a pinned thread records the epoch it was pinned in.
+// The global epoch only advances when every pinned thread has been pinned
+// in the current one, so a thread can only ever be pinned in the current
+// epoch or the one before it.  Memory retired in an epoch was unlinked
+// before anyone pinned in any later epoch could have reached it, so once
+// the global epoch is two past it, nobody can be looking at it anymore.
+//
+// Each thread keeps the memory it retires in its own list, so retiring
+// never contends with other threads; every so often, it tries to advance
+// the global epoch, then frees whatever on its own list has expired.
+// Anything still on a list when the EpochReclaimer is destroyed (when no
+// thread is using the structure anymore) is freed then.
+//
+// Threads are told apart by a slot number that each one is given the first
+// time it uses any EpochReclaimer, and that goes back to be reused when the
+// thread ends.  At most MAX_THREADS threads can have one at the same time.
+
+#ifndef EPOCHRECLAIMER_HPP
+#define EPOCHRECLAIMER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+
+class EpochReclaimer
+{
+public:
+    // The most threads that can be using EpochReclaimers at once.
+    static constexpr unsigned int MAX_THREADS = 256;
+
+    // How many times a thread retires something between its attempts to
+    // advance the global epoch.
+    static constexpr unsigned int ADVANCE_INTERVAL = 64;
+
+    // A Deleter frees memory that was retired.
+    using Deleter = void (*)(void* p) noexcept;
+
+
+    // A Guard keeps the current thread pinned for as long as it exists.
+    // Guards can't be nested: a thread holds at most one at a time for
+    // each EpochReclaimer.
+    class Guard
+    {
+    public:
+        explicit Guard(EpochReclaimer& reclaimer);
+        ~Guard() noexcept;
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        EpochReclaimer& reclaimer;
+        unsigned int slot;
+    };
+
+
+public:
+    EpochReclaimer();
+    ~EpochReclaimer() noexcept;
+
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+
+    // retire() hands over memory that has been unlinked, so that nothing
+    // new can reach it, to be freed with the given deleter once it's safe.
+    // The current thread must be pinned.
+    void retire(void* p, Deleter deleter);
+
+
+    // pendingCount() returns how many retired pieces of memory haven't been
+    // freed yet.  It's only accurate when no thread is pinned.
+    std::size_t pendingCount() const noexcept;
+
+
+    // epoch() returns the global epoch.
+    std::uint64_t epoch() const noexcept;
+
+
+private:
+    struct Retired
+    {
+        void* p;
+        Deleter deleter;
+        std::uint64_t epoch;
+    };
+
+    // Each Slot has a cache line to itself, so that threads pinning and
+    // unpinning don't slow each other down.  Its state is 0 when its
+    // thread isn't pinned; otherwise, it's the epoch the thread was pinned
+    // in, shifted left one bit, with the lowest bit set.
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> state{0};
+        std::vector<Retired> retired;
+        unsigned int retiresSinceAdvance = 0;
+    };
+
+    std::atomic<std::uint64_t> globalEpoch;
+    std::unique_ptr<Slot[]> slots;
+
+private:
+    void pin(Slot& slot) noexcept;
+    void unpin(Slot& slot) noexcept;
+    bool tryAdvance() noexcept;
+    void freeExpired(Slot& slot) noexcept;
+
+    static unsigned int threadSlot();
+};
+
+
+
+#endif // EPOCHRECLAIMER_HPP
@@ -0,0 +1,814 @@
+// FlatHashSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A FlatHashSet is an implementation of a Set that is an open-addressing
+// hash table, laid out in the style of a "Swiss table."  Rather than
+// chaining elements through separately-allocated nodes, the elements are
+// stored directly in one dynamically-allocated array of slots, alongside a
+// parallel array of one-byte "control" values.  Each control byte records
+// whether its slot is empty, deleted, or full; a full slot's control byte
+// also holds 7 bits of the element's hash.
+//
+// Lookups probe the control bytes 16 at a time -- with a single SSE2
+// comparison when the compiler targets it, or a portable loop otherwise --
+// so most unsuccessful probes never touch the elements at all, and most
+// successful ones compare against exactly one element.
+//
+// The capacity is always a power of two.  Whenever adding an element would
+// make the proportion of used slots exceed the maximum load factor (which
+// can be passed to the constructor), the array is doubled in size.
+//
+// Removing an element can't always simply empty its slot, since a probe
+// for some other element may have passed over that slot on its way to the
+// element's own, and an empty slot would now stop it short.  That can only
+// have happened, though, if the slot is in a run of at least a group's
+// worth of full slots, since any group containing an empty slot ends a
+// probe.  So the slot is emptied when its run is shorter than that (which,
+// at the load factors used here, is nearly always), and otherwise marked
+// as deleted: a "tombstone" that probes pass over and add() can reuse.
+// Tombstones count as used slots, so they're cleared out when enough of
+// them build up to trigger a resize, which rehashes into a new array of
+// the capacity that the remaining elements need.
+
+#ifndef FLATHASHSET_HPP
+#define FLATHASHSET_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "Set.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+
+template <typename ElementType, typename Hasher = std::function<unsigned int(const ElementType&)>>
+class FlatHashSet : public Set<ElementType>
+{
+public:
+    // The number of control bytes examined by each step of a probe.
+    static constexpr unsigned int GROUP_WIDTH = 16;
+
+    // The smallest capacity the FlatHashSet will allocate once something
+    // has been added to it.
+    static constexpr unsigned int MINIMUM_CAPACITY = 16;
+
+    // The maximum load factor used when none is passed to the constructor.
+    static constexpr double DEFAULT_MAX_LOAD_FACTOR = 0.875;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.  As with HashSet, this is
+    // only the default; the second template argument can name any function
+    // object type with the same signature, so that it can be inlined.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+    // Initializes a FlatHashSet to be empty, so that it will use the given
+    // hash function whenever it needs to hash an element, and will grow
+    // whenever its load factor would exceed maxLoadFactor.  Load factors
+    // outside of the range (0, 0.9375] are clamped into it, since an open
+    // addressing table must always keep some of its slots empty.
+    explicit FlatHashSet(
+        Hasher hashFunction, double maxLoadFactor = DEFAULT_MAX_LOAD_FACTOR);
+
+    // Cleans up the FlatHashSet so that it leaks no memory.
+    virtual ~FlatHashSet() noexcept;
+
+    // Initializes a new FlatHashSet to be a copy of an existing one.
+    FlatHashSet(const FlatHashSet& s);
+
+    // Initializes a new FlatHashSet whose contents are moved from an
+    // expiring one.  As with a HashSet, the expiring one keeps a copy of
+    // the hash function, so this is only noexcept when copying the hash
+    // function can't throw.
+    FlatHashSet(FlatHashSet&& s) noexcept(std::is_nothrow_copy_constructible_v<Hasher>);
+
+    // Assigns an existing FlatHashSet into another.
+    FlatHashSet& operator=(const FlatHashSet& s);
+
+    // Assigns an expiring FlatHashSet into another.
+    FlatHashSet& operator=(FlatHashSet&& s) noexcept(std::is_nothrow_swappable_v<Hasher>);
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  When adding the element would push
+    // the load factor past the maximum, the array is doubled in size first,
+    // which takes linear time; otherwise, this function runs in constant
+    // time (assuming a good hash function).
+    virtual void add(const ElementType& element) override;
+
+
+    // addAll() adds every element in the range [begin, end) to the set,
+    // first growing the array (with reserve()) so that it's resized at
+    // most once.  The presorted hint is ignored.
+    virtual void addAll(const ElementType* begin, const ElementType* end, bool presorted) override;
+
+
+    // remove() removes an element from the set, as described above.  This
+    // function runs in constant time (assuming a good hash function).
+    virtual bool remove(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in constant time (assuming a
+    // good hash function).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // statistics() also reports the memory taken by the slots and their
+    // control bytes.  Each group of control bytes that contains() checks is
+    // a probe; an element is compared only when its hash fragment matches.
+    virtual SetStatistics statistics() const override;
+
+
+    // capacity() returns the number of slots in the array, which is zero
+    // until something has been added.
+    unsigned int capacity() const noexcept;
+
+
+    // loadFactor() returns the proportion of the slots that are in use.
+    double loadFactor() const noexcept;
+
+
+    // maxLoadFactor() returns the load factor beyond which the FlatHashSet
+    // will grow.
+    double maxLoadFactor() const noexcept;
+
+
+    // reserve() grows the array, if necessary, so that the given number of
+    // elements can be stored without the load factor exceeding the maximum.
+    void reserve(unsigned int elements);
+
+
+private:
+    // Control bytes are signed: full slots hold a non-negative 7-bit hash
+    // fragment, while the special (negative) values below mark slots that
+    // hold no element.
+    using Control = signed char;
+
+    static constexpr Control EMPTY = -128;
+    static constexpr Control DELETED = -2;
+
+    // A BitMask holds one bit per control byte in a group, with bit i set
+    // when the i-th byte of the group matched whatever was being sought.
+    using BitMask = std::uint32_t;
+
+    Hasher hashFunction;
+    double maxLoad;
+
+    // The ctrl array has capacity + GROUP_WIDTH bytes; the last GROUP_WIDTH
+    // of them mirror the first GROUP_WIDTH, so that a group can be loaded
+    // starting at any slot without wrapping around.
+    Control* ctrl;
+    ElementType* slots;
+
+    unsigned int slotCount;
+    unsigned int elementCount;
+    unsigned int usedSlots;
+    unsigned int growthLimit;
+
+    std::allocator<ElementType> slotAllocator;
+
+private:
+    static std::uint64_t mixHash(unsigned int hash) noexcept;
+    static unsigned int groupIndex(std::uint64_t mixed) noexcept;
+    static Control hashFragment(std::uint64_t mixed) noexcept;
+
+    static BitMask matchByte(const Control* group, Control value) noexcept;
+    static BitMask matchNotFull(const Control* group) noexcept;
+    static unsigned int lowestBit(BitMask mask) noexcept;
+    static unsigned int highestBit(BitMask mask) noexcept;
+
+    std::uint64_t hashOf(const ElementType& element) const;
+    long long findSlot(const ElementType& element, std::uint64_t mixed) const;
+    long long findSlot(const ElementType& element, std::uint64_t mixed, LookupCounter::Lookup& lookup) const;
+    unsigned int findInsertSlot(std::uint64_t mixed) const noexcept;
+    void setControl(unsigned int index, Control value) noexcept;
+
+    void allocate(unsigned int newCapacity);
+    void resize(unsigned int newCapacity);
+    void copyFrom(const FlatHashSet& s);
+    void destroyAll() noexcept;
+    unsigned int capacityFor(unsigned int elements) const noexcept;
+};
+
+
+
+template <typename ElementType, typename Hasher>
+FlatHashSet<ElementType, Hasher>::FlatHashSet(Hasher hashFunction, double maxLoadFactor)
+    : hashFunction{std::move(hashFunction)}, maxLoad{maxLoadFactor},
+      ctrl{nullptr}, slots{nullptr},
+      slotCount{0}, elementCount{0}, usedSlots{0}, growthLimit{0}
+{
+    if (!(maxLoad > 0.0))
+    {
+        maxLoad = DEFAULT_MAX_LOAD_FACTOR;
+    }
+    else if (maxLoad > 0.9375)
+    {
+        maxLoad = 0.9375;
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+FlatHashSet<ElementType, Hasher>::~FlatHashSet() noexcept
+{
+    destroyAll();
+}
+
+
+template <typename ElementType, typename Hasher>
+FlatHashSet<ElementType, Hasher>::FlatHashSet(const FlatHashSet& s)
+    : hashFunction{s.hashFunction}, maxLoad{s.maxLoad},
+      ctrl{nullptr}, slots{nullptr},
+      slotCount{0}, elementCount{0}, usedSlots{0}, growthLimit{0}
+{
+    copyFrom(s);
+}
+
+
+template <typename ElementType, typename Hasher>
+FlatHashSet<ElementType, Hasher>::FlatHashSet(FlatHashSet&& s)
+    noexcept(std::is_nothrow_copy_constructible_v<Hasher>)
+    : hashFunction{s.hashFunction}, maxLoad{s.maxLoad},
+      ctrl{nullptr}, slots{nullptr},
+      slotCount{0}, elementCount{0}, usedSlots{0}, growthLimit{0}
+{
+    std::swap(ctrl, s.ctrl);
+    std::swap(slots, s.slots);
+    std::swap(slotCount, s.slotCount);
+    std::swap(elementCount, s.elementCount);
+    std::swap(usedSlots, s.usedSlots);
+    std::swap(growthLimit, s.growthLimit);
+}
+
+
+template <typename ElementType, typename Hasher>
+FlatHashSet<ElementType, Hasher>& FlatHashSet<ElementType, Hasher>::operator=(const FlatHashSet& s)
+{
+    if (this != &s)
+    {
+        FlatHashSet copy{s};
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType, typename Hasher>
+FlatHashSet<ElementType, Hasher>& FlatHashSet<ElementType, Hasher>::operator=(FlatHashSet&& s)
+    noexcept(std::is_nothrow_swappable_v<Hasher>)
+{
+    if (this != &s)
+    {
+        std::swap(hashFunction, s.hashFunction);
+        std::swap(maxLoad, s.maxLoad);
+        std::swap(ctrl, s.ctrl);
+        std::swap(slots, s.slots);
+        std::swap(slotCount, s.slotCount);
+        std::swap(elementCount, s.elementCount);
+        std::swap(usedSlots, s.usedSlots);
+        std::swap(growthLimit, s.growthLimit);
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool FlatHashSet<ElementType, Hasher>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType, typename Hasher>
+void FlatHashSet<ElementType, Hasher>::add(const ElementType& element)
+{
+    std::uint64_t mixed = hashOf(element);
+
+    if (findSlot(element, mixed) >= 0)
+    {
+        return;
+    }
+
+    if (usedSlots >= growthLimit)
+    {
+        resize(capacityFor(elementCount + 1));
+    }
+
+    unsigned int index = findInsertSlot(mixed);
+
+    new (slots + index) ElementType(element);
+
+    if (ctrl[index] == EMPTY)
+    {
+        ++usedSlots;
+    }
+
+    setControl(index, hashFragment(mixed));
+    ++elementCount;
+}
+
+
+template <typename ElementType, typename Hasher>
+void FlatHashSet<ElementType, Hasher>::addAll(
+    const ElementType* begin, const ElementType* end, bool presorted)
+{
+    reserve(elementCount + static_cast<unsigned int>(end - begin));
+    Set<ElementType>::addAll(begin, end, presorted);
+}
+
+
+// The slot's run of full slots is measured by looking for empty slots in
+// the group starting at it and in the group just before it: the run extends
+// forward to the first empty one in the former and back to the last empty
+// one in the latter.  (If either group has no empty slots, the run is at
+// least a group long.)
+
+template <typename ElementType, typename Hasher>
+bool FlatHashSet<ElementType, Hasher>::remove(const ElementType& element)
+{
+    if (elementCount == 0)
+    {
+        return false;
+    }
+
+    long long found = findSlot(element, hashOf(element));
+
+    if (found < 0)
+    {
+        return false;
+    }
+
+    unsigned int index = static_cast<unsigned int>(found);
+    unsigned int mask = slotCount - 1;
+
+    BitMask emptyAfter = matchByte(ctrl + index, EMPTY);
+    BitMask emptyBefore = matchByte(ctrl + ((index - GROUP_WIDTH) & mask), EMPTY);
+
+    bool inShortRun = emptyAfter != 0 && emptyBefore != 0
+        && lowestBit(emptyAfter) + (GROUP_WIDTH - 1 - highestBit(emptyBefore)) < GROUP_WIDTH;
+
+    slots[index].~ElementType();
+
+    if (inShortRun)
+    {
+        setControl(index, EMPTY);
+        --usedSlots;
+    }
+    else
+    {
+        setControl(index, DELETED);
+    }
+
+    --elementCount;
+    return true;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool FlatHashSet<ElementType, Hasher>::contains(const ElementType& element) const
+{
+    LookupCounter::Lookup lookup{this};
+    return elementCount > 0 && findSlot(element, hashOf(element), lookup) >= 0;
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int FlatHashSet<ElementType, Hasher>::size() const noexcept
+{
+    return elementCount;
+}
+
+
+template <typename ElementType, typename Hasher>
+SetStatistics FlatHashSet<ElementType, Hasher>::statistics() const
+{
+    SetStatistics statistics = Set<ElementType>::statistics();
+    statistics.memoryBytes =
+        sizeof(*this) + slotCount * sizeof(ElementType)
+        + (ctrl != nullptr ? slotCount + GROUP_WIDTH : 0) * sizeof(Control);
+
+    return statistics;
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int FlatHashSet<ElementType, Hasher>::capacity() const noexcept
+{
+    return slotCount;
+}
+
+
+template <typename ElementType, typename Hasher>
+double FlatHashSet<ElementType, Hasher>::loadFactor() const noexcept
+{
+    return slotCount == 0 ? 0.0 : static_cast<double>(elementCount) / slotCount;
+}
+
+
+template <typename ElementType, typename Hasher>
+double FlatHashSet<ElementType, Hasher>::maxLoadFactor() const noexcept
+{
+    return maxLoad;
+}
+
+
+template <typename ElementType, typename Hasher>
+void FlatHashSet<ElementType, Hasher>::reserve(unsigned int elements)
+{
+    unsigned int newCapacity = capacityFor(elements);
+
+    if (newCapacity > slotCount)
+    {
+        resize(newCapacity);
+    }
+}
+
+
+
+// ===========================
+// ADDITIONAL MEMBER FUNCTIONS
+// ===========================
+
+
+// The hash functions we're given produce 32-bit values whose low bits are
+// often poorly distributed (e.g., summing character codes), so they're mixed
+// by a multiplication with a 64-bit odd constant and a fold of the high
+// half into the low half.  The low 7 bits of the result become the control
+// byte's hash fragment; the remaining bits choose where the probe begins.
+
+template <typename ElementType, typename Hasher>
+std::uint64_t FlatHashSet<ElementType, Hasher>::mixHash(unsigned int hash) noexcept
+{
+    std::uint64_t mixed = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+    return mixed ^ (mixed >> 32);
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int FlatHashSet<ElementType, Hasher>::groupIndex(std::uint64_t mixed) noexcept
+{
+    return static_cast<unsigned int>(mixed >> 7);
+}
+
+
+template <typename ElementType, typename Hasher>
+typename FlatHashSet<ElementType, Hasher>::Control FlatHashSet<ElementType, Hasher>::hashFragment(
+    std::uint64_t mixed) noexcept
+{
+    return static_cast<Control>(mixed & 0x7F);
+}
+
+
+template <typename ElementType, typename Hasher>
+typename FlatHashSet<ElementType, Hasher>::BitMask FlatHashSet<ElementType, Hasher>::matchByte(
+    const Control* group, Control value) noexcept
+{
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    __m128i match = _mm_cmpeq_epi8(_mm_set1_epi8(value), bytes);
+    return static_cast<BitMask>(_mm_movemask_epi8(match));
+#else
+    BitMask mask = 0;
+
+    for (unsigned int i = 0; i < GROUP_WIDTH; ++i)
+    {
+        if (group[i] == value)
+        {
+            mask |= BitMask{1} << i;
+        }
+    }
+
+    return mask;
+#endif
+}
+
+
+// A slot is "not full" when it's either empty or deleted, both of which are
+// represented by control bytes less than -1.
+
+template <typename ElementType, typename Hasher>
+typename FlatHashSet<ElementType, Hasher>::BitMask FlatHashSet<ElementType, Hasher>::matchNotFull(
+    const Control* group) noexcept
+{
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    __m128i match = _mm_cmpgt_epi8(_mm_set1_epi8(-1), bytes);
+    return static_cast<BitMask>(_mm_movemask_epi8(match));
+#else
+    BitMask mask = 0;
+
+    for (unsigned int i = 0; i < GROUP_WIDTH; ++i)
+    {
+        if (group[i] < -1)
+        {
+            mask |= BitMask{1} << i;
+        }
+    }
+
+    return mask;
+#endif
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int FlatHashSet<ElementType, Hasher>::lowestBit(BitMask mask) noexcept
+{
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int FlatHashSet<ElementType, Hasher>::highestBit(BitMask mask) noexcept
+{
+    return static_cast<unsigned int>(31 - __builtin_clz(mask));
+}
+
+
+template <typename ElementType, typename Hasher>
+std::uint64_t FlatHashSet<ElementType, Hasher>::hashOf(const ElementType& element) const
+{
+    return mixHash(static_cast<unsigned int>(hashFunction(element)));
+}
+
+
+// findSlot() returns the index of the slot containing the given element, or
+// -1 if it isn't present.  Groups are probed in a triangular sequence (the
+// start moves by 16, then 32, then 48 slots, and so on), which visits every
+// group exactly once when the capacity is a power of two.  Since the table
+// always has at least one empty slot, a group containing an empty slot
+// ends the probe.
+
+template <typename ElementType, typename Hasher>
+long long FlatHashSet<ElementType, Hasher>::findSlot(
+    const ElementType& element, std::uint64_t mixed) const
+{
+    LookupCounter::Lookup uncounted{nullptr};
+    return findSlot(element, mixed, uncounted);
+}
+
+
+template <typename ElementType, typename Hasher>
+long long FlatHashSet<ElementType, Hasher>::findSlot(
+    const ElementType& element, std::uint64_t mixed, LookupCounter::Lookup& lookup) const
+{
+    if (slotCount == 0)
+    {
+        return -1;
+    }
+
+    unsigned int mask = slotCount - 1;
+    unsigned int position = groupIndex(mixed) & mask;
+    unsigned int step = 0;
+    Control fragment = hashFragment(mixed);
+
+    while (true)
+    {
+        const Control* group = ctrl + position;
+        lookup.probed();
+
+        for (BitMask match = matchByte(group, fragment); match != 0; match &= match - 1)
+        {
+            unsigned int index = (position + lowestBit(match)) & mask;
+            lookup.compared();
+
+            if (slots[index] == element)
+            {
+                return index;
+            }
+        }
+
+        if (matchByte(group, EMPTY) != 0)
+        {
+            return -1;
+        }
+
+        step += GROUP_WIDTH;
+        position = (position + step) & mask;
+    }
+}
+
+
+// findInsertSlot() returns the index of the first empty or deleted slot
+// along the probe sequence for the given hash.
+
+template <typename ElementType, typename Hasher>
+unsigned int FlatHashSet<ElementType, Hasher>::findInsertSlot(std::uint64_t mixed) const noexcept
+{
+    unsigned int mask = slotCount - 1;
+    unsigned int position = groupIndex(mixed) & mask;
+    unsigned int step = 0;
+
+    while (true)
+    {
+        BitMask match = matchNotFull(ctrl + position);
+
+        if (match != 0)
+        {
+            return (position + lowestBit(match)) & mask;
+        }
+
+        step += GROUP_WIDTH;
+        position = (position + step) & mask;
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+void FlatHashSet<ElementType, Hasher>::setControl(unsigned int index, Control value) noexcept
+{
+    ctrl[index] = value;
+
+    if (index < GROUP_WIDTH)
+    {
+        ctrl[slotCount + index] = value;
+    }
+}
+
+
+// allocate() replaces the arrays with empty ones of the given capacity,
+// without touching whatever they used to point to.
+
+template <typename ElementType, typename Hasher>
+void FlatHashSet<ElementType, Hasher>::allocate(unsigned int newCapacity)
+{
+    Control* newCtrl = new Control[newCapacity + GROUP_WIDTH];
+    ElementType* newSlots;
+
+    try
+    {
+        newSlots = slotAllocator.allocate(newCapacity);
+    }
+    catch (...)
+    {
+        delete[] newCtrl;
+        throw;
+    }
+
+    std::memset(newCtrl, static_cast<unsigned char>(EMPTY), newCapacity + GROUP_WIDTH);
+
+    ctrl = newCtrl;
+    slots = newSlots;
+    slotCount = newCapacity;
+    usedSlots = 0;
+    growthLimit = static_cast<unsigned int>(newCapacity * maxLoad);
+
+    if (growthLimit >= newCapacity)
+    {
+        growthLimit = newCapacity - 1;
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+void FlatHashSet<ElementType, Hasher>::resize(unsigned int newCapacity)
+{
+    Control* oldCtrl = ctrl;
+    ElementType* oldSlots = slots;
+    unsigned int oldCapacity = slotCount;
+
+    allocate(newCapacity);
+
+    for (unsigned int i = 0; i < oldCapacity; ++i)
+    {
+        if (oldCtrl[i] >= 0)
+        {
+            std::uint64_t mixed = hashOf(oldSlots[i]);
+            unsigned int index = findInsertSlot(mixed);
+
+            new (slots + index) ElementType(std::move(oldSlots[i]));
+            oldSlots[i].~ElementType();
+
+            setControl(index, hashFragment(mixed));
+            ++usedSlots;
+        }
+    }
+
+    if (oldSlots != nullptr)
+    {
+        slotAllocator.deallocate(oldSlots, oldCapacity);
+    }
+
+    delete[] oldCtrl;
+}
+
+
+// copyFrom() makes this (empty) FlatHashSet an exact copy of another one.
+// Both use the same hash function, so every element can be copied into
+// the same slot it occupies in the original.
+
+template <typename ElementType, typename Hasher>
+void FlatHashSet<ElementType, Hasher>::copyFrom(const FlatHashSet& s)
+{
+    if (s.slotCount == 0)
+    {
+        return;
+    }
+
+    allocate(s.slotCount);
+
+    unsigned int constructed = 0;
+
+    try
+    {
+        for (; constructed < s.slotCount; ++constructed)
+        {
+            if (s.ctrl[constructed] >= 0)
+            {
+                new (slots + constructed) ElementType(s.slots[constructed]);
+            }
+        }
+    }
+    catch (...)
+    {
+        for (unsigned int i = 0; i < constructed; ++i)
+        {
+            if (s.ctrl[i] >= 0)
+            {
+                slots[i].~ElementType();
+            }
+        }
+
+        slotAllocator.deallocate(slots, slotCount);
+        delete[] ctrl;
+
+        ctrl = nullptr;
+        slots = nullptr;
+        slotCount = 0;
+        usedSlots = 0;
+        growthLimit = 0;
+        throw;
+    }
+
+    std::memcpy(ctrl, s.ctrl, s.slotCount + GROUP_WIDTH);
+    elementCount = s.elementCount;
+    usedSlots = s.usedSlots;
+}
+
+
+template <typename ElementType, typename Hasher>
+void FlatHashSet<ElementType, Hasher>::destroyAll() noexcept
+{
+    for (unsigned int i = 0; i < slotCount; ++i)
+    {
+        if (ctrl[i] >= 0)
+        {
+            slots[i].~ElementType();
+        }
+    }
+
+    if (slots != nullptr)
+    {
+        slotAllocator.deallocate(slots, slotCount);
+    }
+
+    delete[] ctrl;
+
+    ctrl = nullptr;
+    slots = nullptr;
+    slotCount = 0;
+    elementCount = 0;
+    usedSlots = 0;
+    growthLimit = 0;
+}
+
+
+// capacityFor() returns the smallest power-of-two capacity (at least
+// MINIMUM_CAPACITY) that can hold the given number of elements without
+// exceeding the maximum load factor.
+
+template <typename ElementType, typename Hasher>
+unsigned int FlatHashSet<ElementType, Hasher>::capacityFor(unsigned int elements) const noexcept
+{
+    unsigned int newCapacity = MINIMUM_CAPACITY;
+
+    while (static_cast<unsigned int>(newCapacity * maxLoad) < elements)
+    {
+        newCapacity *= 2;
+    }
+
+    return newCapacity;
+}
+
+
+
+#endif // FLATHASHSET_HPP
+
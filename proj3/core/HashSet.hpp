@@ -10,9 +10,24 @@
 // indicating the size of the array.
 //
 // As elements are added to the HashSet and the proportion of the HashSet's
-// size to its capacity exceeds 0.8 (i.e., there are more than 80% as many
-// elements as there are array cells), the HashSet should be resized so
-// that it is twice as large as it was before.
+// size to its capacity exceeds a maximum load factor (0.8 by default), the
+// HashSet is resized so that it is larger by a growth factor (2 by default).
+// Both of these can be passed to the constructor.
+//
+// Each node remembers the full hash of its element, so a chain can be
+// walked comparing hashes before comparing elements (which matters when
+// comparing elements is expensive, as with long strings), and so moving a
+// node into a new array never calls the hash function again.
+//
+// Resizing is incremental: rather than re-linking every node into the new
+// array at once, the old array is kept alive alongside the new one, and
+// each subsequent call to add() or contains() migrates a few of its buckets
+// into the new array.  Lookups consult the new array first and then the
+// not-yet-migrated part of the old one.  This way, no single call to add()
+// pays for moving every element.
+//
+// The nodes are allocated with a NodeAllocator (see NodeAllocator.hpp),
+// which is given by the third template argument; the arrays are not.
 //
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector) to store the information
@@ -24,13 +39,17 @@
 #define HASHSET_HPP
 
 #include <functional>
+#include <type_traits>
+#include <utility>
+#include "NodeAllocator.hpp"
 #include "Set.hpp"
 
-#include <iostream>
 
 
-
-template <typename ElementType>
+template <
+    typename ElementType,
+    typename Hasher = std::function<unsigned int(const ElementType&)>,
+    typename NodeAllocator = HeapNodeAllocator>
 class HashSet : public Set<ElementType>
 {
 public:
@@ -38,14 +57,36 @@ public:
     // added to it.
     static constexpr unsigned int DEFAULT_CAPACITY = 10;
 
+    // The load factor beyond which the HashSet grows, when none is passed
+    // to the constructor.
+    static constexpr double DEFAULT_MAX_LOAD_FACTOR = 0.8;
+
+    // The factor by which the capacity is multiplied when the HashSet grows,
+    // when none is passed to the constructor.
+    static constexpr double DEFAULT_GROWTH_FACTOR = 2.0;
+
+    // The number of buckets of the old array that are migrated into the new
+    // one during each call to add() or contains() while a resize is under way.
+    static constexpr unsigned int MIGRATION_STEP = 4;
+
     // A HashFunction is a function that takes a reference to a const
-    // ElementType and returns an unsigned int.
+    // ElementType and returns an unsigned int.  This is the default type
+    // of hash function stored by a HashSet; a second template argument can
+    // replace it with any other function object type with the same
+    // signature, which, unlike a std::function, allows the compiler to
+    // inline calls to the hash function into add() and contains().
     using HashFunction = std::function<unsigned int(const ElementType&)>;
 
 public:
     // Initializes a HashSet to be empty, so that it will use the given
-    // hash function whenever it needs to hash an element.
-    explicit HashSet(HashFunction hashFunction);
+    // hash function whenever it needs to hash an element, and will grow
+    // by growthFactor whenever its load factor exceeds maxLoadFactor.
+    // Non-positive load factors and growth factors no greater than 1 are
+    // replaced by the defaults.
+    explicit HashSet(
+        Hasher hashFunction,
+        double maxLoadFactor = DEFAULT_MAX_LOAD_FACTOR,
+        double growthFactor = DEFAULT_GROWTH_FACTOR);
 
     // Cleans up the HashSet so that it leaks no memory.
     virtual ~HashSet() noexcept;
@@ -54,14 +95,17 @@ public:
     HashSet(const HashSet& s);
 
     // Initializes a new HashSet whose contents are moved from an
-    // expiring one.
-    HashSet(HashSet&& s) noexcept;
+    // expiring one.  The expiring one keeps a copy of the hash function,
+    // so that it can still be used, which means that this can only be
+    // noexcept when copying the hash function can't throw (which copying
+    // a std::function can).
+    HashSet(HashSet&& s) noexcept(std::is_nothrow_copy_constructible_v<Hasher>);
 
     // Assigns an existing HashSet into another.
     HashSet& operator=(const HashSet& s);
 
     // Assigns an expiring HashSet into another.
-    HashSet& operator=(HashSet&& s) noexcept;
+    HashSet& operator=(HashSet&& s) noexcept(std::is_nothrow_swappable_v<Hasher>);
 
 
     // isImplemented() should be modified to return true if you've
@@ -70,15 +114,26 @@ public:
 
 
     // add() adds an element to the set.  If the element is already in the set,
-    // this function has no effect.  This function triggers a resizing of the
-    // array when the ratio of size to capacity would exceed 0.8.  In the case
-    // where the array is resized, this function runs in linear time (with
-    // respect to the number of elements, assuming a good hash function);
-    // otherwise, it runs in constant time (again, assuming a good hash
-    // function).
+    // this function has no effect.  This function starts a resizing of the
+    // array when the ratio of size to capacity exceeds the maximum load
+    // factor; since the resizing is spread across later calls, this function
+    // runs in constant time (assuming a good hash function).
     virtual void add(const ElementType& element) override;
 
 
+    // addAll() adds every element in the range [begin, end) to the set,
+    // first growing the array (with reserve()) so that none of the
+    // additions causes a resize.  The presorted hint is ignored.
+    virtual void addAll(const ElementType* begin, const ElementType* end, bool presorted) override;
+
+
+    // remove() removes an element from the set by unlinking its node from
+    // its chain, so it leaves nothing behind in the array.  (The array
+    // doesn't shrink.)  This function runs in constant time (assuming a
+    // good hash function).
+    virtual bool remove(const ElementType& element) override;
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function runs in constant time (with respect
     // to the number of elements, assuming a good hash function).
@@ -89,369 +144,614 @@ public:
     virtual unsigned int size() const noexcept override;
 
 
+    // statistics() also reports the memory taken by the array (or arrays,
+    // during a resize) and the nodes.  Each node that contains() visits is
+    // a probe; an element is compared only when its hash matches.
+    virtual SetStatistics statistics() const override;
+
+
     // elementsAtIndex() returns the number of elements that hashed to a
     // particular index in the array.  If the index is out of the boundaries
-    // of the array, this function returns 0.
+    // of the array, this function returns 0.  If a resize is under way, it's
+    // finished first (so "the array" is the new one), which takes time
+    // proportional to the size of the old array once, rather than on every
+    // call, so that counting every index takes linear time.
     unsigned int elementsAtIndex(unsigned int index) const;
 
 
     // isElementAtIndex() returns true if the given element hashed to a
     // particular index in the array, false otherwise.  If the index is
-    // out of the boundaries of the array, this functions returns 0.
+    // out of the boundaries of the array, this functions returns false.
+    // As with elementsAtIndex(), the array is the new one during a resize.
     bool isElementAtIndex(const ElementType& element, unsigned int index) const;
 
-    double loadFactor() const;
-    unsigned int cap; // capacity
 
-private:
+    // capacity() returns the size of the array.
+    unsigned int capacity() const noexcept;
 
-    HashFunction hashFunction; 
 
-    // unsigned int cap;// capacity
-    unsigned int hashSize; // current size
+    // loadFactor() returns the ratio of the number of elements to the
+    // capacity of the array.
+    double loadFactor() const noexcept;
+
+
+    // isResizing() returns true if some of the elements still live in the
+    // old array from a resize that hasn't finished, false otherwise.
+    bool isResizing() const noexcept;
+
 
+    // reserve() grows the array, if necessary, so that the given number of
+    // elements can be stored without the load factor exceeding the maximum.
+    // Unlike the growth triggered by add(), this happens all at once, and
+    // finishes any resize already under way.
+    void reserve(unsigned int elements);
+
+
+private:
     struct HashNode
     {
         ElementType value{};
-        HashNode* next = nullptr;     
+        unsigned int hash = 0;
+        HashNode* next = nullptr;
     };
 
-    // HashNode(const ElementType& element): value(element), next(nullptr) {};
+    Hasher hashFunction;
+    double maxLoad;
+    double growth;
+
+    unsigned int hashSize; // current size
+
+    // The active array, into which new elements are always added.  These
+    // are mutable because contains() advances a resize that's under way
+    // (and elementsAtIndex() finishes one).
+    mutable HashNode** hashTable;
+    mutable unsigned int cap; // capacity
+
+    // The array being migrated away from during a resize (nullptr when no
+    // resize is under way), along with its capacity and the index of the
+    // first of its buckets that hasn't been migrated yet.
+    mutable HashNode** oldTable;
+    mutable unsigned int oldCap;
+    mutable unsigned int migrateIndex;
 
-    HashNode** hashTable;
+    NodeAllocator nodeAllocator;
 
-    void emptyHashTable(HashNode** h);
-    void deleteAllHashNodes(HashNode** h, unsigned int size);
-    void copyHash(HashNode** h, HashNode** s, unsigned int size);
-    void addNode(HashNode** table, const ElementType& element, unsigned int index);
-    void rehash(HashNode** newTable, HashNode* node);
-    // double loadFactor() const;
+private:
+    unsigned int hashOf(const ElementType& element) const;
+    HashNode* findInBucket(
+        HashNode* node, const ElementType& element, unsigned int hash, LookupCounter::Lookup& lookup) const;
+    HashNode* find(const ElementType& element, unsigned int hash, LookupCounter::Lookup& lookup) const;
+    bool removeFromBucket(HashNode** link, const ElementType& element, unsigned int hash);
+
+    static HashNode** makeHashTable(unsigned int size);
+    void deleteAllHashNodes(HashNode** h, unsigned int size) noexcept;
+    void copyHash(const HashSet& s);
+
+    void startResize();
+    void migrateBuckets(unsigned int count) const;
+    void finishResize() const;
+    void rehash(HashNode* node) const;
 };
 
 
 
-namespace impl_
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+HashSet<ElementType, Hasher, NodeAllocator>::HashSet(
+    Hasher hashFunction, double maxLoadFactor, double growthFactor)
+    : hashFunction{std::move(hashFunction)},
+      maxLoad{maxLoadFactor > 0.0 ? maxLoadFactor : DEFAULT_MAX_LOAD_FACTOR},
+      growth{growthFactor > 1.0 ? growthFactor : DEFAULT_GROWTH_FACTOR},
+      hashSize{0}, hashTable{makeHashTable(DEFAULT_CAPACITY)}, cap{DEFAULT_CAPACITY},
+      oldTable{nullptr}, oldCap{0}, migrateIndex{0}
 {
-    template <typename ElementType>
-    unsigned int HashSet__undefinedHashFunction(const ElementType& element)
-    {
-        return 0;
-    }
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashFunction hashFunction)
-    : hashFunction{hashFunction}, hashSize{0}, hashTable{new HashNode* [DEFAULT_CAPACITY]}
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+HashSet<ElementType, Hasher, NodeAllocator>::~HashSet() noexcept
 {
-    cap = DEFAULT_CAPACITY;
-    // std::cout << "constructor" << std::endl;
-    emptyHashTable(hashTable);
+    deleteAllHashNodes(hashTable, cap);
+    deleteAllHashNodes(oldTable, oldCap);
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::~HashSet() noexcept
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+HashSet<ElementType, Hasher, NodeAllocator>::HashSet(const HashSet& s)
+    : hashFunction{s.hashFunction}, maxLoad{s.maxLoad}, growth{s.growth},
+      hashSize{0}, hashTable{nullptr}, cap{0},
+      oldTable{nullptr}, oldCap{0}, migrateIndex{0}
 {
-    // std::cout << "DESTRUCTOR" << std::endl;
-    hashSize = 0;
+    copyHash(s);
+}
 
-    for(int i=0; i<cap; i++)
-    {
-         HashNode*& node = hashTable[i];
 
-         while(node != nullptr)
-         {
-            HashNode* dNode = node;
-            node = node->next;
-            delete dNode;
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+HashSet<ElementType, Hasher, NodeAllocator>::HashSet(HashSet&& s)
+    noexcept(std::is_nothrow_copy_constructible_v<Hasher>)
+    : hashFunction{s.hashFunction}, maxLoad{s.maxLoad}, growth{s.growth},
+      hashSize{0}, hashTable{nullptr}, cap{0},
+      oldTable{nullptr}, oldCap{0}, migrateIndex{0},
+      nodeAllocator{std::move(s.nodeAllocator)}
+{
+    std::swap(hashSize, s.hashSize);
+    std::swap(hashTable, s.hashTable);
+    std::swap(cap, s.cap);
+    std::swap(oldTable, s.oldTable);
+    std::swap(oldCap, s.oldCap);
+    std::swap(migrateIndex, s.migrateIndex);
+}
 
 
-         }
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+HashSet<ElementType, Hasher, NodeAllocator>& HashSet<ElementType, Hasher, NodeAllocator>::operator=(const HashSet& s)
+{
+    if (this != &s)
+    {
+        HashSet copy{s};
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
 
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+HashSet<ElementType, Hasher, NodeAllocator>& HashSet<ElementType, Hasher, NodeAllocator>::operator=(HashSet&& s)
+    noexcept(std::is_nothrow_swappable_v<Hasher>)
+{
+    if (this != &s)
+    {
+        std::swap(hashFunction, s.hashFunction);
+        std::swap(maxLoad, s.maxLoad);
+        std::swap(growth, s.growth);
+        std::swap(hashSize, s.hashSize);
+        std::swap(hashTable, s.hashTable);
+        std::swap(cap, s.cap);
+        std::swap(oldTable, s.oldTable);
+        std::swap(oldCap, s.oldCap);
+        std::swap(migrateIndex, s.migrateIndex);
+        std::swap(nodeAllocator, s.nodeAllocator);
     }
 
-    delete[] hashTable;
+    return *this;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(const HashSet& s)
-    : hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>}
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+bool HashSet<ElementType, Hasher, NodeAllocator>::isImplemented() const noexcept
 {
-    // std::cout << "HashSet &s copy" << std::endl;
-    cap = s.cap;
-    hashTable = new HashNode* [cap];
-    copyHash(hashTable, s.hashTable, cap);
-    hashSize = s.hashSize;
+    return true;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashSet&& s) noexcept
-    : hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>}
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+void HashSet<ElementType, Hasher, NodeAllocator>::add(const ElementType& element)
 {
-    // std::cout << "HashSet &&s copy" << std::endl;
-    cap = s.cap;
-    hashTable = new HashNode* [cap];
-    copyHash(hashTable, s.hashTable, cap);
-    hashSize = s.hashSize;
+    unsigned int hash = hashOf(element);
+
+    if (oldTable != nullptr)
+    {
+        migrateBuckets(MIGRATION_STEP);
+    }
+
+    LookupCounter::Lookup uncounted{nullptr};
 
-    // std::cout << "HASH" << s.hash << std::endl;
+    if (find(element, hash, uncounted) != nullptr)
+    {
+        return;
+    }
 
-    for(int i=0; i<s.cap; i++)
+    if (cap == 0)
     {
-         HashNode*& node = s.hashTable[i];
+        hashTable = makeHashTable(DEFAULT_CAPACITY);
+        cap = DEFAULT_CAPACITY;
+    }
 
-         // std::cout << node << std::endl;
-         delete node;
+    unsigned int index = hash % cap;
+    hashTable[index] = createNode<HashNode>(nodeAllocator, element, hash, hashTable[index]);
+    hashSize++;
 
+    if (loadFactor() > maxLoad)
+    {
+        startResize();
     }
-    // delete[] s.hash; // ?????
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(const HashSet& s)
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+void HashSet<ElementType, Hasher, NodeAllocator>::addAll(
+    const ElementType* begin, const ElementType* end, bool presorted)
 {
-    // std::cout << "HashSet &s assign" << std::endl;
-    if(this != &s)
+    reserve(hashSize + static_cast<unsigned int>(end - begin));
+    Set<ElementType>::addAll(begin, end, presorted);
+}
+
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+bool HashSet<ElementType, Hasher, NodeAllocator>::remove(const ElementType& element)
+{
+    unsigned int hash = hashOf(element);
+
+    if (oldTable != nullptr)
     {
-        HashNode** newHashTable = new HashNode* [s.cap];
-        emptyHashTable(newHashTable);
-        copyHash(newHashTable, s.hashTable, s.cap);
-        hashSize = s.hashSize;
+        migrateBuckets(MIGRATION_STEP);
+    }
 
-        deleteAllHashNodes(hashTable, cap);
-        delete[] hashTable;
-        cap = s.cap;
-        hashTable = newHashTable;
+    if (cap == 0)
+    {
+        return false;
+    }
 
-        newHashTable = nullptr;
-        delete[] newHashTable;
+    bool removed = removeFromBucket(&hashTable[hash % cap], element, hash)
+        || (oldTable != nullptr && hash % oldCap >= migrateIndex
+            && removeFromBucket(&oldTable[hash % oldCap], element, hash));
 
+    if (removed)
+    {
+        hashSize--;
     }
 
-    return *this;
+    return removed;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(HashSet&& s) noexcept
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+bool HashSet<ElementType, Hasher, NodeAllocator>::contains(const ElementType& element) const
 {
-    // std::cout << "HashSet &&s assign" << std::endl;
-    if(this != &s)
+    if (oldTable != nullptr)
     {
-        HashNode** newHashTable = new HashNode* [s.cap];
-        emptyHashTable(newHashTable);
-        copyHash(newHashTable, s.hashTable, s.cap);
-        hashSize = s.hashSize;
+        migrateBuckets(MIGRATION_STEP);
+    }
 
-        deleteAllHashNodes(hashTable, cap);
-        delete[] hashTable;
-        cap = s.cap;
-        hashTable = newHashTable;
+    LookupCounter::Lookup lookup{this};
+    return find(element, hashOf(element), lookup) != nullptr;
+}
 
-        newHashTable = nullptr;
-        delete[] newHashTable;
 
-        for(int i=0; i<s.cap; i++)
-        {
-             HashNode*& node = s.hashTable[i];
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+unsigned int HashSet<ElementType, Hasher, NodeAllocator>::size() const noexcept
+{
+    return hashSize;
+}
 
-             // std::cout << node << std::endl;
-             delete node;
 
-        }
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+SetStatistics HashSet<ElementType, Hasher, NodeAllocator>::statistics() const
+{
+    SetStatistics statistics = Set<ElementType>::statistics();
+    statistics.memoryBytes =
+        sizeof(*this) + (cap + (oldTable != nullptr ? oldCap : 0)) * sizeof(HashNode*)
+        + hashSize * sizeof(HashNode);
+
+    return statistics;
+}
+
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+unsigned int HashSet<ElementType, Hasher, NodeAllocator>::elementsAtIndex(unsigned int index) const
+{
+    if (index >= cap)
+    {
+        return 0;
     }
 
-    return *this;
+    finishResize();
+
+    unsigned int sizeIndex = 0;
+
+    for (HashNode* node = hashTable[index]; node != nullptr; node = node->next)
+    {
+        sizeIndex++;
+    }
+
+    return sizeIndex;
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+bool HashSet<ElementType, Hasher, NodeAllocator>::isElementAtIndex(const ElementType& element, unsigned int index) const
 {
-    return true;
+    if (index >= cap)
+    {
+        return false;
+    }
+
+    unsigned int hash = hashOf(element);
+    LookupCounter::Lookup uncounted{nullptr};
+
+    return hash % cap == index && find(element, hash, uncounted) != nullptr;
 }
 
 
-template <typename ElementType>
-void HashSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+unsigned int HashSet<ElementType, Hasher, NodeAllocator>::capacity() const noexcept
 {
-    // std::cout << "ADD" << std::endl;
-    
-    if(contains(element))
-        return;
+    return cap;
+}
 
-    unsigned int index = static_cast<unsigned int>(hashFunction(element)) % cap;
 
-    addNode(hashTable, element, index);
-    hashSize++;
-    // std::cout << hash[index]->value << std::endl;
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+double HashSet<ElementType, Hasher, NodeAllocator>::loadFactor() const noexcept
+{
+    return cap == 0 ? 0.0 : static_cast<double>(hashSize) / cap;
+}
 
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+bool HashSet<ElementType, Hasher, NodeAllocator>::isResizing() const noexcept
+{
+    return oldTable != nullptr;
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+void HashSet<ElementType, Hasher, NodeAllocator>::reserve(unsigned int elements)
 {
-    // bool check = false;
-    // std::cout << "CONTAINS" << std::endl;
-    unsigned int index = static_cast<unsigned int>(hashFunction(element)) % cap;
-    HashNode* node = hashTable[index];
+    finishResize();
+
+    unsigned int newCap = static_cast<unsigned int>(elements / maxLoad) + 1;
 
-    while( node != nullptr )
+    if (newCap <= cap)
     {
-        if(node->value == element)
-            return true;
-        else
-            node = node->next;
+        return;
     }
 
-    return false;
-    
+    HashNode** newTable = makeHashTable(newCap);
+
+    oldTable = hashTable;
+    oldCap = cap;
+    migrateIndex = 0;
+
+    hashTable = newTable;
+    cap = newCap;
+
+    finishResize();
 }
 
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::size() const noexcept
+
+// ===========================
+// ADDITIONAL MEMBER FUNCTIONS
+// ===========================
+
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+unsigned int HashSet<ElementType, Hasher, NodeAllocator>::hashOf(const ElementType& element) const
 {
-    // std::cout << "SIZE" << std::endl;
-    return hashSize;
+    return static_cast<unsigned int>(hashFunction(element));
 }
 
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+typename HashSet<ElementType, Hasher, NodeAllocator>::HashNode* HashSet<ElementType, Hasher, NodeAllocator>::findInBucket(
+    HashNode* node, const ElementType& element, unsigned int hash, LookupCounter::Lookup& lookup) const
 {
-    // std::cout << "elementsAtIndex" << std::endl;
-    int sizeIndex = 0;
-    HashNode* temp = hashTable[index];
-    while(temp != nullptr)
+    for (; node != nullptr; node = node->next)
     {
-        sizeIndex++;
-        temp = temp->next;
+        lookup.probed();
+
+        if (node->hash == hash)
+        {
+            lookup.compared();
+
+            if (node->value == element)
+            {
+                break;
+            }
+        }
     }
-    return sizeIndex;
+
+    return node;
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::isElementAtIndex(const ElementType& element, unsigned int index) const
+// find() returns the node containing the given element (whose hash has
+// already been computed), or nullptr if there isn't one.  The active array
+// is searched first, then the part of the old one not yet migrated.
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+typename HashSet<ElementType, Hasher, NodeAllocator>::HashNode* HashSet<ElementType, Hasher, NodeAllocator>::find(
+    const ElementType& element, unsigned int hash, LookupCounter::Lookup& lookup) const
 {
-    // std::cout << "isElementAtIndex" << std::endl;
-    HashNode* temp = hashTable[index];
-    while(temp != nullptr)
+    if (cap == 0)
     {
-        if(temp->value == element)
-            return true;
-        temp = temp->next;
+        return nullptr;
     }
-    return false;
+
+    HashNode* node = findInBucket(hashTable[hash % cap], element, hash, lookup);
+
+    if (node == nullptr && oldTable != nullptr && hash % oldCap >= migrateIndex)
+    {
+        node = findInBucket(oldTable[hash % oldCap], element, hash, lookup);
+    }
+
+    return node;
 }
 
 
-// ===========================
-// ADDITIONAL MEMBER FUNCTIONS
-// ===========================
+// removeFromBucket() unlinks and destroys the node containing the given
+// element from the chain beginning at the given link, returning false if
+// there isn't one.
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+bool HashSet<ElementType, Hasher, NodeAllocator>::removeFromBucket(
+    HashNode** link, const ElementType& element, unsigned int hash)
+{
+    while (*link != nullptr)
+    {
+        HashNode* node = *link;
+
+        if (node->hash == hash && node->value == element)
+        {
+            *link = node->next;
+            destroyNode(nodeAllocator, node);
+            return true;
+        }
+
+        link = &node->next;
+    }
+
+    return false;
+}
 
 
-template <typename ElementType>
-void HashSet<ElementType>::emptyHashTable(HashNode** h)
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+typename HashSet<ElementType, Hasher, NodeAllocator>::HashNode** HashSet<ElementType, Hasher, NodeAllocator>::makeHashTable(unsigned int size)
 {
-    for(int i=0; i<this->cap; i++)
+    HashNode** h = new HashNode*[size];
+
+    for (unsigned int i = 0; i < size; i++)
+    {
         h[i] = nullptr;
+    }
+
+    return h;
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::deleteAllHashNodes(HashNode** h, unsigned int size)
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+void HashSet<ElementType, Hasher, NodeAllocator>::deleteAllHashNodes(HashNode** h, unsigned int size) noexcept
 {
-    for(int i=0; i<size; i++)
+    if constexpr (mustVisitNodesToDestroy<NodeAllocator, HashNode>)
     {
-        HashNode*& node = h[i];
-        while(node != nullptr)
+        for (unsigned int i = 0; h != nullptr && i < size; i++)
         {
-            HashNode* dNode = node;
-            node = node->next;   
-            dNode = nullptr;
-            delete dNode;
-            
+            HashNode* node = h[i];
+
+            while (node != nullptr)
+            {
+                HashNode* dNode = node;
+                node = node->next;
+                disposeNode(nodeAllocator, dNode);
+            }
         }
-        
     }
+
+    delete[] h;
 }
 
 
-template <typename ElementType>
-void HashSet<ElementType>::copyHash(HashNode** h, HashNode** s, unsigned int size)
+// copyHash() fills this (empty) HashSet with copies of the elements in
+// another one.  Any resize under way in the other HashSet is finished in
+// the copy, with pending elements placed directly into the new array.
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+void HashSet<ElementType, Hasher, NodeAllocator>::copyHash(const HashSet& s)
 {
-    for(int i=0; i<size; i++)
+    HashNode** h = makeHashTable(s.cap);
+
+    try
     {
-        HashNode* n = s[i];
-        HashNode** p = &h[i];
-        *p = nullptr;
-        while(n)
+        for (unsigned int i = 0; i < s.cap; i++)
         {
-            HashNode* c = new HashNode (*n);
-            *p = c;
-            p = &c -> next;
-            n = n->next;
-            delete c;
+            HashNode** p = &h[i];
+
+            for (HashNode* n = s.hashTable[i]; n != nullptr; n = n->next)
+            {
+                *p = createNode<HashNode>(nodeAllocator, n->value, n->hash);
+                p = &(*p)->next;
+            }
         }
+
+        for (unsigned int i = s.migrateIndex; s.oldTable != nullptr && i < s.oldCap; i++)
+        {
+            for (HashNode* n = s.oldTable[i]; n != nullptr; n = n->next)
+            {
+                unsigned int index = n->hash % s.cap;
+                h[index] = createNode<HashNode>(nodeAllocator, n->value, n->hash, h[index]);
+            }
+        }
+    }
+    catch (...)
+    {
+        deleteAllHashNodes(h, s.cap);
+        throw;
     }
+
+    hashTable = h;
+    cap = s.cap;
+    hashSize = s.hashSize;
 }
 
 
-template <typename ElementType>
-double HashSet<ElementType>::loadFactor() const
+// startResize() makes the active array the old one and allocates a new,
+// larger, active array.  If the previous resize is somehow still under way
+// (which can happen only with unusual load or growth factors), it's
+// finished first, so there are never more than two arrays.
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+void HashSet<ElementType, Hasher, NodeAllocator>::startResize()
 {
-    return (double)this->size()/cap;
+    if (oldTable != nullptr)
+    {
+        finishResize();
+    }
+
+    unsigned int newCap = static_cast<unsigned int>(cap * growth);
+
+    if (newCap <= cap)
+    {
+        newCap = cap + 1;
+    }
+
+    oldTable = hashTable;
+    oldCap = cap;
+    migrateIndex = 0;
+
+    hashTable = makeHashTable(newCap);
+    cap = newCap;
 }
 
 
-template<typename ElementType>
-void HashSet<ElementType>::addNode(HashNode** table, const ElementType& element, unsigned int index)
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+void HashSet<ElementType, Hasher, NodeAllocator>::migrateBuckets(unsigned int count) const
 {
-    HashNode* prev = nullptr;
-    HashNode* current = table[index];
-
-    while(current != nullptr)
+    for (unsigned int i = 0; i < count && migrateIndex < oldCap; i++)
     {
-        prev = current;
-        current = current->next;
+        rehash(oldTable[migrateIndex]);
+        oldTable[migrateIndex] = nullptr;
+        migrateIndex++;
     }
 
-    if(current == nullptr)
+    if (migrateIndex >= oldCap)
     {
-        current = new HashNode{element};
-        if(prev == nullptr)
-        {
-            table[index] = current;
-        }
-        else
-            prev->next = current;
+        delete[] oldTable;
+        oldTable = nullptr;
+        oldCap = 0;
+        migrateIndex = 0;
     }
+}
+
 
-    else
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+void HashSet<ElementType, Hasher, NodeAllocator>::finishResize() const
+{
+    if (oldTable != nullptr)
     {
-        current->value = element;
+        migrateBuckets(oldCap);
     }
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::rehash(HashNode** newTable, HashNode* node)
+
+// rehash() re-links each node of an old bucket into the active array,
+// without allocating, copying, or hashing anything.
+
+template <typename ElementType, typename Hasher, typename NodeAllocator>
+void HashSet<ElementType, Hasher, NodeAllocator>::rehash(HashNode* node) const
 {
-    while(node!=nullptr)
+    while (node != nullptr)
     {
-        unsigned int index = static_cast<unsigned int>(hashFunction(node->value)) % cap;
-        addNode(newTable, node->value, index);
-        HashNode* dNode = node;
-        node = node->next;
-        delete dNode;
+        HashNode* next = node->next;
+        unsigned int index = node->hash % cap;
+
+        node->next = hashTable[index];
+        hashTable[index] = node;
+
+        node = next;
     }
 }
 
 
+
 #endif // HASHSET_HPP
 
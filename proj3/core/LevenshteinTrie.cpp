@@ -0,0 +1,329 @@
+// LevenshteinTrie.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <utility>
+#include "LevenshteinTrie.hpp"
+
+
+
+namespace
+{
+    // A Candidate is a suggestion before its word has been copied out of
+    // the trie.  One candidate ranks ahead of another if it's closer, then
+    // if it's more common, then if it comes first alphabetically (which is
+    // the order of the word indexes).
+    struct Candidate
+    {
+        unsigned int distance;
+        unsigned int frequency;
+        std::uint32_t wordIndex;
+    };
+
+
+    bool ranksAhead(const Candidate& a, const Candidate& b)
+    {
+        if (a.distance != b.distance)
+        {
+            return a.distance < b.distance;
+        }
+        else if (a.frequency != b.frequency)
+        {
+            return a.frequency > b.frequency;
+        }
+        else
+        {
+            return a.wordIndex < b.wordIndex;
+        }
+    }
+
+
+    std::size_t commonPrefixLength(std::string_view a, std::string_view b)
+    {
+        std::size_t length = 0;
+
+        while (length < a.length() && length < b.length() && a[length] == b[length])
+        {
+            ++length;
+        }
+
+        return length;
+    }
+}
+
+
+
+LevenshteinTrie::LevenshteinTrie(
+    const std::string* begin, const std::string* end,
+    const unsigned int* frequencies,
+    unsigned int maxDistance, unsigned int suggestionCount)
+    : maxDistance_{maxDistance}, suggestionCount_{suggestionCount}, maxDepth{0}
+{
+    std::vector<std::uint32_t> order;
+    order.reserve(end - begin);
+
+    for (const std::string* word = begin; word != end; ++word)
+    {
+        if (word->length() <= MAX_WORD_LENGTH)
+        {
+            order.push_back(static_cast<std::uint32_t>(word - begin));
+        }
+    }
+
+    if (!std::is_sorted(begin, end))
+    {
+        std::sort(
+            order.begin(), order.end(),
+            [&](std::uint32_t a, std::uint32_t b) { return begin[a] < begin[b]; });
+    }
+
+    // Each distinct word is stored once, with the frequencies of all of its
+    // occurrences added together.
+
+    const std::string* lastWord = nullptr;
+
+    for (std::uint32_t i : order)
+    {
+        unsigned int frequency = frequencies != nullptr ? frequencies[i] : 0;
+
+        if (lastWord != nullptr && *lastWord == begin[i])
+        {
+            this->frequencies.back() += frequency;
+        }
+        else
+        {
+            wordStarts.push_back(static_cast<std::uint32_t>(words.length()));
+            words.append(begin[i]);
+            this->frequencies.push_back(frequency);
+            lastWord = &begin[i];
+        }
+    }
+
+    wordStarts.push_back(static_cast<std::uint32_t>(words.length()));
+
+    // The trie is built in depth-first order by adding the words in
+    // ascending order.  path[d] is the node for the first d characters of
+    // the word most recently added; when a word shares only its first
+    // prefixLength characters with that one, the nodes deeper than that on
+    // the path have no more children to come, so their subtrees end.
+
+    nodes.push_back(Node{0, NO_WORD, 0, '\0'});
+    std::vector<std::uint32_t> path{0};
+    std::string_view previous;
+
+    for (std::uint32_t w = 0; w + 1 < wordStarts.size(); ++w)
+    {
+        std::string_view word = wordAt(w);
+        std::size_t prefixLength = w == 0 ? 0 : commonPrefixLength(previous, word);
+
+        for (std::size_t d = prefixLength + 1; d < path.size(); ++d)
+        {
+            nodes[path[d]].subtreeEnd = static_cast<std::uint32_t>(nodes.size());
+        }
+
+        path.resize(prefixLength + 1);
+
+        for (std::size_t d = prefixLength + 1; d <= word.length(); ++d)
+        {
+            path.push_back(static_cast<std::uint32_t>(nodes.size()));
+            nodes.push_back(Node{0, NO_WORD, static_cast<std::uint16_t>(d), word[d - 1]});
+        }
+
+        nodes[path[word.length()]].wordIndex = w;
+        maxDepth = std::max(maxDepth, word.length());
+        previous = word;
+    }
+
+    for (std::uint32_t node : path)
+    {
+        nodes[node].subtreeEnd = static_cast<std::uint32_t>(nodes.size());
+    }
+}
+
+
+std::vector<LevenshteinTrie::Suggestion> LevenshteinTrie::rankedSuggestionsFor(
+    const std::string& word, unsigned int maxDistance, unsigned int count) const
+{
+    if (count == 0)
+    {
+        return std::vector<Suggestion>{};
+    }
+
+    // The best candidates found so far are kept in a heap with the worst
+    // of them on top, so it can be replaced when a better one is found.
+
+    std::vector<Candidate> best;
+    unsigned int bound = 0;
+
+    auto offer =
+        [&](unsigned int distance, std::uint32_t wordIndex)
+        {
+            Candidate candidate{distance, frequencies[wordIndex], wordIndex};
+
+            if (best.size() < count)
+            {
+                best.push_back(candidate);
+                std::push_heap(best.begin(), best.end(), ranksAhead);
+            }
+            else if (ranksAhead(candidate, best.front()))
+            {
+                std::pop_heap(best.begin(), best.end(), ranksAhead);
+                best.back() = candidate;
+                std::push_heap(best.begin(), best.end(), ranksAhead);
+            }
+
+            if (best.size() == count)
+            {
+                bound = std::min(bound, best.front().distance);
+            }
+        };
+
+    // rows holds one row of the distance table for each depth of the
+    // current path through the trie, and letters the path's letters.  Only
+    // the entries within bound of the diagonal of the table are computed,
+    // since the others must be larger than bound; the entries just outside
+    // that band are set to a value larger than any distance, so the band's
+    // edges can be computed the same way as its middle.
+
+    constexpr unsigned int OUTSIDE_BAND = 0x3fffffff;
+
+    std::size_t length = word.length();
+    std::size_t width = length + 1;
+    std::vector<unsigned int> rows((maxDepth + 1) * width);
+    std::vector<char> letters(maxDepth + 1);
+
+    for (std::size_t j = 0; j < width; ++j)
+    {
+        rows[j] = static_cast<unsigned int>(j);
+    }
+
+    // Searching with a small bound visits much less of the trie than
+    // searching with a larger one, so the search is tried with bounds of 1,
+    // 2, and so on, stopping once the closest count words have been found.
+
+    for (unsigned int pass = std::min(1u, maxDistance); ; ++pass)
+    {
+        best.clear();
+        bound = pass;
+
+        if (nodes[0].wordIndex != NO_WORD && length > 0 && length <= bound)
+        {
+            offer(static_cast<unsigned int>(length), nodes[0].wordIndex);
+        }
+
+        std::size_t i = 1;
+
+        while (i < nodes.size())
+        {
+            const Node& node = nodes[i];
+            std::size_t depth = node.depth;
+            letters[depth] = node.letter;
+
+            unsigned int* row = &rows[depth * width];
+            const unsigned int* parentRow = row - width;
+            const unsigned int* grandparentRow = depth >= 2 ? parentRow - width : nullptr;
+
+            std::size_t low = depth > bound ? depth - bound : 1;
+            std::size_t high = std::min(length, depth + bound);
+
+            row[0] = static_cast<unsigned int>(depth);
+            row[low - 1] = low > 1 ? OUTSIDE_BAND : row[0];
+
+            if (high < length)
+            {
+                row[high + 1] = OUTSIDE_BAND;
+            }
+
+            unsigned int rowMinimum = row[0];
+
+            for (std::size_t j = low; j <= high; ++j)
+            {
+                unsigned int cost = node.letter == word[j - 1] ? 0 : 1;
+
+                unsigned int distance = std::min({
+                    parentRow[j] + 1,
+                    row[j - 1] + 1,
+                    parentRow[j - 1] + cost});
+
+                if (grandparentRow != nullptr && j >= 2
+                    && node.letter == word[j - 2] && letters[depth - 1] == word[j - 1])
+                {
+                    distance = std::min(distance, grandparentRow[j - 2] + 1);
+                }
+
+                row[j] = distance;
+                rowMinimum = std::min(rowMinimum, distance);
+            }
+
+            if (node.wordIndex != NO_WORD && length >= low && length <= high
+                && row[length] > 0 && row[length] <= bound)
+            {
+                offer(row[length], node.wordIndex);
+            }
+
+            i = rowMinimum > bound ? node.subtreeEnd : i + 1;
+        }
+
+        if (best.size() == count || pass >= maxDistance)
+        {
+            break;
+        }
+    }
+
+    std::sort(best.begin(), best.end(), ranksAhead);
+
+    std::vector<Suggestion> suggestions;
+    suggestions.reserve(best.size());
+
+    for (const Candidate& candidate : best)
+    {
+        suggestions.push_back(
+            Suggestion{std::string{wordAt(candidate.wordIndex)}, candidate.distance, candidate.frequency});
+    }
+
+    return suggestions;
+}
+
+
+std::vector<std::string> LevenshteinTrie::suggestionsFor(const std::string& word) const
+{
+    std::vector<std::string> suggestions;
+
+    for (Suggestion& suggestion : rankedSuggestionsFor(word, maxDistance_, suggestionCount_))
+    {
+        suggestions.push_back(std::move(suggestion.word));
+    }
+
+    return suggestions;
+}
+
+
+unsigned int LevenshteinTrie::wordCount() const noexcept
+{
+    return static_cast<unsigned int>(wordStarts.size() - 1);
+}
+
+
+std::size_t LevenshteinTrie::nodeCount() const noexcept
+{
+    return nodes.size();
+}
+
+
+std::size_t LevenshteinTrie::memoryUsage() const noexcept
+{
+    return sizeof(LevenshteinTrie)
+        + words.capacity()
+        + wordStarts.capacity() * sizeof(std::uint32_t)
+        + frequencies.capacity() * sizeof(unsigned int)
+        + nodes.capacity() * sizeof(Node);
+}
+
+
+std::string_view LevenshteinTrie::wordAt(std::uint32_t wordIndex) const noexcept
+{
+    return std::string_view{words}.substr(
+        wordStarts[wordIndex], wordStarts[wordIndex + 1] - wordStarts[wordIndex]);
+}
@@ -0,0 +1,126 @@
+// LevenshteinTrie.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A LevenshteinTrie finds the dictionary words closest to a misspelling
+// and ranks them, best first: by edit distance, then (if the words were
+// given frequencies) by how common they are, then alphabetically.
+//
+// The words are kept in a trie, and a search walks the trie depth-first
+// while computing the edit distance table between the misspelling and
+// each node's prefix one row at a time; each node's row is computed from
+// its parent's, so words with a common prefix share the work of comparing
+// it.  (This amounts to running a Levenshtein automaton for the
+// misspelling over the trie.)  When every entry in a node's row exceeds
+// the distance still of interest, no word below the node can be close
+// enough, so the whole subtree is skipped.  The distance of interest
+// starts at the maximum distance and, once enough suggestions have been
+// found, shrinks to the distance of the worst of them, so the more
+// suggestions there are near the misspelling, the less of the trie is
+// visited.
+//
+// Distances are measured in single-character deletions, insertions,
+// substitutions, and swaps of adjacent characters (the "optimal string
+// alignment" distance), just as in a DeletionIndex.
+//
+// The nodes are stored in one array, in depth-first order, so that a
+// node's first child immediately follows it, and each node records where
+// its subtree ends; skipping a subtree is a matter of jumping there.
+
+#ifndef LEVENSHTEINTRIE_HPP
+#define LEVENSHTEINTRIE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SuggestionSource.hpp"
+
+
+
+class LevenshteinTrie : public SuggestionSource
+{
+public:
+    static constexpr unsigned int DEFAULT_MAX_DISTANCE = 2;
+    static constexpr unsigned int DEFAULT_SUGGESTION_COUNT = 10;
+
+    // Words longer than this are left out of the trie.
+    static constexpr std::size_t MAX_WORD_LENGTH = 65535;
+
+    struct Suggestion
+    {
+        std::string word;
+        unsigned int distance;
+        unsigned int frequency;
+    };
+
+public:
+    // Builds a trie of the distinct words in [begin, end).  If frequencies
+    // isn't nullptr, it must point to one frequency for each word in the
+    // range, and the frequencies of repeated words are added together;
+    // otherwise, every word has frequency 0.  suggestionsFor() returns up
+    // to suggestionCount words, up to maxDistance away from a misspelling.
+    LevenshteinTrie(
+        const std::string* begin, const std::string* end,
+        const unsigned int* frequencies = nullptr,
+        unsigned int maxDistance = DEFAULT_MAX_DISTANCE,
+        unsigned int suggestionCount = DEFAULT_SUGGESTION_COUNT);
+
+
+    // rankedSuggestionsFor() returns up to count words at least 1 and at
+    // most maxDistance away from the given word, best first, along with
+    // their distances and frequencies.
+    std::vector<Suggestion> rankedSuggestionsFor(
+        const std::string& word, unsigned int maxDistance, unsigned int count) const;
+
+
+    // suggestionsFor() returns the words that rankedSuggestionsFor() would,
+    // given the maxDistance and suggestionCount passed to the constructor.
+    virtual std::vector<std::string> suggestionsFor(const std::string& word) const override;
+
+
+    unsigned int wordCount() const noexcept;
+    std::size_t nodeCount() const noexcept;
+
+    virtual std::size_t memoryUsage() const noexcept override;
+
+
+private:
+    static constexpr std::uint32_t NO_WORD = 0xffffffff;
+
+    struct Node
+    {
+        // The index of the first node after this node's subtree.
+        std::uint32_t subtreeEnd;
+
+        // The index of the word that ends at this node, or NO_WORD.
+        std::uint32_t wordIndex;
+
+        std::uint16_t depth;
+        char letter;
+    };
+
+    unsigned int maxDistance_;
+    unsigned int suggestionCount_;
+
+    // The distinct words, in ascending order, one after another in a blob,
+    // with word i starting at wordStarts[i] and ending at wordStarts[i + 1],
+    // and their frequencies.
+    std::string words;
+    std::vector<std::uint32_t> wordStarts;
+    std::vector<unsigned int> frequencies;
+
+    // The nodes, in depth-first order, with the root (whose depth is 0)
+    // first.
+    std::vector<Node> nodes;
+    std::size_t maxDepth;
+
+private:
+    std::string_view wordAt(std::uint32_t wordIndex) const noexcept;
+};
+
+
+
+#endif // LEVENSHTEINTRIE_HPP
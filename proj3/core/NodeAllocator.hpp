@@ -0,0 +1,337 @@
+// NodeAllocator.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Node allocators decide where the linked Set implementations (HashSet,
+// AVLSet, SkipListSet, and ListSet) get the memory for their nodes.  Each
+// of those class templates takes a NodeAllocator template parameter, which
+// can be one of these:
+//
+//   * HeapNodeAllocator (the default), which allocates every node with its
+//     own call to operator new and frees it with its own call to operator
+//     delete.
+//
+//   * ArenaNodeAllocator, which carves nodes out of large "slabs" of
+//     memory, one after another, recycling the memory of nodes that are
+//     destroyed through a free list for each size of node.  All of the
+//     slabs are released at once when the allocator is destroyed, so a Set
+//     that uses one has only to run its elements' destructors -- and not
+//     even that, if they're trivially destructible -- when it's destroyed.
+//
+// Nodes are made with createNode() and destroyed with destroyNode(), which
+// work with either kind of allocator.  When a whole Set is being destroyed,
+// disposeNode() destroys a node without handing its memory back to an
+// allocator that is about to release everything anyway.
+//
+// An allocator belongs to one Set.  Copying a Set gives the copy a new,
+// empty allocator; moving a Set moves its allocator (and its nodes) along
+// with it.
+
+#ifndef NODEALLOCATOR_HPP
+#define NODEALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+
+class HeapNodeAllocator
+{
+public:
+    // Whether the allocator releases all of its memory when it's destroyed,
+    // making it unnecessary to deallocate nodes individually beforehand.
+    static constexpr bool releasesAllAtOnce = false;
+
+    void* allocate(std::size_t bytes);
+    void deallocate(void* p, std::size_t bytes) noexcept;
+};
+
+
+
+class ArenaNodeAllocator
+{
+public:
+    static constexpr bool releasesAllAtOnce = true;
+
+    // The size of each slab of memory that nodes are carved from (though a
+    // single node larger than this gets a slab of its own).
+    static constexpr std::size_t SLAB_SIZE = 64 * 1024;
+
+    // Every allocation is rounded up to a multiple of this, which is also
+    // the alignment of every node.
+    static constexpr std::size_t GRANULE = alignof(std::max_align_t);
+
+    // Memory from nodes up to this size is recycled when they're destroyed;
+    // memory from larger nodes is reclaimed only when the arena is released.
+    static constexpr std::size_t MAX_RECYCLED_SIZE = 512;
+
+public:
+    ArenaNodeAllocator() noexcept;
+    ~ArenaNodeAllocator() noexcept;
+
+    // "Copying" an arena makes a new, empty one, since the nodes in the
+    // original belong to the original's Set.
+    ArenaNodeAllocator(const ArenaNodeAllocator&) noexcept;
+    ArenaNodeAllocator(ArenaNodeAllocator&& a) noexcept;
+
+    ArenaNodeAllocator& operator=(const ArenaNodeAllocator&) = delete;
+    ArenaNodeAllocator& operator=(ArenaNodeAllocator&& a) noexcept;
+
+    void* allocate(std::size_t bytes);
+    void deallocate(void* p, std::size_t bytes) noexcept;
+
+    // release() frees every slab, invalidating every node allocated from the
+    // arena.  It does not run any destructors.
+    void release() noexcept;
+
+    // bytesReserved() returns the total size of the slabs currently held.
+    std::size_t bytesReserved() const noexcept;
+
+private:
+    struct Slab
+    {
+        Slab* next;
+        std::size_t size;
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    static constexpr std::size_t SIZE_CLASSES = MAX_RECYCLED_SIZE / GRANULE;
+    static constexpr std::size_t SLAB_HEADER_SIZE =
+        (sizeof(Slab) + GRANULE - 1) / GRANULE * GRANULE;
+
+    Slab* slabs;
+    char* cursor;
+    char* limit;
+    std::size_t reserved;
+    FreeBlock* freeLists[SIZE_CLASSES];
+
+private:
+    static std::size_t roundUp(std::size_t bytes) noexcept;
+    void* allocateFromNewSlab(std::size_t bytes);
+    void swap(ArenaNodeAllocator& a) noexcept;
+};
+
+
+
+// createNode() allocates memory for a Node from the given allocator and
+// constructs the Node in it, initialized with the given arguments.
+
+template <typename Node, typename NodeAllocator, typename... Args>
+Node* createNode(NodeAllocator& allocator, Args&&... args)
+{
+    void* memory = allocator.allocate(sizeof(Node));
+
+    try
+    {
+        return new (memory) Node{std::forward<Args>(args)...};
+    }
+    catch (...)
+    {
+        allocator.deallocate(memory, sizeof(Node));
+        throw;
+    }
+}
+
+
+// destroyNode() destroys a Node made by createNode() and gives its memory
+// back to the allocator.
+
+template <typename NodeAllocator, typename Node>
+void destroyNode(NodeAllocator& allocator, Node* node) noexcept
+{
+    node->~Node();
+    allocator.deallocate(node, sizeof(Node));
+}
+
+
+// disposeNode() is destroyNode() for use when every node of a Set is being
+// destroyed; it skips the deallocation when the allocator is going to
+// release everything at once.
+
+template <typename NodeAllocator, typename Node>
+void disposeNode(NodeAllocator& allocator, Node* node) noexcept
+{
+    if constexpr (NodeAllocator::releasesAllAtOnce)
+    {
+        node->~Node();
+    }
+    else
+    {
+        destroyNode(allocator, node);
+    }
+}
+
+
+// mustVisitNodesToDestroy is false when destroying a Set's allocator is all
+// that's needed to destroy its nodes: the allocator releases all of its
+// memory at once, and the nodes' destructors have nothing to do.
+
+template <typename NodeAllocator, typename Node>
+constexpr bool mustVisitNodesToDestroy =
+    !(NodeAllocator::releasesAllAtOnce && std::is_trivially_destructible_v<Node>);
+
+
+
+inline void* HeapNodeAllocator::allocate(std::size_t bytes)
+{
+    return ::operator new(bytes);
+}
+
+
+inline void HeapNodeAllocator::deallocate(void* p, std::size_t bytes) noexcept
+{
+    ::operator delete(p);
+}
+
+
+
+inline ArenaNodeAllocator::ArenaNodeAllocator() noexcept
+    : slabs{nullptr}, cursor{nullptr}, limit{nullptr}, reserved{0}, freeLists{}
+{
+}
+
+
+inline ArenaNodeAllocator::~ArenaNodeAllocator() noexcept
+{
+    release();
+}
+
+
+inline ArenaNodeAllocator::ArenaNodeAllocator(const ArenaNodeAllocator&) noexcept
+    : ArenaNodeAllocator{}
+{
+}
+
+
+inline ArenaNodeAllocator::ArenaNodeAllocator(ArenaNodeAllocator&& a) noexcept
+    : ArenaNodeAllocator{}
+{
+    swap(a);
+}
+
+
+inline ArenaNodeAllocator& ArenaNodeAllocator::operator=(ArenaNodeAllocator&& a) noexcept
+{
+    swap(a);
+    return *this;
+}
+
+
+inline void* ArenaNodeAllocator::allocate(std::size_t bytes)
+{
+    bytes = roundUp(bytes);
+
+    if (bytes <= MAX_RECYCLED_SIZE)
+    {
+        FreeBlock*& freeList = freeLists[bytes / GRANULE - 1];
+
+        if (freeList != nullptr)
+        {
+            FreeBlock* block = freeList;
+            freeList = block->next;
+            return block;
+        }
+    }
+
+    if (static_cast<std::size_t>(limit - cursor) < bytes)
+    {
+        return allocateFromNewSlab(bytes);
+    }
+
+    void* p = cursor;
+    cursor += bytes;
+    return p;
+}
+
+
+inline void ArenaNodeAllocator::deallocate(void* p, std::size_t bytes) noexcept
+{
+    bytes = roundUp(bytes);
+
+    if (bytes <= MAX_RECYCLED_SIZE)
+    {
+        FreeBlock*& freeList = freeLists[bytes / GRANULE - 1];
+        freeList = new (p) FreeBlock{freeList};
+    }
+}
+
+
+inline void ArenaNodeAllocator::release() noexcept
+{
+    while (slabs != nullptr)
+    {
+        Slab* next = slabs->next;
+        ::operator delete(slabs);
+        slabs = next;
+    }
+
+    cursor = nullptr;
+    limit = nullptr;
+    reserved = 0;
+
+    for (FreeBlock*& freeList : freeLists)
+    {
+        freeList = nullptr;
+    }
+}
+
+
+inline std::size_t ArenaNodeAllocator::bytesReserved() const noexcept
+{
+    return reserved;
+}
+
+
+inline std::size_t ArenaNodeAllocator::roundUp(std::size_t bytes) noexcept
+{
+    return bytes == 0 ? GRANULE : (bytes + GRANULE - 1) / GRANULE * GRANULE;
+}
+
+
+// allocateFromNewSlab() starts a new slab and carves the requested memory
+// from its beginning.  A request too large for an ordinary slab gets a slab
+// of exactly its size, leaving the current slab in use for later requests.
+
+inline void* ArenaNodeAllocator::allocateFromNewSlab(std::size_t bytes)
+{
+    bool oversized = bytes > SLAB_SIZE - SLAB_HEADER_SIZE;
+    std::size_t slabSize = oversized ? bytes + SLAB_HEADER_SIZE : SLAB_SIZE;
+
+    Slab* slab = static_cast<Slab*>(::operator new(slabSize));
+    slab->next = slabs;
+    slab->size = slabSize;
+    slabs = slab;
+    reserved += slabSize;
+
+    char* start = reinterpret_cast<char*>(slab) + SLAB_HEADER_SIZE;
+
+    if (!oversized)
+    {
+        cursor = start + bytes;
+        limit = reinterpret_cast<char*>(slab) + slabSize;
+    }
+
+    return start;
+}
+
+
+inline void ArenaNodeAllocator::swap(ArenaNodeAllocator& a) noexcept
+{
+    std::swap(slabs, a.slabs);
+    std::swap(cursor, a.cursor);
+    std::swap(limit, a.limit);
+    std::swap(reserved, a.reserved);
+    std::swap(freeLists, a.freeLists);
+}
+
+
+
+#endif // NODEALLOCATOR_HPP
+
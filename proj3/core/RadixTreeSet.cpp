@@ -0,0 +1,601 @@
+// RadixTreeSet.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "RadixTreeSet.hpp"
+
+
+
+namespace
+{
+    // A node can't have more children than there are distinct characters.
+    constexpr unsigned short MAX_CHILD_COUNT = 256;
+
+
+    // labelMatches() returns true if s, starting at position start, begins
+    // with all of label.
+    bool labelMatches(const std::string& label, const std::string& s, std::size_t start) noexcept
+    {
+        return label.length() <= s.length() - start
+            && std::memcmp(label.data(), s.data() + start, label.length()) == 0;
+    }
+}
+
+
+
+RadixTreeSet::RadixTreeSet()
+    : root{nullptr}, elementCount{0}, nodeCount_{0}
+{
+}
+
+
+RadixTreeSet::~RadixTreeSet() noexcept
+{
+    destroyNode(root);
+}
+
+
+RadixTreeSet::RadixTreeSet(const RadixTreeSet& s)
+    : root{s.root != nullptr ? copyNode(s.root) : nullptr},
+      elementCount{s.elementCount}, nodeCount_{s.nodeCount_}
+{
+}
+
+
+RadixTreeSet::RadixTreeSet(RadixTreeSet&& s) noexcept
+    : root{s.root}, elementCount{s.elementCount}, nodeCount_{s.nodeCount_}
+{
+    s.root = nullptr;
+    s.elementCount = 0;
+    s.nodeCount_ = 0;
+}
+
+
+RadixTreeSet& RadixTreeSet::operator=(const RadixTreeSet& s)
+{
+    if (this != &s)
+    {
+        Node* newRoot = s.root != nullptr ? copyNode(s.root) : nullptr;
+        destroyNode(root);
+
+        root = newRoot;
+        elementCount = s.elementCount;
+        nodeCount_ = s.nodeCount_;
+    }
+
+    return *this;
+}
+
+
+RadixTreeSet& RadixTreeSet::operator=(RadixTreeSet&& s) noexcept
+{
+    std::swap(root, s.root);
+    std::swap(elementCount, s.elementCount);
+    std::swap(nodeCount_, s.nodeCount_);
+
+    return *this;
+}
+
+
+bool RadixTreeSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void RadixTreeSet::add(const std::string& element)
+{
+    if (root == nullptr)
+    {
+        root = makeNode(std::string{}, false);
+        nodeCount_ = 1;
+    }
+
+    Node* node = root;
+    std::size_t position = 0;
+
+    while (true)
+    {
+        const std::string& label = node->label;
+        std::size_t common = 0;
+
+        while (common < label.length() && position + common < element.length()
+            && label[common] == element[position + common])
+        {
+            ++common;
+        }
+
+        if (common < label.length())
+        {
+            splitNode(node, common);
+        }
+
+        position += common;
+
+        if (position == element.length())
+        {
+            if (!node->holdsElement)
+            {
+                node->holdsElement = true;
+                ++elementCount;
+            }
+
+            return;
+        }
+
+        Node* child = findChild(node, element[position]);
+
+        if (child == nullptr)
+        {
+            Node* leaf = makeNode(element.substr(position), true);
+
+            try
+            {
+                insertChild(node, leaf);
+            }
+            catch (...)
+            {
+                destroyNode(leaf);
+                throw;
+            }
+
+            ++nodeCount_;
+            ++elementCount;
+            return;
+        }
+
+        node = child;
+    }
+}
+
+
+// Once the element's node no longer holds it, that node may be one the
+// tree doesn't need: a leaf, which is removed (possibly leaving its parent
+// needing to be merged with its remaining child), or a node with only one
+// child, which is merged with it.  The root is never removed or merged.
+// The merged label is made before anything changes, since making it is
+// the only thing that can throw.
+
+bool RadixTreeSet::remove(const std::string& element)
+{
+    Node* parent = nullptr;
+    Node* node = root;
+    std::size_t position = 0;
+
+    while (node != nullptr)
+    {
+        if (!labelMatches(node->label, element, position))
+        {
+            return false;
+        }
+
+        position += node->label.length();
+
+        if (position == element.length())
+        {
+            break;
+        }
+
+        parent = node;
+        node = findChild(node, element[position]);
+    }
+
+    if (node == nullptr || !node->holdsElement)
+    {
+        return false;
+    }
+
+    if (node == root || node->childCount > 1)
+    {
+        node->holdsElement = false;
+    }
+    else if (node->childCount == 1)
+    {
+        mergeWithChild(node, node->label + node->children[0]->label);
+    }
+    else if (parent != root && !parent->holdsElement && parent->childCount == 2)
+    {
+        Node* other = parent->children[parent->children[0] == node ? 1 : 0];
+        std::string label = parent->label + other->label;
+
+        removeChild(parent, static_cast<unsigned char>(node->label[0]));
+        destroyNode(node);
+        --nodeCount_;
+
+        mergeWithChild(parent, std::move(label));
+    }
+    else
+    {
+        removeChild(parent, static_cast<unsigned char>(node->label[0]));
+        destroyNode(node);
+        --nodeCount_;
+    }
+
+    --elementCount;
+    return true;
+}
+
+
+bool RadixTreeSet::contains(const std::string& element) const
+{
+    LookupCounter::Lookup lookup{this};
+    const Node* node = root;
+    std::size_t position = 0;
+
+    while (node != nullptr)
+    {
+        lookup.probed();
+        lookup.compared();
+
+        if (!labelMatches(node->label, element, position))
+        {
+            return false;
+        }
+
+        position += node->label.length();
+
+        if (position == element.length())
+        {
+            return node->holdsElement;
+        }
+
+        node = findChild(node, element[position]);
+    }
+
+    return false;
+}
+
+
+unsigned int RadixTreeSet::size() const noexcept
+{
+    return elementCount;
+}
+
+
+SetStatistics RadixTreeSet::statistics() const
+{
+    SetStatistics statistics = Set<std::string>::statistics();
+    statistics.memoryBytes = sizeof(*this);
+
+    if (root != nullptr)
+    {
+        measure(root, 1, statistics);
+    }
+
+    return statistics;
+}
+
+
+std::vector<std::string> RadixTreeSet::elementsWithPrefix(const std::string& prefix) const
+{
+    std::vector<std::string> elements;
+    std::string path;
+    const Node* node = findPrefixNode(prefix, path);
+
+    if (node != nullptr)
+    {
+        collect(node, path, elements);
+    }
+
+    return elements;
+}
+
+
+unsigned int RadixTreeSet::countWithPrefix(const std::string& prefix) const
+{
+    std::string path;
+    const Node* node = findPrefixNode(prefix, path);
+
+    return node != nullptr ? count(node) : 0;
+}
+
+
+std::size_t RadixTreeSet::longestPrefixOf(const std::string& s) const
+{
+    std::size_t longest = std::string::npos;
+    const Node* node = root;
+    std::size_t position = 0;
+
+    while (node != nullptr && labelMatches(node->label, s, position))
+    {
+        position += node->label.length();
+
+        if (node->holdsElement)
+        {
+            longest = position;
+        }
+
+        if (position == s.length())
+        {
+            break;
+        }
+
+        node = findChild(node, s[position]);
+    }
+
+    return longest;
+}
+
+
+unsigned int RadixTreeSet::nodeCount() const noexcept
+{
+    return nodeCount_;
+}
+
+
+
+RadixTreeSet::Node* RadixTreeSet::makeNode(std::string label, bool holdsElement)
+{
+    return new Node{std::move(label), holdsElement, 0, 0, nullptr, nullptr};
+}
+
+
+void RadixTreeSet::destroyNode(Node* node) noexcept
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    for (unsigned short i = 0; i < node->childCount; ++i)
+    {
+        destroyNode(node->children[i]);
+    }
+
+    delete[] node->keys;
+    delete[] node->children;
+    delete node;
+}
+
+
+RadixTreeSet::Node* RadixTreeSet::copyNode(const Node* node)
+{
+    Node* copy = makeNode(node->label, node->holdsElement);
+
+    try
+    {
+        if (node->childCount > 0)
+        {
+            copy->keys = new unsigned char[node->childCount];
+            copy->children = new Node*[node->childCount];
+            copy->childCapacity = node->childCount;
+        }
+
+        for (unsigned short i = 0; i < node->childCount; ++i)
+        {
+            copy->children[i] = copyNode(node->children[i]);
+            copy->keys[i] = node->keys[i];
+            ++copy->childCount;
+        }
+    }
+    catch (...)
+    {
+        destroyNode(copy);
+        throw;
+    }
+
+    return copy;
+}
+
+
+RadixTreeSet::Node* RadixTreeSet::findChild(const Node* node, unsigned char key) noexcept
+{
+    if (node->childCount == 0)
+    {
+        return nullptr;
+    }
+
+    const void* found = std::memchr(node->keys, key, node->childCount);
+
+    return found != nullptr
+        ? node->children[static_cast<const unsigned char*>(found) - node->keys]
+        : nullptr;
+}
+
+
+void RadixTreeSet::insertChild(Node* node, Node* child)
+{
+    unsigned char key = static_cast<unsigned char>(child->label[0]);
+    unsigned short index = static_cast<unsigned short>(
+        std::lower_bound(node->keys, node->keys + node->childCount, key) - node->keys);
+
+    if (node->childCount == node->childCapacity)
+    {
+        unsigned short newCapacity = static_cast<unsigned short>(
+            std::min<unsigned int>(std::max(2u, node->childCapacity * 2u), MAX_CHILD_COUNT));
+
+        unsigned char* newKeys = new unsigned char[newCapacity];
+        Node** newChildren;
+
+        try
+        {
+            newChildren = new Node*[newCapacity];
+        }
+        catch (...)
+        {
+            delete[] newKeys;
+            throw;
+        }
+
+        std::copy(node->keys, node->keys + node->childCount, newKeys);
+        std::copy(node->children, node->children + node->childCount, newChildren);
+
+        delete[] node->keys;
+        delete[] node->children;
+
+        node->keys = newKeys;
+        node->children = newChildren;
+        node->childCapacity = newCapacity;
+    }
+
+    std::copy_backward(node->keys + index, node->keys + node->childCount, node->keys + node->childCount + 1);
+    std::copy_backward(node->children + index, node->children + node->childCount, node->children + node->childCount + 1);
+
+    node->keys[index] = key;
+    node->children[index] = child;
+    ++node->childCount;
+}
+
+
+void RadixTreeSet::removeChild(Node* node, unsigned char key) noexcept
+{
+    unsigned short index = static_cast<unsigned short>(
+        static_cast<const unsigned char*>(std::memchr(node->keys, key, node->childCount)) - node->keys);
+
+    std::copy(node->keys + index + 1, node->keys + node->childCount, node->keys + index);
+    std::copy(node->children + index + 1, node->children + node->childCount, node->children + index);
+    --node->childCount;
+}
+
+
+void RadixTreeSet::mergeWithChild(Node* node, std::string label) noexcept
+{
+    Node* child = node->children[0];
+
+    delete[] node->keys;
+    delete[] node->children;
+
+    node->label = std::move(label);
+    node->holdsElement = child->holdsElement;
+    node->childCount = child->childCount;
+    node->childCapacity = child->childCapacity;
+    node->keys = child->keys;
+    node->children = child->children;
+
+    delete child;
+    --nodeCount_;
+}
+
+
+// Everything is allocated before the node is changed, so that the tree is
+// left as it was if an allocation fails.  The node is left with room for a
+// second child, since it's split only when one is about to be added (or
+// when it's about to hold an element itself).
+
+void RadixTreeSet::splitNode(Node* node, std::size_t length)
+{
+    Node* rest = makeNode(node->label.substr(length), node->holdsElement);
+    unsigned char* keys = nullptr;
+    Node** children = nullptr;
+
+    try
+    {
+        keys = new unsigned char[2];
+        children = new Node*[2];
+    }
+    catch (...)
+    {
+        delete[] keys;
+        destroyNode(rest);
+        throw;
+    }
+
+    rest->childCount = node->childCount;
+    rest->childCapacity = node->childCapacity;
+    rest->keys = node->keys;
+    rest->children = node->children;
+
+    keys[0] = static_cast<unsigned char>(rest->label[0]);
+    children[0] = rest;
+
+    node->label.resize(length);
+    node->holdsElement = false;
+    node->childCount = 1;
+    node->childCapacity = 2;
+    node->keys = keys;
+    node->children = children;
+
+    ++nodeCount_;
+}
+
+
+const RadixTreeSet::Node* RadixTreeSet::findPrefixNode(const std::string& prefix, std::string& path) const
+{
+    const Node* node = root;
+    std::size_t position = 0;
+
+    while (node != nullptr)
+    {
+        const std::string& label = node->label;
+        std::size_t compared = std::min(label.length(), prefix.length() - position);
+
+        if (std::memcmp(label.data(), prefix.data() + position, compared) != 0)
+        {
+            return nullptr;
+        }
+
+        path.append(label);
+        position += compared;
+
+        if (position == prefix.length())
+        {
+            return node;
+        }
+
+        node = findChild(node, prefix[position]);
+    }
+
+    return nullptr;
+}
+
+
+// Since the children are in order of their first characters, visiting the
+// node's own element first and then its children in order visits the
+// elements in ascending order.
+
+void RadixTreeSet::collect(const Node* node, std::string& path, std::vector<std::string>& elements)
+{
+    if (node->holdsElement)
+    {
+        elements.push_back(path);
+    }
+
+    for (unsigned short i = 0; i < node->childCount; ++i)
+    {
+        std::size_t length = path.length();
+        path.append(node->children[i]->label);
+        collect(node->children[i], path, elements);
+        path.resize(length);
+    }
+}
+
+
+unsigned int RadixTreeSet::count(const Node* node) noexcept
+{
+    unsigned int total = node->holdsElement ? 1 : 0;
+
+    for (unsigned short i = 0; i < node->childCount; ++i)
+    {
+        total += count(node->children[i]);
+    }
+
+    return total;
+}
+
+
+// A label too long for the std::string to hold inside itself has an array
+// of its own on the heap, whose size is the string's capacity (plus one,
+// for the terminating null character).
+
+void RadixTreeSet::measure(const Node* node, unsigned int depth, SetStatistics& statistics) noexcept
+{
+    static const std::size_t inlineCapacity = std::string{}.capacity();
+
+    statistics.levels = std::max(statistics.levels, depth);
+    statistics.memoryBytes +=
+        sizeof(Node) + node->childCapacity * (sizeof(unsigned char) + sizeof(Node*));
+
+    if (node->label.capacity() > inlineCapacity)
+    {
+        statistics.memoryBytes += node->label.capacity() + 1;
+    }
+
+    for (unsigned short i = 0; i < node->childCount; ++i)
+    {
+        measure(node->children[i], depth + 1, statistics);
+    }
+}
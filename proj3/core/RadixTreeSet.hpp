@@ -0,0 +1,167 @@
+// RadixTreeSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A RadixTreeSet is an implementation of a Set<std::string> that is a
+// radix tree (a path-compressed trie).  Each node is labeled with the
+// characters on the way to it from its parent, and a chain of nodes that
+// would each have had only one child is merged into a single node with a
+// longer label, so that there are never more than about twice as many
+// nodes as strings.  A node whose path from the root spells out one of the
+// strings is marked as holding it.
+//
+// Looking a string up takes time proportional to its length, no matter how
+// many strings are in the set, and compares each of its characters only
+// once.  Because the strings sharing a prefix are all in the same subtree,
+// the set can also find every string that begins with a given prefix
+// (elementsWithPrefix()) and the longest string that is a prefix of a given
+// one (longestPrefixOf()).
+//
+// A node's children are kept in two small arrays, sorted by the first
+// character of their labels: one of those characters, packed together so
+// that finding a child scans only a few bytes, and one of pointers to the
+// children themselves.  (Dictionaries mix upper- and lowercase letters with
+// digits and punctuation, so a fixed table of 26 slots wouldn't cover the
+// characters that turn up.)
+
+#ifndef RADIXTREESET_HPP
+#define RADIXTREESET_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Set.hpp"
+
+
+
+class RadixTreeSet : public Set<std::string>
+{
+public:
+    // Initializes a RadixTreeSet to be empty.
+    RadixTreeSet();
+
+    // Cleans up the RadixTreeSet so that it leaks no memory.
+    virtual ~RadixTreeSet() noexcept;
+
+    // Initializes a new RadixTreeSet to be a copy of an existing one.
+    RadixTreeSet(const RadixTreeSet& s);
+
+    // Initializes a new RadixTreeSet whose contents are moved from an
+    // expiring one.
+    RadixTreeSet(RadixTreeSet&& s) noexcept;
+
+    // Assigns an existing RadixTreeSet into another.
+    RadixTreeSet& operator=(const RadixTreeSet& s);
+
+    // Assigns an expiring RadixTreeSet into another.
+    RadixTreeSet& operator=(RadixTreeSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in time
+    // proportional to the length of the element.
+    virtual void add(const std::string& element) override;
+
+
+    // remove() removes an element from the set, removing or merging nodes
+    // as needed so that the tree stays path-compressed.  This function runs
+    // in time proportional to the length of the element.
+    virtual bool remove(const std::string& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in time proportional to the
+    // length of the element.
+    virtual bool contains(const std::string& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // statistics() also reports the number of nodes on the longest path
+    // down the tree and the memory taken by the nodes, their child arrays,
+    // and any labels too long to fit inside a std::string.  Each node that
+    // contains() visits is a probe, and comparing its label is a comparison.
+    virtual SetStatistics statistics() const override;
+
+
+    // elementsWithPrefix() returns every element that begins with the given
+    // prefix (including the prefix itself, if it's an element), in
+    // ascending order.
+    std::vector<std::string> elementsWithPrefix(const std::string& prefix) const;
+
+
+    // countWithPrefix() returns the number of elements that begin with the
+    // given prefix, without copying any of them.
+    unsigned int countWithPrefix(const std::string& prefix) const;
+
+
+    // longestPrefixOf() returns the length of the longest element that is a
+    // prefix of s (which might be s itself), or std::string::npos if no
+    // element is.
+    std::size_t longestPrefixOf(const std::string& s) const;
+
+
+    // nodeCount() returns the number of nodes in the tree, including the
+    // root, whose label is always empty.  (A set to which nothing has ever
+    // been added has no nodes at all.)
+    unsigned int nodeCount() const noexcept;
+
+
+private:
+    struct Node
+    {
+        std::string label;
+        bool holdsElement;
+
+        unsigned short childCount;
+        unsigned short childCapacity;
+
+        // keys[i] is the first character of children[i]->label, and the
+        // keys are in ascending order (as unsigned chars, which is the
+        // order in which std::string compares characters).
+        unsigned char* keys;
+        Node** children;
+    };
+
+    Node* root;
+    unsigned int elementCount;
+    unsigned int nodeCount_;
+
+private:
+    static Node* makeNode(std::string label, bool holdsElement);
+    static void destroyNode(Node* node) noexcept;
+    static Node* copyNode(const Node* node);
+
+    static Node* findChild(const Node* node, unsigned char key) noexcept;
+    static void insertChild(Node* node, Node* child);
+    static void removeChild(Node* node, unsigned char key) noexcept;
+
+    // mergeWithChild() absorbs a node's only child into it, given the
+    // concatenation of their labels.
+    void mergeWithChild(Node* node, std::string label) noexcept;
+
+    // splitNode() gives the node a new child holding everything the node
+    // held past the first length characters of its label, and cuts its
+    // label down to those characters.
+    void splitNode(Node* node, std::size_t length);
+
+    // findPrefixNode() returns the node in whose subtree exactly the
+    // elements beginning with prefix are found, or nullptr if there are
+    // none; path is set to the string spelled out by the way to the node,
+    // which begins with prefix but may be longer.
+    const Node* findPrefixNode(const std::string& prefix, std::string& path) const;
+
+    static void collect(const Node* node, std::string& path, std::vector<std::string>& elements);
+    static unsigned int count(const Node* node) noexcept;
+    static void measure(const Node* node, unsigned int depth, SetStatistics& statistics) noexcept;
+};
+
+
+
+#endif // RADIXTREESET_HPP
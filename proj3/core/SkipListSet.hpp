@@ -12,10 +12,28 @@
 // nodes, with pointers connecting them.  You can, however, use other parts of
 // the C++ Standard Library -- including <random>, notably.
 //
-// Each node should contain only two pointers: one to the node that follows it
-// on the same level and another to the equivalent node on the level below it.
-// Additional pointers use more memory but don't enable any techniques not
-// enabled by the other two.
+// Rather than a column of nodes for each element, one per level, there is
+// a single node per element, allocated along with an array of the links
+// that lead from it to the next node on each level it occupies (so the
+// number of levels an element occupies is the length of its array).  The
+// element is stored once, in its node; there are no nodes for -INF and
+// +INF, since the links from the -INF end of each level are kept in the
+// SkipListSet itself, and a link that leads nowhere marks the +INF end.
+// Going down a level is a matter of using the next link of the same node's
+// array, which is already in the cache.  The number of levels is kept up
+// to date as they're added and removed, and is limited to a few more than
+// the base-2 logarithm of the number of elements, so that a long run of
+// coin flips can't make the skip list (and the way down it) much taller
+// than it needs to be.
+//
+// The nodes are allocated with a NodeAllocator (see NodeAllocator.hpp),
+// which is given by the second template argument of SkipListSet.
+//
+// Each link also records its span: how many places along the bottom level
+// it skips over.  Adding up the spans of the links followed on the way down
+// to an element gives its rank (its position in ascending order), so the
+// set can find the rank of an element, or the element with a given rank,
+// in the same expected O(log n) time that it takes to find the element.
 //
 // A couple of utilities are included here: SkipListKind and SkipListKey.
 // You can feel free to use these as-is and probably will not need to
@@ -24,9 +42,19 @@
 #ifndef SKIPLISTSET_HPP
 #define SKIPLISTSET_HPP
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
+#include <new>
 #include <random>
+#include <stdexcept>
+#include <utility>
+#include "NodeAllocator.hpp"
 #include "Set.hpp"
+#include "SortedRange.hpp"
 
 
 
@@ -104,12 +132,14 @@ bool SkipListKey<ElementType>::operator<(const SkipListKey& other) const
 // The SkipListLevelTester class represents the ability to decide whether
 // a key placed on one level of the skip list should also occupy the next
 // level.  This is the "coin flip," so to speak.  Note that this is an
-// abstract base class with one implementation, RandomSkipListLevelTester,
-// just below it.  RandomSkipListLevelTester is what it sounds like: It
-// makes the decision at random (with a 50/50 chance of deciding whether
-// a key should occupy the next level).  However, by setting things up
-// this way, we have a way to control things more carefully in our
-// testing (as you can, as well).
+// abstract base class with two implementations, RandomSkipListLevelTester
+// and FastSkipListLevelTester, just below it.  RandomSkipListLevelTester is
+// what it sounds like: It makes the decision at random (with a 50/50 chance
+// of deciding whether a key should occupy the next level).  However, by
+// setting things up this way, we have a way to control things more
+// carefully in our testing (as you can, as well).  FastSkipListLevelTester
+// decides a key's whole height at once, and can be seeded so that its
+// decisions are repeatable.
 //
 // DO NOT MAKE CHANGES TO THE SIGNATURES OF THE MEMBER FUNCTIONS OF
 // THE "level tester" CLASSES.  You can add new member functions or even
@@ -125,9 +155,27 @@ public:
 
     virtual bool shouldOccupyNextLevel(const ElementType& element) = 0;
     virtual std::unique_ptr<SkipListLevelTester<ElementType>> clone() = 0;
+
+    // chooseHeight() returns the number of levels (at least 1 and at most
+    // the given limit) that a new element should occupy.  Unless it's
+    // overridden, it asks shouldOccupyNextLevel() once per level, until the
+    // answer is no or the limit is reached.
+    virtual unsigned int chooseHeight(const ElementType& element, unsigned int limit);
 };
 
 
+template <typename ElementType>
+unsigned int SkipListLevelTester<ElementType>::chooseHeight(const ElementType& element, unsigned int limit)
+{
+    unsigned int height = 1;
+
+    while(height < limit && shouldOccupyNextLevel(element))
+        height++;
+
+    return height;
+}
+
+
 template <typename ElementType>
 class RandomSkipListLevelTester : public SkipListLevelTester<ElementType>
 {
@@ -168,13 +216,184 @@ std::unique_ptr<SkipListLevelTester<ElementType>> RandomSkipListLevelTester<Elem
 
 
 
+// SkipListPromotion is the probability with which a FastSkipListLevelTester
+// decides that an element should occupy the next level.  A smaller one
+// makes a skip list with fewer links per element (1 / (1 - p) on average)
+// but more steps along each level on the way down; 1/e minimizes the
+// expected number of steps overall.
+
+enum class SkipListPromotion
+{
+    OneHalf,
+    OneQuarter,
+    OneOverE
+};
+
+
+
+// A FastSkipListLevelTester decides the height of a new element with a
+// single draw from a small, fast generator (wyrand, whose whole state is
+// one 64-bit integer), rather than one draw per level.  With a probability
+// of 1/2, each bit of the draw is a coin flip, so the number of trailing
+// zero bits is the number of levels above the first that the element
+// occupies; with 1/4, it's the number of trailing pairs of zero bits.  With
+// 1/e, the draw is turned into a number u in (0, 1], and -ln u (which is
+// exponentially distributed) is rounded down.
+//
+// It can be given a seed, so that a skip list built with it is the same
+// every time; otherwise, it's seeded from std::random_device.  A clone is
+// seeded with the next draw, so it doesn't repeat the same heights, but is
+// still determined by the original seed.
+
+template <typename ElementType>
+class FastSkipListLevelTester : public SkipListLevelTester<ElementType>
+{
+public:
+    FastSkipListLevelTester();
+    explicit FastSkipListLevelTester(
+        std::uint64_t seed, SkipListPromotion promotion = SkipListPromotion::OneHalf);
+    virtual ~FastSkipListLevelTester() = default;
+
+    virtual bool shouldOccupyNextLevel(const ElementType& element) override;
+    virtual std::unique_ptr<SkipListLevelTester<ElementType>> clone() override;
+    virtual unsigned int chooseHeight(const ElementType& element, unsigned int limit) override;
+
+private:
+    std::uint64_t state;
+    SkipListPromotion promotion;
+
+private:
+    std::uint64_t next() noexcept;
+};
+
+
+template <typename ElementType>
+FastSkipListLevelTester<ElementType>::FastSkipListLevelTester()
+    : FastSkipListLevelTester{
+        (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}()}
+{
+}
+
+
+template <typename ElementType>
+FastSkipListLevelTester<ElementType>::FastSkipListLevelTester(
+    std::uint64_t seed, SkipListPromotion promotion)
+    : state{seed}, promotion{promotion}
+{
+}
+
+
+// Deciding one level at a time takes a draw per level; with 1/e, the draw
+// is compared against 2^64 / e, which it's below with that probability.
+
 template <typename ElementType>
+bool FastSkipListLevelTester<ElementType>::shouldOccupyNextLevel(const ElementType& element)
+{
+    switch(promotion)
+    {
+    case SkipListPromotion::OneHalf:
+        return (next() >> 63) == 0;
+
+    case SkipListPromotion::OneQuarter:
+        return (next() >> 62) == 0;
+
+    default: // SkipListPromotion::OneOverE
+        return next() < 6786177901268885274ULL;
+    }
+}
+
+
+template <typename ElementType>
+std::unique_ptr<SkipListLevelTester<ElementType>> FastSkipListLevelTester<ElementType>::clone()
+{
+    return std::unique_ptr<SkipListLevelTester<ElementType>>{
+        new FastSkipListLevelTester<ElementType>{next(), promotion}};
+}
+
+
+// The top bit is set before counting trailing zeros, so there's always one
+// to stop at.  The 1/e case uses the top 53 bits of the draw, which are as
+// many as a double can hold exactly.
+
+template <typename ElementType>
+unsigned int FastSkipListLevelTester<ElementType>::chooseHeight(const ElementType& element, unsigned int limit)
+{
+    std::uint64_t draw = next();
+    unsigned int height;
+
+    switch(promotion)
+    {
+    case SkipListPromotion::OneHalf:
+        height = 1 + __builtin_ctzll(draw | (1ULL << 63));
+        break;
+
+    case SkipListPromotion::OneQuarter:
+        height = 1 + __builtin_ctzll(draw | (1ULL << 63)) / 2;
+        break;
+
+    default: // SkipListPromotion::OneOverE
+        height = 1 + static_cast<unsigned int>(
+            -std::log(static_cast<double>((draw >> 11) + 1) * 0x1.0p-53));
+        break;
+    }
+
+    return std::min(height, limit);
+}
+
+
+// Where there's no 128-bit integer type, the 128-bit product is put
+// together from four 32x32-bit products instead.
+
+template <typename ElementType>
+std::uint64_t FastSkipListLevelTester<ElementType>::next() noexcept
+{
+    state += 0xa0761d6478bd642fULL;
+    std::uint64_t a = state;
+    std::uint64_t b = state ^ 0xe7037ed1a0b428dbULL;
+
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<std::uint64_t>(product >> 64) ^ static_cast<std::uint64_t>(product);
+#else
+    std::uint64_t aLow = a & 0xFFFFFFFFu, aHigh = a >> 32;
+    std::uint64_t bLow = b & 0xFFFFFFFFu, bHigh = b >> 32;
+
+    std::uint64_t lowLow = aLow * bLow;
+    std::uint64_t lowHigh = aLow * bHigh;
+    std::uint64_t highLow = aHigh * bLow;
+    std::uint64_t highHigh = aHigh * bHigh;
+
+    std::uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFu) + (highLow & 0xFFFFFFFFu);
+    std::uint64_t low = (lowLow & 0xFFFFFFFFu) | (middle << 32);
+    std::uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+
+    return high ^ low;
+#endif
+}
+
+
+
+
+template <typename ElementType, typename NodeAllocator = HeapNodeAllocator>
 class SkipListSet : public Set<ElementType>
 {
+private:
+    struct Node;
+
+public:
+    // The most levels that a SkipListSet can have.
+    static constexpr unsigned int MAX_LEVEL_COUNT = 32;
+
+    // An element added with add() occupies at most this many levels more
+    // than the base-2 logarithm of the set's size (rounded down), however
+    // many times the level tester says it should occupy the next one.
+    static constexpr unsigned int EXTRA_LEVELS = 4;
+
 public:
     // Initializes an SkipListSet to be empty, with or without a
     // "level tester" object that will decide, whenever a "coin flip"
     // is needed, whether a key should occupy the next level above.
+    // Without one, a FastSkipListLevelTester with a random seed is used.
     SkipListSet();
     explicit SkipListSet(std::unique_ptr<SkipListLevelTester<ElementType>> levelTester);
 
@@ -185,8 +404,10 @@ public:
     SkipListSet(const SkipListSet& s);
 
     // Initializes a new SkipListSet whose contents are moved from an
-    // expiring one.
-    SkipListSet(SkipListSet&& s) noexcept;
+    // expiring one.  The expiring one is given a clone of the level tester,
+    // so that it can still be used; cloning allocates memory, so this isn't
+    // noexcept.
+    SkipListSet(SkipListSet&& s);
 
     // Assigns an existing SkipListSet into another.
     SkipListSet& operator=(const SkipListSet& s);
@@ -201,12 +422,33 @@ public:
 
 
     // add() adds an element to the set.  If the element is already in the set,
-    // this function has no effect.  This function runs in an expected time
-    // of O(log n) (i.e., over the long run, we expect the average to be
+    // this function has no effect.  The number of levels the element occupies
+    // is decided by the level tester, up to the limit described alongside
+    // EXTRA_LEVELS above.  This function runs in an expected time of
+    // O(log n) (i.e., over the long run, we expect the average to be
     // O(log n)) with very high probability.
     virtual void add(const ElementType& element) override;
 
 
+    // addAll() adds every element in the range [begin, end) to the set.
+    // When the set is empty, the skip list is built directly, from left to
+    // right, with deterministic levels rather than coin flips: the i-th
+    // smallest element (counting from 1) occupies one level more than the
+    // number of times 2 divides i, so each level holds every other element
+    // of the level below it.  This takes O(n) time if the elements are in
+    // ascending order (and presorted is true), O(n log n) otherwise.  When
+    // the set isn't empty, the elements are added one at a time with add().
+    virtual void addAll(const ElementType* begin, const ElementType* end, bool presorted) override;
+
+
+    // remove() removes an element from the set, unlinking its node on every
+    // level it occupies, along with any levels above the bottom one that
+    // are left empty.  (Removing the last element leaves no levels at all,
+    // as in a new SkipListSet.)  This function runs in an expected time of
+    // O(log n).
+    virtual bool remove(const ElementType& element) override;
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function runs in an expected time of O(log n)
     // (i.e., over the long run, we expect the average to be O(log n))
@@ -218,15 +460,23 @@ public:
     virtual unsigned int size() const noexcept override;
 
 
-    // levelCount() returns the number of levels in the skip list.
+    // statistics() also reports the number of levels and the memory taken
+    // by the nodes, which it finds by walking the bottom level, so it runs
+    // in O(n) time.  Each node that contains() moves to is a probe, and
+    // each element comparison is counted.
+    virtual SetStatistics statistics() const override;
+
+
+    // levelCount() returns the number of levels in the skip list, which is
+    // kept up to date as levels are added and removed, so this function
+    // runs in O(1) time.
     unsigned int levelCount() const noexcept;
 
 
     // elementsOnLevel() returns the number of elements that are stored
     // on the given level of the skip list.  Level 0 is the bottom level;
     // level 1 is the one above level 0; and so on.  If the given level
-    // doesn't exist, this function returns 0.  (Note that the -INF
-    // and +INF shouldn't be counted.)
+    // doesn't exist, this function returns 0.
     unsigned int elementsOnLevel(unsigned int level) const noexcept;
 
 
@@ -237,389 +487,611 @@ public:
     bool isElementOnLevel(const ElementType& element, unsigned int level) const;
 
 
+    // A ConstIterator refers to one of the elements of a SkipListSet, and
+    // advances through them in ascending order along the bottom level.
+    // Adding an element to the set doesn't invalidate it.
+    class ConstIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ElementType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ElementType*;
+        using reference = const ElementType&;
+
+    public:
+        // Initializes a ConstIterator that refers to nothing, like the one
+        // returned by end().
+        ConstIterator() noexcept;
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+
+        ConstIterator& operator++() noexcept;
+        ConstIterator operator++(int) noexcept;
+
+        bool operator==(const ConstIterator& i) const noexcept;
+        bool operator!=(const ConstIterator& i) const noexcept;
+
+    private:
+        friend class SkipListSet;
+
+        // Initializes a ConstIterator referring to the given node, or to
+        // nothing if it's nullptr.
+        explicit ConstIterator(const Node* node) noexcept;
+
+        const Node* node;
+    };
+
+    using iterator = ConstIterator;
+    using const_iterator = ConstIterator;
+
+
+    // begin() returns a ConstIterator referring to the smallest element in
+    // the set, and end() one referring to nothing, which is where a
+    // ConstIterator ends up after it advances past the largest element.
+    ConstIterator begin() const noexcept;
+    ConstIterator end() const noexcept;
+
+
+    // lowerBound() returns a ConstIterator referring to the smallest element
+    // not less than the given one, and upperBound() one referring to the
+    // smallest element greater than it; either returns end() if there's no
+    // such element.  Both run in an expected time of O(log n).
+    ConstIterator lowerBound(const ElementType& element) const;
+    ConstIterator upperBound(const ElementType& element) const;
+
+
+    // range() returns the elements not less than low and less than high,
+    // which can be iterated in ascending order in a range-based for loop.
+    SortedRange<ConstIterator> range(const ElementType& low, const ElementType& high) const;
+
+
+    // rank() returns the number of elements less than the given one, which
+    // (when it's in the set) is its position in ascending order, counting
+    // from 0.  select() returns the element at the given position, throwing
+    // a std::out_of_range if there's no such position.  Both run in an
+    // expected time of O(log n).
+    unsigned int rank(const ElementType& element) const;
+    const ElementType& select(unsigned int position) const;
+
+
 private:
-    std::unique_ptr<SkipListLevelTester<ElementType>> levelTester;
+    // A Link leads from a node (or the head) to the next node on one level,
+    // or to nothing at the end of the level.  Its span is the number of
+    // places along the bottom level that it skips over, counting the end of
+    // the level as the place after the largest element.
+    struct Link
+    {
+        Node* next;
+        unsigned int span;
+    };
+
+    // There is one Node per element, allocated along with an array of its
+    // links (one per level it occupies, starting from the bottom), which
+    // follows it in the same block of memory.
     struct Node
     {
-        Node(const ElementType& element) : value{ element }, key{SkipListKind::Normal, element}, prev{ nullptr }, next{ nullptr }, up{ nullptr }, down{ nullptr } {}
-        Node(SkipListKind kind) : value{}, key{kind, ElementType()}, prev{ nullptr }, next{ nullptr }, up{ nullptr }, down{ nullptr }{}
-        
         ElementType value;
-        SkipListKey<ElementType> key;
-        Node* prev;
-        Node* next;
-        Node* up;
-        Node* down;
+        unsigned int height;
+
+        Link* links() noexcept;
+        const Link* links() const noexcept;
+    };
+
+    // The distance from the beginning of a Node to its links.
+    static constexpr std::size_t LINKS_OFFSET =
+        (sizeof(Node) + alignof(Link) - 1) / alignof(Link) * alignof(Link);
+
+    // The last link on each level of a skip list that's being built from
+    // left to right, and the positions of the nodes they leave from.
+    struct LevelEnds
+    {
+        Link* links[MAX_LEVEL_COUNT];
+        unsigned int positions[MAX_LEVEL_COUNT];
     };
 
+    std::unique_ptr<SkipListLevelTester<ElementType>> levelTester;
+
     unsigned int elementNum;
 
-    Node* head;
+    unsigned int levels;
+
+    // The links from the -INF end of each level; only the first levels
+    // of them are in use.
+    Link head[MAX_LEVEL_COUNT];
 
-    void copyNode(const SkipListSet& s, Node* targetHead);
-    void deleteAllNodes(SkipListSet& s) const;
+    NodeAllocator nodeAllocator;
 
+    void copyNode(const SkipListSet& s);
+    void buildLevels(const ElementType** sorted, unsigned int count);
+    void deleteAllNodes() noexcept;
+
+    void startBuilding(unsigned int levelCount, LevelEnds& ends) noexcept;
+    void append(Node* node, LevelEnds& ends) noexcept;
+    void finishBuilding(LevelEnds& ends) noexcept;
+
+    const Link* lastBefore(const ElementType& element, unsigned int& rank) const;
+    const Link* lastBefore(const ElementType& element, unsigned int& rank, LookupCounter::Lookup& lookup) const;
+    unsigned int heightLimit() const noexcept;
+
+    Node* makeNode(const ElementType& element, unsigned int height);
+    void freeNode(Node* node) noexcept;
+    static std::size_t nodeBytes(unsigned int height) noexcept;
 };
 
 
 
-template <typename ElementType>
-SkipListSet<ElementType>::SkipListSet()
-    : SkipListSet{std::make_unique<RandomSkipListLevelTester<ElementType>>()}
+template <typename ElementType, typename NodeAllocator>
+SkipListSet<ElementType, NodeAllocator>::SkipListSet()
+    : SkipListSet{std::make_unique<FastSkipListLevelTester<ElementType>>()}
 {
-    std::cout << "constructor 1" << std::endl;
-    head = {};
-    elementNum=0;
 }
 
 
-template <typename ElementType>
-SkipListSet<ElementType>::SkipListSet(std::unique_ptr<SkipListLevelTester<ElementType>> levelTester)
-    : levelTester{std::move(levelTester)}
+template <typename ElementType, typename NodeAllocator>
+SkipListSet<ElementType, NodeAllocator>::SkipListSet(std::unique_ptr<SkipListLevelTester<ElementType>> levelTester)
+    : levelTester{std::move(levelTester)}, elementNum{0}, levels{0}, head{}
 {
-    std::cout << "constructor 2" << std::endl;
-    head = {};
-    elementNum=0;
 }
 
 
-template <typename ElementType>
-SkipListSet<ElementType>::~SkipListSet() noexcept
+template <typename ElementType, typename NodeAllocator>
+SkipListSet<ElementType, NodeAllocator>::~SkipListSet() noexcept
 {
-    std::cout << "destructor: " << std::endl;
-    
-    if(head==nullptr)
-        delete head;
-
-    else
+    if constexpr (mustVisitNodesToDestroy<NodeAllocator, Node>)
     {
-        Node* currentHead = *&head;
-        while(currentHead->down)
-        {
-            Node* temp = currentHead;
-            if(currentHead->down != nullptr)
-            {
-                currentHead = currentHead->down;
-            }
-            while(temp)
-            {
-                Node* dNode = temp;
-                temp = temp->next;
-                delete dNode;
-            }
-        }
-        elementNum=0;
+        deleteAllNodes();
     }
+}
+
 
-    
+template <typename ElementType, typename NodeAllocator>
+SkipListSet<ElementType, NodeAllocator>::SkipListSet(const SkipListSet& s)
+    : levelTester{s.levelTester->clone()}, elementNum{0}, levels{0}, head{}
+{
+    copyNode(s);
 }
 
 
-template <typename ElementType>
-SkipListSet<ElementType>::SkipListSet(const SkipListSet& s)
+// The moved-to SkipListSet takes over the level tester, the nodes, and the
+// allocator whose memory they live in; the expiring one is left empty, with
+// a clone of the level tester, so it can still be used.  The clone is made
+// first, so that if making it throws, the expiring one is left as it was.
+
+template <typename ElementType, typename NodeAllocator>
+SkipListSet<ElementType, NodeAllocator>::SkipListSet(SkipListSet&& s)
+    : levelTester{s.levelTester->clone()}, elementNum{s.elementNum}, levels{s.levels},
+      nodeAllocator{std::move(s.nodeAllocator)}
 {
-    std::cout << "SkipListSet &s copy" << std::endl;
+    std::copy(s.head, s.head + MAX_LEVEL_COUNT, head);
+
+    std::swap(levelTester, s.levelTester);
+    s.elementNum = 0;
+    s.levels = 0;
+    s.head[0] = Link{nullptr, 0};
+}
 
-    levelTester = s.levelTester->clone();
 
-    if(s.head == nullptr)
+template <typename ElementType, typename NodeAllocator>
+SkipListSet<ElementType, NodeAllocator>& SkipListSet<ElementType, NodeAllocator>::operator=(const SkipListSet& s)
+{
+    if(this != &s)
     {
-        head = nullptr;
-        return;
+        SkipListSet copy{s};
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+SkipListSet<ElementType, NodeAllocator>& SkipListSet<ElementType, NodeAllocator>::operator=(SkipListSet&& s) noexcept
+{
+    if(this != &s)
+    {
+        std::swap(levelTester, s.levelTester);
+        std::swap(elementNum, s.elementNum);
+        std::swap(levels, s.levels);
+        std::swap(head, s.head);
+        std::swap(nodeAllocator, s.nodeAllocator);
     }
 
-    copyNode(s, head);
+    return *this;
+}
+
 
+template <typename ElementType, typename NodeAllocator>
+bool SkipListSet<ElementType, NodeAllocator>::isImplemented() const noexcept
+{
+    return true;
 }
 
 
-template <typename ElementType>
-SkipListSet<ElementType>::SkipListSet(SkipListSet&& s) noexcept
+// The way down from the top level records, on each level, the last link
+// before where the element belongs and the rank of the node (or head) it
+// leaves from, which is everything needed to link the new node in once the
+// coin flips have decided its height.  Levels that only the new node
+// reaches begin with a head link spanning the whole list.  Each link that
+// the new node splits in two is shared between the node it leaves from and
+// the new node; each link that passes over the new node spans one more
+// place than it did.
+
+template <typename ElementType, typename NodeAllocator>
+void SkipListSet<ElementType, NodeAllocator>::add(const ElementType& element)
 {
-    std::cout << "SkipListSet &&s copy" << std::endl;
+    Link* before[MAX_LEVEL_COUNT];
+    unsigned int ranks[MAX_LEVEL_COUNT];
 
-    levelTester = s.levelTester->clone();
+    Link* links = head;
+    unsigned int rank = 0;
 
-    if(s.head == nullptr)
+    for(unsigned int lvl = levels; lvl-- > 0; )
     {
-        head = nullptr;
+        while(links[lvl].next != nullptr && links[lvl].next->value < element)
+        {
+            rank += links[lvl].span;
+            links = links[lvl].next->links();
+        }
+
+        before[lvl] = &links[lvl];
+        ranks[lvl] = rank;
+    }
+
+    if(links[0].next != nullptr && !(element < links[0].next->value))
         return;
+
+    unsigned int height = levelTester->chooseHeight(element, heightLimit());
+
+    Node* node = makeNode(element, height);
+
+    for(; levels < height; levels++)
+    {
+        head[levels] = Link{nullptr, elementNum + 1};
+        before[levels] = &head[levels];
+        ranks[levels] = 0;
     }
 
-    copyNode(s, head);
-    deleteAllNodes(s);
+    Link* nodeLinks = node->links();
+
+    for(unsigned int lvl = 0; lvl < levels; lvl++)
+    {
+        if(lvl < height)
+        {
+            nodeLinks[lvl].next = before[lvl]->next;
+            nodeLinks[lvl].span = before[lvl]->span - (rank - ranks[lvl]);
+            before[lvl]->next = node;
+            before[lvl]->span = rank - ranks[lvl] + 1;
+        }
+        else
+        {
+            before[lvl]->span++;
+        }
+    }
+
+    elementNum++;
 }
 
 
-template <typename ElementType>
-SkipListSet<ElementType>& SkipListSet<ElementType>::operator=(const SkipListSet& s)
+template <typename ElementType, typename NodeAllocator>
+void SkipListSet<ElementType, NodeAllocator>::addAll(const ElementType* begin, const ElementType* end, bool presorted)
 {
-    std::cout << "SkipListSet &s Assigns" << std::endl;
+    if(levels != 0)
+    {
+        for(; begin != end; ++begin)
+            add(*begin);
+        return;
+    }
 
-    levelTester = s.levelTester->clone();
+    if(begin == end)
+        return;
+
+    const ElementType** sorted = new const ElementType*[end - begin];
 
-    if(s.head == nullptr)
+    try
     {
-        head = nullptr;
-        return *this;
+        unsigned int count = sortDistinct(begin, end, presorted, sorted);
+        buildLevels(sorted, count);
+    }
+    catch (...)
+    {
+        delete[] sorted;
+        throw;
     }
 
-    copyNode(s, head);
-    return *this;
+    delete[] sorted;
 }
 
 
-template <typename ElementType>
-SkipListSet<ElementType>& SkipListSet<ElementType>::operator=(SkipListSet&& s) noexcept
+// On the way down, each link that passes over the element loses one from
+// its span, and each link to the element's node is replaced by the node's
+// own link on that level, spanning the places that both of them did less
+// the one being removed.
+
+template <typename ElementType, typename NodeAllocator>
+bool SkipListSet<ElementType, NodeAllocator>::remove(const ElementType& element)
 {
-    std::cout << "SkipListSet &&s Assigns" << std::endl;
+    Link* before[MAX_LEVEL_COUNT];
+    Link* links = head;
+
+    for(unsigned int lvl = levels; lvl-- > 0; )
+    {
+        while(links[lvl].next != nullptr && links[lvl].next->value < element)
+            links = links[lvl].next->links();
+
+        before[lvl] = &links[lvl];
+    }
+
+    Node* node = links[0].next;
+
+    if(node == nullptr || element < node->value)
+        return false;
 
-    levelTester = s.levelTester->clone();
+    Link* nodeLinks = node->links();
 
-    if(s.head == nullptr)
+    for(unsigned int lvl = 0; lvl < levels; lvl++)
     {
-        head = nullptr;
-        return *this;
+        if(lvl < node->height)
+        {
+            before[lvl]->next = nodeLinks[lvl].next;
+            before[lvl]->span += nodeLinks[lvl].span - 1;
+        }
+        else
+        {
+            before[lvl]->span--;
+        }
     }
-    copyNode(s, head);
-    deleteAllNodes(s);
-    
-    return *this;
-}
 
+    freeNode(node);
+    elementNum--;
+
+    while(levels > 0 && head[levels - 1].next == nullptr)
+        levels--;
 
-template <typename ElementType>
-bool SkipListSet<ElementType>::isImplemented() const noexcept
-{
     return true;
 }
 
 
-template <typename ElementType>
-void SkipListSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, typename NodeAllocator>
+bool SkipListSet<ElementType, NodeAllocator>::contains(const ElementType& element) const
 {
-    if(contains(element))
-        return;
+    LookupCounter::Lookup lookup{this};
+    unsigned int rank = 0;
+    const Node* next = lastBefore(element, rank, lookup)[0].next;
 
+    if(next == nullptr)
+        return false;
 
-    Node* newNode = new Node(element);
-    Node* current = head;
+    lookup.compared();
+    return !(element < next->value);
+}
 
-    // IF STATEMENT for inserting the newNode on the first level
-    if(!current)
-    {
-        Node* newHead = new Node(SkipListKind::NegInf);
-        Node* newTail = new Node(SkipListKind::PosInf);
 
-        newHead->next = newNode;
-        newNode->prev = newHead;
-        newNode->next = newTail;
-        newTail->prev = newNode;
+template <typename ElementType, typename NodeAllocator>
+unsigned int SkipListSet<ElementType, NodeAllocator>::size() const noexcept
+{
+    return elementNum;
+}
 
-        head = newHead;
-        current = newNode;
 
-    }
-    else
-    {
-        while(current->down)
-            current = current->down;
+template <typename ElementType, typename NodeAllocator>
+SetStatistics SkipListSet<ElementType, NodeAllocator>::statistics() const
+{
+    SetStatistics statistics = Set<ElementType>::statistics();
+    statistics.levels = levels;
+    statistics.memoryBytes = sizeof(*this);
 
-        while(current->next->key < newNode->key)
-        {
-            current = current->next;
-        }
+    for(const Node* node = head[0].next; node != nullptr; node = node->links()[0].next)
+        statistics.memoryBytes += nodeBytes(node->height);
 
-        Node* tempNext = current->next;
-        current->next = newNode;
-        newNode->prev = current;
-        newNode->next = tempNext;
-        tempNext->prev = newNode;
+    return statistics;
+}
 
-        current = newNode;
 
-    }
-    elementNum++;
+template <typename ElementType, typename NodeAllocator>
+unsigned int SkipListSet<ElementType, NodeAllocator>::levelCount() const noexcept
+{
+    return levels;
+}
 
-    unsigned int currentLevel = 0;
-    unsigned int totalLevel = levelCount();
 
+template <typename ElementType, typename NodeAllocator>
+unsigned int SkipListSet<ElementType, NodeAllocator>::elementsOnLevel(unsigned int level) const noexcept
+{
+    unsigned int eleNum = 0;
 
-    // WHILE STATEMENT to insert the newNode on the random levels
-    while(levelTester->shouldOccupyNextLevel(element))
+    if(level < levels)
     {
-        // std::cout << "talLevel << std::endl;
-        // add new node above 
-        // check the prev of the current node
-        Node* newNodeAbove = new Node(element);
-        current->up = newNodeAbove;
-        newNodeAbove->down = current;
-        currentLevel++;
+        for(const Node* node = head[level].next; node != nullptr; node = node->links()[level].next)
+            eleNum++;
+    }
 
+    return eleNum;
+}
 
-        // if it needs a new level
-        if(totalLevel==currentLevel)
-        {
-            Node* currentHead = head;
-            Node* currentTail = current;
-            current = current->up;
-            Node* newHead = new Node(SkipListKind::NegInf);
-            Node* newTail = new Node(SkipListKind::PosInf);
-            newHead->down = currentHead;
-            currentHead->up = newHead;
 
-            newHead->next = current;
-            current->prev = newHead;
-            current->next = newTail;
-            newTail->prev = current;
+template <typename ElementType, typename NodeAllocator>
+bool SkipListSet<ElementType, NodeAllocator>::isElementOnLevel(const ElementType& element, unsigned int level) const
+{
+    unsigned int rank = 0;
+    const Node* next = lastBefore(element, rank)[0].next;
 
-            while(currentTail->next)
-                currentTail=currentTail->next;
+    return next != nullptr && !(element < next->value) && level < next->height;
+}
 
-            currentTail->up = newTail;
-            newTail->down = currentTail;
 
-            head = newHead;
-            totalLevel++;
 
-            // std::cout << "N->next->next << " " << std::endl;
-        }
+template <typename ElementType, typename NodeAllocator>
+typename SkipListSet<ElementType, NodeAllocator>::ConstIterator
+SkipListSet<ElementType, NodeAllocator>::begin() const noexcept
+{
+    return ConstIterator{head[0].next};
+}
 
-        // if there's already the level existing
-        else
-        {
-            Node* currentPrev = current->prev;
-            Node* currentNext = current->next;
-            current = current->up;
-
-            // // connect with the previous node
-            while(currentPrev->up == nullptr)
-                currentPrev = currentPrev->prev;
-
-            currentPrev = currentPrev->up;
-            currentPrev->next = current;
-            current->prev = currentPrev;
-
-            // // connect with the next node
-            while(currentNext->up == nullptr)
-            {
-                if(currentNext->key == SkipListKey{SkipListKind::PosInf, ElementType()})
-                    return;
-                currentNext = currentNext->next;
-            }
-            currentNext = currentNext->up;
-            currentNext->prev = current;
-            current->next = currentNext;
-        }
-    }
+
+template <typename ElementType, typename NodeAllocator>
+typename SkipListSet<ElementType, NodeAllocator>::ConstIterator
+SkipListSet<ElementType, NodeAllocator>::end() const noexcept
+{
+    return ConstIterator{};
 }
 
 
-template <typename ElementType>
-bool SkipListSet<ElementType>::contains(const ElementType& element) const
+// lowerBound() goes down the skip list just as contains() does; the node
+// after the last one it stops at is the smallest not less than the element.
+// upperBound() does the same, except that it passes the element itself, too.
+
+template <typename ElementType, typename NodeAllocator>
+typename SkipListSet<ElementType, NodeAllocator>::ConstIterator
+SkipListSet<ElementType, NodeAllocator>::lowerBound(const ElementType& element) const
 {
-    const SkipListKey k = SkipListKey{SkipListKind::Normal, element};
+    unsigned int rank = 0;
+    return ConstIterator{lastBefore(element, rank)[0].next};
+}
 
-    Node* current = head;
-    // std::cout << head 
 
-    while(current)
-    {
-        if(current->key == k)
-            return true;
+template <typename ElementType, typename NodeAllocator>
+typename SkipListSet<ElementType, NodeAllocator>::ConstIterator
+SkipListSet<ElementType, NodeAllocator>::upperBound(const ElementType& element) const
+{
+    ConstIterator i = lowerBound(element);
 
-        if(current->down == nullptr)
-            if(k < current->next->key)
-                return false;
-            else
-                current = current->next;
+    if(i.node != nullptr && !(element < i.node->value))
+        ++i;
 
-        else
-            if(k < current->next->key)
-                current = current->down;
-            else
-                current=current->next;
-                        
-    }
+    return i;
+}
 
-    return false;
+
+template <typename ElementType, typename NodeAllocator>
+SortedRange<typename SkipListSet<ElementType, NodeAllocator>::ConstIterator>
+SkipListSet<ElementType, NodeAllocator>::range(const ElementType& low, const ElementType& high) const
+{
+    if(!(low < high))
+        return SortedRange<ConstIterator>{end(), end()};
+
+    return SortedRange<ConstIterator>{lowerBound(low), lowerBound(high)};
 }
 
 
-template <typename ElementType>
-unsigned int SkipListSet<ElementType>::size() const noexcept
+template <typename ElementType, typename NodeAllocator>
+unsigned int SkipListSet<ElementType, NodeAllocator>::rank(const ElementType& element) const
 {
-    return elementNum;
+    unsigned int less = 0;
+    lastBefore(element, less);
+    return less;
 }
 
 
-template <typename ElementType>
-unsigned int SkipListSet<ElementType>::levelCount() const noexcept
+// select() goes down the skip list, following each link whose span doesn't
+// take it past the position it's looking for (counting the head as being
+// at position 0 and the elements from 1).
+
+template <typename ElementType, typename NodeAllocator>
+const ElementType& SkipListSet<ElementType, NodeAllocator>::select(unsigned int position) const
 {
-    unsigned int levelNum=0;
-    if(head!=nullptr)
+    if(position >= elementNum)
+        throw std::out_of_range{"SkipListSet::select(): no element at that position"};
+
+    unsigned int target = position + 1;
+    unsigned int passed = 0;
+    const Link* links = head;
+    const Node* node = nullptr;
+
+    for(unsigned int lvl = levels; lvl-- > 0; )
     {
-        Node* temp = head;
-        while(temp)
+        while(passed + links[lvl].span <= target)
         {
-            levelNum++;
-            temp = temp->down;
+            passed += links[lvl].span;
+            node = links[lvl].next;
+            links = node->links();
         }
+
+        if(passed == target)
+            break;
     }
 
-    return levelNum;
+    return node->value;
 }
 
 
-template <typename ElementType>
-unsigned int SkipListSet<ElementType>::elementsOnLevel(unsigned int level) const noexcept
+
+template <typename ElementType, typename NodeAllocator>
+SkipListSet<ElementType, NodeAllocator>::ConstIterator::ConstIterator() noexcept
+    : node{nullptr}
 {
-    unsigned int eleNum = 0;;
-    if(level < levelCount())
-    {
-        Node* current = head;
-        for(int i=this->levelCount()-1; i>level; i--)
-            current = current->down;
+}
 
-        while(current->next->next != nullptr)
-        {
-            current = current->next;
-            eleNum++;
-        }
-    
-    }
 
-    
-    return eleNum;
+template <typename ElementType, typename NodeAllocator>
+SkipListSet<ElementType, NodeAllocator>::ConstIterator::ConstIterator(const Node* node) noexcept
+    : node{node}
+{
 }
 
 
-template <typename ElementType>
-bool SkipListSet<ElementType>::isElementOnLevel(const ElementType& element, unsigned int level) const
+template <typename ElementType, typename NodeAllocator>
+const ElementType& SkipListSet<ElementType, NodeAllocator>::ConstIterator::operator*() const noexcept
 {
-    if(level < levelCount())
-    {
-        
-        Node* current = head;
-        int lvl = levelCount()-level-1;
-        while(lvl!=0)
-        {
-            current = current->down;
-            lvl--;
-        }
+    return node->value;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+const ElementType* SkipListSet<ElementType, NodeAllocator>::ConstIterator::operator->() const noexcept
+{
+    return &node->value;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+typename SkipListSet<ElementType, NodeAllocator>::ConstIterator&
+SkipListSet<ElementType, NodeAllocator>::ConstIterator::operator++() noexcept
+{
+    node = node->links()[0].next;
+    return *this;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+typename SkipListSet<ElementType, NodeAllocator>::ConstIterator
+SkipListSet<ElementType, NodeAllocator>::ConstIterator::operator++(int) noexcept
+{
+    ConstIterator old{*this};
+    ++*this;
+    return old;
+}
 
-        while(current->next != nullptr)
-        {
-            if(current->key == SkipListKey{SkipListKind::Normal, element})
-            {
-                return true;
-            }
-            current = current->next;
-        }
-    }
+
+template <typename ElementType, typename NodeAllocator>
+bool SkipListSet<ElementType, NodeAllocator>::ConstIterator::operator==(const ConstIterator& i) const noexcept
+{
+    return node == i.node;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+bool SkipListSet<ElementType, NodeAllocator>::ConstIterator::operator!=(const ConstIterator& i) const noexcept
+{
+    return node != i.node;
+}
+
+
+
+template <typename ElementType, typename NodeAllocator>
+typename SkipListSet<ElementType, NodeAllocator>::Link*
+SkipListSet<ElementType, NodeAllocator>::Node::links() noexcept
+{
+    return reinterpret_cast<Link*>(reinterpret_cast<char*>(this) + LINKS_OFFSET);
+}
 
 
-    return false;
+template <typename ElementType, typename NodeAllocator>
+const typename SkipListSet<ElementType, NodeAllocator>::Link*
+SkipListSet<ElementType, NodeAllocator>::Node::links() const noexcept
+{
+    return reinterpret_cast<const Link*>(reinterpret_cast<const char*>(this) + LINKS_OFFSET);
 }
 
 
@@ -629,98 +1101,238 @@ bool SkipListSet<ElementType>::isElementOnLevel(const ElementType& element, unsi
 // =============================================
 
 
-template <typename ElementType>
-void SkipListSet<ElementType>::copyNode(const SkipListSet& s, Node* targetHead)
-{
-    targetHead = new Node(SkipListKind::NegInf);
-    Node* sNode = s.head;
-    Node* current = targetHead;
+// copyNode() fills this (empty) SkipListSet with copies of the nodes of
+// another one, from left to right, so that every element occupies the
+// same levels in the copy as in the original.
 
-    Node** arr = new Node* [s.levelCount()];
-    int lvl = s.levelCount()-1;
-    arr[lvl] = targetHead;
+template <typename ElementType, typename NodeAllocator>
+void SkipListSet<ElementType, NodeAllocator>::copyNode(const SkipListSet& s)
+{
+    LevelEnds ends;
+    startBuilding(s.levels, ends);
 
-    // // creating NegInf nodes
-    while(sNode->down)
+    try
     {
-        lvl--;
-        Node* newNode = new Node(SkipListKind::NegInf);
-        current->down = newNode;
-        newNode->up = current;
-        Node* temp = newNode;
-
-        arr[lvl] = temp; // just for checking
-        current = current->down;
-        sNode = sNode->down;
+        for(const Node* sNode = s.head[0].next; sNode != nullptr; sNode = sNode->links()[0].next)
+            append(makeNode(sNode->value, sNode->height), ends);
     }
-
-    // copy other keys
-    while(sNode->next == nullptr || sNode->next->key < SkipListKey(SkipListKind::PosInf, ElementType()))
+    catch (...)
     {
-        sNode = sNode->next;
-        Node* n = sNode;
+        deleteAllNodes();
+        throw;
+    }
 
-        Node* newRowNode = new Node(*n);
-        // std::cout << &newRowNode << std::endl;
-        current->next = newRowNode;
-        newRowNode->prev = current;
+    finishBuilding(ends);
+}
+
+
+// buildLevels() fills this (empty) SkipListSet with count distinct elements
+// in ascending order, from left to right (as copyNode() does), giving the
+// i-th element the levels described in addAll().
 
-        current = current->next;
+template <typename ElementType, typename NodeAllocator>
+void SkipListSet<ElementType, NodeAllocator>::buildLevels(const ElementType** sorted, unsigned int count)
+{
+    unsigned int levelCount = 1;
+
+    while(levelCount < MAX_LEVEL_COUNT && (1u << levelCount) <= count)
+        levelCount++;
 
-        Node* temp = newRowNode;
-        arr[0] = temp;
-        
-        Node* sColumnNode = sNode;
-        Node* columnNode = current;
+    LevelEnds ends;
+    startBuilding(levelCount, ends);
 
-        int i=1;
-        while(sColumnNode->up)
+    try
+    {
+        for(unsigned int i = 1; i <= count; i++)
         {
-            sColumnNode=sColumnNode->up;
-            Node* newColumnNode = new Node(*sColumnNode);
-            columnNode->up = newColumnNode;
-            newColumnNode->down = columnNode;
-
-            Node* temp2 = arr[i];
-            temp2->next = newColumnNode;
-            newColumnNode->prev = temp2;
-
-            temp2 = temp2->next;
-            arr[i] = temp2;
-            columnNode = columnNode->up;
-            i++;
+            unsigned int height = 1;
+
+            while(height < levelCount && i % (1u << height) == 0)
+                height++;
+
+            append(makeNode(*sorted[i - 1], height), ends);
         }
     }
+    catch (...)
+    {
+        deleteAllNodes();
+        throw;
+    }
+
+    finishBuilding(ends);
+}
 
-    for(int i=0; i<s.levelCount(); i++)
+
+// deleteAllNodes() destroys every node, following the bottom level, which
+// every node occupies, leaving the SkipListSet empty.
+
+template <typename ElementType, typename NodeAllocator>
+void SkipListSet<ElementType, NodeAllocator>::deleteAllNodes() noexcept
+{
+    Node* node = head[0].next;
+
+    while(node != nullptr)
     {
-        arr[i] = nullptr;
-        delete arr[i];
+        Node* next = node->links()[0].next;
+
+        if constexpr (NodeAllocator::releasesAllAtOnce)
+            node->~Node();
+        else
+            freeNode(node);
+
+        node = next;
     }
 
-    delete[] arr;
+    head[0] = Link{nullptr, 0};
+    levels = 0;
+    elementNum = 0;
 }
 
 
-template <typename ElementType>
-void SkipListSet<ElementType>::deleteAllNodes(SkipListSet& s) const
+// startBuilding(), append(), and finishBuilding() build a skip list from
+// left to right: startBuilding() gives the (empty) SkipListSet the given
+// number of levels, append() links a node onto the end of every level it
+// occupies, and finishBuilding() links the last node on each level to the
+// end of that level.
+
+template <typename ElementType, typename NodeAllocator>
+void SkipListSet<ElementType, NodeAllocator>::startBuilding(unsigned int levelCount, LevelEnds& ends) noexcept
+{
+    levels = levelCount;
+
+    for(unsigned int lvl = 0; lvl < levels; lvl++)
+    {
+        head[lvl] = Link{nullptr, 0};
+        ends.links[lvl] = &head[lvl];
+        ends.positions[lvl] = 0;
+    }
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+void SkipListSet<ElementType, NodeAllocator>::append(Node* node, LevelEnds& ends) noexcept
+{
+    elementNum++;
+
+    for(unsigned int lvl = 0; lvl < node->height; lvl++)
+    {
+        ends.links[lvl]->next = node;
+        ends.links[lvl]->span = elementNum - ends.positions[lvl];
+        ends.links[lvl] = &node->links()[lvl];
+        ends.positions[lvl] = elementNum;
+    }
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+void SkipListSet<ElementType, NodeAllocator>::finishBuilding(LevelEnds& ends) noexcept
+{
+    for(unsigned int lvl = 0; lvl < levels; lvl++)
+        ends.links[lvl]->span = elementNum + 1 - ends.positions[lvl];
+}
+
+
+// lastBefore() goes down the skip list from the top level, stopping on each
+// level at the last link before where the element is (or would be), and
+// returns the links of the node (or head) where it stops on the bottom
+// level, adding the spans of the links it follows to rank.  A node that's
+// been found not to come before the element isn't compared with it again
+// on the levels below.
+
+template <typename ElementType, typename NodeAllocator>
+const typename SkipListSet<ElementType, NodeAllocator>::Link*
+SkipListSet<ElementType, NodeAllocator>::lastBefore(const ElementType& element, unsigned int& rank) const
 {
-    Node* sNode = s.head;
-    Node* sHead = s.head;
+    LookupCounter::Lookup uncounted{nullptr};
+    return lastBefore(element, rank, uncounted);
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+const typename SkipListSet<ElementType, NodeAllocator>::Link*
+SkipListSet<ElementType, NodeAllocator>::lastBefore(
+    const ElementType& element, unsigned int& rank, LookupCounter::Lookup& lookup) const
+{
+    const Link* links = head;
+    const Node* notBefore = nullptr;
 
-    while(sHead != nullptr)
+    for(unsigned int lvl = levels; lvl-- > 0; )
     {
-        sHead = sHead->down;
-        while(sNode != nullptr)
+        while(links[lvl].next != notBefore)
         {
-            Node* dNode = sNode;
-            sNode = sNode->next;
-            delete dNode;
+            lookup.compared();
+
+            if(!(links[lvl].next->value < element))
+                break;
+
+            lookup.probed();
+            rank += links[lvl].span;
+            links = links[lvl].next->links();
         }
+
+        notBefore = links[lvl].next;
     }
+
+    return links;
 }
 
 
+// heightLimit() returns the most levels that an element added now can
+// occupy, counting the element in the size of the set.
 
-#endif // SKIPLISTSET_HPP
+template <typename ElementType, typename NodeAllocator>
+unsigned int SkipListSet<ElementType, NodeAllocator>::heightLimit() const noexcept
+{
+    unsigned int limit = EXTRA_LEVELS;
+
+    for(unsigned int n = elementNum + 1; n > 1; n >>= 1)
+        limit++;
 
+    return limit < MAX_LEVEL_COUNT ? limit : MAX_LEVEL_COUNT;
+}
+
+
+// makeNode() allocates the memory for a node and the given number of links
+// from the NodeAllocator, and constructs the node in it, with every link
+// leading nowhere.
+
+template <typename ElementType, typename NodeAllocator>
+typename SkipListSet<ElementType, NodeAllocator>::Node*
+SkipListSet<ElementType, NodeAllocator>::makeNode(const ElementType& element, unsigned int height)
+{
+    void* memory = nodeAllocator.allocate(nodeBytes(height));
+    Node* node = nullptr;
+
+    try
+    {
+        node = new (memory) Node{element, height};
+    }
+    catch (...)
+    {
+        nodeAllocator.deallocate(memory, nodeBytes(height));
+        throw;
+    }
+
+    std::uninitialized_fill_n(node->links(), height, Link{nullptr, 0});
+    return node;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+void SkipListSet<ElementType, NodeAllocator>::freeNode(Node* node) noexcept
+{
+    std::size_t bytes = nodeBytes(node->height);
+    node->~Node();
+    nodeAllocator.deallocate(node, bytes);
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+std::size_t SkipListSet<ElementType, NodeAllocator>::nodeBytes(unsigned int height) noexcept
+{
+    return LINKS_OFFSET + height * sizeof(Link);
+}
+
+
+
+#endif // SKIPLISTSET_HPP
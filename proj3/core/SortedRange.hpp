@@ -0,0 +1,119 @@
+// SortedRange.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Support for ranges of elements in ascending order, which the ordered Set
+// implementations (AVLSet and SkipListSet) both take and give.
+//
+// Their addAll() member functions can build their whole structure at once
+// from the distinct elements of a range in ascending order.  Rather than
+// copying the elements, sortDistinct() arranges pointers to them, so the
+// only copy of each element made is the one that ends up in the Set.
+//
+// Their range() member functions return a SortedRange, which is a pair of
+// iterators into the Set that can be used in a range-based for loop.
+
+#ifndef SORTEDRANGE_HPP
+#define SORTEDRANGE_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+
+
+// sortDistinct() fills the given array (which must have room for
+// end - begin pointers) with pointers to the elements of [begin, end) in
+// ascending order, leaving out duplicates, and returns how many it stored.
+// When presorted is true, the range is checked in one pass, and sorting is
+// skipped if it really is in ascending order.
+
+template <typename ElementType>
+unsigned int sortDistinct(
+    const ElementType* begin, const ElementType* end, bool presorted,
+    const ElementType** sorted)
+{
+    unsigned int count = static_cast<unsigned int>(end - begin);
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        sorted[i] = begin + i;
+    }
+
+    if (!presorted || !std::is_sorted(begin, end))
+    {
+        std::sort(
+            sorted, sorted + count,
+            [](const ElementType* a, const ElementType* b) { return *a < *b; });
+    }
+
+    unsigned int distinct = 0;
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (distinct == 0 || *sorted[distinct - 1] < *sorted[i])
+        {
+            sorted[distinct] = sorted[i];
+            ++distinct;
+        }
+    }
+
+    return distinct;
+}
+
+
+
+// A SortedRange is the elements from one iterator up to (but not including)
+// another, in ascending order.  It refers to elements in the Set it came
+// from, so it's only valid as long as its iterators are.
+
+template <typename Iterator>
+class SortedRange
+{
+public:
+    SortedRange(Iterator first, Iterator last);
+
+    const Iterator& begin() const noexcept;
+    const Iterator& end() const noexcept;
+
+    // count() returns the number of elements in the range, which takes
+    // time proportional to that number.
+    unsigned int count() const;
+
+private:
+    Iterator first;
+    Iterator last;
+};
+
+
+template <typename Iterator>
+SortedRange<Iterator>::SortedRange(Iterator first, Iterator last)
+    : first{std::move(first)}, last{std::move(last)}
+{
+}
+
+
+template <typename Iterator>
+const Iterator& SortedRange<Iterator>::begin() const noexcept
+{
+    return first;
+}
+
+
+template <typename Iterator>
+const Iterator& SortedRange<Iterator>::end() const noexcept
+{
+    return last;
+}
+
+
+template <typename Iterator>
+unsigned int SortedRange<Iterator>::count() const
+{
+    return static_cast<unsigned int>(std::distance(first, last));
+}
+
+
+
+#endif // SORTEDRANGE_HPP
@@ -0,0 +1,44 @@
+// SuggestionSource.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A SuggestionSource is an index of a dictionary that can find suggested
+// spellings for a misspelled word faster than (or better than) trying edits
+// of the word against a Set.  A WordChecker can be given one to use in
+// place of its own edits.  The implementations are:
+//
+//   * DeletionIndex, which finds the words closest to a misspelling by
+//     looking up its delete variants.
+//
+//   * LevenshteinTrie, which walks a trie of the words, ranking the closest
+//     ones by distance and (optionally) by how common they are.
+//
+// A SuggestionSource is never changed once it's built, so it can be
+// searched from several threads at once.
+
+#ifndef SUGGESTIONSOURCE_HPP
+#define SUGGESTIONSOURCE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+
+class SuggestionSource
+{
+public:
+    virtual ~SuggestionSource() noexcept = default;
+
+    // suggestionsFor() returns suggested spellings for the given word, best
+    // suggestions first.  The word itself is never suggested.
+    virtual std::vector<std::string> suggestionsFor(const std::string& word) const = 0;
+
+    // memoryUsage() returns the number of bytes of memory the index uses.
+    virtual std::size_t memoryUsage() const noexcept = 0;
+};
+
+
+
+#endif // SUGGESTIONSOURCE_HPP
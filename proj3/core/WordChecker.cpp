@@ -5,80 +5,197 @@
 //
 // Replace and/or augment the implementations below as needed to meet
 // the requirements.
+//
+// findSuggestions() builds every candidate spelling in one edit buffer,
+// changing only the characters that differ from the previous candidate,
+// so that looking up the hundreds of candidates for a word allocates no
+// memory beyond the buffer itself and the suggestions that are found.
 
+#include <cstddef>
+#include <utility>
+#include "StringHashing.hpp"
 #include "WordChecker.hpp"
 
+
+
+namespace
+{
+    constexpr char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    constexpr std::size_t ALPHABET_SIZE = sizeof(ALPHABET) - 1;
+
+
+    // A SuggestionList adds candidates to a vector of suggestions, skipping
+    // any that are already there.  It keeps the hash of each suggestion, so
+    // that checking for a duplicate compares the strings only when their
+    // hashes match.
+
+    class SuggestionList
+    {
+    public:
+        explicit SuggestionList(std::vector<std::string>& suggestions);
+
+        void add(const std::string& candidate);
+
+    private:
+        std::vector<std::string>& suggestions;
+        std::vector<unsigned int> hashes;
+    };
+
+
+    SuggestionList::SuggestionList(std::vector<std::string>& suggestions)
+        : suggestions{suggestions}
+    {
+    }
+
+
+    void SuggestionList::add(const std::string& candidate)
+    {
+        unsigned int hash = StringHashAsFnv1a{}(candidate);
+
+        for (std::size_t i = 0; i < hashes.size(); ++i)
+        {
+            if (hashes[i] == hash && suggestions[i] == candidate)
+            {
+                return;
+            }
+        }
+
+        suggestions.push_back(candidate);
+        hashes.push_back(hash);
+    }
+}
+
+
+
 WordChecker::WordChecker(const Set<std::string>& words)
-    : words{words}
+    : words{words}, suggestionSource{nullptr}
+{
+}
+
+
+WordChecker::WordChecker(const Set<std::string>& words, const SuggestionSource& suggestionSource)
+    : words{words}, suggestionSource{&suggestionSource}
 {
 }
 
 
 bool WordChecker::wordExists(const std::string& word) const
 {
-	return words.contains(word);
+    return words.contains(word);
 }
 
 
 std::vector<std::string> WordChecker::findSuggestions(const std::string& word) const
 {
-	std::vector<std::string> suggestions;
-	std::string alphabets = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-
-	// 1) delete
-	for(int i=0; i<word.size(); i++)
-	{	
-		std::string temp = word;
-		temp = temp.erase(i,1);
-		if(wordExists(temp) && std::find(suggestions.begin(), suggestions.end(), temp) == suggestions.end())
-			suggestions.push_back(temp);
-	}
-
-	// 2) Addition
-	for(int i=0; i<word.size()+1; i++)
-	{
-		for(int j=0; j<alphabets.size(); j++)
-		{
-			std::string temp = word;
-			temp.insert(i,alphabets.substr(j,1));
-			if(wordExists(temp) && std::find(suggestions.begin(), suggestions.end(), temp) == suggestions.end())
-				suggestions.push_back(temp);
-		}
-	}
-
-	// 3) Substitution
-	for(int i=0; i<word.size(); i++)
-	{
-		for(int j=0; j<alphabets.size(); j++)
-		{
-			std::string temp = word;
-			temp.replace(i, 1, alphabets.substr(j,1));
-			if(wordExists(temp) && std::find(suggestions.begin(), suggestions.end(), temp) == suggestions.end())
-				suggestions.push_back(temp);
-		}
-	}
-
-	// 4) Swap
-	for(int i=0; i<word.size()-1; i++)
-	{
-		for (int j=i+1; j<word.size(); j++)
-		{
-			std::string temp = word;
-			std::swap(temp[i],temp[j]);
-			if(wordExists(temp) && std::find(suggestions.begin(), suggestions.end(), temp) == suggestions.end())
-				suggestions.push_back(temp);
-		}
-	}
-
-	// 5) Giving a space
-	for(int i=1; i<word.size(); i++)
-	{
-		std::string temp = word;
-		temp.insert(i," ");
-		if(wordExists(temp) && std::find(suggestions.begin(), suggestions.end(), temp) == suggestions.end())
-				suggestions.push_back(temp);
-	}
+    if (suggestionSource != nullptr)
+    {
+        return suggestionSource->suggestionsFor(word);
+    }
+
+    std::vector<std::string> suggestions;
+    SuggestionList found{suggestions};
+
+    std::size_t length = word.length();
+
+    // Every candidate is at most one character longer than the word, so the
+    // buffer never has to grow once it's been reserved.
+    std::string candidate;
+    candidate.reserve(length + 1);
+
+    auto check =
+        [&]()
+        {
+            if (wordExists(candidate))
+            {
+                found.add(candidate);
+            }
+        };
+
+    // 1) Deletion: the candidate for position i is the word without its
+    // ith character, which differs from the candidate for position i - 1
+    // only at position i - 1.
+    if (length > 0)
+    {
+        candidate.assign(word, 1, std::string::npos);
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            if (i > 0)
+            {
+                candidate[i - 1] = word[i - 1];
+            }
+
+            check();
+        }
+    }
+
+    // 2) Insertion: each letter in turn goes into the slot at position i;
+    // moving the slot one position to the right fills in the character the
+    // slot moved past.
+    candidate.assign(1, ' ');
+    candidate.append(word);
+
+    for (std::size_t i = 0; i <= length; ++i)
+    {
+        if (i > 0)
+        {
+            candidate[i - 1] = word[i - 1];
+        }
+
+        for (std::size_t j = 0; j < ALPHABET_SIZE; ++j)
+        {
+            candidate[i] = ALPHABET[j];
+            check();
+        }
+    }
+
+    // 3) Substitution: each letter in turn replaces the ith character,
+    // which is put back afterward.
+    candidate.assign(word);
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        for (std::size_t j = 0; j < ALPHABET_SIZE; ++j)
+        {
+            candidate[i] = ALPHABET[j];
+            check();
+        }
+
+        candidate[i] = word[i];
+    }
+
+    // 4) Swapping: every pair of characters, not only adjacent ones, is
+    // swapped and then swapped back.
+    for (std::size_t i = 0; i + 1 < length; ++i)
+    {
+        for (std::size_t j = i + 1; j < length; ++j)
+        {
+            std::swap(candidate[i], candidate[j]);
+            check();
+            std::swap(candidate[i], candidate[j]);
+        }
+    }
+
+    // 5) Splitting: a space goes between positions i - 1 and i; moving it
+    // one position to the right puts the character it moved past in its
+    // place.
+    if (length > 1)
+    {
+        candidate.assign(1, word[0]);
+        candidate.push_back(' ');
+        candidate.append(word, 1, std::string::npos);
+
+        for (std::size_t i = 1; i < length; ++i)
+        {
+            if (i > 1)
+            {
+                candidate[i - 1] = word[i - 1];
+                candidate[i] = ' ';
+            }
+
+            check();
+        }
+    }
 
     return suggestions;
 }
-
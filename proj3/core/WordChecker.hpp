@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 #include "Set.hpp"
+#include "SuggestionSource.hpp"
 
 
 
@@ -31,6 +32,14 @@ public:
     WordChecker(const Set<std::string>& words);
 
 
+    // A WordChecker can instead be given a SuggestionSource, such as a
+    // DeletionIndex (built from the same words as the Set), to find its
+    // suggestions in.  It stores a reference to the source, too, and
+    // findSuggestions() then returns whatever the source suggests, rather
+    // than trying the five kinds of edits on the word.
+    WordChecker(const Set<std::string>& words, const SuggestionSource& suggestionSource);
+
+
     // wordExists() returns true if the given word is spelled correctly,
     // false otherwise.
     bool wordExists(const std::string& word) const;
@@ -44,6 +53,7 @@ public:
 
 private:
     const Set<std::string>& words;
+    const SuggestionSource* suggestionSource;
 };
 
 
@@ -0,0 +1,168 @@
+// AVLLayoutExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares how quickly an AVLSet looks words up when it was built one
+// element at a time with add(), when it was built all at once with
+// addAll(), and after freeze() has laid it out in breadth-first order,
+// alongside a std::set (a red-black tree of separately allocated nodes
+// linked by pointers) for reference.  Every word in a word file is looked
+// up, in a shuffled order (with a fixed seed), along with the same number
+// of words that aren't present (each word with a '#' appended).  Then the
+// same is done with ints, one per word, since comparing strings costs
+// enough to hide some of the difference the layout makes.
+//
+// Input: the path to the word file.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 10;
+
+
+    template <typename SetType, typename ElementType>
+    void measure(
+        const std::string& name, const SetType& set, int height,
+        const std::vector<ElementType>& elements, const std::vector<ElementType>& misses)
+    {
+        unsigned int found = 0;
+
+        double hitTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const ElementType& element : elements)
+                {
+                    found += set.count(element);
+                }
+            });
+
+        double missTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const ElementType& element : misses)
+                {
+                    found += set.count(element);
+                }
+            });
+
+        std::cout << std::left << std::setw(24) << name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << hitTime * 1000.0 / elements.size()
+                  << std::setw(12) << missTime * 1000.0 / misses.size()
+                  << std::setw(8) << height
+                  << std::setw(10) << found / REPETITIONS
+                  << std::endl;
+    }
+
+
+    // CountingAVLSet gives an AVLSet the count() member function that the
+    // std::set has, so that measure() can treat them alike.
+    template <typename ElementType>
+    struct CountingAVLSet
+    {
+        const AVLSet<ElementType>& set;
+
+        unsigned int count(const ElementType& element) const
+        {
+            return set.contains(element) ? 1 : 0;
+        }
+    };
+
+
+    template <typename ElementType>
+    void measureAll(
+        const std::vector<ElementType>& sorted, const std::vector<ElementType>& shuffled,
+        const std::vector<ElementType>& misses)
+    {
+        {
+            std::set<ElementType> set{sorted.begin(), sorted.end()};
+            measure("std::set", set, -1, shuffled, misses);
+        }
+
+        {
+            AVLSet<ElementType> set;
+
+            for (const ElementType& element : shuffled)
+            {
+                set.add(element);
+            }
+
+            measure("AVLSet, add()", CountingAVLSet<ElementType>{set}, set.height(), shuffled, misses);
+
+            set.freeze();
+            measure("AVLSet, add(), frozen", CountingAVLSet<ElementType>{set}, set.height(), shuffled, misses);
+        }
+
+        {
+            AVLSet<ElementType> set;
+            set.addAll(sorted.data(), sorted.data() + sorted.size(), false);
+            measure("AVLSet, addAll()", CountingAVLSet<ElementType>{set}, set.height(), shuffled, misses);
+
+            set.freeze();
+            measure("AVLSet, addAll(), frozen", CountingAVLSet<ElementType>{set}, set.height(), shuffled, misses);
+        }
+    }
+
+
+    void printHeading(const std::string& heading)
+    {
+        std::cout << std::endl << heading << std::endl;
+        std::cout << std::left << std::setw(24) << "Set"
+                  << std::right << std::setw(12) << "hit nsec"
+                  << std::setw(12) << "miss nsec"
+                  << std::setw(8) << "height"
+                  << std::setw(10) << "found" << std::endl;
+    }
+}
+
+
+
+void runAVLLayoutExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+    std::vector<std::string> shuffled = words;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{46});
+
+    std::vector<std::string> misses;
+
+    for (const std::string& word : shuffled)
+    {
+        misses.push_back(word + "#");
+    }
+
+    std::cout << words.size() << " words, best of " << REPETITIONS << " runs" << std::endl;
+
+    printHeading("std::string elements");
+    measureAll(words, shuffled, misses);
+
+    std::vector<int> numbers;
+    std::vector<int> numberMisses;
+
+    for (int i = 0; i < static_cast<int>(words.size()); ++i)
+    {
+        numbers.push_back(2 * i);
+        numberMisses.push_back(2 * i + 1);
+    }
+
+    std::vector<int> shuffledNumbers = numbers;
+    std::shuffle(shuffledNumbers.begin(), shuffledNumbers.end(), std::mt19937{46});
+    std::shuffle(numberMisses.begin(), numberMisses.end(), std::mt19937{46});
+
+    printHeading("int elements");
+    measureAll(numbers, shuffledNumbers, numberMisses);
+}
@@ -0,0 +1,188 @@
+// BloomFilterExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures how much a BloomFilterSet in front of each kind of Set speeds up
+// WordChecker::findSuggestions(), nearly all of whose lookups are of words
+// that aren't in the set, by finding suggestions for every misspelled word
+// in a text file with and without the filter.  Also reports the size of
+// the filter, how many lookups got past it to the set, and the proportion
+// of those that were wasted on words that weren't there after all.
+//
+// Input: the path to the word file, the path to the text file, and then
+// the false positive rate (the default if the line is blank).
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BloomFilterSet.hpp"
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "FlatHashSet.hpp"
+#include "RadixTreeSet.hpp"
+#include "SkipListSet.hpp"
+#include "StringHashing.hpp"
+#include "TextFileReader.hpp"
+#include "WordChecker.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 5;
+
+
+    using StringBloomFilterSet = BloomFilterSet<std::string, StringHashAsFnv1a>;
+
+
+    // A CountingSet passes every call on to another set, counting the
+    // lookups that reach it and how many of them found something.
+    class CountingSet : public Set<std::string>
+    {
+    public:
+        explicit CountingSet(std::unique_ptr<Set<std::string>> set)
+            : lookups{0}, hits{0}, set{std::move(set)}
+        {
+        }
+
+        virtual bool isImplemented() const noexcept override { return set->isImplemented(); }
+        virtual void add(const std::string& element) override { set->add(element); }
+        virtual bool remove(const std::string& element) override { return set->remove(element); }
+        virtual unsigned int size() const noexcept override { return set->size(); }
+
+        virtual void addAll(const std::string* begin, const std::string* end, bool presorted) override
+        {
+            set->addAll(begin, end, presorted);
+        }
+
+        virtual bool contains(const std::string& element) const override
+        {
+            ++lookups;
+            bool found = set->contains(element);
+            hits += found ? 1 : 0;
+            return found;
+        }
+
+        mutable unsigned long lookups;
+        mutable unsigned long hits;
+
+    private:
+        std::unique_ptr<Set<std::string>> set;
+    };
+
+
+    double timeSuggestions(const Set<std::string>& wordSet, const std::vector<std::string>& misspellings)
+    {
+        WordChecker wordChecker{wordSet};
+
+        return bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const std::string& word : misspellings)
+                {
+                    wordChecker.findSuggestions(word);
+                }
+            });
+    }
+
+
+    void measure(
+        const std::string& name, const std::function<std::unique_ptr<Set<std::string>>()>& makeSet,
+        const std::string& wordFilePath, const std::vector<std::string>& misspellings,
+        double falsePositiveRate)
+    {
+        std::unique_ptr<Set<std::string>> plain = makeSet();
+        WordSetLoader{}.load(wordFilePath, *plain);
+        double plainTime = timeSuggestions(*plain, misspellings);
+        plain.reset();
+
+        StringBloomFilterSet filtered{makeSet(), StringHashAsFnv1a{}, falsePositiveRate};
+        WordSetLoader{}.load(wordFilePath, filtered);
+        double filteredTime = timeSuggestions(filtered, misspellings);
+
+        std::unique_ptr<CountingSet> counting = std::make_unique<CountingSet>(makeSet());
+        CountingSet& counts = *counting;
+        StringBloomFilterSet counted{std::move(counting), StringHashAsFnv1a{}, falsePositiveRate};
+        WordSetLoader{}.load(wordFilePath, counted);
+
+        WordChecker countedChecker{counted};
+
+        for (const std::string& word : misspellings)
+        {
+            countedChecker.findSuggestions(word);
+        }
+
+        double wasted =
+            counts.lookups > 0 ? static_cast<double>(counts.lookups - counts.hits) / counts.lookups : 0.0;
+
+        std::cout << std::left << std::setw(12) << name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << plainTime
+                  << std::setw(12) << filteredTime
+                  << std::setprecision(2)
+                  << std::setw(10) << plainTime / filteredTime
+                  << std::setw(12) << filtered.filterSize()
+                  << std::setw(12) << counts.lookups
+                  << std::setprecision(4)
+                  << std::setw(10) << wasted
+                  << std::endl;
+    }
+}
+
+
+
+void runBloomFilterExperiment()
+{
+    std::string wordFilePath = readLine();
+    std::string textFilePath = readLine();
+    std::string rateLine = readLine();
+    double falsePositiveRate =
+        rateLine.empty() ? StringBloomFilterSet::DEFAULT_FALSE_POSITIVE_RATE : std::stod(rateLine);
+
+    FlatHashSet<std::string, StringHashAsProduct> dictionary{StringHashAsProduct{}};
+    WordSetLoader{}.load(wordFilePath, dictionary);
+
+    std::vector<std::string> misspellings;
+
+    for (TextFileReader reader{textFilePath}; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        if (!dictionary.contains(reader.currentWord()))
+        {
+            misspellings.push_back(reader.currentWord());
+        }
+    }
+
+    std::cout << misspellings.size() << " misspelled words; false positive rate "
+              << falsePositiveRate << "; best of " << REPETITIONS << std::endl;
+    std::cout << std::left << std::setw(12) << "Set"
+              << std::right << std::setw(12) << "plain usec"
+              << std::setw(12) << "bloom usec"
+              << std::setw(10) << "speedup"
+              << std::setw(12) << "bytes"
+              << std::setw(12) << "lookups"
+              << std::setw(10) << "wasted" << std::endl;
+
+    measure(
+        "AVL", []() { return std::make_unique<AVLSet<std::string>>(); },
+        wordFilePath, misspellings, falsePositiveRate);
+
+    measure(
+        "SKIPLIST", []() { return std::make_unique<SkipListSet<std::string>>(); },
+        wordFilePath, misspellings, falsePositiveRate);
+
+    measure(
+        "HASH FLAT",
+        []() { return std::make_unique<FlatHashSet<std::string, StringHashAsProduct>>(StringHashAsProduct{}); },
+        wordFilePath, misspellings, falsePositiveRate);
+
+    measure(
+        "TRIE", []() { return std::make_unique<RadixTreeSet>(); },
+        wordFilePath, misspellings, falsePositiveRate);
+}
@@ -0,0 +1,173 @@
+// ChurnExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures each kind of Set under a mix of additions, removals, and
+// lookups, as a dictionary that users can edit would see, rather than the
+// load-once-then-look-up pattern that the other experiments measure.  Each
+// set starts out holding half of the words in the word file; a quarter of
+// the operations then add a word, a quarter remove one, and the other half
+// look one up, each chosen at random (with a fixed seed) from the whole
+// word file, so that about half of the removals and lookups find their
+// word (which is reported, along with the final size, as a check that
+// every set did the same thing).  Building the starting set isn't timed.
+//
+// Input: the path to the word file.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "FlatHashSet.hpp"
+#include "HashSet.hpp"
+#include "RadixTreeSet.hpp"
+#include "SkipListSet.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 5;
+    constexpr unsigned int OPERATION_COUNT = 1000000;
+
+
+    enum class Operation
+    {
+        Add,
+        Remove,
+        Lookup
+    };
+
+
+    struct Step
+    {
+        Operation operation;
+        const std::string* word;
+    };
+
+
+    std::vector<Step> makeSteps(const std::vector<std::string>& words)
+    {
+        std::mt19937 generator{46};
+        std::uniform_int_distribution<std::size_t> wordDistribution{0, words.size() - 1};
+        std::uniform_int_distribution<unsigned int> operationDistribution{0, 3};
+
+        std::vector<Step> steps;
+        steps.reserve(OPERATION_COUNT);
+
+        for (unsigned int i = 0; i < OPERATION_COUNT; ++i)
+        {
+            unsigned int choice = operationDistribution(generator);
+
+            Operation operation =
+                choice == 0 ? Operation::Add
+                : choice == 1 ? Operation::Remove
+                : Operation::Lookup;
+
+            steps.push_back(Step{operation, &words[wordDistribution(generator)]});
+        }
+
+        return steps;
+    }
+
+
+    template <typename MakeSet>
+    void measure(
+        const std::string& name, MakeSet makeSet,
+        const std::vector<std::string>& initial, const std::vector<Step>& steps)
+    {
+        Stopwatch stopwatch;
+        double best = 0.0;
+        unsigned long finalSize = 0;
+        double hitRate = 0.0;
+
+        for (unsigned int i = 0; i < REPETITIONS; ++i)
+        {
+            auto set = makeSet();
+            set->addAll(initial.data(), initial.data() + initial.size(), false);
+
+            unsigned long found = 0;
+
+            stopwatch.start();
+
+            for (const Step& step : steps)
+            {
+                switch (step.operation)
+                {
+                case Operation::Add:
+                    set->add(*step.word);
+                    break;
+
+                case Operation::Remove:
+                    found += set->remove(*step.word) ? 1 : 0;
+                    break;
+
+                case Operation::Lookup:
+                    found += set->contains(*step.word) ? 1 : 0;
+                    break;
+                }
+            }
+
+            stopwatch.stop();
+
+            if (i == 0 || stopwatch.lastDuration() < best)
+            {
+                best = stopwatch.lastDuration();
+            }
+
+            finalSize = set->size();
+            hitRate = static_cast<double>(found) / std::count_if(
+                steps.begin(), steps.end(),
+                [](const Step& step) { return step.operation != Operation::Add; });
+        }
+
+        std::cout << std::left << std::setw(12) << name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << best * 1000.0 / steps.size()
+                  << std::setw(14) << perSecond(steps.size(), best) / 1000000.0
+                  << std::setw(12) << finalSize
+                  << std::setprecision(3) << std::setw(10) << hitRate << std::endl;
+    }
+}
+
+
+
+void runChurnExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+    std::shuffle(words.begin(), words.end(), std::mt19937{46});
+
+    std::vector<std::string> initial{words.begin(), words.begin() + words.size() / 2};
+    std::vector<Step> steps = makeSteps(words);
+
+    std::cout << initial.size() << " of " << words.size() << " words to start, "
+              << steps.size() << " operations, best of " << REPETITIONS << std::endl;
+    std::cout << std::left << std::setw(12) << "Set"
+              << std::right << std::setw(12) << "nsec/op"
+              << std::setw(14) << "Mops/sec"
+              << std::setw(12) << "final size"
+              << std::setw(10) << "found" << std::endl;
+
+    measure(
+        "HASH",
+        []() { return std::make_unique<HashSet<std::string, StringHashAsProduct>>(StringHashAsProduct{}); },
+        initial, steps);
+
+    measure(
+        "HASH FLAT",
+        []() { return std::make_unique<FlatHashSet<std::string, StringHashAsProduct>>(StringHashAsProduct{}); },
+        initial, steps);
+
+    measure("AVL", []() { return std::make_unique<AVLSet<std::string>>(); }, initial, steps);
+    measure("SKIPLIST", []() { return std::make_unique<SkipListSet<std::string>>(); }, initial, steps);
+    measure("TRIE", []() { return std::make_unique<RadixTreeSet>(); }, initial, steps);
+}
@@ -0,0 +1,269 @@
+// ConcurrentSkipListExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures how the throughput of a ConcurrentSkipListSet scales with the
+// number of threads using it at once, against a SkipListSet that's shared
+// by putting it behind a std::shared_mutex (so lookups can still happen
+// at the same time, but additions and removals lock everyone else out).
+// Each set starts out holding half of the words in the word file; the
+// threads then share a fixed number of operations between them, each
+// looking up, adding, or removing a word chosen at random (with a fixed
+// seed per thread) from the whole word file.  Two mixes are measured: one
+// with only lookups, and one with 5% additions and 5% removals.  Starting
+// the threads and building the starting set aren't timed.
+//
+// Input: the path to the word file.
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentSkipListSet.hpp"
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "SkipListSet.hpp"
+#include "Stopwatch.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 3;
+    constexpr unsigned int OPERATION_COUNT = 1600000;
+    const unsigned int threadCounts[] = {1, 2, 4, 8, 16};
+
+
+    enum class Operation
+    {
+        Add,
+        Remove,
+        Lookup
+    };
+
+
+    struct Step
+    {
+        Operation operation;
+        const std::string* word;
+    };
+
+
+    // A LockedSkipListSet shares a SkipListSet between threads with a
+    // std::shared_mutex: lookups share it, while additions and removals
+    // take it for themselves.
+    class LockedSkipListSet
+    {
+    public:
+        void add(const std::string& element)
+        {
+            std::unique_lock<std::shared_mutex> lock{mutex};
+            set.add(element);
+        }
+
+        bool remove(const std::string& element)
+        {
+            std::unique_lock<std::shared_mutex> lock{mutex};
+            return set.remove(element);
+        }
+
+        bool contains(const std::string& element) const
+        {
+            std::shared_lock<std::shared_mutex> lock{mutex};
+            return set.contains(element);
+        }
+
+    private:
+        SkipListSet<std::string> set;
+        mutable std::shared_mutex mutex;
+    };
+
+
+    std::vector<Step> makeSteps(
+        const std::vector<std::string>& words, unsigned int count,
+        unsigned int updatePercent, unsigned int seed)
+    {
+        std::mt19937 generator{seed};
+        std::uniform_int_distribution<std::size_t> wordDistribution{0, words.size() - 1};
+        std::uniform_int_distribution<unsigned int> percentDistribution{0, 99};
+
+        std::vector<Step> steps;
+        steps.reserve(count);
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            unsigned int percent = percentDistribution(generator);
+
+            Operation operation =
+                percent < updatePercent / 2 ? Operation::Add
+                : percent < updatePercent ? Operation::Remove
+                : Operation::Lookup;
+
+            steps.push_back(Step{operation, &words[wordDistribution(generator)]});
+        }
+
+        return steps;
+    }
+
+
+    template <typename SetType>
+    void run(SetType& set, const std::vector<Step>& steps, unsigned long& found)
+    {
+        unsigned long count = 0;
+
+        for (const Step& step : steps)
+        {
+            switch (step.operation)
+            {
+            case Operation::Add:
+                set.add(*step.word);
+                break;
+
+            case Operation::Remove:
+                count += set.remove(*step.word) ? 1 : 0;
+                break;
+
+            case Operation::Lookup:
+                count += set.contains(*step.word) ? 1 : 0;
+                break;
+            }
+        }
+
+        found = count;
+    }
+
+
+    // timeOnThreads() returns the time (in microseconds) that the given
+    // number of threads take to run their share of the operations, from
+    // when they're all told to start until the last of them finishes.
+    template <typename SetType>
+    double timeOnThreads(
+        SetType& set, const std::vector<std::vector<Step>>& steps, unsigned long& found)
+    {
+        std::atomic<bool> go{false};
+        std::vector<unsigned long> counts(steps.size());
+        std::vector<std::thread> threads;
+
+        for (unsigned int i = 0; i < steps.size(); ++i)
+        {
+            threads.emplace_back(
+                [&, i]()
+                {
+                    while (!go.load(std::memory_order_acquire))
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    run(set, steps[i], counts[i]);
+                });
+        }
+
+        Stopwatch stopwatch;
+        stopwatch.start();
+        go.store(true, std::memory_order_release);
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        stopwatch.stop();
+
+        found = 0;
+
+        for (unsigned long count : counts)
+        {
+            found += count;
+        }
+
+        return stopwatch.lastDuration();
+    }
+
+
+    template <typename SetType>
+    double measure(
+        const std::vector<std::string>& initial, const std::vector<std::vector<Step>>& steps,
+        unsigned long& found)
+    {
+        double best = 0.0;
+
+        for (unsigned int i = 0; i < REPETITIONS; ++i)
+        {
+            SetType set;
+
+            for (const std::string& word : initial)
+            {
+                set.add(word);
+            }
+
+            double duration = timeOnThreads(set, steps, found);
+
+            if (i == 0 || duration < best)
+            {
+                best = duration;
+            }
+        }
+
+        return best;
+    }
+
+
+    void measureMix(
+        const std::string& heading, const std::vector<std::string>& words,
+        const std::vector<std::string>& initial, unsigned int updatePercent)
+    {
+        std::cout << std::endl << heading << std::endl;
+        std::cout << std::left << std::setw(10) << "threads"
+                  << std::right << std::setw(16) << "concurrent"
+                  << std::setw(16) << "locked"
+                  << std::setw(12) << "speedup" << std::endl;
+
+        for (unsigned int threadCount : threadCounts)
+        {
+            std::vector<std::vector<Step>> steps;
+
+            for (unsigned int i = 0; i < threadCount; ++i)
+            {
+                steps.push_back(makeSteps(words, OPERATION_COUNT / threadCount, updatePercent, 46 + i));
+            }
+
+            unsigned long concurrentFound = 0;
+            unsigned long lockedFound = 0;
+
+            double concurrent = measure<ConcurrentSkipListSet<std::string>>(initial, steps, concurrentFound);
+            double locked = measure<LockedSkipListSet>(initial, steps, lockedFound);
+
+            std::cout << std::left << std::setw(10) << threadCount
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(16) << perSecond(OPERATION_COUNT, concurrent) / 1000000.0
+                      << std::setw(16) << perSecond(OPERATION_COUNT, locked) / 1000000.0
+                      << std::setw(12) << locked / concurrent << std::endl;
+        }
+    }
+}
+
+
+
+void runConcurrentSkipListExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+    std::shuffle(words.begin(), words.end(), std::mt19937{46});
+
+    std::vector<std::string> initial{words.begin(), words.begin() + words.size() / 2};
+
+    std::cout << initial.size() << " of " << words.size() << " words to start, "
+              << OPERATION_COUNT << " operations shared among the threads, best of "
+              << REPETITIONS << std::endl;
+    std::cout << "Throughput in millions of operations per second; "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    measureMix("Lookups only", words, initial, 0);
+    measureMix("90% lookups, 5% additions, 5% removals", words, initial, 10);
+}
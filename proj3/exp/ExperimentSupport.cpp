@@ -0,0 +1,50 @@
+// ExperimentSupport.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include "ExperimentSupport.hpp"
+
+
+
+std::string readLine()
+{
+    std::string line;
+    std::getline(std::cin, line);
+    return line;
+}
+
+
+std::vector<std::string> readWordFile(const std::string& wordFilePath)
+{
+    std::ifstream wordFile{wordFilePath};
+    std::vector<std::string> words;
+    std::string word;
+
+    while (std::getline(wordFile, word))
+    {
+        std::transform(
+            word.begin(), word.end(), word.begin(),
+            [](auto c) { return std::toupper(c); });
+
+        word.erase(
+            std::remove_if(
+                word.begin(), word.end(),
+                [](auto c) { return c == '\r' || c == '\n'; }),
+            word.end());
+
+        words.push_back(word);
+    }
+
+    return words;
+}
+
+
+double perSecond(double count, double microseconds)
+{
+    return microseconds > 0.0 ? count * 1000000.0 / microseconds : 0.0;
+}
@@ -0,0 +1,59 @@
+// ExperimentSupport.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Utilities shared by the experiments: reading input, loading word files
+// into memory (so that what's timed is the set and not the file), and
+// timing the best of several repetitions with a Stopwatch.
+
+#ifndef EXPERIMENTSUPPORT_HPP
+#define EXPERIMENTSUPPORT_HPP
+
+#include <string>
+#include <vector>
+#include "Stopwatch.hpp"
+
+
+
+// readLine() returns the next line of the standard input.
+std::string readLine();
+
+
+// readWordFile() returns the words in a word file, one per line, converted
+// to uppercase the same way the WordSetLoader converts them.
+std::vector<std::string> readWordFile(const std::string& wordFilePath);
+
+
+// bestOf() calls the given function the given number of times, returning
+// the shortest duration (in microseconds) of any of the calls.
+
+template <typename Function>
+double bestOf(unsigned int repetitions, Function function)
+{
+    Stopwatch stopwatch;
+    double best = 0.0;
+
+    for (unsigned int i = 0; i < repetitions; ++i)
+    {
+        stopwatch.start();
+        function();
+        stopwatch.stop();
+
+        if (i == 0 || stopwatch.lastDuration() < best)
+        {
+            best = stopwatch.lastDuration();
+        }
+    }
+
+    return best;
+}
+
+
+// perSecond() converts a count of operations performed in the given number
+// of microseconds into a rate per second.
+double perSecond(double count, double microseconds);
+
+
+
+#endif // EXPERIMENTSUPPORT_HPP
@@ -0,0 +1,94 @@
+// Experiments.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Declarations of the experiments that expmain can run.  Each one reads
+// whatever further input it needs (such as the paths to files) from the
+// standard input, one line at a time, as the SpellCheckShell does.
+
+#ifndef EXPERIMENTS_HPP
+#define EXPERIMENTS_HPP
+
+
+
+// Compares AVLSet lookups when the tree was built with add(), with
+// addAll(), and after freeze(), against a std::set.
+void runAVLLayoutExperiment();
+
+
+// Measures how much a BloomFilterSet in front of each kind of Set speeds up
+// finding suggestions for the misspelled words in a text file.
+void runBloomFilterExperiment();
+
+
+// Measures the time each kind of Set takes per operation under a random
+// mix of additions, removals, and lookups.
+void runChurnExperiment();
+
+
+// Measures how the throughput of a ConcurrentSkipListSet scales with the
+// number of threads, against a SkipListSet behind a std::shared_mutex.
+void runConcurrentSkipListExperiment();
+
+
+// Compares finding the words that begin with each of a set of prefixes
+// with the range() and rank() member functions of the ordered Sets against
+// filtering everything visited by an inorder() traversal.
+void runRangeScanExperiment();
+
+
+// Measures the memory a SkipListSet uses per element and how quickly it
+// looks up words and ints, when built with add() and with addAll().
+void runSkipListLayoutExperiment();
+
+
+// Compares the time taken to choose heights, build a SkipListSet, and look
+// up words with each level tester, and the number of elements on each
+// level of the resulting skip list.
+void runSkipListLevelExperiment();
+
+
+// Measures how quickly each HashSet hash function inserts, then finds,
+// every word in a word file.
+void runHashSetInsertExperiment();
+
+
+// Reports how evenly each hash function spreads the words in a word file
+// across the buckets of a HashSet.
+void runHashDistributionExperiment();
+
+
+// Compares lookup throughput of hash tables whose hash function is a
+// std::function against ones whose hash function is a function object.
+void runHashFunctorExperiment();
+
+
+// Compares load and teardown times of the linked Set implementations when
+// their nodes come from the heap against when they come from an arena.
+void runNodeArenaExperiment();
+
+
+// Compares loading a word file and scanning a text file through a stream
+// against doing both by mapping the files into memory.
+void runFileReadExperiment();
+
+
+// Measures how the time taken to check the spelling of a large text scales
+// with the number of threads checking it.
+void runParallelCheckExperiment();
+
+
+// Compares the speed of WordChecker::findSuggestions() against the original
+// implementation, which made a new string for every candidate.
+void runSuggestionExperiment();
+
+
+// Compares the memory used and the time taken to find suggestions when
+// they're found in each kind of SuggestionSource against when edits of
+// each misspelled word are tried against the word set.
+void runSuggestionSourceExperiment();
+
+
+
+#endif // EXPERIMENTS_HPP
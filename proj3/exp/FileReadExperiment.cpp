@@ -0,0 +1,90 @@
+// FileReadExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares the two FileReadModes: how long the WordSetLoader takes to read
+// a word file (into an EmptySet, so that no time is spent in a real set)
+// and how long a TextFileReader takes to scan through every word of a text
+// file, reading each file through a stream versus mapping it into memory.
+//
+// Input: the path to the word file, then the path to the text file.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "EmptySet.hpp"
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "MappedFile.hpp"
+#include "TextFileReader.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int LOAD_REPETITIONS = 20;
+    constexpr unsigned int SCAN_REPETITIONS = 200;
+
+
+    void measure(
+        const std::string& name, FileReadMode mode,
+        const std::string& wordFilePath, const std::string& textFilePath)
+    {
+        double loadTime = bestOf(
+            LOAD_REPETITIONS,
+            [&]()
+            {
+                EmptySet<std::string> wordSet;
+                WordSetLoader{mode}.load(wordFilePath, wordSet);
+            });
+
+        unsigned long words = 0;
+        unsigned long characters = 0;
+
+        double scanTime = bestOf(
+            SCAN_REPETITIONS,
+            [&]()
+            {
+                words = 0;
+                characters = 0;
+
+                for (TextFileReader reader{textFilePath, mode}; !reader.noMoreWords(); reader.advanceToNextWord())
+                {
+                    ++words;
+                    characters += reader.currentWord().length();
+                }
+            });
+
+        std::cout << std::left << std::setw(10) << name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << loadTime
+                  << std::setw(12) << scanTime
+                  << std::setw(16) << perSecond(words, scanTime)
+                  << std::setw(10) << words
+                  << std::setw(10) << characters
+                  << std::endl;
+    }
+}
+
+
+
+void runFileReadExperiment()
+{
+    std::string wordFilePath = readLine();
+    std::string textFilePath = readLine();
+
+    std::cout << "best of " << LOAD_REPETITIONS << " loads and "
+              << SCAN_REPETITIONS << " scans" << std::endl;
+
+    std::cout << std::left << std::setw(10) << "Mode"
+              << std::right << std::setw(12) << "load usec"
+              << std::setw(12) << "scan usec"
+              << std::setw(16) << "words/sec"
+              << std::setw(10) << "words"
+              << std::setw(10) << "chars" << std::endl;
+
+    measure("stream", FileReadMode::Stream, wordFilePath, textFilePath);
+    measure("mapped", FileReadMode::Mapped, wordFilePath, textFilePath);
+}
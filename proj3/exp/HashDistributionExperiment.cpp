@@ -0,0 +1,105 @@
+// HashDistributionExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Loads a word file into a HashSet once per hash function, then describes
+// how evenly the words are spread across the HashSet's buckets, as seen
+// through elementsAtIndex():
+//
+//   * the chi-square statistic of the bucket sizes against a uniform
+//     spread, divided by its degrees of freedom (so a well-distributed
+//     hash comes out near 1.0, and larger values are worse)
+//   * the longest chain
+//   * the proportion of buckets left empty (about e^-(load factor) when
+//     the hash is uniform)
+//
+// hashStringAsZero is left out, since it puts every word into one bucket
+// and takes minutes to load a large word file.
+//
+// Input: the path to the word file.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "HashSet.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    void report(
+        const std::string& name, HashSet<std::string>::HashFunction hashFunction,
+        const std::vector<std::string>& words)
+    {
+        HashSet<std::string> set{hashFunction};
+
+        double loadTime = bestOf(
+            1,
+            [&]()
+            {
+                for (const std::string& word : words)
+                {
+                    set.add(word);
+                }
+            });
+
+        unsigned int buckets = set.capacity();
+        double expected = static_cast<double>(set.size()) / buckets;
+        double chiSquare = 0.0;
+        unsigned int longest = 0;
+        unsigned int empty = 0;
+
+        for (unsigned int i = 0; i < buckets; ++i)
+        {
+            unsigned int observed = set.elementsAtIndex(i);
+            double difference = observed - expected;
+
+            chiSquare += difference * difference / expected;
+
+            if (observed > longest)
+            {
+                longest = observed;
+            }
+
+            if (observed == 0)
+            {
+                ++empty;
+            }
+        }
+
+        std::cout << std::left << std::setw(14) << name
+                  << std::right << std::fixed
+                  << std::setw(10) << buckets
+                  << std::setprecision(2) << std::setw(14) << chiSquare / (buckets - 1)
+                  << std::setw(10) << longest
+                  << std::setprecision(3) << std::setw(10) << static_cast<double>(empty) / buckets
+                  << std::setprecision(0) << std::setw(12) << loadTime << "usec"
+                  << std::endl;
+    }
+}
+
+
+
+void runHashDistributionExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+
+    std::cout << words.size() << " words" << std::endl;
+    std::cout << std::left << std::setw(14) << "Hash"
+              << std::right << std::setw(10) << "buckets"
+              << std::setw(14) << "chi-sq / df"
+              << std::setw(10) << "longest"
+              << std::setw(10) << "empty"
+              << std::setw(16) << "load time" << std::endl;
+
+    report("HASH SUM", hashStringAsSum, words);
+    report("HASH PRODUCT", hashStringAsProduct, words);
+    report("HASH FNV1A", hashStringAsFnv1a, words);
+    report("HASH WYMIX", hashStringAsWymix, words);
+    report("HASH CRC32C", hashStringAsCrc32c, words);
+}
@@ -0,0 +1,119 @@
+// HashFunctorExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares the lookup throughput of hash tables that call their hash
+// function through a std::function (the default) against ones that are
+// parameterized on a function object type, which lets the compiler inline
+// the hash.  Every word in a word file is looked up, along with the same
+// number of words that aren't present (each word with a '#' appended).
+//
+// Input: the path to the word file.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "FlatHashSet.hpp"
+#include "HashSet.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 10;
+
+
+    template <typename SetType>
+    void measure(
+        const std::string& name, SetType& set,
+        const std::vector<std::string>& words, const std::vector<std::string>& misses)
+    {
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+
+        unsigned int found = 0;
+
+        double hitTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const std::string& word : words)
+                {
+                    found += set.contains(word) ? 1 : 0;
+                }
+            });
+
+        double missTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const std::string& word : misses)
+                {
+                    found += set.contains(word) ? 1 : 0;
+                }
+            });
+
+        std::cout << std::left << std::setw(36) << name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << perSecond(words.size(), hitTime)
+                  << std::setw(14) << perSecond(misses.size(), missTime)
+                  << std::setw(10) << found / REPETITIONS
+                  << std::endl;
+    }
+}
+
+
+
+void runHashFunctorExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+    std::vector<std::string> misses;
+
+    for (const std::string& word : words)
+    {
+        misses.push_back(word + "#");
+    }
+
+    std::cout << words.size() << " words, best of " << REPETITIONS << " runs" << std::endl;
+    std::cout << std::left << std::setw(36) << "Set"
+              << std::right << std::setw(14) << "hits/sec"
+              << std::setw(14) << "misses/sec"
+              << std::setw(10) << "found" << std::endl;
+
+    {
+        HashSet<std::string> set{hashStringAsProduct};
+        measure("HashSet, std::function PRODUCT", set, words, misses);
+    }
+
+    {
+        HashSet<std::string, StringHashAsProduct> set{StringHashAsProduct{}};
+        measure("HashSet, functor PRODUCT", set, words, misses);
+    }
+
+    {
+        HashSet<std::string> set{hashStringAsFnv1a};
+        measure("HashSet, std::function FNV1A", set, words, misses);
+    }
+
+    {
+        HashSet<std::string, StringHashAsFnv1a> set{StringHashAsFnv1a{}};
+        measure("HashSet, functor FNV1A", set, words, misses);
+    }
+
+    {
+        FlatHashSet<std::string> set{hashStringAsProduct};
+        measure("FlatHashSet, std::function PRODUCT", set, words, misses);
+    }
+
+    {
+        FlatHashSet<std::string, StringHashAsProduct> set{StringHashAsProduct{}};
+        measure("FlatHashSet, functor PRODUCT", set, words, misses);
+    }
+}
@@ -0,0 +1,90 @@
+// HashSetInsertExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Loads a word file into memory, then measures (best of several runs) how
+// many words per second a HashSet can insert and then find, for each of
+// the hash functions that the SpellCheckShell offers.
+//
+// Input: the path to the word file.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "HashSet.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 5;
+
+
+    void measure(
+        const std::string& name, HashSet<std::string>::HashFunction hashFunction,
+        const std::vector<std::string>& words)
+    {
+        double insertTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                HashSet<std::string> set{hashFunction};
+
+                for (const std::string& word : words)
+                {
+                    set.add(word);
+                }
+            });
+
+        HashSet<std::string> set{hashFunction};
+
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+
+        unsigned int found = 0;
+
+        double lookupTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                found = 0;
+
+                for (const std::string& word : words)
+                {
+                    found += set.contains(word) ? 1 : 0;
+                }
+            });
+
+        std::cout << std::left << std::setw(16) << name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << perSecond(words.size(), insertTime)
+                  << std::setw(14) << perSecond(words.size(), lookupTime)
+                  << std::setw(10) << found << std::endl;
+    }
+}
+
+
+
+void runHashSetInsertExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+
+    std::cout << words.size() << " words, best of " << REPETITIONS << " runs" << std::endl;
+    std::cout << std::left << std::setw(16) << "Hash"
+              << std::right << std::setw(14) << "inserts/sec"
+              << std::setw(14) << "lookups/sec"
+              << std::setw(10) << "found" << std::endl;
+
+    measure("HASH SUM", hashStringAsSum, words);
+    measure("HASH PRODUCT", hashStringAsProduct, words);
+    measure("HASH FNV1A", hashStringAsFnv1a, words);
+    measure("HASH WYMIX", hashStringAsWymix, words);
+    measure("HASH CRC32C", hashStringAsCrc32c, words);
+}
@@ -0,0 +1,167 @@
+// NodeArenaExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares how long each linked Set implementation takes to load, and then
+// to destroy, when its nodes are allocated one at a time on the heap
+// (HeapNodeAllocator) versus carved out of an arena (ArenaNodeAllocator).
+// Each is measured with the words of a word file and again with ints (one
+// per word), since an arena full of trivially destructible nodes can be
+// released without visiting them at all.  The words are shuffled, with a
+// fixed seed, so every run sees them in the same order.
+//
+// Input: the path to the word file, then the number of words to use (all
+// of them if the line is blank or zero).
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "HashSet.hpp"
+#include "ListSet.hpp"
+#include "NodeAllocator.hpp"
+#include "SkipListSet.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 5;
+
+
+    struct IntHash
+    {
+        unsigned int operator()(const int& i) const
+        {
+            return static_cast<unsigned int>(i) * 2654435761u;
+        }
+    };
+
+
+    template <typename SetType, typename ElementType, typename MakeSet>
+    void measure(
+        const std::string& name, MakeSet makeSet, const std::vector<ElementType>& elements)
+    {
+        Stopwatch stopwatch;
+        double bestLoad = 0.0;
+        double bestTeardown = 0.0;
+        unsigned int size = 0;
+
+        for (unsigned int i = 0; i < REPETITIONS; ++i)
+        {
+            std::unique_ptr<SetType> set = makeSet();
+
+            stopwatch.start();
+
+            for (const ElementType& element : elements)
+            {
+                set->add(element);
+            }
+
+            stopwatch.stop();
+            double load = stopwatch.lastDuration();
+            size = set->size();
+
+            stopwatch.start();
+            set.reset();
+            stopwatch.stop();
+            double teardown = stopwatch.lastDuration();
+
+            if (i == 0 || load < bestLoad)
+            {
+                bestLoad = load;
+            }
+
+            if (i == 0 || teardown < bestTeardown)
+            {
+                bestTeardown = teardown;
+            }
+        }
+
+        std::cout << std::left << std::setw(28) << name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << bestLoad
+                  << std::setw(14) << bestTeardown
+                  << std::setw(10) << size
+                  << std::endl;
+    }
+
+
+    template <typename ElementType, typename NodeAllocator, typename Hasher>
+    void measureAll(
+        const std::string& allocatorName, const std::vector<ElementType>& elements, Hasher hasher)
+    {
+        measure<HashSet<ElementType, Hasher, NodeAllocator>>(
+            "HashSet, " + allocatorName,
+            [&]() { return std::make_unique<HashSet<ElementType, Hasher, NodeAllocator>>(hasher); },
+            elements);
+
+        measure<AVLSet<ElementType, NodeAllocator>>(
+            "AVLSet, " + allocatorName,
+            []() { return std::make_unique<AVLSet<ElementType, NodeAllocator>>(); },
+            elements);
+
+        measure<SkipListSet<ElementType, NodeAllocator>>(
+            "SkipListSet, " + allocatorName,
+            []() { return std::make_unique<SkipListSet<ElementType, NodeAllocator>>(); },
+            elements);
+
+        measure<ListSet<ElementType, NodeAllocator>>(
+            "ListSet, " + allocatorName,
+            []() { return std::make_unique<ListSet<ElementType, NodeAllocator>>(); },
+            elements);
+    }
+
+
+    void printHeading(const std::string& heading)
+    {
+        std::cout << std::endl << heading << std::endl;
+        std::cout << std::left << std::setw(28) << "Set"
+                  << std::right << std::setw(12) << "load usec"
+                  << std::setw(14) << "teardown usec"
+                  << std::setw(10) << "size" << std::endl;
+    }
+}
+
+
+
+void runNodeArenaExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+    std::string countLine = readLine();
+    unsigned long count = countLine.empty() ? 0 : std::stoul(countLine);
+
+    std::shuffle(words.begin(), words.end(), std::mt19937{46});
+
+    if (count != 0 && count < words.size())
+    {
+        words.resize(count);
+    }
+
+    std::vector<int> numbers;
+
+    for (int i = 0; i < static_cast<int>(words.size()); ++i)
+    {
+        numbers.push_back(i);
+    }
+
+    std::shuffle(numbers.begin(), numbers.end(), std::mt19937{46});
+
+    std::cout << words.size() << " elements, best of " << REPETITIONS << " runs" << std::endl;
+
+    printHeading("std::string elements");
+    measureAll<std::string, HeapNodeAllocator>("heap", words, StringHashAsProduct{});
+    measureAll<std::string, ArenaNodeAllocator>("arena", words, StringHashAsProduct{});
+
+    printHeading("int elements");
+    measureAll<int, HeapNodeAllocator>("heap", numbers, IntHash{});
+    measureAll<int, ArenaNodeAllocator>("arena", numbers, IntHash{});
+}
@@ -0,0 +1,117 @@
+// ParallelCheckExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures how SpellChecker::runInParallel() scales with the number of
+// threads.  The word file is loaded into a FlatHashSet, the text file is
+// repeated to make a text large enough to be worth splitting up, and the
+// text is checked with 1, 2, 4, ... threads, up to twice the number of
+// hardware threads.  Each run counts the misspellings it's told about, as
+// a check that every run reports the same ones.
+//
+// Input: the path to the word file, the path to the text file, then the
+// number of copies of the text to check.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "FlatHashSet.hpp"
+#include "MappedFile.hpp"
+#include "SpellChecker.hpp"
+#include "SpellCheckerListener.hpp"
+#include "StringHashing.hpp"
+#include "WordChecker.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 3;
+
+
+    class CountingListener : public SpellCheckerListener
+    {
+    public:
+        unsigned long misspellings = 0;
+        unsigned long suggestions = 0;
+
+        virtual void misspellingFound(
+            const std::string& word, const std::string& line,
+            const std::vector<std::string>& suggestions) override
+        {
+            ++misspellings;
+            this->suggestions += suggestions.size();
+        }
+    };
+}
+
+
+
+void runParallelCheckExperiment()
+{
+    std::string wordFilePath = readLine();
+    std::string textFilePath = readLine();
+    unsigned int copies = std::stoul(readLine());
+
+    FlatHashSet<std::string, StringHashAsProduct> wordSet{StringHashAsProduct{}};
+    WordSetLoader{}.load(wordFilePath, wordSet);
+
+    MappedFile textFile{textFilePath};
+    std::string text;
+    text.reserve(textFile.contents().length() * copies);
+
+    for (unsigned int i = 0; i < copies; ++i)
+    {
+        text.append(textFile.contents());
+    }
+
+    WordChecker wordChecker{wordSet};
+
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+
+    std::cout << "text: " << text.length() << " bytes; "
+              << "hardware threads: " << hardwareThreads << "; "
+              << "best of " << REPETITIONS << std::endl;
+
+    std::cout << std::right
+              << std::setw(8) << "threads"
+              << std::setw(14) << "usec"
+              << std::setw(10) << "speedup"
+              << std::setw(14) << "misspellings"
+              << std::setw(14) << "suggestions" << std::endl;
+
+    double oneThreadTime = 0.0;
+
+    for (unsigned int threads = 1; threads <= 2 * std::max(1u, hardwareThreads); threads *= 2)
+    {
+        std::shared_ptr<CountingListener> listener;
+
+        double time = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                SpellChecker spellChecker;
+                listener = std::make_shared<CountingListener>();
+                spellChecker.addObserver(listener);
+                spellChecker.runInParallel(wordChecker, text, threads);
+            });
+
+        if (threads == 1)
+        {
+            oneThreadTime = time;
+        }
+
+        std::cout << std::setw(8) << threads
+                  << std::fixed << std::setprecision(0) << std::setw(14) << time
+                  << std::setprecision(2) << std::setw(10) << oneThreadTime / time
+                  << std::setw(14) << listener->misspellings
+                  << std::setw(14) << listener->suggestions << std::endl;
+    }
+}
@@ -0,0 +1,172 @@
+// RangeScanExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures how quickly the ordered Sets find every word beginning with a
+// given prefix, as an autocompleting dictionary browser would.  The words
+// beginning with a prefix are exactly the ones not less than it and less
+// than the prefix with its last character incremented, so they can be
+// found with range(), which skips straight to the first of them; or
+// counted without visiting them at all, as the difference between the
+// rank() of those two bounds.  For comparison, the same words are found by
+// filtering everything that inorder() visits, which is all that was
+// possible before range() existed.
+//
+// The prefixes are the first one, two, or three letters of words chosen
+// from the word file in a shuffled order (with a fixed seed).
+//
+// Input: the path to the word file.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AVLSet.hpp"
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "SkipListSet.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 5;
+    constexpr unsigned int QUERY_COUNT = 1000;
+
+    // Filtering visits every word for every query, so it's only given a
+    // few of the queries.
+    constexpr unsigned int FILTER_QUERY_COUNT = 50;
+
+
+    struct Query
+    {
+        std::string low;
+        std::string high;
+    };
+
+
+    std::vector<Query> makeQueries(const std::vector<std::string>& words)
+    {
+        std::vector<std::string> shuffled = words;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{46});
+
+        std::vector<Query> queries;
+
+        for (const std::string& word : shuffled)
+        {
+            if (queries.size() == QUERY_COUNT)
+            {
+                break;
+            }
+
+            std::string low = word.substr(0, queries.size() % 3 + 1);
+            std::string high = low;
+            ++high.back();
+
+            queries.push_back(Query{low, high});
+        }
+
+        return queries;
+    }
+
+
+    void report(const std::string& name, double time, unsigned int queryCount, unsigned long matches)
+    {
+        std::cout << std::left << std::setw(28) << name
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << time / queryCount
+                  << std::setw(14) << matches / REPETITIONS / queryCount
+                  << std::endl;
+    }
+
+
+    template <typename SetType>
+    void measureRanges(const std::string& name, const SetType& set, const std::vector<Query>& queries)
+    {
+        unsigned long matches = 0;
+
+        double time = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const Query& query : queries)
+                {
+                    for (const std::string& word : set.range(query.low, query.high))
+                    {
+                        matches += word.length() > 0 ? 1 : 0;
+                    }
+                }
+            });
+
+        report(name + " range()", time, queries.size(), matches);
+
+        matches = 0;
+
+        time = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const Query& query : queries)
+                {
+                    matches += set.rank(query.high) - set.rank(query.low);
+                }
+            });
+
+        report(name + " rank()", time, queries.size(), matches);
+    }
+
+
+    void measureFiltering(const AVLSet<std::string>& set, const std::vector<Query>& queries)
+    {
+        unsigned long matches = 0;
+
+        double time = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (unsigned int i = 0; i < FILTER_QUERY_COUNT; ++i)
+                {
+                    const Query& query = queries[i];
+
+                    set.inorder(
+                        [&](const std::string& word)
+                        {
+                            if (!(word < query.low) && word < query.high)
+                            {
+                                ++matches;
+                            }
+                        });
+                }
+            });
+
+        report("AVLSet inorder() filter", time, FILTER_QUERY_COUNT, matches);
+    }
+}
+
+
+
+void runRangeScanExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+    std::vector<Query> queries = makeQueries(words);
+
+    AVLSet<std::string> avl;
+    avl.addAll(words.data(), words.data() + words.size(), false);
+
+    SkipListSet<std::string> skipList;
+    skipList.addAll(words.data(), words.data() + words.size(), false);
+
+    std::cout << avl.size() << " words, " << queries.size() << " prefixes, best of "
+              << REPETITIONS << " runs" << std::endl;
+
+    std::cout << std::left << std::setw(28) << "Method"
+              << std::right << std::setw(14) << "usec/query"
+              << std::setw(14) << "words/query" << std::endl;
+
+    measureRanges("AVLSet", avl, queries);
+    measureRanges("SkipListSet", skipList, queries);
+    measureFiltering(avl, queries);
+}
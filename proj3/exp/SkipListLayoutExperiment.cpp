@@ -0,0 +1,196 @@
+// SkipListLayoutExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures how much memory a SkipListSet uses per element, and how quickly
+// it looks words up, when it's built one element at a time with add() and
+// when it's built all at once with addAll().  The memory is counted by a
+// NodeAllocator that passes every request on to the heap, keeping track of
+// how many bytes (and how many allocations) are live; that leaves out what
+// the heap itself adds to each allocation, which only makes a difference
+// larger when there are more allocations.  Every word in a word file is
+// looked up, in a shuffled order (with a fixed seed), along with the same
+// number of words that aren't present (each word with a '#' appended), and
+// then the same is done with ints, one per word.
+//
+// Input: the path to the word file.
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "NodeAllocator.hpp"
+#include "SkipListSet.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 10;
+
+
+    struct AllocationCounts
+    {
+        std::size_t bytes = 0;
+        std::size_t allocations = 0;
+    };
+
+    AllocationCounts liveAllocations;
+
+
+    // A CountingNodeAllocator gets its memory from the heap, just as a
+    // HeapNodeAllocator does, and keeps liveAllocations up to date.
+    class CountingNodeAllocator
+    {
+    public:
+        static constexpr bool releasesAllAtOnce = false;
+
+        void* allocate(std::size_t bytes)
+        {
+            void* p = heap.allocate(bytes);
+            liveAllocations.bytes += bytes;
+            ++liveAllocations.allocations;
+            return p;
+        }
+
+        void deallocate(void* p, std::size_t bytes) noexcept
+        {
+            heap.deallocate(p, bytes);
+            liveAllocations.bytes -= bytes;
+            --liveAllocations.allocations;
+        }
+
+    private:
+        HeapNodeAllocator heap;
+    };
+
+
+    template <typename ElementType>
+    using CountedSkipListSet = SkipListSet<ElementType, CountingNodeAllocator>;
+
+
+    template <typename ElementType>
+    void measure(
+        const std::string& name, const CountedSkipListSet<ElementType>& set,
+        const std::vector<ElementType>& elements, const std::vector<ElementType>& misses)
+    {
+        unsigned int found = 0;
+
+        double hitTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const ElementType& element : elements)
+                {
+                    found += set.contains(element) ? 1 : 0;
+                }
+            });
+
+        double missTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const ElementType& element : misses)
+                {
+                    found += set.contains(element) ? 1 : 0;
+                }
+            });
+
+        std::cout << std::left << std::setw(20) << name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << static_cast<double>(liveAllocations.bytes) / set.size()
+                  << std::setprecision(2)
+                  << std::setw(10) << static_cast<double>(liveAllocations.allocations) / set.size()
+                  << std::setprecision(1)
+                  << std::setw(12) << hitTime * 1000.0 / elements.size()
+                  << std::setw(12) << missTime * 1000.0 / misses.size()
+                  << std::setw(8) << set.levelCount()
+                  << std::setw(10) << found / REPETITIONS
+                  << std::endl;
+    }
+
+
+    template <typename ElementType>
+    void measureAll(
+        const std::vector<ElementType>& sorted, const std::vector<ElementType>& shuffled,
+        const std::vector<ElementType>& misses)
+    {
+        {
+            liveAllocations = AllocationCounts{};
+            CountedSkipListSet<ElementType> set;
+
+            for (const ElementType& element : shuffled)
+            {
+                set.add(element);
+            }
+
+            measure("add()", set, shuffled, misses);
+        }
+
+        {
+            liveAllocations = AllocationCounts{};
+            CountedSkipListSet<ElementType> set;
+            set.addAll(sorted.data(), sorted.data() + sorted.size(), true);
+            measure("addAll()", set, shuffled, misses);
+        }
+    }
+
+
+    void printHeading(const std::string& heading)
+    {
+        std::cout << std::endl << heading << std::endl;
+        std::cout << std::left << std::setw(20) << "Built with"
+                  << std::right << std::setw(12) << "bytes/elem"
+                  << std::setw(10) << "allocs"
+                  << std::setw(12) << "hit nsec"
+                  << std::setw(12) << "miss nsec"
+                  << std::setw(8) << "levels"
+                  << std::setw(10) << "found" << std::endl;
+    }
+}
+
+
+
+void runSkipListLayoutExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    std::vector<std::string> shuffled = words;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{46});
+
+    std::vector<std::string> misses;
+
+    for (const std::string& word : shuffled)
+    {
+        misses.push_back(word + "#");
+    }
+
+    std::cout << words.size() << " words, best of " << REPETITIONS << " runs" << std::endl;
+
+    printHeading("std::string elements");
+    measureAll(words, shuffled, misses);
+
+    std::vector<int> numbers;
+    std::vector<int> numberMisses;
+
+    for (int i = 0; i < static_cast<int>(words.size()); ++i)
+    {
+        numbers.push_back(2 * i);
+        numberMisses.push_back(2 * i + 1);
+    }
+
+    std::vector<int> shuffledNumbers = numbers;
+    std::shuffle(shuffledNumbers.begin(), shuffledNumbers.end(), std::mt19937{46});
+    std::shuffle(numberMisses.begin(), numberMisses.end(), std::mt19937{46});
+
+    printHeading("int elements");
+    measureAll(numbers, shuffledNumbers, numberMisses);
+}
@@ -0,0 +1,190 @@
+// SkipListLevelExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares the level testers that a SkipListSet can be given: the
+// RandomSkipListLevelTester, which draws a coin flip from a
+// std::default_random_engine for each level, and a FastSkipListLevelTester
+// (seeded, so every run builds the same skip lists) with each promotion
+// probability.  For each, it measures how long choosing one height takes
+// on its own, how long adding every word in a word file (in a shuffled
+// order, with a fixed seed) to an empty SkipListSet takes, and how long
+// looking each of them up takes afterward; it then reports how many
+// elements the resulting skip list has on each level, against the number
+// the promotion probability predicts.
+//
+// Input: the path to the word file.
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "SkipListSet.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 5;
+    constexpr unsigned int DRAW_COUNT = 10000000;
+    constexpr unsigned int LEVELS_SHOWN = 12;
+
+
+    struct Tester
+    {
+        std::string name;
+        double probability;
+        std::unique_ptr<SkipListLevelTester<std::string>> tester;
+    };
+
+
+    std::vector<Tester> makeTesters()
+    {
+        std::vector<Tester> testers;
+
+        testers.push_back(Tester{
+            "RANDOM 1/2", 0.5,
+            std::make_unique<RandomSkipListLevelTester<std::string>>()});
+
+        testers.push_back(Tester{
+            "FAST 1/2", 0.5,
+            std::make_unique<FastSkipListLevelTester<std::string>>(46, SkipListPromotion::OneHalf)});
+
+        testers.push_back(Tester{
+            "FAST 1/4", 0.25,
+            std::make_unique<FastSkipListLevelTester<std::string>>(46, SkipListPromotion::OneQuarter)});
+
+        testers.push_back(Tester{
+            "FAST 1/e", std::exp(-1.0),
+            std::make_unique<FastSkipListLevelTester<std::string>>(46, SkipListPromotion::OneOverE)});
+
+        return testers;
+    }
+
+
+    // Each repetition starts from a clone of the tester, so that they all
+    // build the same skip list when the tester is seeded.
+    std::vector<unsigned int> measure(const Tester& tester, const std::vector<std::string>& words)
+    {
+        std::unique_ptr<SkipListLevelTester<std::string>> drawer = tester.tester->clone();
+        const std::string word = "WORD";
+        unsigned long total = 0;
+
+        double drawTime = bestOf(
+            1,
+            [&]()
+            {
+                for (unsigned int i = 0; i < DRAW_COUNT; ++i)
+                {
+                    total += drawer->chooseHeight(word, SkipListSet<std::string>::MAX_LEVEL_COUNT);
+                }
+            });
+
+        std::unique_ptr<SkipListSet<std::string>> set;
+
+        double addTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                set = std::make_unique<SkipListSet<std::string>>(tester.tester->clone());
+
+                for (const std::string& word : words)
+                {
+                    set->add(word);
+                }
+            });
+
+        unsigned int found = 0;
+
+        double hitTime = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                for (const std::string& word : words)
+                {
+                    found += set->contains(word) ? 1 : 0;
+                }
+            });
+
+        std::cout << std::left << std::setw(12) << tester.name
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << drawTime * 1000.0 / DRAW_COUNT
+                  << std::setw(10) << static_cast<double>(total) / DRAW_COUNT
+                  << std::setprecision(1)
+                  << std::setw(12) << addTime * 1000.0 / words.size()
+                  << std::setw(14) << perSecond(words.size(), addTime) / 1000000.0
+                  << std::setw(12) << hitTime * 1000.0 / words.size()
+                  << std::setw(8) << set->levelCount()
+                  << std::setw(10) << found / REPETITIONS << std::endl;
+
+        std::vector<unsigned int> onLevel;
+
+        for (unsigned int level = 0; level < set->levelCount(); ++level)
+        {
+            onLevel.push_back(set->elementsOnLevel(level));
+        }
+
+        return onLevel;
+    }
+}
+
+
+
+void runSkipListLevelExperiment()
+{
+    std::vector<std::string> words = readWordFile(readLine());
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    std::shuffle(words.begin(), words.end(), std::mt19937{46});
+
+    std::cout << words.size() << " words, best of " << REPETITIONS << " runs" << std::endl;
+    std::cout << std::left << std::setw(12) << "Tester"
+              << std::right << std::setw(12) << "draw nsec"
+              << std::setw(10) << "height"
+              << std::setw(12) << "add nsec"
+              << std::setw(14) << "Madds/sec"
+              << std::setw(12) << "hit nsec"
+              << std::setw(8) << "levels"
+              << std::setw(10) << "found" << std::endl;
+
+    std::vector<Tester> testers = makeTesters();
+    std::vector<std::vector<unsigned int>> distributions;
+
+    for (const Tester& tester : testers)
+    {
+        distributions.push_back(measure(tester, words));
+    }
+
+    std::cout << std::endl << "Elements on each level (expected in parentheses)" << std::endl;
+    std::cout << std::left << std::setw(8) << "level";
+
+    for (const Tester& tester : testers)
+    {
+        std::cout << std::right << std::setw(20) << tester.name;
+    }
+
+    std::cout << std::endl;
+
+    for (unsigned int level = 0; level < LEVELS_SHOWN; ++level)
+    {
+        std::cout << std::left << std::setw(8) << level << std::right;
+
+        for (unsigned int i = 0; i < testers.size(); ++i)
+        {
+            unsigned int actual = level < distributions[i].size() ? distributions[i][level] : 0;
+            double expected = words.size() * std::pow(testers[i].probability, level);
+
+            std::cout << std::setw(10) << actual
+                      << std::setw(10) << ("(" + std::to_string(std::lround(expected)) + ")");
+        }
+
+        std::cout << std::endl;
+    }
+}
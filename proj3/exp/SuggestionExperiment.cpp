@@ -0,0 +1,173 @@
+// SuggestionExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures how quickly WordChecker::findSuggestions() generates suggestions
+// for every misspelled word in a text file, against a copy of the original
+// implementation, which built each candidate in a new string (and each
+// letter in another) and removed duplicates by searching the suggestions
+// found so far.  Both must find the same suggestions, in the same order.
+//
+// Input: the path to the word file, then the path to the text file.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "FlatHashSet.hpp"
+#include "StringHashing.hpp"
+#include "TextFileReader.hpp"
+#include "WordChecker.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 10;
+
+
+    std::vector<std::string> findSuggestionsByCopying(
+        const WordChecker& wordChecker, const std::string& word)
+    {
+        std::vector<std::string> suggestions;
+        std::string alphabets = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+        auto check =
+            [&](const std::string& temp)
+            {
+                if (wordChecker.wordExists(temp)
+                    && std::find(suggestions.begin(), suggestions.end(), temp) == suggestions.end())
+                {
+                    suggestions.push_back(temp);
+                }
+            };
+
+        for (std::size_t i = 0; i < word.size(); i++)
+        {
+            std::string temp = word;
+            temp = temp.erase(i, 1);
+            check(temp);
+        }
+
+        for (std::size_t i = 0; i < word.size() + 1; i++)
+        {
+            for (std::size_t j = 0; j < alphabets.size(); j++)
+            {
+                std::string temp = word;
+                temp.insert(i, alphabets.substr(j, 1));
+                check(temp);
+            }
+        }
+
+        for (std::size_t i = 0; i < word.size(); i++)
+        {
+            for (std::size_t j = 0; j < alphabets.size(); j++)
+            {
+                std::string temp = word;
+                temp.replace(i, 1, alphabets.substr(j, 1));
+                check(temp);
+            }
+        }
+
+        for (std::size_t i = 0; i + 1 < word.size(); i++)
+        {
+            for (std::size_t j = i + 1; j < word.size(); j++)
+            {
+                std::string temp = word;
+                std::swap(temp[i], temp[j]);
+                check(temp);
+            }
+        }
+
+        for (std::size_t i = 1; i < word.size(); i++)
+        {
+            std::string temp = word;
+            temp.insert(i, " ");
+            check(temp);
+        }
+
+        return suggestions;
+    }
+
+
+    template <typename FindSuggestions>
+    void measure(
+        const std::string& name, const std::vector<std::string>& misspellings,
+        FindSuggestions findSuggestions)
+    {
+        unsigned long suggestions = 0;
+
+        double time = bestOf(
+            REPETITIONS,
+            [&]()
+            {
+                suggestions = 0;
+
+                for (const std::string& word : misspellings)
+                {
+                    suggestions += findSuggestions(word).size();
+                }
+            });
+
+        std::cout << std::left << std::setw(10) << name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << time
+                  << std::setw(16) << perSecond(misspellings.size(), time)
+                  << std::setw(16) << perSecond(suggestions, time)
+                  << std::setw(14) << suggestions << std::endl;
+    }
+}
+
+
+
+void runSuggestionExperiment()
+{
+    std::string wordFilePath = readLine();
+    std::string textFilePath = readLine();
+
+    FlatHashSet<std::string, StringHashAsProduct> wordSet{StringHashAsProduct{}};
+    WordSetLoader{}.load(wordFilePath, wordSet);
+
+    WordChecker wordChecker{wordSet};
+
+    std::vector<std::string> misspellings;
+
+    for (TextFileReader reader{textFilePath}; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        if (!wordChecker.wordExists(reader.currentWord()))
+        {
+            misspellings.push_back(reader.currentWord());
+        }
+    }
+
+    for (const std::string& word : misspellings)
+    {
+        if (wordChecker.findSuggestions(word) != findSuggestionsByCopying(wordChecker, word))
+        {
+            std::cout << "ERROR: Suggestions differ for " << word << std::endl;
+            return;
+        }
+    }
+
+    std::cout << misspellings.size() << " misspelled words; best of "
+              << REPETITIONS << std::endl;
+
+    std::cout << std::left << std::setw(10) << "Version"
+              << std::right << std::setw(12) << "usec"
+              << std::setw(16) << "words/sec"
+              << std::setw(16) << "suggestions/sec"
+              << std::setw(14) << "suggestions" << std::endl;
+
+    measure(
+        "copying", misspellings,
+        [&](const std::string& word) { return findSuggestionsByCopying(wordChecker, word); });
+
+    measure(
+        "in place", misspellings,
+        [&](const std::string& word) { return wordChecker.findSuggestions(word); });
+}
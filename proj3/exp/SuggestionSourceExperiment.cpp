@@ -0,0 +1,163 @@
+// SuggestionSourceExperiment.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares finding suggestions by trying edits of each misspelled word
+// against the word set with finding them in a SuggestionSource: a
+// DeletionIndex, for maximum distances of 1 and 2, and a LevenshteinTrie,
+// returning the ten best words up to distance 2.  For each source, it
+// reports how long it took to build and how much memory it uses; for each
+// way of finding suggestions, it reports the median, 99th percentile, and
+// mean time taken per misspelled word in a text file, and the number of
+// suggestions found.
+//
+// Input: the path to the word file, then the path to the text file.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "DeletionIndex.hpp"
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
+#include "FlatHashSet.hpp"
+#include "LevenshteinTrie.hpp"
+#include "StringHashing.hpp"
+#include "TextFileReader.hpp"
+#include "WordChecker.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 5;
+
+
+    void measureLatency(
+        const std::string& name, const WordChecker& wordChecker,
+        const std::vector<std::string>& misspellings)
+    {
+        std::vector<double> latencies(misspellings.size());
+        unsigned long suggestions = 0;
+        Stopwatch stopwatch;
+
+        for (unsigned int r = 0; r < REPETITIONS; ++r)
+        {
+            suggestions = 0;
+
+            for (std::size_t i = 0; i < misspellings.size(); ++i)
+            {
+                stopwatch.start();
+                std::vector<std::string> found = wordChecker.findSuggestions(misspellings[i]);
+                stopwatch.stop();
+
+                suggestions += found.size();
+
+                if (r == 0 || stopwatch.lastDuration() < latencies[i])
+                {
+                    latencies[i] = stopwatch.lastDuration();
+                }
+            }
+        }
+
+        double total = 0.0;
+
+        for (double latency : latencies)
+        {
+            total += latency;
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+
+        std::cout << std::left << std::setw(12) << name
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << latencies[latencies.size() / 2]
+                  << std::setw(12) << latencies[latencies.size() * 99 / 100]
+                  << std::setw(12) << total / latencies.size()
+                  << std::setw(14) << suggestions << std::endl;
+    }
+}
+
+
+
+void runSuggestionSourceExperiment()
+{
+    std::string wordFilePath = readLine();
+    std::string textFilePath = readLine();
+
+    std::vector<std::string> words;
+    bool presorted = WordSetLoader{}.readWords(wordFilePath, words);
+
+    FlatHashSet<std::string, StringHashAsProduct> wordSet{StringHashAsProduct{}};
+    wordSet.addAll(words.data(), words.data() + words.size(), presorted);
+
+    std::vector<std::string> misspellings;
+
+    for (TextFileReader reader{textFilePath}; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        if (!wordSet.contains(reader.currentWord()))
+        {
+            misspellings.push_back(reader.currentWord());
+        }
+    }
+
+    if (misspellings.empty())
+    {
+        std::cout << "ERROR: No misspelled words in " << textFilePath << std::endl;
+        return;
+    }
+
+    Stopwatch stopwatch;
+
+    stopwatch.start();
+    DeletionIndex distanceOne{words.data(), words.data() + words.size(), presorted, 1};
+    stopwatch.stop();
+    double distanceOneBuildTime = stopwatch.lastDuration();
+
+    stopwatch.start();
+    DeletionIndex distanceTwo{words.data(), words.data() + words.size(), presorted, 2};
+    stopwatch.stop();
+    double distanceTwoBuildTime = stopwatch.lastDuration();
+
+    stopwatch.start();
+    LevenshteinTrie trie{words.data(), words.data() + words.size()};
+    stopwatch.stop();
+    double trieBuildTime = stopwatch.lastDuration();
+
+    std::cout << std::left << std::setw(12) << "Source"
+              << std::right << std::setw(12) << "build usec"
+              << std::setw(14) << "bytes"
+              << std::setw(12) << "bytes/word" << std::endl;
+
+    for (auto [name, source, buildTime] :
+        {std::make_tuple("distance 1", static_cast<const SuggestionSource*>(&distanceOne), distanceOneBuildTime),
+         std::make_tuple("distance 2", static_cast<const SuggestionSource*>(&distanceTwo), distanceTwoBuildTime),
+         std::make_tuple("ranked", static_cast<const SuggestionSource*>(&trie), trieBuildTime)})
+    {
+        std::cout << std::left << std::setw(12) << name
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << buildTime
+                  << std::setw(14) << source->memoryUsage()
+                  << std::setw(12) << static_cast<double>(source->memoryUsage()) / words.size()
+                  << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout << misspellings.size() << " misspelled words; best of "
+              << REPETITIONS << " for each word" << std::endl;
+
+    std::cout << std::left << std::setw(12) << "Strategy"
+              << std::right << std::setw(12) << "p50 usec"
+              << std::setw(12) << "p99 usec"
+              << std::setw(12) << "mean usec"
+              << std::setw(14) << "suggestions" << std::endl;
+
+    measureLatency("edits", WordChecker{wordSet}, misspellings);
+    measureLatency("distance 1", WordChecker{wordSet, distanceOne}, misspellings);
+    measureLatency("distance 2", WordChecker{wordSet, distanceTwo}, misspellings);
+    measureLatency("ranked", WordChecker{wordSet, trie}, misspellings);
+}
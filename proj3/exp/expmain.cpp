@@ -6,12 +6,55 @@
 // Do whatever you'd like here.  This is intended to allow you to experiment
 // with your code, outside of the context of the broader program or Google
 // Test.
+//
+// The first line of the standard input names the experiment to run (see
+// Experiments.hpp); the experiment reads whatever else it needs after that.
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include "ExperimentSupport.hpp"
+#include "Experiments.hpp"
 
 
 int main()
 {
+    const std::map<std::string, std::function<void()>> experiments{
+        {"AVL LAYOUT", runAVLLayoutExperiment},
+        {"BLOOM FILTER", runBloomFilterExperiment},
+        {"CHURN", runChurnExperiment},
+        {"CONCURRENT SKIPLIST", runConcurrentSkipListExperiment},
+        {"FILE READ", runFileReadExperiment},
+        {"HASH FUNCTOR", runHashFunctorExperiment},
+        {"HASH INSERT", runHashSetInsertExperiment},
+        {"HASH REPORT", runHashDistributionExperiment},
+        {"NODE ARENA", runNodeArenaExperiment},
+        {"PARALLEL CHECK", runParallelCheckExperiment},
+        {"RANGE SCAN", runRangeScanExperiment},
+        {"SKIPLIST LAYOUT", runSkipListLayoutExperiment},
+        {"SKIPLIST LEVELS", runSkipListLevelExperiment},
+        {"SUGGESTION SOURCES", runSuggestionSourceExperiment},
+        {"SUGGESTIONS", runSuggestionExperiment}
+    };
+
+    std::string name = readLine();
+    auto experiment = experiments.find(name);
+
+    if (experiment == experiments.end())
+    {
+        std::cout << "ERROR: Unknown experiment: " << name << std::endl;
+        std::cout << "Experiments:" << std::endl;
 
+        for (const auto& e : experiments)
+        {
+            std::cout << "    " << e.first << std::endl;
+        }
+
+        return 0;
+    }
+
+    experiment->second();
 
     return 0;
 }
-
@@ -0,0 +1,587 @@
+// AVLSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the AVLSet beyond the sanity checks.
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+
+
+namespace
+{
+    std::vector<int> inorderOf(const AVLSet<int>& s)
+    {
+        std::vector<int> elements;
+        s.inorder([&](const int& element) { elements.push_back(element); });
+        return elements;
+    }
+
+    // Checks the ordered queries of a set holding exactly the even numbers
+    // from 0 to 2 * (count - 1).
+    template <typename SetType>
+    void expectOrderedQueriesWork(const SetType& s, int count)
+    {
+        ASSERT_EQ(count, s.size());
+
+        for (int i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(2 * i, s.select(i));
+            ASSERT_EQ(i, s.rank(2 * i));
+            ASSERT_EQ(i + 1, s.rank(2 * i + 1));
+
+            ASSERT_EQ(2 * i, *s.lowerBound(2 * i));
+            ASSERT_EQ(2 * i, *s.lowerBound(2 * i - 1));
+            ASSERT_EQ(2 * i, *s.upperBound(2 * i - 1));
+            ASSERT_EQ(2 * i, *s.upperBound(2 * i - 2));
+        }
+
+        EXPECT_EQ(0, s.rank(-1));
+        EXPECT_TRUE(s.lowerBound(2 * count - 1) == s.end());
+        EXPECT_TRUE(s.upperBound(2 * count - 2) == s.end());
+        EXPECT_THROW(s.select(count), std::out_of_range);
+
+        for (int low : {-5, 0, 7, count / 2, count})
+        {
+            for (int high : {-5, 1, 8, count, 2 * count, 3 * count})
+            {
+                std::vector<int> expected;
+
+                for (int i = 0; i < count; ++i)
+                {
+                    if (2 * i >= low && 2 * i < high)
+                    {
+                        expected.push_back(2 * i);
+                    }
+                }
+
+                std::vector<int> elements;
+
+                for (int element : s.range(low, high))
+                {
+                    elements.push_back(element);
+                }
+
+                ASSERT_EQ(expected, elements) << low << ", " << high;
+                ASSERT_EQ(expected.size(), s.range(low, high).count()) << low << ", " << high;
+            }
+        }
+    }
+}
+
+
+TEST(AVLSetTests, copiesAreIndependent)
+{
+    AVLSet<int> s1;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(i);
+    }
+
+    AVLSet<int> s2{s1};
+    s2.add(100);
+
+    AVLSet<int> s3;
+    s3.add(-1);
+    s3 = s2;
+    s3.add(101);
+
+    EXPECT_EQ(100, s1.size());
+    EXPECT_FALSE(s1.contains(100));
+    EXPECT_EQ(101, s2.size());
+    EXPECT_TRUE(s2.contains(0));
+    EXPECT_EQ(102, s3.size());
+    EXPECT_FALSE(s3.contains(-1));
+    EXPECT_EQ(inorderOf(s1).size(), 100);
+}
+
+
+TEST(AVLSetTests, moveTransfersElementsAndLeavesSourceEmpty)
+{
+    AVLSet<std::string> s1;
+    s1.add("Boo");
+    s1.add("Alex");
+
+    AVLSet<std::string> s2{std::move(s1)};
+    EXPECT_EQ(2, s2.size());
+    EXPECT_TRUE(s2.contains("Alex"));
+    EXPECT_EQ(0, s1.size());
+    EXPECT_FALSE(s1.contains("Alex"));
+
+    s1.add("Cool");
+    s2 = std::move(s1);
+    EXPECT_EQ(1, s2.size());
+    EXPECT_TRUE(s2.contains("Cool"));
+}
+
+
+TEST(AVLSetTests, copyOfUnbalancedSetStaysUnbalanced)
+{
+    AVLSet<int> s1{false};
+
+    for (int i = 0; i < 10; ++i)
+    {
+        s1.add(i);
+    }
+
+    AVLSet<int> s2{s1};
+    s2.add(10);
+
+    EXPECT_EQ(10, s2.height());
+}
+
+
+TEST(AVLSetTests, addAllBuildsPerfectlyBalancedTreeFromSortedRange)
+{
+    std::vector<int> elements;
+
+    for (int i = 0; i < 1023; ++i)
+    {
+        elements.push_back(i);
+    }
+
+    AVLSet<int> s;
+    s.addAll(elements.data(), elements.data() + elements.size(), true);
+
+    EXPECT_EQ(1023, s.size());
+    EXPECT_EQ(9, s.height());
+    EXPECT_EQ(elements, inorderOf(s));
+}
+
+
+TEST(AVLSetTests, addAllSortsUnsortedRangeAndSkipsDuplicates)
+{
+    int elements[] = {5, 3, 9, 3, 1, 5, 7};
+
+    AVLSet<int> wrongHint;
+    wrongHint.addAll(elements, elements + 7, true);
+
+    AVLSet<int> noHint;
+    noHint.addAll(elements, elements + 7, false);
+
+    std::vector<int> expected{1, 3, 5, 7, 9};
+
+    EXPECT_EQ(5, wrongHint.size());
+    EXPECT_EQ(expected, inorderOf(wrongHint));
+    EXPECT_EQ(5, noHint.size());
+    EXPECT_EQ(expected, inorderOf(noHint));
+    EXPECT_EQ(2, noHint.height());
+}
+
+
+TEST(AVLSetTests, addAllToNonEmptySetAddsEachElement)
+{
+    int elements[] = {1, 2, 3, 4};
+
+    AVLSet<int> s;
+    s.add(3);
+    s.addAll(elements, elements + 4, true);
+
+    EXPECT_EQ(4, s.size());
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4}), inorderOf(s));
+}
+
+
+TEST(AVLSetTests, addAllToUnbalancedSetBehavesLikeAdd)
+{
+    int elements[] = {1, 2, 3, 4, 5};
+
+    AVLSet<int> s{false};
+    s.addAll(elements, elements + 5, true);
+
+    EXPECT_EQ(5, s.size());
+    EXPECT_EQ(4, s.height());
+}
+
+
+TEST(AVLSetTests, addingInAscendingOrderKeepsTreeBalanced)
+{
+    AVLSet<int> s;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        s.add(i);
+    }
+
+    // A perfectly balanced tree of 100,000 nodes has height 16; an AVL
+    // tree's height is at most about 1.44 times that.
+    EXPECT_EQ(100000, s.size());
+    EXPECT_LE(s.height(), 23);
+    EXPECT_TRUE(s.contains(0));
+    EXPECT_TRUE(s.contains(99999));
+    EXPECT_FALSE(s.contains(100000));
+}
+
+
+TEST(AVLSetTests, addingInRandomOrderKeepsElementsInOrder)
+{
+    AVLSet<int> s;
+    std::vector<int> expected;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        s.add((i * 7919) % 5000);
+        s.add((i * 7919) % 5000);
+        expected.push_back(i);
+    }
+
+    EXPECT_EQ(5000, s.size());
+    EXPECT_LE(s.height(), 17);
+    EXPECT_EQ(expected, inorderOf(s));
+}
+
+
+TEST(AVLSetTests, frozenSetIsCompleteTreeInBreadthFirstOrder)
+{
+    AVLSet<int> s{false};
+
+    for (int i = 1; i <= 7; ++i)
+    {
+        s.add(i);
+    }
+
+    s.freeze();
+
+    std::vector<int> preElements;
+    s.preorder([&](const int& element) { preElements.push_back(element); });
+
+    EXPECT_TRUE(s.isFrozen());
+    EXPECT_EQ(2, s.height());
+    EXPECT_EQ((std::vector<int>{4, 2, 1, 3, 6, 5, 7}), preElements);
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5, 6, 7}), inorderOf(s));
+}
+
+
+TEST(AVLSetTests, frozenSetFindsEveryElementAndNothingElse)
+{
+    for (int count : {1, 2, 3, 10, 100, 1000, 1023, 1024})
+    {
+        AVLSet<std::string> s;
+
+        for (int i = 0; i < count; ++i)
+        {
+            s.add(std::to_string(i * 2));
+        }
+
+        s.freeze();
+
+        for (int i = 0; i < count; ++i)
+        {
+            ASSERT_TRUE(s.contains(std::to_string(i * 2))) << count << ": " << i * 2;
+            ASSERT_FALSE(s.contains(std::to_string(i * 2 + 1))) << count << ": " << i * 2 + 1;
+        }
+
+        EXPECT_FALSE(s.contains(""));
+        EXPECT_FALSE(s.contains("~"));
+    }
+}
+
+
+TEST(AVLSetTests, addingToFrozenSetUnfreezesIt)
+{
+    AVLSet<int> s;
+
+    for (int i = 0; i < 100; i += 2)
+    {
+        s.add(i);
+    }
+
+    s.freeze();
+    AVLSet<int> copy{s};
+
+    s.add(51);
+    s.add(50);
+
+    EXPECT_FALSE(s.isFrozen());
+    EXPECT_EQ(51, s.size());
+    EXPECT_TRUE(s.contains(51));
+    EXPECT_TRUE(s.contains(98));
+    EXPECT_FALSE(s.contains(99));
+
+    EXPECT_TRUE(copy.isFrozen());
+    EXPECT_TRUE(copy.contains(50));
+    EXPECT_FALSE(copy.contains(51));
+}
+
+
+TEST(AVLSetTests, traversalsVisitNodesInTheRightOrder)
+{
+    AVLSet<int> s;
+
+    for (int i = 1; i <= 7; ++i)
+    {
+        s.add(i);
+    }
+
+    std::vector<int> preElements;
+    std::vector<int> postElements;
+    s.preorder([&](const int& element) { preElements.push_back(element); });
+    s.postorder([&](const int& element) { postElements.push_back(element); });
+
+    EXPECT_EQ((std::vector<int>{4, 2, 1, 3, 6, 5, 7}), preElements);
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5, 6, 7}), inorderOf(s));
+    EXPECT_EQ((std::vector<int>{1, 3, 2, 5, 7, 6, 4}), postElements);
+}
+
+
+TEST(AVLSetTests, iteratorVisitsElementsInAscendingOrder)
+{
+    AVLSet<std::string> s;
+    std::vector<std::string> expected;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(std::to_string((i * 7919) % 1000));
+        expected.push_back(std::to_string(i));
+    }
+
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::string> elements;
+
+    for (const std::string& element : s)
+    {
+        elements.push_back(element);
+    }
+
+    EXPECT_EQ(expected, elements);
+    EXPECT_EQ(expected, (std::vector<std::string>{s.begin(), s.end()}));
+    EXPECT_EQ(1000, std::distance(s.begin(), s.end()));
+
+    AVLSet<std::string>::const_iterator i = s.begin();
+    AVLSet<std::string>::const_iterator j = i++;
+
+    EXPECT_EQ(expected[0], *j);
+    EXPECT_EQ(expected[1], *i);
+    EXPECT_EQ(expected[1].size(), i->size());
+    EXPECT_TRUE(++j == i);
+    EXPECT_TRUE(j != s.end());
+}
+
+
+TEST(AVLSetTests, iteratorOfEmptySetIsAtTheEnd)
+{
+    AVLSet<int> s;
+
+    EXPECT_TRUE(s.begin() == s.end());
+    EXPECT_TRUE(AVLSet<int>::ConstIterator{} == s.end());
+}
+
+
+TEST(AVLSetTests, degenerateTreeCanBeTraversedCopiedAndDestroyed)
+{
+    // Without balancing, adding the elements in ascending order makes a
+    // tree that's one long chain of right children, far deeper than a
+    // recursive traversal could go without running out of stack.
+    const int count = 25000;
+
+    AVLSet<int> s{false};
+
+    for (int i = 0; i < count; ++i)
+    {
+        s.add(i);
+    }
+
+    ASSERT_EQ(count - 1, s.height());
+
+    int next = 0;
+    s.preorder([&](const int& element) { ASSERT_EQ(next++, element); });
+    EXPECT_EQ(count, next);
+
+    next = 0;
+    s.inorder([&](const int& element) { ASSERT_EQ(next++, element); });
+    EXPECT_EQ(count, next);
+
+    s.postorder([&](const int& element) { ASSERT_EQ(--next, element); });
+    EXPECT_EQ(0, next);
+
+    for (int element : s)
+    {
+        ASSERT_EQ(next++, element);
+    }
+
+    EXPECT_EQ(count, next);
+
+    AVLSet<int> copy{s};
+    s = AVLSet<int>{};
+
+    EXPECT_EQ(count - 1, copy.height());
+    EXPECT_TRUE(copy.contains(count - 1));
+
+    copy.freeze();
+    EXPECT_EQ(14, copy.height());
+    EXPECT_TRUE(copy.contains(count - 1));
+}
+
+
+TEST(AVLSetTests, orderedQueriesWorkAfterAdding)
+{
+    AVLSet<int> s;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        s.add((i * 7919) % 2000 * 2);
+    }
+
+    expectOrderedQueriesWork(s, 2000);
+}
+
+
+TEST(AVLSetTests, orderedQueriesWorkWhenFrozenOrUnbalanced)
+{
+    std::vector<int> elements;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        elements.push_back(2 * i);
+    }
+
+    AVLSet<int> s;
+    s.addAll(elements.data(), elements.data() + elements.size(), true);
+    s.freeze();
+    expectOrderedQueriesWork(s, 1000);
+
+    AVLSet<int> unbalanced{false};
+
+    for (int element : elements)
+    {
+        unbalanced.add(element);
+    }
+
+    expectOrderedQueriesWork(unbalanced, 1000);
+}
+
+
+TEST(AVLSetTests, orderedQueriesOnEmptySet)
+{
+    AVLSet<std::string> s;
+
+    EXPECT_EQ(0, s.rank("A"));
+    EXPECT_TRUE(s.lowerBound("A") == s.end());
+    EXPECT_TRUE(s.upperBound("A") == s.end());
+    EXPECT_EQ(0, s.range("A", "Z").count());
+    EXPECT_THROW(s.select(0), std::out_of_range);
+}
+
+
+TEST(AVLSetTests, removingKeepsTreeBalancedAndOrdered)
+{
+    AVLSet<int> s;
+
+    for (int i = 0; i < 4000; ++i)
+    {
+        s.add(i);
+    }
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        EXPECT_TRUE(s.remove((i * 7919) % 2000 * 2 + 1));
+    }
+
+    EXPECT_FALSE(s.remove(1));
+    EXPECT_FALSE(s.remove(4000));
+    EXPECT_FALSE(s.contains(1));
+    EXPECT_LE(s.height(), 15);
+    expectOrderedQueriesWork(s, 2000);
+}
+
+
+TEST(AVLSetTests, removingEveryElementLeavesSetUsable)
+{
+    AVLSet<std::string> s;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(std::to_string(i));
+    }
+
+    for (int i = 99; i >= 0; --i)
+    {
+        ASSERT_TRUE(s.remove(std::to_string(i))) << i;
+        ASSERT_FALSE(s.contains(std::to_string(i))) << i;
+        ASSERT_EQ(i, s.size());
+    }
+
+    EXPECT_EQ(-1, s.height());
+    EXPECT_TRUE(s.begin() == s.end());
+
+    s.add("AGAIN");
+    EXPECT_TRUE(s.contains("AGAIN"));
+    EXPECT_EQ(1, s.size());
+}
+
+
+TEST(AVLSetTests, removingFromFrozenOrUnbalancedSet)
+{
+    AVLSet<int> frozen;
+    AVLSet<int> unbalanced{false};
+
+    for (int i = 0; i < 200; ++i)
+    {
+        frozen.add(i);
+        unbalanced.add(i);
+    }
+
+    frozen.freeze();
+
+    for (int i = 0; i < 200; i += 2)
+    {
+        frozen.remove(i + 1);
+        unbalanced.remove(i + 1);
+    }
+
+    EXPECT_FALSE(frozen.isFrozen());
+    expectOrderedQueriesWork(frozen, 100);
+    expectOrderedQueriesWork(unbalanced, 100);
+    EXPECT_EQ(99, unbalanced.height());
+}
+
+
+TEST(AVLSetTests, statisticsReportTheShapeAndLookupsOfTheTree)
+{
+    AVLSet<int> s;
+
+    for (int i = 0; i < 127; ++i)
+    {
+        s.add(i);
+    }
+
+    s.resetStatistics();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        s.contains(i * 20);
+    }
+
+    SetStatistics statistics = s.statistics();
+
+    EXPECT_EQ(127, statistics.elementCount);
+    EXPECT_EQ(s.height() + 1, statistics.levels);
+    EXPECT_GE(statistics.memoryBytes, 127 * sizeof(int));
+    EXPECT_EQ(SET_STATISTICS_ENABLED, statistics.countsLookups);
+
+    if (SET_STATISTICS_ENABLED)
+    {
+        EXPECT_EQ(10, statistics.lookups);
+        EXPECT_GE(statistics.comparisonsPerLookup(), statistics.probesPerLookup());
+        EXPECT_LE(statistics.maxProbes, statistics.levels);
+        EXPECT_GT(statistics.maxProbes, 0);
+    }
+    else
+    {
+        EXPECT_EQ(0, statistics.lookups);
+        EXPECT_EQ(0, statistics.comparisons);
+    }
+
+    AVLSet<int> copy{s};
+    EXPECT_EQ(0, copy.statistics().lookups);
+
+    s.resetStatistics();
+    EXPECT_EQ(0, s.statistics().lookups);
+}
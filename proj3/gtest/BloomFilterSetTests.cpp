@@ -0,0 +1,220 @@
+// BloomFilterSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the BloomFilterSet, checking that it never rejects an
+// element that was added, and that it lets through about as many missing
+// elements as its false positive rate says it should.
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+#include "BloomFilterSet.hpp"
+#include "FlatHashSet.hpp"
+#include "ListSet.hpp"
+#include "StringHashing.hpp"
+
+
+namespace
+{
+    using StringBloomFilterSet = BloomFilterSet<std::string, StringHashAsFnv1a>;
+
+
+    // A CountingSet is a ListSet that counts how many times it's asked
+    // whether it contains something.
+    class CountingSet : public ListSet<std::string>
+    {
+    public:
+        explicit CountingSet(unsigned int& lookups)
+            : lookups{lookups}
+        {
+        }
+
+        virtual bool contains(const std::string& element) const override
+        {
+            ++lookups;
+            return ListSet<std::string>::contains(element);
+        }
+
+    private:
+        unsigned int& lookups;
+    };
+
+
+    std::vector<std::string> makeWords(const std::string& prefix, unsigned int count)
+    {
+        std::vector<std::string> words;
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            words.push_back(prefix + std::to_string(i * 7919));
+        }
+
+        return words;
+    }
+
+
+    std::unique_ptr<StringBloomFilterSet> makeFilter(double falsePositiveRate)
+    {
+        return std::make_unique<StringBloomFilterSet>(
+            std::make_unique<FlatHashSet<std::string, StringHashAsProduct>>(StringHashAsProduct{}),
+            StringHashAsFnv1a{}, falsePositiveRate);
+    }
+
+
+    double measuredRate(const StringBloomFilterSet& s, const std::vector<std::string>& missing)
+    {
+        unsigned int passed = 0;
+
+        for (const std::string& word : missing)
+        {
+            if (s.mightContain(word))
+            {
+                ++passed;
+            }
+        }
+
+        return static_cast<double>(passed) / missing.size();
+    }
+}
+
+
+TEST(BloomFilterSetTests, containsExactlyWhatWasAdded)
+{
+    std::unique_ptr<StringBloomFilterSet> s = makeFilter(0.01);
+    s->add("APPLE");
+    s->add("BANANA");
+    s->add("APPLE");
+
+    EXPECT_TRUE(s->isImplemented());
+    EXPECT_EQ(2, s->size());
+    EXPECT_TRUE(s->contains("APPLE"));
+    EXPECT_TRUE(s->contains("BANANA"));
+    EXPECT_FALSE(s->contains("CHERRY"));
+    EXPECT_FALSE(s->contains(""));
+}
+
+
+TEST(BloomFilterSetTests, emptySetRejectsEverything)
+{
+    std::unique_ptr<StringBloomFilterSet> s = makeFilter(0.01);
+
+    EXPECT_FALSE(s->mightContain("A"));
+    EXPECT_EQ(0, s->stageCount());
+    EXPECT_EQ(0, s->filterSize());
+}
+
+
+TEST(BloomFilterSetTests, addAllBuildsOneStageForTheConfiguredRate)
+{
+    std::vector<std::string> words = makeWords("W", 20000);
+    std::unique_ptr<StringBloomFilterSet> s = makeFilter(0.01);
+    s->addAll(words.data(), words.data() + words.size(), false);
+
+    EXPECT_EQ(1, s->stageCount());
+    EXPECT_EQ(20000, s->size());
+
+    for (const std::string& word : words)
+    {
+        ASSERT_TRUE(s->mightContain(word)) << word;
+    }
+
+    EXPECT_LT(measuredRate(*s, makeWords("X", 100000)), 0.015);
+}
+
+
+TEST(BloomFilterSetTests, lowerRateUsesMoreBitsAndPassesFewer)
+{
+    std::vector<std::string> words = makeWords("W", 20000);
+    std::vector<std::string> missing = makeWords("X", 100000);
+
+    std::unique_ptr<StringBloomFilterSet> loose = makeFilter(0.05);
+    std::unique_ptr<StringBloomFilterSet> tight = makeFilter(0.001);
+    loose->addAll(words.data(), words.data() + words.size(), false);
+    tight->addAll(words.data(), words.data() + words.size(), false);
+
+    EXPECT_LT(loose->filterSize(), tight->filterSize());
+    EXPECT_LT(measuredRate(*loose, missing), 0.075);
+    EXPECT_LT(measuredRate(*tight, missing), 0.0015);
+}
+
+
+TEST(BloomFilterSetTests, growingThroughAddKeepsEveryElement)
+{
+    std::vector<std::string> words = makeWords("W", 20000);
+    std::unique_ptr<StringBloomFilterSet> s = makeFilter(0.01);
+
+    for (const std::string& word : words)
+    {
+        s->add(word);
+    }
+
+    EXPECT_GT(s->stageCount(), 1);
+
+    for (const std::string& word : words)
+    {
+        ASSERT_TRUE(s->contains(word)) << word;
+    }
+
+    EXPECT_LT(measuredRate(*s, makeWords("X", 100000)), 0.02);
+}
+
+
+TEST(BloomFilterSetTests, missesRarelyReachTheSet)
+{
+    unsigned int lookups = 0;
+    StringBloomFilterSet s{std::make_unique<CountingSet>(lookups), StringHashAsFnv1a{}, 0.01};
+
+    std::vector<std::string> words = makeWords("W", 1000);
+    s.addAll(words.data(), words.data() + words.size(), false);
+
+    for (const std::string& word : makeWords("X", 10000))
+    {
+        ASSERT_FALSE(s.contains(word));
+    }
+
+    EXPECT_LT(lookups, 150);
+}
+
+
+TEST(BloomFilterSetTests, ratesOutsideTheRangeAreClamped)
+{
+    EXPECT_EQ(StringBloomFilterSet::DEFAULT_FALSE_POSITIVE_RATE, makeFilter(0.0)->falsePositiveRate());
+    EXPECT_EQ(StringBloomFilterSet::DEFAULT_FALSE_POSITIVE_RATE, makeFilter(-1.0)->falsePositiveRate());
+    EXPECT_EQ(StringBloomFilterSet::MIN_FALSE_POSITIVE_RATE, makeFilter(1e-9)->falsePositiveRate());
+    EXPECT_EQ(StringBloomFilterSet::MAX_FALSE_POSITIVE_RATE, makeFilter(0.9)->falsePositiveRate());
+}
+
+
+TEST(BloomFilterSetTests, setThatIsNotEmptyIsNotFiltered)
+{
+    std::unique_ptr<Set<std::string>> avl = std::make_unique<AVLSet<std::string>>();
+    avl->add("ALREADY");
+
+    StringBloomFilterSet s{std::move(avl), StringHashAsFnv1a{}};
+    s.add("ADDED");
+
+    EXPECT_TRUE(s.contains("ALREADY"));
+    EXPECT_TRUE(s.contains("ADDED"));
+    EXPECT_FALSE(s.contains("NEVER"));
+}
+
+
+TEST(BloomFilterSetTests, removingReachesTheSetButLeavesTheFilter)
+{
+    std::unique_ptr<StringBloomFilterSet> s = makeFilter(0.01);
+    s->add("APPLE");
+    s->add("BANANA");
+
+    EXPECT_TRUE(s->remove("APPLE"));
+    EXPECT_FALSE(s->remove("APPLE"));
+    EXPECT_FALSE(s->remove("CHERRY"));
+
+    EXPECT_EQ(1, s->size());
+    EXPECT_FALSE(s->contains("APPLE"));
+    EXPECT_TRUE(s->contains("BANANA"));
+    EXPECT_TRUE(s->mightContain("APPLE"));
+}
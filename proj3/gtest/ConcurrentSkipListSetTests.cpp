@@ -0,0 +1,313 @@
+// ConcurrentSkipListSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the ConcurrentSkipListSet: first on one thread, as any
+// other Set, then with several threads adding and removing at once, while
+// others check that elements nobody is changing are always found.
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ConcurrentSkipListSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int THREAD_COUNT = 8;
+
+
+    template <typename Function>
+    void runOnThreads(unsigned int count, Function function)
+    {
+        std::vector<std::thread> threads;
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            threads.emplace_back(function, i);
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+
+    // A HookedKey runs beforeNextComparison (once) the next time two of
+    // them are compared, which lets a test do something in the middle of
+    // one of the set's operations.
+    struct HookedKey
+    {
+        int key;
+
+        static std::function<void()> beforeNextComparison;
+    };
+
+    std::function<void()> HookedKey::beforeNextComparison;
+
+
+    bool operator<(const HookedKey& a, const HookedKey& b)
+    {
+        if (HookedKey::beforeNextComparison)
+        {
+            std::function<void()> hook = std::move(HookedKey::beforeNextComparison);
+            HookedKey::beforeNextComparison = nullptr;
+            hook();
+        }
+
+        return a.key < b.key;
+    }
+}
+
+
+TEST(ConcurrentSkipListSetTests, behavesLikeASetOnOneThread)
+{
+    ConcurrentSkipListSet<std::string> s;
+    Set<std::string>& ss = s;
+
+    EXPECT_TRUE(ss.isImplemented());
+    EXPECT_FALSE(ss.contains("A"));
+    EXPECT_FALSE(ss.remove("A"));
+
+    for (int i = 0; i < 500; ++i)
+    {
+        ss.add(std::to_string((i * 7919) % 500));
+        ss.add(std::to_string((i * 7919) % 500));
+    }
+
+    EXPECT_EQ(500, ss.size());
+
+    for (int i = 0; i < 500; i += 2)
+    {
+        ASSERT_TRUE(ss.remove(std::to_string(i)));
+    }
+
+    EXPECT_EQ(250, ss.size());
+
+    for (int i = 0; i < 500; ++i)
+    {
+        ASSERT_EQ(i % 2 == 1, ss.contains(std::to_string(i))) << i;
+    }
+
+    EXPECT_FALSE(ss.contains("500"));
+    EXPECT_FALSE(ss.contains(""));
+    EXPECT_GT(s.levelCount(), 1);
+}
+
+
+TEST(ConcurrentSkipListSetTests, concurrentAddsAreAllFound)
+{
+    ConcurrentSkipListSet<int> s;
+
+    // Each thread adds every THREAD_COUNT-th number, so the threads are
+    // always adding next to each other.
+    runOnThreads(
+        THREAD_COUNT,
+        [&](unsigned int thread)
+        {
+            for (int i = thread; i < 16000; i += THREAD_COUNT)
+            {
+                s.add(i);
+            }
+        });
+
+    EXPECT_EQ(16000, s.size());
+
+    for (int i = 0; i < 16000; ++i)
+    {
+        ASSERT_TRUE(s.contains(i)) << i;
+    }
+
+    EXPECT_FALSE(s.contains(16000));
+}
+
+
+TEST(ConcurrentSkipListSetTests, concurrentAddsOfTheSameElementsAddEachOnce)
+{
+    ConcurrentSkipListSet<int> s;
+
+    runOnThreads(
+        THREAD_COUNT,
+        [&](unsigned int thread)
+        {
+            for (int i = 0; i < 2000; ++i)
+            {
+                s.add(i);
+            }
+        });
+
+    EXPECT_EQ(2000, s.size());
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        ASSERT_TRUE(s.contains(i)) << i;
+    }
+}
+
+
+TEST(ConcurrentSkipListSetTests, concurrentRemovesRemoveEachElementOnce)
+{
+    ConcurrentSkipListSet<int> s;
+
+    for (int i = 0; i < 4000; ++i)
+    {
+        s.add(i);
+    }
+
+    std::atomic<unsigned int> removed{0};
+
+    runOnThreads(
+        THREAD_COUNT,
+        [&](unsigned int thread)
+        {
+            for (int i = 0; i < 4000; ++i)
+            {
+                if (s.remove((i + thread * 500) % 4000))
+                {
+                    ++removed;
+                }
+            }
+        });
+
+    EXPECT_EQ(4000, removed);
+    EXPECT_EQ(0, s.size());
+
+    for (int i = 0; i < 4000; ++i)
+    {
+        ASSERT_FALSE(s.contains(i)) << i;
+    }
+
+    s.add(17);
+    EXPECT_TRUE(s.contains(17));
+}
+
+
+TEST(ConcurrentSkipListSetTests, readersFindUnchangedElementsWhileWritersChurn)
+{
+    ConcurrentSkipListSet<int> s;
+
+    // The even numbers are never changed; each writer adds and removes the
+    // odd numbers in its own range, over and over, ending with the ones
+    // whose round number matches them added.
+    for (int i = 0; i < 4000; i += 2)
+    {
+        s.add(i);
+    }
+
+    constexpr unsigned int WRITER_COUNT = THREAD_COUNT / 2;
+    constexpr int RANGE = 4000 / WRITER_COUNT;
+    constexpr int ROUNDS = 20;
+
+    std::atomic<unsigned int> writersFinished{0};
+    std::atomic<unsigned int> missing{0};
+    std::atomic<unsigned int> extra{0};
+
+    runOnThreads(
+        THREAD_COUNT,
+        [&](unsigned int thread)
+        {
+            if (thread < WRITER_COUNT)
+            {
+                for (int round = 0; round < ROUNDS; ++round)
+                {
+                    for (int i = thread * RANGE + 1; i < static_cast<int>(thread + 1) * RANGE; i += 2)
+                    {
+                        s.add(i);
+                    }
+
+                    for (int i = thread * RANGE + 1; i < static_cast<int>(thread + 1) * RANGE; i += 2)
+                    {
+                        if (i % ROUNDS != round)
+                        {
+                            s.remove(i);
+                        }
+                    }
+                }
+
+                ++writersFinished;
+            }
+            else
+            {
+                do
+                {
+                    for (int i = 0; i < 4000; i += 2)
+                    {
+                        if (!s.contains(i))
+                        {
+                            ++missing;
+                        }
+
+                        if (s.contains(4000 + i))
+                        {
+                            ++extra;
+                        }
+                    }
+                }
+                while (writersFinished < WRITER_COUNT);
+            }
+        });
+
+    EXPECT_EQ(0, missing);
+    EXPECT_EQ(0, extra);
+
+    unsigned int expectedSize = 2000;
+
+    for (int i = 1; i < 4000; i += 2)
+    {
+        bool expected = i % ROUNDS == ROUNDS - 1;
+        ASSERT_EQ(expected, s.contains(i)) << i;
+        expectedSize += expected ? 1 : 0;
+    }
+
+    EXPECT_EQ(expectedSize, s.size());
+}
+
+
+// The element is added by another thread after remove() has decided how
+// many levels to go down through, but before it finds the element, which
+// it does only if the element is taller than that; otherwise, the attempt
+// is tried again with a new set.  Either way, once remove() has finished,
+// nothing should be linked to the node anymore.
+
+TEST(ConcurrentSkipListSetTests, removingANodeTallerThanTheLevelsAtTheStartUnlinksItEverywhere)
+{
+    bool tested = false;
+
+    for (unsigned int attempt = 0; attempt < 10000 && !tested; ++attempt)
+    {
+        ConcurrentSkipListSet<HookedKey> s;
+        s.add(HookedKey{10});
+
+        if (s.levelCount() != 2)
+        {
+            continue;
+        }
+
+        HookedKey::beforeNextComparison =
+            [&]()
+            {
+                std::thread{[&]() { s.add(HookedKey{42}); }}.join();
+                tested = s.levelCount() > 2;
+            };
+
+        ASSERT_TRUE(s.remove(HookedKey{42}));
+        ASSERT_FALSE(HookedKey::beforeNextComparison);
+
+        EXPECT_EQ(1, s.size());
+        EXPECT_FALSE(s.contains(HookedKey{42}));
+        EXPECT_EQ(1, s.elementsOnLevel(0));
+        EXPECT_EQ(1, s.elementsOnLevel(1));
+
+        for (unsigned int level = 2; level < s.levelCount(); ++level)
+        {
+            ASSERT_EQ(0, s.elementsOnLevel(level)) << level;
+        }
+    }
+
+    EXPECT_TRUE(tested);
+}
@@ -0,0 +1,186 @@
+// DeletionIndexTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the DeletionIndex, including a comparison against a
+// brute-force search of a dictionary of random words.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "DeletionIndex.hpp"
+#include "ListSet.hpp"
+#include "WordChecker.hpp"
+
+
+namespace
+{
+    DeletionIndex makeIndex(const std::vector<std::string>& words, unsigned int maxDistance = 2)
+    {
+        return DeletionIndex{words.data(), words.data() + words.size(), false, maxDistance};
+    }
+
+
+    // The optimal string alignment distance, computed with the whole table.
+    unsigned int distance(const std::string& a, const std::string& b)
+    {
+        std::vector<std::vector<unsigned int>> d(
+            a.length() + 1, std::vector<unsigned int>(b.length() + 1));
+
+        for (std::size_t i = 0; i <= a.length(); ++i)
+        {
+            for (std::size_t j = 0; j <= b.length(); ++j)
+            {
+                if (i == 0 || j == 0)
+                {
+                    d[i][j] = i + j;
+                    continue;
+                }
+
+                d[i][j] = std::min({
+                    d[i - 1][j] + 1, d[i][j - 1] + 1,
+                    d[i - 1][j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1)});
+
+                if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                {
+                    d[i][j] = std::min(d[i][j], d[i - 2][j - 2] + 1);
+                }
+            }
+        }
+
+        return d[a.length()][b.length()];
+    }
+
+
+    std::string randomWord(std::mt19937& random)
+    {
+        std::uniform_int_distribution<int> length{1, 7};
+        std::uniform_int_distribution<int> letter{'A', 'E'};
+
+        std::string word(length(random), ' ');
+
+        for (char& c : word)
+        {
+            c = static_cast<char>(letter(random));
+        }
+
+        return word;
+    }
+}
+
+
+TEST(DeletionIndexTests, findsWordsOneEditAway)
+{
+    DeletionIndex index = makeIndex({"CAT", "CART", "COAT", "DOG", "CT"});
+
+    EXPECT_EQ((std::vector<std::string>{"CAT"}), index.suggestionsFor("CAX"));
+    EXPECT_EQ((std::vector<std::string>{"CART", "CAT", "COAT"}), index.suggestionsFor("CAAT"));
+    EXPECT_EQ((std::vector<std::string>{"DOG"}), index.suggestionsFor("ODG"));
+}
+
+
+TEST(DeletionIndexTests, findsWordsTwoEditsAwayOnlyWhenNothingIsCloser)
+{
+    DeletionIndex index = makeIndex({"COAT", "BOAT", "ZEBRA"});
+    DeletionIndex oneEdit = makeIndex({"COAT", "BOAT", "ZEBRA"}, 1);
+
+    EXPECT_EQ((std::vector<std::string>{"BOAT", "COAT"}), index.suggestionsFor("KOAX"));
+    EXPECT_TRUE(oneEdit.suggestionsFor("KOAX").empty());
+    EXPECT_TRUE(index.suggestionsFor("XYZ").empty());
+}
+
+
+TEST(DeletionIndexTests, doesNotSuggestTheWordItself)
+{
+    DeletionIndex index = makeIndex({"CAT", "CAR"});
+
+    EXPECT_EQ((std::vector<std::string>{"CAR"}), index.suggestionsFor("CAT"));
+}
+
+
+TEST(DeletionIndexTests, duplicateWordsAreIndexedOnce)
+{
+    DeletionIndex index = makeIndex({"B", "A", "B", "A"});
+
+    EXPECT_EQ(2, index.wordCount());
+    EXPECT_EQ((std::vector<std::string>{"A", "B"}), index.suggestionsFor("C"));
+}
+
+
+TEST(DeletionIndexTests, emptyIndexSuggestsNothing)
+{
+    DeletionIndex index = makeIndex({});
+
+    EXPECT_EQ(0, index.wordCount());
+    EXPECT_TRUE(index.suggestionsFor("ANYTHING").empty());
+    EXPECT_TRUE(index.suggestionsFor("").empty());
+}
+
+
+TEST(DeletionIndexTests, matchesBruteForceSearch)
+{
+    std::mt19937 random{46};
+    std::vector<std::string> words;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        words.push_back(randomWord(random));
+    }
+
+    for (unsigned int maxDistance : {1u, 2u})
+    {
+        DeletionIndex index = makeIndex(words, maxDistance);
+
+        for (int q = 0; q < 300; ++q)
+        {
+            std::string query = randomWord(random);
+
+            std::vector<std::string> expected;
+            unsigned int best = maxDistance;
+
+            for (const std::string& word : words)
+            {
+                unsigned int d = distance(query, word);
+
+                if (d == 0 || d > best)
+                {
+                    continue;
+                }
+                else if (d < best)
+                {
+                    best = d;
+                    expected.clear();
+                }
+
+                expected.push_back(word);
+            }
+
+            std::sort(expected.begin(), expected.end());
+            expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+            ASSERT_EQ(expected, index.suggestionsFor(query)) << query << ", distance " << maxDistance;
+        }
+    }
+}
+
+
+TEST(DeletionIndexTests, wordCheckerCanFindSuggestionsInIndex)
+{
+    std::vector<std::string> words{"HELLO", "HALLO", "HELP"};
+
+    ListSet<std::string> set;
+
+    for (const std::string& word : words)
+    {
+        set.add(word);
+    }
+
+    DeletionIndex index = makeIndex(words);
+    WordChecker checker{set, index};
+
+    EXPECT_TRUE(checker.wordExists("HELP"));
+    EXPECT_EQ((std::vector<std::string>{"HALLO", "HELLO"}), checker.findSuggestions("HXLLO"));
+}
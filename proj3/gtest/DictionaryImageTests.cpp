@@ -0,0 +1,201 @@
+// DictionaryImageTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the DictionaryImage, which write images to temporary files
+// and open them again, including some that have been damaged.
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "DictionaryImage.hpp"
+
+
+namespace
+{
+    std::string tempPath(const std::string& name)
+    {
+        return ::testing::TempDir() + name;
+    }
+
+
+    std::string writeImage(const std::string& name, const std::vector<std::string>& words)
+    {
+        std::string path = tempPath(name);
+        DictionaryImage::write(path, words.data(), words.data() + words.size());
+        return path;
+    }
+
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+
+    void writeFile(const std::string& path, const std::string& contents)
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << contents;
+    }
+}
+
+
+TEST(DictionaryImageTests, containsWrittenWordsAfterOpening)
+{
+    std::string path = writeImage("image_words.img", {"ZEBRA", "APPLE", "MANGO", "KIWI"});
+
+    DictionaryImage image{path};
+
+    EXPECT_EQ(4, image.size());
+    EXPECT_TRUE(image.contains("APPLE"));
+    EXPECT_TRUE(image.contains("KIWI"));
+    EXPECT_TRUE(image.contains("MANGO"));
+    EXPECT_TRUE(image.contains("ZEBRA"));
+    EXPECT_FALSE(image.contains("APPL"));
+    EXPECT_FALSE(image.contains("APPLES"));
+    EXPECT_FALSE(image.contains(""));
+}
+
+
+TEST(DictionaryImageTests, duplicatesAreWrittenOnce)
+{
+    std::string path = writeImage("image_dups.img", {"B", "A", "B", "A", "C"});
+
+    DictionaryImage image{path};
+
+    EXPECT_EQ(3, image.size());
+    EXPECT_TRUE(image.contains("A"));
+    EXPECT_TRUE(image.contains("B"));
+    EXPECT_TRUE(image.contains("C"));
+}
+
+
+TEST(DictionaryImageTests, emptyImageContainsNothing)
+{
+    std::string path = writeImage("image_empty.img", {});
+
+    DictionaryImage image{path};
+
+    EXPECT_EQ(0, image.size());
+    EXPECT_FALSE(image.contains("A"));
+}
+
+
+TEST(DictionaryImageTests, unopenedImageContainsNothing)
+{
+    DictionaryImage image;
+
+    EXPECT_TRUE(image.isImplemented());
+    EXPECT_EQ(0, image.size());
+    EXPECT_EQ(0, image.imageSize());
+    EXPECT_FALSE(image.contains("A"));
+}
+
+
+TEST(DictionaryImageTests, manyWordsAreAllFound)
+{
+    std::vector<std::string> words;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        words.push_back("WORD" + std::to_string(i * 7));
+    }
+
+    DictionaryImage image{writeImage("image_many.img", words)};
+
+    EXPECT_EQ(5000, image.size());
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        ASSERT_TRUE(image.contains("WORD" + std::to_string(i * 7)));
+        ASSERT_FALSE(image.contains("WORD" + std::to_string(i * 7 + 1)));
+    }
+}
+
+
+TEST(DictionaryImageTests, imageCannotBeChanged)
+{
+    DictionaryImage image{writeImage("image_readonly.img", {"A"})};
+    std::string words[] = {"B"};
+
+    EXPECT_THROW(image.add("B"), DictionaryImage::ImageException);
+    EXPECT_THROW(image.addAll(words, words + 1, true), DictionaryImage::ImageException);
+    EXPECT_THROW(image.remove("A"), DictionaryImage::ImageException);
+    EXPECT_FALSE(image.contains("B"));
+    EXPECT_TRUE(image.contains("A"));
+}
+
+
+TEST(DictionaryImageTests, reopeningReplacesImage)
+{
+    std::string first = writeImage("image_first.img", {"A"});
+    std::string second = writeImage("image_second.img", {"B", "C"});
+
+    DictionaryImage image{first};
+    image.open(second);
+
+    EXPECT_EQ(2, image.size());
+    EXPECT_FALSE(image.contains("A"));
+    EXPECT_TRUE(image.contains("B"));
+}
+
+
+TEST(DictionaryImageTests, missingFileThrows)
+{
+    EXPECT_THROW(
+        DictionaryImage{tempPath("image_does_not_exist.img")},
+        DictionaryImage::ImageException);
+}
+
+
+TEST(DictionaryImageTests, textFileIsNotAnImage)
+{
+    std::string path = tempPath("image_text.img");
+    writeFile(path, "APPLE\nBANANA\nCHERRY\nDATE\nELDERBERRY\nFIG\nGRAPE\n");
+
+    EXPECT_THROW(DictionaryImage{path}, DictionaryImage::ImageException);
+}
+
+
+TEST(DictionaryImageTests, wrongVersionThrows)
+{
+    std::string path = writeImage("image_version.img", {"A", "B"});
+    std::string contents = readFile(path);
+    contents[8] = static_cast<char>(contents[8] + 1);
+    writeFile(path, contents);
+
+    try
+    {
+        DictionaryImage image{path};
+        FAIL() << "Expected an ImageException";
+    }
+    catch (DictionaryImage::ImageException& e)
+    {
+        EXPECT_NE(std::string::npos, e.reason().find("version"));
+    }
+}
+
+
+TEST(DictionaryImageTests, truncatedImageThrows)
+{
+    std::string path = writeImage("image_truncated.img", {"APPLE", "BANANA"});
+    std::string contents = readFile(path);
+    contents.pop_back();
+    writeFile(path, contents);
+
+    EXPECT_THROW(DictionaryImage{path}, DictionaryImage::ImageException);
+}
+
+
+TEST(DictionaryImageTests, failedOpenLeavesPreviousImageOpen)
+{
+    DictionaryImage image{writeImage("image_kept.img", {"A"})};
+
+    EXPECT_THROW(image.open(tempPath("image_does_not_exist.img")), DictionaryImage::ImageException);
+    EXPECT_TRUE(image.contains("A"));
+}
@@ -0,0 +1,127 @@
+// EpochReclaimerTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the EpochReclaimer, checking that retired memory is
+// freed eventually, but never while a thread that was pinned when it was
+// retired is still pinned.
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <gtest/gtest.h>
+#include "EpochReclaimer.hpp"
+
+
+namespace
+{
+    std::atomic<unsigned int> freedCount{0};
+
+
+    void countAndFree(void* p) noexcept
+    {
+        ++freedCount;
+        delete static_cast<int*>(p);
+    }
+
+
+    void retireMany(EpochReclaimer& reclaimer, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            EpochReclaimer::Guard guard{reclaimer};
+            reclaimer.retire(new int{static_cast<int>(i)}, countAndFree);
+        }
+    }
+}
+
+
+TEST(EpochReclaimerTests, retiredMemoryIsFreedOnceNobodyIsPinned)
+{
+    freedCount = 0;
+
+    {
+        EpochReclaimer reclaimer;
+        retireMany(reclaimer, 10 * EpochReclaimer::ADVANCE_INTERVAL);
+
+        EXPECT_GT(reclaimer.epoch(), 0);
+        EXPECT_GT(freedCount, 0);
+        EXPECT_EQ(10 * EpochReclaimer::ADVANCE_INTERVAL, freedCount + reclaimer.pendingCount());
+        EXPECT_LE(reclaimer.pendingCount(), 4 * EpochReclaimer::ADVANCE_INTERVAL);
+    }
+
+    EXPECT_EQ(10 * EpochReclaimer::ADVANCE_INTERVAL, freedCount);
+}
+
+
+TEST(EpochReclaimerTests, pinnedThreadHoldsBackFreeing)
+{
+    freedCount = 0;
+    EpochReclaimer reclaimer;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool pinned = false;
+    bool finished = false;
+
+    std::thread reader{
+        [&]()
+        {
+            EpochReclaimer::Guard guard{reclaimer};
+            std::unique_lock<std::mutex> lock{mutex};
+            pinned = true;
+            changed.notify_all();
+            changed.wait(lock, [&]() { return finished; });
+        }};
+
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        changed.wait(lock, [&]() { return pinned; });
+    }
+
+    retireMany(reclaimer, 10 * EpochReclaimer::ADVANCE_INTERVAL);
+    EXPECT_EQ(0, freedCount);
+    EXPECT_LE(reclaimer.epoch(), 1);
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        finished = true;
+        changed.notify_all();
+    }
+
+    reader.join();
+
+    retireMany(reclaimer, 10 * EpochReclaimer::ADVANCE_INTERVAL);
+    EXPECT_GT(freedCount, 0);
+}
+
+
+TEST(EpochReclaimerTests, manyThreadsCanComeAndGo)
+{
+    freedCount = 0;
+
+    {
+        EpochReclaimer reclaimer;
+
+        // More threads over time than there are slots, so slots have to be
+        // given back and reused.
+        for (unsigned int round = 0; round < EpochReclaimer::MAX_THREADS / 4 + 1; ++round)
+        {
+            std::thread threads[8];
+
+            for (std::thread& thread : threads)
+            {
+                thread = std::thread{[&]() { retireMany(reclaimer, 4); }};
+            }
+
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+        }
+    }
+
+    EXPECT_EQ((EpochReclaimer::MAX_THREADS / 4 + 1) * 8 * 4, freedCount);
+}
@@ -0,0 +1,283 @@
+// FlatHashSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the FlatHashSet, covering growth and the cases where
+// probes have to cross group boundaries (e.g., when every element hashes
+// to the same value).
+
+#include <string>
+#include <type_traits>
+#include <gtest/gtest.h>
+#include "FlatHashSet.hpp"
+#include "StringHashing.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T& t)
+    {
+        return 0;
+    }
+
+
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+}
+
+
+TEST(FlatHashSetTests, inheritFromSet)
+{
+    FlatHashSet<int> s1{identityHash};
+    Set<int>& ss1 = s1;
+    EXPECT_EQ(0, ss1.size());
+    EXPECT_TRUE(ss1.isImplemented());
+}
+
+
+TEST(FlatHashSetTests, emptySetContainsNothing)
+{
+    FlatHashSet<int> s{identityHash};
+    EXPECT_FALSE(s.contains(0));
+    EXPECT_EQ(0, s.capacity());
+}
+
+
+TEST(FlatHashSetTests, containsElementsAfterAdding)
+{
+    FlatHashSet<int> s{identityHash};
+    s.add(11);
+    s.add(1);
+    s.add(5);
+
+    EXPECT_TRUE(s.contains(11));
+    EXPECT_TRUE(s.contains(1));
+    EXPECT_TRUE(s.contains(5));
+    EXPECT_FALSE(s.contains(2));
+    EXPECT_EQ(3, s.size());
+}
+
+
+TEST(FlatHashSetTests, addingDuplicatesHasNoEffect)
+{
+    FlatHashSet<std::string> s{zeroHash<std::string>};
+    s.add("Boo");
+    s.add("Boo");
+    s.add("Boo");
+
+    EXPECT_EQ(1, s.size());
+}
+
+
+TEST(FlatHashSetTests, growsToStayBelowMaxLoadFactor)
+{
+    FlatHashSet<int> s{identityHash, 0.5};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+        ASSERT_LE(s.loadFactor(), 0.5);
+    }
+
+    EXPECT_EQ(1000, s.size());
+    EXPECT_EQ(2048, s.capacity());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+
+    EXPECT_FALSE(s.contains(1000));
+}
+
+
+TEST(FlatHashSetTests, maxLoadFactorIsClamped)
+{
+    FlatHashSet<int> tooHigh{identityHash, 1.5};
+    FlatHashSet<int> tooLow{identityHash, -1.0};
+
+    EXPECT_DOUBLE_EQ(0.9375, tooHigh.maxLoadFactor());
+    EXPECT_DOUBLE_EQ(FlatHashSet<int>::DEFAULT_MAX_LOAD_FACTOR, tooLow.maxLoadFactor());
+}
+
+
+TEST(FlatHashSetTests, probesAcrossGroupsWhenEveryHashCollides)
+{
+    FlatHashSet<int> s{zeroHash<int>};
+
+    for (int i = 0; i < 200; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(200, s.size());
+
+    for (int i = 0; i < 200; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+
+    EXPECT_FALSE(s.contains(200));
+    EXPECT_FALSE(s.contains(-1));
+}
+
+
+TEST(FlatHashSetTests, copiesAreIndependent)
+{
+    FlatHashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("A");
+    s1.add("B");
+
+    FlatHashSet<std::string> s2{s1};
+    s2.add("C");
+
+    FlatHashSet<std::string> s3{zeroHash<std::string>};
+    s3 = s2;
+    s3.add("D");
+
+    EXPECT_EQ(2, s1.size());
+    EXPECT_FALSE(s1.contains("C"));
+    EXPECT_EQ(3, s2.size());
+    EXPECT_TRUE(s2.contains("A"));
+    EXPECT_FALSE(s2.contains("D"));
+    EXPECT_EQ(4, s3.size());
+    EXPECT_TRUE(s3.contains("C"));
+}
+
+
+TEST(FlatHashSetTests, moveLeavesSourceUsable)
+{
+    FlatHashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("A");
+
+    FlatHashSet<std::string> s2{std::move(s1)};
+    EXPECT_TRUE(s2.contains("A"));
+
+    s1.add("B");
+    EXPECT_TRUE(s1.contains("B"));
+
+    s2 = std::move(s1);
+    EXPECT_TRUE(s2.contains("B"));
+}
+
+
+TEST(FlatHashSetTests, movingIsNoexceptOnlyWhenCopyingTheHashFunctionCantThrow)
+{
+    EXPECT_TRUE((std::is_nothrow_move_constructible_v<FlatHashSet<std::string, StringHashAsFnv1a>>));
+    EXPECT_TRUE((std::is_nothrow_move_assignable_v<FlatHashSet<std::string, StringHashAsFnv1a>>));
+    EXPECT_FALSE(std::is_nothrow_move_constructible_v<FlatHashSet<int>>);
+}
+
+
+TEST(FlatHashSetTests, canUseHashFunctionObjectType)
+{
+    FlatHashSet<std::string, StringHashAsFnv1a> s{StringHashAsFnv1a{}};
+    s.add("HELLO");
+    s.add("THERE");
+
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_FALSE(s.contains("BOO"));
+}
+
+
+TEST(FlatHashSetTests, addAllReservesCapacityFirst)
+{
+    int elements[1000];
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        elements[i] = 999 - i;
+    }
+
+    FlatHashSet<int> s{identityHash};
+    s.addAll(elements, elements + 1000, false);
+
+    EXPECT_EQ(1000, s.size());
+    EXPECT_EQ(2048, s.capacity());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+}
+
+
+TEST(FlatHashSetTests, removedElementsAreNotFound)
+{
+    FlatHashSet<int> s{identityHash};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i);
+    }
+
+    for (int i = 0; i < 100; i += 3)
+    {
+        EXPECT_TRUE(s.remove(i));
+    }
+
+    EXPECT_FALSE(s.remove(0));
+    EXPECT_FALSE(s.remove(100));
+    EXPECT_EQ(66, s.size());
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(i % 3 != 0, s.contains(i)) << i;
+    }
+}
+
+
+TEST(FlatHashSetTests, removingFromLongProbeSequenceKeepsLaterElements)
+{
+    FlatHashSet<int> s{zeroHash<int>};
+
+    for (int i = 0; i < 200; ++i)
+    {
+        s.add(i);
+    }
+
+    for (int i = 0; i < 200; i += 2)
+    {
+        EXPECT_TRUE(s.remove(i));
+    }
+
+    for (int i = 0; i < 200; ++i)
+    {
+        ASSERT_EQ(i % 2 == 1, s.contains(i)) << i;
+    }
+
+    s.add(0);
+    EXPECT_TRUE(s.contains(0));
+    EXPECT_EQ(101, s.size());
+}
+
+
+TEST(FlatHashSetTests, churnDoesNotGrowTheArray)
+{
+    FlatHashSet<int> s{identityHash};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i * 7919);
+    }
+
+    unsigned int capacity = s.capacity();
+
+    // Each element is removed 100 additions after it was added, so the set
+    // never holds more than 100 at a time, however many slots the removals
+    // leave behind.
+    for (int i = 100; i < 100000; ++i)
+    {
+        s.add(i * 7919);
+        ASSERT_TRUE(s.remove((i - 100) * 7919));
+    }
+
+    EXPECT_EQ(100, s.size());
+    EXPECT_LE(s.capacity(), 2 * capacity);
+    EXPECT_TRUE(s.contains(99999 * 7919));
+    EXPECT_FALSE(s.contains(99899 * 7919));
+}
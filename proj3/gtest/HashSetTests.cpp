@@ -0,0 +1,343 @@
+// HashSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the HashSet beyond the sanity checks, mostly around how
+// and when it grows.
+
+#include <string>
+#include <type_traits>
+#include <gtest/gtest.h>
+#include "HashSet.hpp"
+
+
+namespace
+{
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+
+
+    struct CountingHash
+    {
+        unsigned int* calls;
+
+        unsigned int operator()(const int& i) const
+        {
+            ++*calls;
+            return static_cast<unsigned int>(i);
+        }
+    };
+}
+
+
+TEST(HashSetTests, growsWhenLoadFactorExceedsMaximum)
+{
+    HashSet<int> s{identityHash};
+
+    for (int i = 0; i < 8; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(10, s.capacity());
+    EXPECT_FALSE(s.isResizing());
+
+    s.add(8);
+
+    EXPECT_EQ(20, s.capacity());
+    EXPECT_TRUE(s.isResizing());
+}
+
+
+TEST(HashSetTests, thresholdAndGrowthFactorCanBeChosen)
+{
+    HashSet<int> s{identityHash, 0.5, 3.0};
+
+    for (int i = 0; i < 6; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(30, s.capacity());
+}
+
+
+TEST(HashSetTests, resizeIsSpreadOverLaterOperations)
+{
+    HashSet<int> s{identityHash};
+
+    for (int i = 0; i < 9; ++i)
+    {
+        s.add(i);
+    }
+
+    ASSERT_TRUE(s.isResizing());
+
+    s.contains(0);
+    EXPECT_TRUE(s.isResizing());
+
+    s.contains(0);
+    s.contains(0);
+    EXPECT_FALSE(s.isResizing());
+}
+
+
+TEST(HashSetTests, elementsAreFoundWhileResizing)
+{
+    HashSet<int> s{identityHash};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+
+        for (int j = 0; j <= i; j += 97)
+        {
+            ASSERT_TRUE(s.contains(j));
+        }
+    }
+
+    EXPECT_EQ(1000, s.size());
+    EXPECT_LE(s.loadFactor(), HashSet<int>::DEFAULT_MAX_LOAD_FACTOR);
+    EXPECT_FALSE(s.contains(1000));
+}
+
+
+TEST(HashSetTests, elementsAtIndexDescribesNewArrayWhileResizing)
+{
+    HashSet<int> s{identityHash};
+
+    for (int i = 0; i < 9; ++i)
+    {
+        s.add(i);
+    }
+
+    ASSERT_TRUE(s.isResizing());
+
+    unsigned int total = 0;
+
+    for (unsigned int i = 0; i < s.capacity(); ++i)
+    {
+        total += s.elementsAtIndex(i);
+    }
+
+    EXPECT_EQ(9, total);
+    EXPECT_FALSE(s.isResizing());
+    EXPECT_EQ(1, s.elementsAtIndex(8));
+    EXPECT_TRUE(s.isElementAtIndex(8, 8));
+    EXPECT_FALSE(s.isElementAtIndex(8, 18));
+    EXPECT_EQ(0, s.elementsAtIndex(s.capacity()));
+}
+
+
+TEST(HashSetTests, copiesMadeWhileResizingContainEverything)
+{
+    HashSet<int> s{identityHash};
+
+    for (int i = 0; i < 9; ++i)
+    {
+        s.add(i);
+    }
+
+    HashSet<int> copy{s};
+    EXPECT_FALSE(copy.isResizing());
+    EXPECT_EQ(9, copy.size());
+
+    for (int i = 0; i < 9; ++i)
+    {
+        EXPECT_TRUE(copy.contains(i));
+        EXPECT_TRUE(copy.isElementAtIndex(i, i));
+    }
+}
+
+
+TEST(HashSetTests, movedFromSetCanBeReused)
+{
+    HashSet<std::string> s1{[](const std::string& s) { return s.length(); }};
+    s1.add("Boo");
+
+    HashSet<std::string> s2{std::move(s1)};
+    EXPECT_TRUE(s2.contains("Boo"));
+
+    s1.add("Alex");
+    EXPECT_TRUE(s1.contains("Alex"));
+    EXPECT_EQ(1, s1.size());
+}
+
+
+TEST(HashSetTests, movingIsNoexceptOnlyWhenCopyingTheHashFunctionCantThrow)
+{
+    EXPECT_TRUE((std::is_nothrow_move_constructible_v<HashSet<int, CountingHash>>));
+    EXPECT_TRUE((std::is_nothrow_move_assignable_v<HashSet<int, CountingHash>>));
+    EXPECT_FALSE(std::is_nothrow_move_constructible_v<HashSet<int>>);
+}
+
+
+TEST(HashSetTests, canUseHashFunctionObjectType)
+{
+    unsigned int calls = 0;
+    HashSet<int, CountingHash> s{CountingHash{&calls}};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(100, s.size());
+    EXPECT_TRUE(s.contains(99));
+    EXPECT_FALSE(s.contains(100));
+
+    HashSet<int, CountingHash> copy{s};
+    EXPECT_TRUE(copy.contains(42));
+}
+
+
+TEST(HashSetTests, hashesEachElementOnceWhenAddingAndResizing)
+{
+    unsigned int calls = 0;
+    HashSet<int, CountingHash> s{CountingHash{&calls}};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(1000, calls);
+
+    s.add(0);
+    EXPECT_EQ(1001, calls);
+}
+
+
+TEST(HashSetTests, addAllGrowsOnceBeforeAdding)
+{
+    int elements[1000];
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        elements[i] = i;
+    }
+
+    HashSet<int> s{identityHash};
+    s.addAll(elements, elements + 1000, true);
+
+    EXPECT_EQ(1000, s.size());
+    EXPECT_EQ(1251, s.capacity());
+    EXPECT_FALSE(s.isResizing());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s.isElementAtIndex(i, i));
+    }
+}
+
+
+TEST(HashSetTests, reserveFinishesResizeUnderWay)
+{
+    HashSet<int> s{identityHash};
+
+    for (int i = 0; i < 9; ++i)
+    {
+        s.add(i);
+    }
+
+    ASSERT_TRUE(s.isResizing());
+
+    s.reserve(5);
+    EXPECT_FALSE(s.isResizing());
+    EXPECT_EQ(20, s.capacity());
+
+    s.reserve(100);
+    EXPECT_EQ(126, s.capacity());
+
+    for (int i = 0; i < 9; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+}
+
+
+TEST(HashSetTests, removingWorksWhileResizing)
+{
+    HashSet<int> s{identityHash};
+
+    for (int i = 0; i < 9; ++i)
+    {
+        s.add(i);
+    }
+
+    ASSERT_TRUE(s.isResizing());
+
+    // 8 hasn't been moved into the new array yet; 0 has.
+    EXPECT_TRUE(s.remove(8));
+    EXPECT_TRUE(s.remove(0));
+    EXPECT_FALSE(s.remove(0));
+    EXPECT_FALSE(s.remove(100));
+
+    EXPECT_EQ(7, s.size());
+    EXPECT_FALSE(s.contains(8));
+    EXPECT_FALSE(s.contains(0));
+
+    for (int i = 1; i < 8; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+}
+
+
+TEST(HashSetTests, removedElementsCanBeAddedAgain)
+{
+    HashSet<int> s{identityHash};
+
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 500; ++i)
+        {
+            s.add(i);
+        }
+
+        for (int i = 0; i < 500; i += 2)
+        {
+            ASSERT_TRUE(s.remove(i));
+        }
+
+        ASSERT_EQ(250, s.size());
+
+        for (int i = 0; i < 500; ++i)
+        {
+            ASSERT_EQ(i % 2 == 1, s.contains(i)) << i;
+        }
+    }
+
+    EXPECT_EQ(0, s.elementsAtIndex(0));
+    EXPECT_TRUE(s.isElementAtIndex(1, 1));
+}
+
+
+TEST(HashSetTests, statisticsCountEveryNodeInTheBucketAsAProbe)
+{
+    HashSet<int> s{[](const int&) { return 7u; }};
+
+    for (int i = 0; i < 10; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_FALSE(s.contains(10));
+    EXPECT_TRUE(s.contains(0));
+
+    SetStatistics statistics = s.statistics();
+
+    EXPECT_EQ(10, statistics.elementCount);
+    EXPECT_EQ(0, statistics.levels);
+    EXPECT_GE(statistics.memoryBytes, s.capacity() * sizeof(void*) + 10 * sizeof(int));
+
+    if (SET_STATISTICS_ENABLED)
+    {
+        EXPECT_EQ(2, statistics.lookups);
+        EXPECT_EQ(10, statistics.maxProbes);
+        EXPECT_EQ(statistics.probes, statistics.comparisons);
+    }
+}
@@ -0,0 +1,251 @@
+// LevenshteinTrieTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the LevenshteinTrie, including a comparison against a
+// brute-force ranking of a dictionary of random words.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <gtest/gtest.h>
+#include "LevenshteinTrie.hpp"
+
+
+namespace
+{
+    LevenshteinTrie makeTrie(
+        const std::vector<std::string>& words,
+        const std::vector<unsigned int>& frequencies = {},
+        unsigned int maxDistance = 2, unsigned int count = 10)
+    {
+        return LevenshteinTrie{
+            words.data(), words.data() + words.size(),
+            frequencies.empty() ? nullptr : frequencies.data(),
+            maxDistance, count};
+    }
+
+
+    std::vector<std::string> wordsOf(const std::vector<LevenshteinTrie::Suggestion>& suggestions)
+    {
+        std::vector<std::string> words;
+
+        for (const LevenshteinTrie::Suggestion& suggestion : suggestions)
+        {
+            words.push_back(suggestion.word);
+        }
+
+        return words;
+    }
+
+
+    // The optimal string alignment distance, computed with the whole table.
+    unsigned int distance(const std::string& a, const std::string& b)
+    {
+        std::vector<std::vector<unsigned int>> d(
+            a.length() + 1, std::vector<unsigned int>(b.length() + 1));
+
+        for (std::size_t i = 0; i <= a.length(); ++i)
+        {
+            for (std::size_t j = 0; j <= b.length(); ++j)
+            {
+                if (i == 0 || j == 0)
+                {
+                    d[i][j] = i + j;
+                    continue;
+                }
+
+                d[i][j] = std::min({
+                    d[i - 1][j] + 1, d[i][j - 1] + 1,
+                    d[i - 1][j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1)});
+
+                if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                {
+                    d[i][j] = std::min(d[i][j], d[i - 2][j - 2] + 1);
+                }
+            }
+        }
+
+        return d[a.length()][b.length()];
+    }
+}
+
+
+TEST(LevenshteinTrieTests, ranksByDistanceThenAlphabetically)
+{
+    LevenshteinTrie trie = makeTrie({"CART", "CAT", "COAT", "CT", "DOG", "CAST"});
+
+    std::vector<LevenshteinTrie::Suggestion> suggestions = trie.rankedSuggestionsFor("CAXT", 2, 10);
+
+    EXPECT_EQ((std::vector<std::string>{"CART", "CAST", "CAT", "COAT", "CT"}), wordsOf(suggestions));
+    EXPECT_EQ(1, suggestions[0].distance);
+    EXPECT_EQ(2, suggestions[3].distance);
+}
+
+
+TEST(LevenshteinTrieTests, moreFrequentWordsRankFirstAtSameDistance)
+{
+    LevenshteinTrie trie = makeTrie({"CART", "CAST", "CAT", "COAT"}, {5, 50, 1, 500});
+
+    std::vector<LevenshteinTrie::Suggestion> suggestions = trie.rankedSuggestionsFor("CAXT", 2, 10);
+
+    EXPECT_EQ((std::vector<std::string>{"CAST", "CART", "CAT", "COAT"}), wordsOf(suggestions));
+    EXPECT_EQ(50, suggestions[0].frequency);
+}
+
+
+TEST(LevenshteinTrieTests, returnsOnlyTheBestFew)
+{
+    LevenshteinTrie trie = makeTrie({"CART", "CAST", "CAT", "COAT"}, {}, 2, 2);
+
+    EXPECT_EQ((std::vector<std::string>{"CART", "CAST"}), trie.suggestionsFor("CAXT"));
+    EXPECT_TRUE(trie.rankedSuggestionsFor("CAXT", 2, 0).empty());
+}
+
+
+TEST(LevenshteinTrieTests, respectsMaximumDistance)
+{
+    LevenshteinTrie trie = makeTrie({"COAT", "KOALAS"});
+
+    EXPECT_EQ((std::vector<std::string>{"COAT"}), wordsOf(trie.rankedSuggestionsFor("KOAX", 2, 10)));
+    EXPECT_TRUE(trie.rankedSuggestionsFor("KOAX", 1, 10).empty());
+    EXPECT_EQ(
+        (std::vector<std::string>{"COAT", "KOALAS"}),
+        wordsOf(trie.rankedSuggestionsFor("KOAX", 3, 10)));
+}
+
+
+TEST(LevenshteinTrieTests, findsWordsThatArePrefixesOfOthers)
+{
+    LevenshteinTrie trie = makeTrie({"ABCD", "A", "ABC", "AB", ""});
+
+    EXPECT_EQ(5, trie.wordCount());
+    EXPECT_EQ(5, trie.nodeCount());
+    EXPECT_EQ((std::vector<std::string>{"AB", "ABCD", "A"}), trie.suggestionsFor("ABC"));
+    EXPECT_EQ((std::vector<std::string>{"", "AB", "ABC"}), trie.suggestionsFor("A"));
+}
+
+
+TEST(LevenshteinTrieTests, swapsOfAdjacentLettersCountOnce)
+{
+    LevenshteinTrie trie = makeTrie({"THE", "TOE"});
+
+    std::vector<LevenshteinTrie::Suggestion> suggestions = trie.rankedSuggestionsFor("TEH", 2, 10);
+
+    ASSERT_EQ(2, suggestions.size());
+    EXPECT_EQ("THE", suggestions[0].word);
+    EXPECT_EQ(1, suggestions[0].distance);
+}
+
+
+TEST(LevenshteinTrieTests, frequenciesOfRepeatedWordsAreAdded)
+{
+    LevenshteinTrie trie = makeTrie({"B", "A", "B"}, {1, 2, 2});
+
+    std::vector<LevenshteinTrie::Suggestion> suggestions = trie.rankedSuggestionsFor("C", 1, 10);
+
+    EXPECT_EQ(2, trie.wordCount());
+    EXPECT_EQ((std::vector<std::string>{"B", "A"}), wordsOf(suggestions));
+    EXPECT_EQ(3, suggestions[0].frequency);
+}
+
+
+TEST(LevenshteinTrieTests, emptyTrieSuggestsNothing)
+{
+    LevenshteinTrie trie = makeTrie({});
+
+    EXPECT_EQ(0, trie.wordCount());
+    EXPECT_TRUE(trie.suggestionsFor("ANYTHING").empty());
+}
+
+
+TEST(LevenshteinTrieTests, matchesBruteForceRanking)
+{
+    std::mt19937 random{46};
+    std::uniform_int_distribution<int> length{1, 7};
+    std::uniform_int_distribution<int> letter{'A', 'E'};
+    std::uniform_int_distribution<unsigned int> frequency{0, 3};
+
+    auto randomWord =
+        [&]()
+        {
+            std::string word(length(random), ' ');
+
+            for (char& c : word)
+            {
+                c = static_cast<char>(letter(random));
+            }
+
+            return word;
+        };
+
+    std::vector<std::string> words;
+    std::vector<unsigned int> frequencies;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        words.push_back(randomWord());
+        frequencies.push_back(frequency(random));
+    }
+
+    LevenshteinTrie trie = makeTrie(words, frequencies);
+
+    // The expected ranking, with frequencies of repeated words added.
+    std::vector<std::tuple<std::string, unsigned int>> distinct;
+
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        distinct.emplace_back(words[i], frequencies[i]);
+    }
+
+    std::sort(distinct.begin(), distinct.end());
+
+    std::vector<std::tuple<std::string, unsigned int>> merged;
+
+    for (const auto& [word, f] : distinct)
+    {
+        if (!merged.empty() && std::get<0>(merged.back()) == word)
+        {
+            std::get<1>(merged.back()) += f;
+        }
+        else
+        {
+            merged.emplace_back(word, f);
+        }
+    }
+
+    for (int q = 0; q < 300; ++q)
+    {
+        std::string query = randomWord();
+        unsigned int maxDistance = q % 3 + 1;
+        unsigned int count = q % 7 + 1;
+
+        std::vector<std::tuple<unsigned int, int, std::string>> ranked;
+
+        for (const auto& [word, f] : merged)
+        {
+            unsigned int d = distance(query, word);
+
+            if (d > 0 && d <= maxDistance)
+            {
+                ranked.emplace_back(d, -static_cast<int>(f), word);
+            }
+        }
+
+        std::sort(ranked.begin(), ranked.end());
+        ranked.resize(std::min<std::size_t>(ranked.size(), count));
+
+        std::vector<std::string> expected;
+
+        for (const auto& r : ranked)
+        {
+            expected.push_back(std::get<2>(r));
+        }
+
+        ASSERT_EQ(expected, wordsOf(trie.rankedSuggestionsFor(query, maxDistance, count)))
+            << query << ", distance " << maxDistance << ", count " << count;
+    }
+}
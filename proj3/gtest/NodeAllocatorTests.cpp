@@ -0,0 +1,230 @@
+// NodeAllocatorTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the node allocators, along with checks that each of the
+// linked Set implementations works the same way when its nodes come from
+// an ArenaNodeAllocator.
+
+#include <cstdint>
+#include <string>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+#include "HashSet.hpp"
+#include "ListSet.hpp"
+#include "NodeAllocator.hpp"
+#include "SkipListSet.hpp"
+
+
+namespace
+{
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+
+
+    struct Tracked
+    {
+        static int live;
+
+        Tracked() { ++live; }
+        Tracked(const Tracked&) { ++live; }
+        ~Tracked() { --live; }
+    };
+
+    int Tracked::live = 0;
+
+
+    template <typename SetType>
+    void addNumberWords(SetType& s, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            s.add(std::to_string(i * 7919 % count));
+        }
+    }
+
+
+    template <typename SetType>
+    void expectNumberWords(const SetType& s, int count)
+    {
+        EXPECT_EQ(count, s.size());
+
+        for (int i = 0; i < count; ++i)
+        {
+            EXPECT_TRUE(s.contains(std::to_string(i)));
+        }
+
+        EXPECT_FALSE(s.contains(std::to_string(count)));
+    }
+}
+
+
+TEST(NodeAllocatorTests, arenaAllocationsAreAlignedAndDistinct)
+{
+    ArenaNodeAllocator arena;
+
+    char* a = static_cast<char*>(arena.allocate(24));
+    char* b = static_cast<char*>(arena.allocate(1));
+    char* c = static_cast<char*>(arena.allocate(40));
+
+    for (char* p : {a, b, c})
+    {
+        EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(p) % ArenaNodeAllocator::GRANULE);
+    }
+
+    EXPECT_LE(a + 24, b);
+    EXPECT_LE(b + 1, c);
+    EXPECT_EQ(ArenaNodeAllocator::SLAB_SIZE, arena.bytesReserved());
+}
+
+
+TEST(NodeAllocatorTests, arenaRecyclesDeallocatedNodesOfTheSameSize)
+{
+    ArenaNodeAllocator arena;
+
+    void* a = arena.allocate(32);
+    void* b = arena.allocate(32);
+    arena.deallocate(a, 32);
+    arena.deallocate(b, 32);
+
+    EXPECT_EQ(b, arena.allocate(32));
+    EXPECT_EQ(a, arena.allocate(32));
+    EXPECT_NE(a, arena.allocate(32));
+}
+
+
+TEST(NodeAllocatorTests, arenaGivesOversizedRequestsTheirOwnSlab)
+{
+    ArenaNodeAllocator arena;
+
+    void* small1 = arena.allocate(16);
+    void* big = arena.allocate(ArenaNodeAllocator::SLAB_SIZE * 2);
+    void* small2 = arena.allocate(16);
+
+    EXPECT_NE(nullptr, big);
+    EXPECT_EQ(static_cast<char*>(small1) + 16, small2);
+    EXPECT_GT(arena.bytesReserved(), ArenaNodeAllocator::SLAB_SIZE * 3);
+}
+
+
+TEST(NodeAllocatorTests, arenaStartsNewSlabsAsNeeded)
+{
+    ArenaNodeAllocator arena;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        arena.allocate(48);
+    }
+
+    EXPECT_GE(arena.bytesReserved(), 48 * 10000);
+    EXPECT_LT(arena.bytesReserved(), 48 * 10000 + 2 * ArenaNodeAllocator::SLAB_SIZE);
+
+    arena.release();
+    EXPECT_EQ(0, arena.bytesReserved());
+}
+
+
+TEST(NodeAllocatorTests, movingArenaTransfersItsSlabs)
+{
+    ArenaNodeAllocator a1;
+    a1.allocate(16);
+
+    ArenaNodeAllocator a2{std::move(a1)};
+    EXPECT_EQ(0, a1.bytesReserved());
+    EXPECT_EQ(ArenaNodeAllocator::SLAB_SIZE, a2.bytesReserved());
+
+    ArenaNodeAllocator a3{a2};
+    EXPECT_EQ(0, a3.bytesReserved());
+}
+
+
+TEST(NodeAllocatorTests, createAndDestroyNodeRunConstructorsAndDestructors)
+{
+    HeapNodeAllocator heap;
+    ArenaNodeAllocator arena;
+
+    Tracked* t1 = createNode<Tracked>(heap);
+    Tracked* t2 = createNode<Tracked>(arena);
+    EXPECT_EQ(2, Tracked::live);
+
+    destroyNode(heap, t1);
+    disposeNode(arena, t2);
+    EXPECT_EQ(0, Tracked::live);
+}
+
+
+TEST(NodeAllocatorTests, arenaHashSetWorksLikeHeapHashSet)
+{
+    HashSet<std::string, HashSet<std::string>::HashFunction, ArenaNodeAllocator> s{
+        [](const std::string& s) { return static_cast<unsigned int>(s.length() * 31 + s[0]); }};
+
+    addNumberWords(s, 2000);
+    expectNumberWords(s, 2000);
+
+    auto copy = s;
+    auto moved = std::move(s);
+    expectNumberWords(copy, 2000);
+    expectNumberWords(moved, 2000);
+}
+
+
+TEST(NodeAllocatorTests, arenaAVLSetWorksLikeHeapAVLSet)
+{
+    AVLSet<std::string, ArenaNodeAllocator> s;
+
+    addNumberWords(s, 2000);
+    expectNumberWords(s, 2000);
+
+    auto copy = s;
+    auto moved = std::move(s);
+    expectNumberWords(copy, 2000);
+    expectNumberWords(moved, 2000);
+}
+
+
+TEST(NodeAllocatorTests, arenaSkipListSetWorksLikeHeapSkipListSet)
+{
+    SkipListSet<std::string, ArenaNodeAllocator> s;
+
+    addNumberWords(s, 2000);
+    expectNumberWords(s, 2000);
+
+    auto copy = s;
+    auto moved = std::move(s);
+    expectNumberWords(copy, 2000);
+    expectNumberWords(moved, 2000);
+}
+
+
+TEST(NodeAllocatorTests, arenaListSetWorksLikeHeapListSet)
+{
+    ListSet<std::string, ArenaNodeAllocator> s;
+
+    addNumberWords(s, 200);
+    expectNumberWords(s, 200);
+
+    auto copy = s;
+    auto moved = std::move(s);
+    expectNumberWords(copy, 200);
+    expectNumberWords(moved, 200);
+}
+
+
+TEST(NodeAllocatorTests, trivialElementsNeedNoTeardownWalk)
+{
+    EXPECT_FALSE((mustVisitNodesToDestroy<ArenaNodeAllocator, int>));
+    EXPECT_TRUE((mustVisitNodesToDestroy<ArenaNodeAllocator, std::string>));
+    EXPECT_TRUE((mustVisitNodesToDestroy<HeapNodeAllocator, int>));
+
+    HashSet<int, HashSet<int>::HashFunction, ArenaNodeAllocator> s{identityHash};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_TRUE(s.contains(999));
+}
@@ -0,0 +1,119 @@
+// PerfCountersTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for PerfCounters and the Stopwatch's use of them.  Whether
+// hardware events can be counted depends on the machine the tests run on,
+// so these check that the counters behave sensibly either way.
+
+#include <set>
+#include <string>
+#include <gtest/gtest.h>
+#include "PerfCounters.hpp"
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+    const PerfEvent allEvents[] = {
+        PerfEvent::Cycles,
+        PerfEvent::Instructions,
+        PerfEvent::L1DataMisses,
+        PerfEvent::LastLevelCacheMisses,
+        PerfEvent::BranchMisses
+    };
+
+
+    unsigned long doSomeWork()
+    {
+        volatile unsigned long sum = 0;
+
+        for (unsigned long i = 0; i < 1000000; ++i)
+        {
+            sum = sum + i;
+        }
+
+        return sum;
+    }
+}
+
+
+TEST(PerfCountersTests, samplesStartOutEmpty)
+{
+    PerfSample sample;
+    EXPECT_TRUE(sample.empty());
+
+    sample.setCount(PerfEvent::BranchMisses, 17);
+
+    EXPECT_FALSE(sample.empty());
+    EXPECT_TRUE(sample.has(PerfEvent::BranchMisses));
+    EXPECT_EQ(17, sample.count(PerfEvent::BranchMisses));
+    EXPECT_FALSE(sample.has(PerfEvent::Cycles));
+}
+
+
+TEST(PerfCountersTests, eventsHaveDistinctNames)
+{
+    std::set<std::string> names;
+
+    for (PerfEvent event : allEvents)
+    {
+        names.insert(perfEventName(event));
+    }
+
+    EXPECT_EQ(PERF_EVENT_COUNT, names.size());
+}
+
+
+TEST(PerfCountersTests, onlyAvailableEventsAreCounted)
+{
+    PerfCounters counters;
+
+    counters.start();
+    doSomeWork();
+    PerfSample sample = counters.stop();
+
+    for (PerfEvent event : allEvents)
+    {
+        if (sample.has(event))
+        {
+            EXPECT_TRUE(counters.available(event)) << perfEventName(event);
+        }
+    }
+
+    if (sample.has(PerfEvent::Instructions))
+    {
+        EXPECT_GT(sample.count(PerfEvent::Instructions), 1000000);
+    }
+
+    if (!counters.available())
+    {
+        EXPECT_TRUE(sample.empty());
+    }
+}
+
+
+TEST(PerfCountersTests, stopwatchTimesWithOrWithoutCounters)
+{
+    PerfCounters counters;
+    Stopwatch withCounters{counters};
+    Stopwatch withoutCounters;
+
+    withCounters.start();
+    withoutCounters.start();
+    doSomeWork();
+    withoutCounters.stop();
+    withCounters.stop();
+
+    EXPECT_GT(withCounters.lastDuration(), 0.0);
+    EXPECT_GT(withoutCounters.lastDuration(), 0.0);
+    EXPECT_TRUE(withoutCounters.lastCounts().empty());
+
+    if (!withCounters.lastCounts().empty())
+    {
+        EXPECT_TRUE(counters.available());
+    }
+
+    EXPECT_THROW(withCounters.stop(), Stopwatch::NotRunningException);
+}
@@ -0,0 +1,293 @@
+// RadixTreeSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the RadixTreeSet, including its prefix queries, which are
+// checked against a brute-force search of a sorted list of the same words.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "RadixTreeSet.hpp"
+
+
+namespace
+{
+    std::vector<std::string> makeWords()
+    {
+        std::vector<std::string> words;
+        std::string letters = "ABC'";
+
+        // Every string of up to four of the letters, so that there are
+        // plenty of shared prefixes, added in a scrambled order.
+        std::vector<std::string> level{""};
+
+        for (int length = 1; length <= 4; ++length)
+        {
+            std::vector<std::string> next;
+
+            for (const std::string& s : level)
+            {
+                for (char c : letters)
+                {
+                    next.push_back(s + c);
+                }
+            }
+
+            for (std::size_t i = 0; i < next.size(); i += 3)
+            {
+                words.push_back(next[i]);
+            }
+
+            level = next;
+        }
+
+        std::reverse(words.begin(), words.end());
+        std::rotate(words.begin(), words.begin() + words.size() / 3, words.end());
+        return words;
+    }
+
+
+    RadixTreeSet makeSet(const std::vector<std::string>& words)
+    {
+        RadixTreeSet s;
+
+        for (const std::string& word : words)
+        {
+            s.add(word);
+        }
+
+        return s;
+    }
+}
+
+
+TEST(RadixTreeSetTests, containsOnlyWhatWasAdded)
+{
+    RadixTreeSet s = makeSet({"ROMANE", "ROMANUS", "ROMULUS", "RUBENS", "RUBER", "RUBICON"});
+
+    EXPECT_EQ(6, s.size());
+    EXPECT_TRUE(s.contains("ROMANE"));
+    EXPECT_TRUE(s.contains("RUBER"));
+    EXPECT_TRUE(s.contains("RUBICON"));
+    EXPECT_FALSE(s.contains("R"));
+    EXPECT_FALSE(s.contains("ROMAN"));
+    EXPECT_FALSE(s.contains("RUBE"));
+    EXPECT_FALSE(s.contains("RUBENSX"));
+    EXPECT_FALSE(s.contains(""));
+}
+
+
+TEST(RadixTreeSetTests, prefixOfExistingWordCanBeAdded)
+{
+    RadixTreeSet s = makeSet({"TESTING", "TEST", "TE", "TEAM"});
+
+    EXPECT_EQ(4, s.size());
+    EXPECT_TRUE(s.contains("TE"));
+    EXPECT_TRUE(s.contains("TEST"));
+    EXPECT_TRUE(s.contains("TESTING"));
+    EXPECT_FALSE(s.contains("TES"));
+    EXPECT_FALSE(s.contains("T"));
+}
+
+
+TEST(RadixTreeSetTests, addingTwiceHasNoEffect)
+{
+    RadixTreeSet s = makeSet({"ABLE", "ABLE", "AB", "AB"});
+
+    EXPECT_EQ(2, s.size());
+    EXPECT_EQ(3, s.nodeCount());
+}
+
+
+TEST(RadixTreeSetTests, emptyStringCanBeAnElement)
+{
+    RadixTreeSet s;
+    EXPECT_FALSE(s.contains(""));
+
+    s.add("");
+    EXPECT_TRUE(s.contains(""));
+    EXPECT_EQ(1, s.size());
+    EXPECT_EQ(0, s.longestPrefixOf("ANYTHING"));
+}
+
+
+TEST(RadixTreeSetTests, pathsAreCompressed)
+{
+    RadixTreeSet s = makeSet({"INTERNATIONALIZATION", "INTERNATIONAL", "INTERN"});
+
+    // The root, plus one node for each word, each labeled with what the
+    // word adds to the one before it.
+    EXPECT_EQ(4, s.nodeCount());
+}
+
+
+TEST(RadixTreeSetTests, manyWordsAreAllFound)
+{
+    std::vector<std::string> words = makeWords();
+    RadixTreeSet s = makeSet(words);
+
+    EXPECT_EQ(words.size(), s.size());
+    EXPECT_LE(s.nodeCount(), 2 * words.size() + 1);
+
+    for (const std::string& word : words)
+    {
+        ASSERT_TRUE(s.contains(word)) << word;
+        ASSERT_FALSE(s.contains(word + "X")) << word;
+    }
+}
+
+
+TEST(RadixTreeSetTests, elementsWithPrefixMatchBruteForce)
+{
+    std::vector<std::string> words = makeWords();
+    RadixTreeSet s = makeSet(words);
+    std::sort(words.begin(), words.end());
+
+    for (std::string prefix : {"", "A", "AB", "ABC", "C'", "'''", "BAB'", "X", "ABCAB"})
+    {
+        std::vector<std::string> expected;
+
+        for (const std::string& word : words)
+        {
+            if (word.compare(0, prefix.length(), prefix) == 0)
+            {
+                expected.push_back(word);
+            }
+        }
+
+        EXPECT_EQ(expected, s.elementsWithPrefix(prefix)) << prefix;
+        EXPECT_EQ(expected.size(), s.countWithPrefix(prefix)) << prefix;
+    }
+}
+
+
+TEST(RadixTreeSetTests, longestPrefixMatchesBruteForce)
+{
+    std::vector<std::string> words = makeWords();
+    RadixTreeSet s = makeSet(words);
+
+    for (std::string text : {"", "A", "ABCA", "ABCABC", "''''", "C'BA'X", "X", "BCAXYZ"})
+    {
+        std::size_t expected = std::string::npos;
+
+        for (const std::string& word : words)
+        {
+            if (text.compare(0, word.length(), word) == 0
+                && (expected == std::string::npos || word.length() > expected))
+            {
+                expected = word.length();
+            }
+        }
+
+        EXPECT_EQ(expected, s.longestPrefixOf(text)) << text;
+    }
+}
+
+
+TEST(RadixTreeSetTests, copiesAreIndependent)
+{
+    RadixTreeSet s = makeSet({"APPLE", "APPLY"});
+    RadixTreeSet copy{s};
+    copy.add("APP");
+
+    RadixTreeSet assigned;
+    assigned = copy;
+    assigned.add("APRICOT");
+
+    EXPECT_FALSE(s.contains("APP"));
+    EXPECT_TRUE(copy.contains("APP"));
+    EXPECT_FALSE(copy.contains("APRICOT"));
+    EXPECT_TRUE(assigned.contains("APPLY"));
+    EXPECT_TRUE(assigned.contains("APRICOT"));
+
+    RadixTreeSet moved{std::move(assigned)};
+    EXPECT_EQ(4, moved.size());
+    EXPECT_EQ(0, assigned.size());
+    EXPECT_FALSE(assigned.contains("APPLE"));
+
+    assigned.add("PEAR");
+    EXPECT_TRUE(assigned.contains("PEAR"));
+}
+
+
+TEST(RadixTreeSetTests, removingMergesNodesBackTogether)
+{
+    RadixTreeSet s = makeSet({"TEST", "TESTING", "TEAM"});
+    EXPECT_EQ(5, s.nodeCount());
+
+    EXPECT_TRUE(s.remove("TEST"));
+    EXPECT_FALSE(s.remove("TEST"));
+    EXPECT_FALSE(s.remove("TE"));
+    EXPECT_EQ(4, s.nodeCount());
+
+    EXPECT_TRUE(s.remove("TEAM"));
+    EXPECT_EQ(2, s.nodeCount());
+    EXPECT_EQ(1, s.size());
+    EXPECT_TRUE(s.contains("TESTING"));
+    EXPECT_FALSE(s.contains("TEST"));
+    EXPECT_EQ(std::vector<std::string>{"TESTING"}, s.elementsWithPrefix("TES"));
+
+    EXPECT_TRUE(s.remove("TESTING"));
+    EXPECT_EQ(1, s.nodeCount());
+    EXPECT_EQ(0, s.size());
+}
+
+
+TEST(RadixTreeSetTests, removingMatchesBruteForce)
+{
+    std::vector<std::string> words = makeWords();
+    RadixTreeSet s = makeSet(words);
+    std::vector<std::string> kept;
+
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        if (i % 3 == 0)
+        {
+            ASSERT_TRUE(s.remove(words[i])) << words[i];
+        }
+        else
+        {
+            kept.push_back(words[i]);
+        }
+    }
+
+    EXPECT_EQ(kept.size(), s.size());
+    EXPECT_LE(s.nodeCount(), 2 * kept.size() + 1);
+
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        ASSERT_EQ(i % 3 != 0, s.contains(words[i])) << words[i];
+    }
+
+    std::sort(kept.begin(), kept.end());
+    EXPECT_EQ(kept, s.elementsWithPrefix(""));
+}
+
+
+TEST(RadixTreeSetTests, statisticsCountOneProbePerNodeOnTheWayDown)
+{
+    RadixTreeSet s;
+    s.add("a");
+    s.add("ab");
+    s.add("abc");
+
+    SetStatistics statistics = s.statistics();
+
+    EXPECT_EQ(3, statistics.elementCount);
+    EXPECT_EQ(4, statistics.levels);
+    EXPECT_GT(statistics.memoryBytes, sizeof(s));
+
+    EXPECT_TRUE(s.contains("abc"));
+    EXPECT_FALSE(s.contains("b"));
+
+    if (SET_STATISTICS_ENABLED)
+    {
+        statistics = s.statistics();
+        EXPECT_EQ(2, statistics.lookups);
+        EXPECT_EQ(4, statistics.maxProbes);
+        EXPECT_EQ(5, statistics.probes);
+    }
+}
@@ -0,0 +1,580 @@
+// SkipListSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the SkipListSet beyond the sanity checks.
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "SkipListSet.hpp"
+
+
+namespace
+{
+    // Sends every element whose value is a multiple of 2^k up to level k.
+    class PowerOfTwoSkipListLevelTester : public SkipListLevelTester<int>
+    {
+    public:
+        virtual bool shouldOccupyNextLevel(const int& element) override
+        {
+            if (element == lastElement)
+            {
+                ++levels;
+            }
+            else
+            {
+                lastElement = element;
+                levels = 1;
+            }
+
+            return element != 0 && element % (1 << levels) == 0;
+        }
+
+        virtual std::unique_ptr<SkipListLevelTester<int>> clone() override
+        {
+            return std::make_unique<PowerOfTwoSkipListLevelTester>();
+        }
+
+    private:
+        int lastElement = -1;
+        int levels = 0;
+    };
+
+
+    // Would send every element up forever, if the SkipListSet let it.
+    class AlwaysGrowSkipListLevelTester : public SkipListLevelTester<int>
+    {
+    public:
+        virtual bool shouldOccupyNextLevel(const int& element) override
+        {
+            return true;
+        }
+
+        virtual std::unique_ptr<SkipListLevelTester<int>> clone() override
+        {
+            return std::make_unique<AlwaysGrowSkipListLevelTester>();
+        }
+    };
+
+
+    SkipListSet<int> makePowerOfTwoSkipList()
+    {
+        SkipListSet<int> s{std::make_unique<PowerOfTwoSkipListLevelTester>()};
+
+        for (int i = 1; i <= 16; ++i)
+        {
+            s.add(i);
+        }
+
+        return s;
+    }
+
+    // Checks the ordered queries of a set holding exactly the even numbers
+    // from 0 to 2 * (count - 1).
+    template <typename SetType>
+    void expectOrderedQueriesWork(const SetType& s, int count)
+    {
+        ASSERT_EQ(count, s.size());
+
+        for (int i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(2 * i, s.select(i));
+            ASSERT_EQ(i, s.rank(2 * i));
+            ASSERT_EQ(i + 1, s.rank(2 * i + 1));
+
+            ASSERT_EQ(2 * i, *s.lowerBound(2 * i));
+            ASSERT_EQ(2 * i, *s.lowerBound(2 * i - 1));
+            ASSERT_EQ(2 * i, *s.upperBound(2 * i - 1));
+            ASSERT_EQ(2 * i, *s.upperBound(2 * i - 2));
+        }
+
+        EXPECT_EQ(0, s.rank(-1));
+        EXPECT_TRUE(s.lowerBound(2 * count - 1) == s.end());
+        EXPECT_TRUE(s.upperBound(2 * count - 2) == s.end());
+        EXPECT_THROW(s.select(count), std::out_of_range);
+
+        for (int low : {-5, 0, 7, count / 2, count})
+        {
+            for (int high : {-5, 1, 8, count, 2 * count, 3 * count})
+            {
+                std::vector<int> expected;
+
+                for (int i = 0; i < count; ++i)
+                {
+                    if (2 * i >= low && 2 * i < high)
+                    {
+                        expected.push_back(2 * i);
+                    }
+                }
+
+                std::vector<int> elements;
+
+                for (int element : s.range(low, high))
+                {
+                    elements.push_back(element);
+                }
+
+                ASSERT_EQ(expected, elements) << low << ", " << high;
+                ASSERT_EQ(expected.size(), s.range(low, high).count()) << low << ", " << high;
+            }
+        }
+    }
+}
+
+
+TEST(SkipListSetTests, copyHasTheSameLevels)
+{
+    SkipListSet<int> s1 = makePowerOfTwoSkipList();
+    ASSERT_EQ(5, s1.levelCount());
+
+    SkipListSet<int> s2{s1};
+
+    EXPECT_EQ(16, s2.size());
+    EXPECT_EQ(5, s2.levelCount());
+
+    for (unsigned int level = 0; level < 5; ++level)
+    {
+        EXPECT_EQ(s1.elementsOnLevel(level), s2.elementsOnLevel(level));
+    }
+
+    EXPECT_TRUE(s2.isElementOnLevel(16, 4));
+    EXPECT_TRUE(s2.isElementOnLevel(12, 2));
+    EXPECT_FALSE(s2.isElementOnLevel(12, 3));
+}
+
+
+TEST(SkipListSetTests, copiesAreIndependent)
+{
+    SkipListSet<int> s1 = makePowerOfTwoSkipList();
+
+    SkipListSet<int> s2{s1};
+    s2.add(17);
+
+    SkipListSet<int> s3;
+    s3.add(-1);
+    s3 = s2;
+    s3.add(18);
+
+    EXPECT_EQ(16, s1.size());
+    EXPECT_FALSE(s1.contains(17));
+    EXPECT_EQ(17, s2.size());
+    EXPECT_TRUE(s2.contains(1));
+    EXPECT_EQ(18, s3.size());
+    EXPECT_FALSE(s3.contains(-1));
+
+    for (int i = 1; i <= 18; ++i)
+    {
+        EXPECT_TRUE(s3.contains(i));
+    }
+}
+
+
+TEST(SkipListSetTests, moveTransfersElementsAndLeavesSourceUsable)
+{
+    SkipListSet<std::string> s1;
+    s1.add("Boo");
+    s1.add("Alex");
+
+    SkipListSet<std::string> s2{std::move(s1)};
+    EXPECT_EQ(2, s2.size());
+    EXPECT_TRUE(s2.contains("Alex"));
+    EXPECT_EQ(0, s1.size());
+    EXPECT_EQ(0, s1.levelCount());
+
+    s1.add("Cool");
+    EXPECT_TRUE(s1.contains("Cool"));
+
+    s2 = std::move(s1);
+    EXPECT_EQ(1, s2.size());
+    EXPECT_TRUE(s2.contains("Cool"));
+}
+
+
+TEST(SkipListSetTests, addAllBuildsDeterministicLevels)
+{
+    int elements[16];
+
+    for (int i = 0; i < 16; ++i)
+    {
+        elements[i] = (i + 1) * 10;
+    }
+
+    SkipListSet<int> s;
+    s.addAll(elements, elements + 16, true);
+
+    EXPECT_EQ(16, s.size());
+    EXPECT_EQ(5, s.levelCount());
+    EXPECT_EQ(16, s.elementsOnLevel(0));
+    EXPECT_EQ(8, s.elementsOnLevel(1));
+    EXPECT_EQ(4, s.elementsOnLevel(2));
+    EXPECT_EQ(2, s.elementsOnLevel(3));
+    EXPECT_EQ(1, s.elementsOnLevel(4));
+    EXPECT_TRUE(s.isElementOnLevel(160, 4));
+    EXPECT_TRUE(s.isElementOnLevel(120, 2));
+    EXPECT_FALSE(s.isElementOnLevel(120, 3));
+
+    for (int i = 0; i < 16; ++i)
+    {
+        EXPECT_TRUE(s.contains(elements[i]));
+        EXPECT_FALSE(s.contains(elements[i] + 1));
+    }
+
+    s.add(5);
+    s.add(1000);
+    EXPECT_TRUE(s.contains(5));
+    EXPECT_TRUE(s.contains(1000));
+    EXPECT_EQ(18, s.elementsOnLevel(0));
+}
+
+
+TEST(SkipListSetTests, addAllSortsUnsortedRangeAndSkipsDuplicates)
+{
+    std::string elements[] = {"Boo", "Alex", "Cool", "Alex", "Boo"};
+
+    SkipListSet<std::string> s;
+    s.addAll(elements, elements + 5, true);
+
+    EXPECT_EQ(3, s.size());
+    EXPECT_EQ(2, s.levelCount());
+    EXPECT_TRUE(s.isElementOnLevel("Boo", 1));
+    EXPECT_TRUE(s.contains("Alex"));
+    EXPECT_TRUE(s.contains("Cool"));
+}
+
+
+TEST(SkipListSetTests, addAllToNonEmptySetAddsEachElement)
+{
+    int elements[] = {1, 2, 3};
+
+    SkipListSet<int> s;
+    s.add(2);
+    s.addAll(elements, elements + 3, true);
+
+    EXPECT_EQ(3, s.size());
+
+    for (int i = 1; i <= 3; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+}
+
+
+TEST(SkipListSetTests, iteratorVisitsElementsInAscendingOrder)
+{
+    SkipListSet<int> s = makePowerOfTwoSkipList();
+    std::vector<int> elements{s.begin(), s.end()};
+
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}), elements);
+    EXPECT_TRUE(SkipListSet<int>{}.begin() == SkipListSet<int>{}.end());
+}
+
+
+TEST(SkipListSetTests, orderedQueriesWorkAfterAdding)
+{
+    SkipListSet<int> s;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        s.add((i * 7919) % 2000 * 2);
+    }
+
+    expectOrderedQueriesWork(s, 2000);
+    expectOrderedQueriesWork(SkipListSet<int>{s}, 2000);
+}
+
+
+TEST(SkipListSetTests, orderedQueriesWorkAfterAddAll)
+{
+    std::vector<int> elements;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        elements.push_back(2 * i);
+    }
+
+    SkipListSet<int> s;
+    s.addAll(elements.data(), elements.data() + elements.size(), true);
+    expectOrderedQueriesWork(s, 1000);
+
+    // Adding to a set built by addAll() has to keep the spans of the
+    // deterministic levels up to date, too.
+    s.add(-2);
+    s.add(5);
+    EXPECT_EQ(0, s.rank(-2));
+    EXPECT_EQ(4, s.rank(5));
+    EXPECT_EQ(5, s.select(4));
+    EXPECT_EQ(1998, s.select(1001));
+}
+
+
+TEST(SkipListSetTests, orderedQueriesOnEmptySet)
+{
+    SkipListSet<std::string> s;
+
+    EXPECT_EQ(0, s.rank("A"));
+    EXPECT_TRUE(s.lowerBound("A") == s.end());
+    EXPECT_TRUE(s.upperBound("A") == s.end());
+    EXPECT_EQ(0, s.range("A", "Z").count());
+    EXPECT_THROW(s.select(0), std::out_of_range);
+}
+
+
+TEST(SkipListSetTests, removingKeepsRanksAndBoundsUpToDate)
+{
+    SkipListSet<int> s;
+
+    for (int i = 0; i < 4000; ++i)
+    {
+        s.add((i * 7919) % 4000);
+    }
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        EXPECT_TRUE(s.remove((i * 7919) % 2000 * 2 + 1));
+    }
+
+    EXPECT_FALSE(s.remove(1));
+    EXPECT_FALSE(s.remove(4000));
+    EXPECT_FALSE(s.contains(1));
+    expectOrderedQueriesWork(s, 2000);
+    expectOrderedQueriesWork(SkipListSet<int>{s}, 2000);
+}
+
+
+TEST(SkipListSetTests, removingTallestElementsRemovesEmptyLevels)
+{
+    SkipListSet<int> s = makePowerOfTwoSkipList();
+    EXPECT_EQ(5, s.levelCount());
+
+    EXPECT_TRUE(s.remove(16));
+    EXPECT_EQ(4, s.levelCount());
+    EXPECT_EQ(1, s.elementsOnLevel(3));
+
+    EXPECT_TRUE(s.remove(8));
+    EXPECT_EQ(3, s.levelCount());
+    EXPECT_EQ(14, s.elementsOnLevel(0));
+    EXPECT_EQ(2, s.elementsOnLevel(2));
+    EXPECT_EQ(6, s.elementsOnLevel(1));
+    EXPECT_EQ(7, s.select(6));
+    EXPECT_EQ(9, s.select(7));
+}
+
+
+TEST(SkipListSetTests, removingEveryElementLeavesSetUsable)
+{
+    SkipListSet<int> s = makePowerOfTwoSkipList();
+
+    for (int i = 1; i <= 16; ++i)
+    {
+        ASSERT_TRUE(s.remove(i)) << i;
+        ASSERT_FALSE(s.contains(i)) << i;
+        ASSERT_EQ(16 - i, s.size());
+    }
+
+    EXPECT_EQ(0, s.levelCount());
+    EXPECT_TRUE(s.begin() == s.end());
+    EXPECT_FALSE(s.remove(1));
+
+    s.add(4);
+    s.add(2);
+    EXPECT_TRUE(s.contains(4));
+    EXPECT_EQ(1, s.rank(4));
+    EXPECT_EQ(3, s.levelCount());
+}
+
+
+TEST(SkipListSetTests, heightIsLimitedByTheSizeOfTheSet)
+{
+    SkipListSet<int> s{std::make_unique<AlwaysGrowSkipListLevelTester>()};
+
+    s.add(0);
+    EXPECT_EQ(SkipListSet<int>::EXTRA_LEVELS, s.levelCount());
+
+    for (int i = 1; i < 1000; ++i)
+    {
+        s.add(2 * i);
+    }
+
+    // Each element occupies log2 of the set's size once it's been added,
+    // rounded down, plus EXTRA_LEVELS; the tallest are the 489 added once
+    // there were at least 512.
+    EXPECT_EQ(9 + SkipListSet<int>::EXTRA_LEVELS, s.levelCount());
+    EXPECT_EQ(1000, s.elementsOnLevel(0));
+    EXPECT_EQ(489, s.elementsOnLevel(s.levelCount() - 1));
+    EXPECT_TRUE(s.isElementOnLevel(1022, s.levelCount() - 1));
+    EXPECT_FALSE(s.isElementOnLevel(1020, s.levelCount() - 1));
+    expectOrderedQueriesWork(s, 1000);
+}
+
+
+TEST(SkipListSetTests, nodesOfEveryHeightCanComeFromAnArena)
+{
+    SkipListSet<std::string, ArenaNodeAllocator> s;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        s.add(std::to_string(i));
+    }
+
+    for (int i = 0; i < 2000; i += 2)
+    {
+        ASSERT_TRUE(s.remove(std::to_string(i)));
+    }
+
+    for (int i = 2000; i < 3000; ++i)
+    {
+        s.add(std::to_string(i));
+    }
+
+    SkipListSet<std::string, ArenaNodeAllocator> copy{s};
+    s.add("EXTRA");
+
+    EXPECT_EQ(2000, copy.size());
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        ASSERT_EQ(i % 2 == 1 || i >= 2000, copy.contains(std::to_string(i))) << i;
+    }
+
+    EXPECT_FALSE(copy.contains("EXTRA"));
+    EXPECT_TRUE(s.contains("EXTRA"));
+}
+
+
+TEST(SkipListSetTests, fastLevelTestersWithTheSameSeedChooseTheSameHeights)
+{
+    FastSkipListLevelTester<int> t1{46};
+    FastSkipListLevelTester<int> t2{46};
+    FastSkipListLevelTester<int> t3{47};
+
+    unsigned int differences = 0;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        unsigned int height = t1.chooseHeight(i, 32);
+        ASSERT_EQ(height, t2.chooseHeight(i, 32));
+        differences += height != t3.chooseHeight(i, 32) ? 1 : 0;
+    }
+
+    EXPECT_GT(differences, 100);
+
+    std::unique_ptr<SkipListLevelTester<int>> c1 = t1.clone();
+    std::unique_ptr<SkipListLevelTester<int>> c2 = t2.clone();
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(c1->chooseHeight(i, 32), c2->chooseHeight(i, 32));
+    }
+}
+
+
+TEST(SkipListSetTests, fastLevelTestersPromoteWithTheirProbability)
+{
+    const std::pair<SkipListPromotion, double> promotions[] = {
+        {SkipListPromotion::OneHalf, 0.5},
+        {SkipListPromotion::OneQuarter, 0.25},
+        {SkipListPromotion::OneOverE, 0.36787944117144233}
+    };
+
+    constexpr unsigned int DRAWS = 100000;
+
+    for (const auto& promotion : promotions)
+    {
+        FastSkipListLevelTester<int> tester{46, promotion.first};
+        unsigned int atLeast[4] = {};
+        unsigned int promoted = 0;
+
+        for (unsigned int i = 0; i < DRAWS; ++i)
+        {
+            unsigned int height = tester.chooseHeight(0, 32);
+            ASSERT_GE(height, 1);
+
+            for (unsigned int h = 0; h < 4 && h < height; ++h)
+            {
+                ++atLeast[h];
+            }
+
+            promoted += tester.shouldOccupyNextLevel(0) ? 1 : 0;
+        }
+
+        double p = promotion.second;
+        EXPECT_NEAR(p, static_cast<double>(atLeast[1]) / DRAWS, 0.01);
+        EXPECT_NEAR(p * p, static_cast<double>(atLeast[2]) / DRAWS, 0.01);
+        EXPECT_NEAR(p * p * p, static_cast<double>(atLeast[3]) / DRAWS, 0.01);
+        EXPECT_NEAR(p, static_cast<double>(promoted) / DRAWS, 0.01);
+    }
+}
+
+
+TEST(SkipListSetTests, fastLevelTestersRespectTheLimit)
+{
+    FastSkipListLevelTester<int> tester{46, SkipListPromotion::OneHalf};
+    unsigned int highest = 0;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        unsigned int height = tester.chooseHeight(i, 3);
+        ASSERT_LE(height, 3);
+        highest = std::max(highest, height);
+    }
+
+    EXPECT_EQ(3, highest);
+    EXPECT_EQ(1, tester.chooseHeight(0, 1));
+}
+
+
+TEST(SkipListSetTests, skipListsWithTheSameSeedHaveTheSameShape)
+{
+    SkipListSet<int> s1{std::make_unique<FastSkipListLevelTester<int>>(46)};
+    SkipListSet<int> s2{std::make_unique<FastSkipListLevelTester<int>>(46)};
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        s1.add((i * 7919) % 2000);
+        s2.add((i * 7919) % 2000);
+    }
+
+    ASSERT_EQ(s1.levelCount(), s2.levelCount());
+    EXPECT_GT(s1.levelCount(), 5);
+
+    for (unsigned int level = 0; level < s1.levelCount(); ++level)
+    {
+        EXPECT_EQ(s1.elementsOnLevel(level), s2.elementsOnLevel(level)) << level;
+    }
+}
+
+
+TEST(SkipListSetTests, statisticsReportTheLevelsAndTheNodes)
+{
+    SkipListSet<int> s{std::make_unique<FastSkipListLevelTester<int>>(46)};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    SetStatistics statistics = s.statistics();
+
+    EXPECT_EQ(1000, statistics.elementCount);
+    EXPECT_EQ(s.levelCount(), statistics.levels);
+    EXPECT_GE(statistics.memoryBytes, sizeof(s) + 1000 * (sizeof(int) + sizeof(void*)));
+
+    s.resetStatistics();
+    EXPECT_TRUE(s.contains(999));
+    EXPECT_FALSE(s.contains(1000));
+
+    statistics = s.statistics();
+
+    if (SET_STATISTICS_ENABLED)
+    {
+        EXPECT_EQ(2, statistics.lookups);
+        EXPECT_GT(statistics.comparisons, statistics.probes);
+        EXPECT_LT(statistics.probesPerLookup(), 100.0);
+    }
+}
@@ -0,0 +1,176 @@
+// SpellCheckerTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the SpellChecker, which check that running it in parallel
+// notifies its observers of exactly the misspellings that running it on
+// one thread does, in the same order.
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "HashSet.hpp"
+#include "SpellChecker.hpp"
+#include "SpellCheckerListener.hpp"
+#include "StringHashing.hpp"
+#include "WordChecker.hpp"
+
+
+namespace
+{
+    struct Notification
+    {
+        std::string word;
+        std::string line;
+        std::vector<std::string> suggestions;
+
+        bool operator==(const Notification& n) const
+        {
+            return word == n.word && line == n.line && suggestions == n.suggestions;
+        }
+    };
+
+
+    class RecordingListener : public SpellCheckerListener
+    {
+    public:
+        std::vector<Notification> notifications;
+
+        virtual void misspellingFound(
+            const std::string& word, const std::string& line,
+            const std::vector<std::string>& suggestions) override
+        {
+            notifications.push_back(Notification{word, line, suggestions});
+        }
+    };
+
+
+    // A Set that throws when asked about one particular word.
+    class ThrowingSet : public Set<std::string>
+    {
+    public:
+        virtual bool isImplemented() const noexcept override { return true; }
+        virtual void add(const std::string& element) override { }
+        virtual bool remove(const std::string& element) override { return false; }
+        virtual unsigned int size() const noexcept override { return 0; }
+
+        virtual bool contains(const std::string& element) const override
+        {
+            if (element == "BOOM")
+            {
+                throw std::runtime_error{"BOOM"};
+            }
+
+            return true;
+        }
+    };
+
+
+    HashSet<std::string, StringHashAsFnv1a> makeWordSet()
+    {
+        HashSet<std::string, StringHashAsFnv1a> words{StringHashAsFnv1a{}};
+
+        for (const char* word : {"THE", "CAT", "SAT", "ON", "MAT", "A", "DOG", "RAN"})
+        {
+            words.add(word);
+        }
+
+        return words;
+    }
+
+
+    // makeText() makes a text of the given number of lines, a mixture of
+    // correctly spelled words, misspellings, and empty lines, with each
+    // misspelling marked by its line number so that order matters.
+    std::string makeText(unsigned int lines)
+    {
+        std::string text;
+
+        for (unsigned int i = 0; i < lines; ++i)
+        {
+            if (i % 7 == 3)
+            {
+                text += "\n";
+            }
+            else
+            {
+                text += "the cat sat on teh mat, dgo" + std::to_string(i) + " ran\n";
+            }
+        }
+
+        return text;
+    }
+
+
+    std::vector<Notification> check(
+        const WordChecker& wordChecker, const std::string& text, unsigned int threadCount)
+    {
+        SpellChecker spellChecker;
+        std::shared_ptr<RecordingListener> listener = std::make_shared<RecordingListener>();
+        spellChecker.addObserver(listener);
+
+        spellChecker.runInParallel(wordChecker, text, threadCount);
+
+        return listener->notifications;
+    }
+}
+
+
+TEST(SpellCheckerTests, parallelRunsNotifyInDocumentOrder)
+{
+    HashSet<std::string, StringHashAsFnv1a> words = makeWordSet();
+    WordChecker wordChecker{words};
+
+    std::string text = makeText(3000);
+
+    SpellChecker spellChecker;
+    std::shared_ptr<RecordingListener> listener = std::make_shared<RecordingListener>();
+    spellChecker.addObserver(listener);
+
+    TextFileReader reader{std::string_view{text}};
+    spellChecker.run(wordChecker, reader);
+
+    ASSERT_EQ(2 * (3000 - 3000 / 7 - 1), listener->notifications.size());
+
+    for (unsigned int threadCount : {0u, 1u, 2u, 3u, 8u, 64u})
+    {
+        EXPECT_EQ(listener->notifications, check(wordChecker, text, threadCount))
+            << threadCount << " threads";
+    }
+}
+
+
+TEST(SpellCheckerTests, parallelRunsHandleUnusualTexts)
+{
+    HashSet<std::string, StringHashAsFnv1a> words = makeWordSet();
+    WordChecker wordChecker{words};
+
+    EXPECT_TRUE(check(wordChecker, "", 4).empty());
+    EXPECT_TRUE(check(wordChecker, "\n\n\n", 4).empty());
+
+    std::string noFinalNewline = makeText(1000) + "last wrod";
+    std::vector<Notification> notifications = check(wordChecker, noFinalNewline, 4);
+    ASSERT_FALSE(notifications.empty());
+    EXPECT_EQ("WROD", notifications.back().word);
+    EXPECT_EQ("last wrod", notifications.back().line);
+
+    std::string oneLongLine(100000, ' ');
+    oneLongLine += "xyzzy";
+    notifications = check(wordChecker, oneLongLine, 4);
+    ASSERT_EQ(1, notifications.size());
+    EXPECT_EQ("XYZZY", notifications[0].word);
+}
+
+
+TEST(SpellCheckerTests, exceptionsFromWorkerThreadsReachCaller)
+{
+    ThrowingSet words;
+    WordChecker wordChecker{words};
+
+    std::string text = makeText(2000) + "boom\n" + makeText(2000);
+
+    EXPECT_THROW(check(wordChecker, text, 4), std::runtime_error);
+}
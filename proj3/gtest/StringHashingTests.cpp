@@ -0,0 +1,44 @@
+// StringHashingTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the string hash functions, checked against published
+// test vectors where they exist.
+
+#include <string>
+#include <gtest/gtest.h>
+#include "StringHashing.hpp"
+
+
+TEST(StringHashingTests, fnv1aMatchesReferenceValues)
+{
+    EXPECT_EQ(0x811c9dc5u, hashStringAsFnv1a(""));
+    EXPECT_EQ(0xe40c292cu, hashStringAsFnv1a("a"));
+    EXPECT_EQ(0xbf9cf968u, hashStringAsFnv1a("foobar"));
+}
+
+
+TEST(StringHashingTests, crc32cMatchesReferenceValues)
+{
+    EXPECT_EQ(0x00000000u, hashStringAsCrc32c(""));
+    EXPECT_EQ(0xe3069283u, hashStringAsCrc32c("123456789"));
+    EXPECT_EQ(0x22620404u, hashStringAsCrc32c("The quick brown fox jumps over the lazy dog"));
+}
+
+
+TEST(StringHashingTests, wymixDependsOnEveryByteAndLength)
+{
+    std::string word = "ABCDEFGHIJKLMNOPQRS";
+    unsigned int hash = hashStringAsWymix(word);
+
+    for (size_t i = 0; i < word.length(); ++i)
+    {
+        std::string changed = word;
+        changed[i] = 'Z' + 1;
+        EXPECT_NE(hash, hashStringAsWymix(changed));
+    }
+
+    EXPECT_NE(hashStringAsWymix("A"), hashStringAsWymix(std::string{"A\0", 2}));
+    EXPECT_EQ(hash, hashStringAsWymix(word));
+}
@@ -0,0 +1,115 @@
+// TextFileReaderTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the TextFileReader, which check that reading a file by
+// mapping it and reading it through a stream find the same words.
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "TextFileReader.hpp"
+
+
+namespace
+{
+    std::string writeTempFile(const std::string& name, const std::string& contents)
+    {
+        std::string path = ::testing::TempDir() + name;
+        std::ofstream file{path, std::ios::binary};
+        file << contents;
+        return path;
+    }
+
+
+    struct ReadResult
+    {
+        std::vector<std::string> words;
+        std::vector<std::string> lines;
+    };
+
+
+    ReadResult readAll(const std::string& path, FileReadMode mode)
+    {
+        ReadResult result;
+        TextFileReader reader{path, mode};
+
+        while (!reader.noMoreWords())
+        {
+            result.words.push_back(reader.currentWord());
+            result.lines.push_back(reader.currentLine());
+            reader.advanceToNextWord();
+        }
+
+        return result;
+    }
+}
+
+
+TEST(TextFileReaderTests, findsWordsAndTheirLinesInBothModes)
+{
+    std::string path = writeTempFile(
+        "TextFileReaderTests1.txt",
+        "Hello, world!\n\n  it's a well-known fact.\nlast line");
+
+    for (FileReadMode mode : {FileReadMode::Mapped, FileReadMode::Stream})
+    {
+        ReadResult result = readAll(path, mode);
+
+        std::vector<std::string> expectedWords{
+            "HELLO", "WORLD", "IT'S", "A", "WELL-KNOWN", "FACT", "LAST", "LINE"};
+
+        EXPECT_EQ(expectedWords, result.words);
+        ASSERT_EQ(8, result.lines.size());
+        EXPECT_EQ("Hello, world!", result.lines[0]);
+        EXPECT_EQ("  it's a well-known fact.", result.lines[2]);
+        EXPECT_EQ("last line", result.lines[7]);
+    }
+}
+
+
+TEST(TextFileReaderTests, keepsCarriageReturnsInLinesLikeGetline)
+{
+    std::string path = writeTempFile("TextFileReaderTests2.txt", "one\r\ntwo\r\n");
+
+    ReadResult mapped = readAll(path, FileReadMode::Mapped);
+    ReadResult stream = readAll(path, FileReadMode::Stream);
+
+    EXPECT_EQ((std::vector<std::string>{"ONE", "TWO"}), mapped.words);
+    EXPECT_EQ(stream.words, mapped.words);
+    EXPECT_EQ(stream.lines, mapped.lines);
+}
+
+
+TEST(TextFileReaderTests, emptyAndMissingFilesHaveNoWords)
+{
+    std::string path = writeTempFile("TextFileReaderTests3.txt", "");
+
+    for (FileReadMode mode : {FileReadMode::Mapped, FileReadMode::Stream})
+    {
+        EXPECT_TRUE(TextFileReader(path, mode).noMoreWords());
+        EXPECT_TRUE(TextFileReader(path + ".missing", mode).noMoreWords());
+    }
+}
+
+
+TEST(TextFileReaderTests, readsTextAlreadyInMemory)
+{
+    std::string text = "first line\nsecond, and\n\nlast";
+    TextFileReader reader{std::string_view{text}};
+
+    std::vector<std::string> words;
+    std::vector<std::string> lines;
+
+    for (; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        words.push_back(reader.currentWord());
+        lines.push_back(reader.currentLine());
+    }
+
+    EXPECT_EQ((std::vector<std::string>{"FIRST", "LINE", "SECOND", "AND", "LAST"}), words);
+    EXPECT_EQ("second, and", lines[3]);
+    EXPECT_EQ("last", lines[4]);
+}
@@ -0,0 +1,63 @@
+// WordCheckerTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for WordChecker::findSuggestions(), covering each kind of
+// candidate it generates, the order in which suggestions are returned,
+// and the removal of duplicates.
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ListSet.hpp"
+#include "WordChecker.hpp"
+
+
+namespace
+{
+    std::vector<std::string> suggestionsFor(
+        const std::string& word, const std::vector<std::string>& dictionary)
+    {
+        ListSet<std::string> set;
+
+        for (const std::string& s : dictionary)
+        {
+            set.add(s);
+        }
+
+        return WordChecker{set}.findSuggestions(word);
+    }
+}
+
+
+TEST(WordCheckerTests, findsEachKindOfSuggestionInOrder)
+{
+    std::vector<std::string> suggestions = suggestionsFor(
+        "CAHT",
+        {"CAT", "SCAHT", "CAHTS", "CART", "CHAT", "TAHC", "CA HT", "ZEBRA"});
+
+    EXPECT_EQ(
+        (std::vector<std::string>{"CAT", "SCAHT", "CAHTS", "CART", "TAHC", "CHAT", "CA HT"}),
+        suggestions);
+}
+
+
+TEST(WordCheckerTests, duplicateSuggestionsAreReturnedOnce)
+{
+    EXPECT_EQ(
+        (std::vector<std::string>{"BOK"}),
+        suggestionsFor("BOOK", {"BOK"}));
+}
+
+
+TEST(WordCheckerTests, handlesShortWords)
+{
+    EXPECT_EQ(
+        (std::vector<std::string>{"XY", "A"}),
+        suggestionsFor("X", {"A", "XY", "X Y"}));
+
+    EXPECT_EQ(
+        (std::vector<std::string>{"A", "B"}),
+        suggestionsFor("", {"A", "B", "AB"}));
+}
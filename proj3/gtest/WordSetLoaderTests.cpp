@@ -0,0 +1,96 @@
+// WordSetLoaderTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the WordSetLoader, which check what it passes to a Set's
+// addAll() when reading a word file either by mapping it or through a
+// stream.
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "Set.hpp"
+#include "WordSetLoader.hpp"
+
+
+namespace
+{
+    std::string writeTempFile(const std::string& name, const std::string& contents)
+    {
+        std::string path = ::testing::TempDir() + name;
+        std::ofstream file{path, std::ios::binary};
+        file << contents;
+        return path;
+    }
+
+
+    // Records the arguments of each call to addAll().
+    class RecordingSet : public Set<std::string>
+    {
+    public:
+        virtual bool isImplemented() const noexcept override { return true; }
+        virtual void add(const std::string& element) override { words.push_back(element); }
+        virtual bool contains(const std::string& element) const override { return false; }
+        virtual bool remove(const std::string& element) override { return false; }
+        virtual unsigned int size() const noexcept override { return words.size(); }
+
+        virtual void addAll(const std::string* begin, const std::string* end, bool presorted) override
+        {
+            ++addAllCalls;
+            wasPresorted = presorted;
+            words.assign(begin, end);
+        }
+
+        std::vector<std::string> words;
+        unsigned int addAllCalls = 0;
+        bool wasPresorted = false;
+    };
+}
+
+
+TEST(WordSetLoaderTests, loadsUppercaseWordsWithOneCallToAddAll)
+{
+    std::string path = writeTempFile("WordSetLoaderTests1.txt", "apple\r\nbanana\ncherry");
+
+    for (FileReadMode mode : {FileReadMode::Mapped, FileReadMode::Stream})
+    {
+        RecordingSet s;
+        WordSetLoader{mode}.load(path, s);
+
+        EXPECT_EQ(1, s.addAllCalls);
+        EXPECT_EQ((std::vector<std::string>{"APPLE", "BANANA", "CHERRY"}), s.words);
+        EXPECT_TRUE(s.wasPresorted);
+    }
+}
+
+
+TEST(WordSetLoaderTests, detectsWordsOutOfOrder)
+{
+    std::string path = writeTempFile("WordSetLoaderTests2.txt", "banana\napple\n");
+
+    for (FileReadMode mode : {FileReadMode::Mapped, FileReadMode::Stream})
+    {
+        RecordingSet s;
+        WordSetLoader{mode}.load(path, s);
+
+        EXPECT_EQ((std::vector<std::string>{"BANANA", "APPLE"}), s.words);
+        EXPECT_FALSE(s.wasPresorted);
+    }
+}
+
+
+TEST(WordSetLoaderTests, emptyLinesBecomeEmptyWordsInBothModes)
+{
+    std::string path = writeTempFile("WordSetLoaderTests3.txt", "a\n\nb\n");
+
+    RecordingSet mapped;
+    WordSetLoader{FileReadMode::Mapped}.load(path, mapped);
+
+    RecordingSet stream;
+    WordSetLoader{FileReadMode::Stream}.load(path, stream);
+
+    EXPECT_EQ((std::vector<std::string>{"A", "", "B"}), mapped.words);
+    EXPECT_EQ(stream.words, mapped.words);
+}
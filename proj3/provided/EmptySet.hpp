@@ -21,6 +21,7 @@ class EmptySet : public Set<ElementType>
 public:
     virtual bool isImplemented() const noexcept override;
     virtual void add(const ElementType& element) override;
+    virtual bool remove(const ElementType& element) override;
     virtual bool contains(const ElementType& element) const override;
     virtual unsigned int size() const noexcept override;
 };
@@ -39,6 +40,13 @@ void EmptySet<ElementType>::add(const ElementType& element)
 }
 
 
+template <typename ElementType>
+bool EmptySet<ElementType>::remove(const ElementType& element)
+{
+    return false;
+}
+
+
 template <typename ElementType>
 bool EmptySet<ElementType>::contains(const ElementType& element) const
 {
@@ -5,17 +5,20 @@
 //
 // An implementation of the Set<ElementType> class template, which uses
 // a singly-linked list with a head pointer to store its keys.  The keys
-// are not sorted in any particular order.
+// are not sorted in any particular order.  Its nodes are allocated with a
+// NodeAllocator (see NodeAllocator.hpp), which is given by the second
+// template argument.
 
 #ifndef LISTSET_HPP
 #define LISTSET_HPP
 
 #include <algorithm>
+#include "NodeAllocator.hpp"
 #include "Set.hpp"
 
 
 
-template <typename ElementType>
+template <typename ElementType, typename NodeAllocator = HeapNodeAllocator>
 class ListSet : public Set<ElementType>
 {
 public:
@@ -28,8 +31,10 @@ public:
 
     virtual bool isImplemented() const noexcept override;
     virtual void add(const ElementType& element) override;
+    virtual bool remove(const ElementType& element) override;
     virtual bool contains(const ElementType& element) const override;
     virtual unsigned int size() const noexcept override;
+    virtual SetStatistics statistics() const override;
 
 private:
     struct Node
@@ -39,6 +44,7 @@ private:
     };
 
     Node* head;
+    NodeAllocator nodeAllocator;
 
 private:
     Node* copyAll(const ListSet& s);
@@ -47,38 +53,48 @@ private:
 
 
 
-template <typename ElementType>
-ListSet<ElementType>::ListSet() noexcept
+template <typename ElementType, typename NodeAllocator>
+ListSet<ElementType, NodeAllocator>::ListSet() noexcept
     : head{nullptr}
 {
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>::~ListSet() noexcept
+template <typename ElementType, typename NodeAllocator>
+ListSet<ElementType, NodeAllocator>::~ListSet() noexcept
 {
-    destroyAll(head);
+    if constexpr (mustVisitNodesToDestroy<NodeAllocator, Node>)
+    {
+        Node* curr = head;
+
+        while (curr != nullptr)
+        {
+            Node* temp = curr;
+            curr = curr->next;
+            disposeNode(nodeAllocator, temp);
+        }
+    }
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>::ListSet(const ListSet& s)
+template <typename ElementType, typename NodeAllocator>
+ListSet<ElementType, NodeAllocator>::ListSet(const ListSet& s)
     : head{nullptr}
 {
     head = copyAll(s);
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>::ListSet(ListSet&& s) noexcept
-    : head{nullptr}
+template <typename ElementType, typename NodeAllocator>
+ListSet<ElementType, NodeAllocator>::ListSet(ListSet&& s) noexcept
+    : head{nullptr}, nodeAllocator{std::move(s.nodeAllocator)}
 {
     std::swap(head, s.head);
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>& ListSet<ElementType>::operator=(const ListSet& s)
+template <typename ElementType, typename NodeAllocator>
+ListSet<ElementType, NodeAllocator>& ListSet<ElementType, NodeAllocator>::operator=(const ListSet& s)
 {
     if (this != &s)
     {
@@ -91,23 +107,24 @@ ListSet<ElementType>& ListSet<ElementType>::operator=(const ListSet& s)
 }
 
 
-template <typename ElementType>
-ListSet<ElementType>& ListSet<ElementType>::operator=(ListSet&& s) noexcept
+template <typename ElementType, typename NodeAllocator>
+ListSet<ElementType, NodeAllocator>& ListSet<ElementType, NodeAllocator>::operator=(ListSet&& s) noexcept
 {
     std::swap(head, s.head);
+    std::swap(nodeAllocator, s.nodeAllocator);
     return *this;
 }
 
 
-template <typename ElementType>
-bool ListSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename NodeAllocator>
+bool ListSet<ElementType, NodeAllocator>::isImplemented() const noexcept
 {
     return true;
 }
 
 
-template <typename ElementType>
-void ListSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, typename NodeAllocator>
+void ListSet<ElementType, NodeAllocator>::add(const ElementType& element)
 {
     Node* curr = head;
 
@@ -121,17 +138,43 @@ void ListSet<ElementType>::add(const ElementType& element)
         curr = curr->next;
     }
 
-    head = new Node{element, head};
+    head = createNode<Node>(nodeAllocator, element, head);
 }
 
 
-template <typename ElementType>
-bool ListSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, typename NodeAllocator>
+bool ListSet<ElementType, NodeAllocator>::remove(const ElementType& element)
 {
+    Node** link = &head;
+
+    while (*link != nullptr)
+    {
+        if ((*link)->element == element)
+        {
+            Node* removed = *link;
+            *link = removed->next;
+            destroyNode(nodeAllocator, removed);
+            return true;
+        }
+
+        link = &(*link)->next;
+    }
+
+    return false;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+bool ListSet<ElementType, NodeAllocator>::contains(const ElementType& element) const
+{
+    LookupCounter::Lookup lookup{this};
     Node* curr = head;
 
     while (curr != nullptr)
     {
+        lookup.probed();
+        lookup.compared();
+
         if (curr->element == element)
         {
             return true;
@@ -144,8 +187,8 @@ bool ListSet<ElementType>::contains(const ElementType& element) const
 }
 
 
-template <typename ElementType>
-unsigned int ListSet<ElementType>::size() const noexcept
+template <typename ElementType, typename NodeAllocator>
+unsigned int ListSet<ElementType, NodeAllocator>::size() const noexcept
 {
     Node* curr = head;
     unsigned int count = 0;
@@ -160,8 +203,18 @@ unsigned int ListSet<ElementType>::size() const noexcept
 }
 
 
-template <typename ElementType>
-typename ListSet<ElementType>::Node* ListSet<ElementType>::copyAll(const ListSet& s)
+template <typename ElementType, typename NodeAllocator>
+SetStatistics ListSet<ElementType, NodeAllocator>::statistics() const
+{
+    SetStatistics statistics = Set<ElementType>::statistics();
+    statistics.memoryBytes = sizeof(*this) + statistics.elementCount * sizeof(Node);
+
+    return statistics;
+}
+
+
+template <typename ElementType, typename NodeAllocator>
+typename ListSet<ElementType, NodeAllocator>::Node* ListSet<ElementType, NodeAllocator>::copyAll(const ListSet& s)
 {
     Node* curr = s.head;
     Node* newHead = nullptr;
@@ -170,7 +223,7 @@ typename ListSet<ElementType>::Node* ListSet<ElementType>::copyAll(const ListSet
     {
         while (curr != nullptr)
         {
-            newHead = new Node{curr->element, newHead};
+            newHead = createNode<Node>(nodeAllocator, curr->element, newHead);
             curr = curr->next;
         }
 
@@ -184,8 +237,8 @@ typename ListSet<ElementType>::Node* ListSet<ElementType>::copyAll(const ListSet
 }
 
 
-template <typename ElementType>
-void ListSet<ElementType>::destroyAll(Node* head) noexcept
+template <typename ElementType, typename NodeAllocator>
+void ListSet<ElementType, NodeAllocator>::destroyAll(Node* head) noexcept
 {
     Node* curr = head;
 
@@ -193,7 +246,7 @@ void ListSet<ElementType>::destroyAll(Node* head) noexcept
     {
         Node* temp = curr;
         curr = curr->next;
-        delete temp;
+        destroyNode(nodeAllocator, temp);
     }
 }
 
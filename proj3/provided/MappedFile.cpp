@@ -0,0 +1,98 @@
+// MappedFile.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <fstream>
+#include <iterator>
+#include "MappedFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPEDFILE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+MappedFile::MappedFile(const std::string& filePath)
+    : opened{false}, data{nullptr}, length{0}, mapped{false}, buffer{}
+{
+#ifdef MAPPEDFILE_USE_MMAP
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+
+    if (fd >= 0)
+    {
+        struct stat status;
+
+        if (::fstat(fd, &status) == 0 && S_ISREG(status.st_mode))
+        {
+            std::size_t size = static_cast<std::size_t>(status.st_size);
+
+            if (size == 0)
+            {
+                opened = true;
+            }
+            else
+            {
+                void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if (p != MAP_FAILED)
+                {
+                    ::madvise(p, size, MADV_SEQUENTIAL);
+
+                    opened = true;
+                    data = static_cast<const char*>(p);
+                    length = size;
+                    mapped = true;
+                }
+            }
+        }
+
+        ::close(fd);
+
+        if (opened)
+        {
+            return;
+        }
+    }
+#endif
+
+    // Either mapping isn't supported here, or this is something that can't
+    // be mapped (such as a pipe), so read the whole thing into the buffer.
+    std::ifstream file{filePath, std::ios::binary};
+
+    if (file.is_open())
+    {
+        buffer.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+
+        opened = true;
+        data = buffer.data();
+        length = buffer.size();
+    }
+}
+
+
+MappedFile::~MappedFile() noexcept
+{
+#ifdef MAPPEDFILE_USE_MMAP
+    if (mapped)
+    {
+        ::munmap(const_cast<char*>(data), length);
+    }
+#endif
+}
+
+
+bool MappedFile::isOpen() const noexcept
+{
+    return opened;
+}
+
+
+std::string_view MappedFile::contents() const noexcept
+{
+    return std::string_view{data, length};
+}
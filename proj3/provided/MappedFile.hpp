@@ -0,0 +1,67 @@
+// MappedFile.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A MappedFile makes the entire contents of a file available, read-only,
+// as a std::string_view.  On systems that support it, the file is mapped
+// into memory with mmap(), so its contents are read directly from the
+// operating system's page cache rather than being copied through a stream
+// into strings; elsewhere, the file is read into a buffer in one go.
+//
+// A FileReadMode chooses how the TextFileReader and WordSetLoader read
+// their files: by mapping them with a MappedFile and scanning them in
+// place, or through a std::ifstream one line at a time (the way they
+// originally did).
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+
+enum class FileReadMode
+{
+    Stream,
+    Mapped
+};
+
+
+
+class MappedFile
+{
+public:
+    // Maps the file with the given path.  If the file can't be opened, the
+    // MappedFile is not open and its contents are empty.
+    explicit MappedFile(const std::string& filePath);
+
+    ~MappedFile() noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // isOpen() returns true if the file was opened successfully (even if
+    // it turned out to be empty), false otherwise.
+    bool isOpen() const noexcept;
+
+    // contents() returns the contents of the file.  The view remains valid
+    // for as long as the MappedFile exists.
+    std::string_view contents() const noexcept;
+
+private:
+    bool opened;
+    const char* data;
+    std::size_t length;
+
+    // Whether data points to a mapping (which must be unmapped) rather than
+    // into the buffer.
+    bool mapped;
+    std::string buffer;
+};
+
+
+
+#endif // MAPPEDFILE_HPP
@@ -0,0 +1,329 @@
+// PerfCounters.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "PerfCounters.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+
+
+namespace
+{
+    const char* const eventNames[PERF_EVENT_COUNT] = {
+        "cycles",
+        "instructions",
+        "l1d_misses",
+        "llc_misses",
+        "branch_misses"
+    };
+
+
+    unsigned int indexOf(PerfEvent event) noexcept
+    {
+        return static_cast<unsigned int>(event);
+    }
+
+
+#ifdef __linux__
+    struct EventConfig
+    {
+        std::uint32_t type;
+        std::uint64_t config;
+    };
+
+
+    // In the same order as PerfEvent.  The generic cache miss event counts
+    // misses in the last-level cache on the processors that support it.
+    const EventConfig eventConfigs[PERF_EVENT_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+    };
+
+
+    // Only the current thread is counted, and only while it's running in
+    // user mode, which is all that unprivileged users are usually allowed
+    // to count.  A counter that leads a group (or isn't in one, when
+    // groupLeader is -1) starts out disabled; the other members of a group
+    // are counted whenever their leader is.
+    int openCounter(const EventConfig& eventConfig, int groupLeader) noexcept
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = eventConfig.type;
+        attr.config = eventConfig.config;
+        attr.disabled = groupLeader < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        long descriptor = syscall(SYS_perf_event_open, &attr, 0, -1, groupLeader, 0);
+        return descriptor >= 0 ? static_cast<int>(descriptor) : -1;
+    }
+
+
+    // readCounter() reads the count, then the time enabled, then the time
+    // running, returning false if they can't be read.
+    bool readCounter(int descriptor, std::uint64_t (&values)[3]) noexcept
+    {
+        return read(descriptor, values, sizeof(values)) == sizeof(values);
+    }
+#endif
+}
+
+
+
+const char* perfEventName(PerfEvent event) noexcept
+{
+    return eventNames[indexOf(event)];
+}
+
+
+
+PerfSample::PerfSample()
+    : counts{}, present{}
+{
+}
+
+
+bool PerfSample::has(PerfEvent event) const noexcept
+{
+    return present[indexOf(event)];
+}
+
+
+std::uint64_t PerfSample::count(PerfEvent event) const noexcept
+{
+    return counts[indexOf(event)];
+}
+
+
+void PerfSample::setCount(PerfEvent event, std::uint64_t count) noexcept
+{
+    counts[indexOf(event)] = count;
+    present[indexOf(event)] = true;
+}
+
+
+bool PerfSample::empty() const noexcept
+{
+    for (bool p : present)
+    {
+        if (p)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+PerfCounters::PerfCounters()
+    : groupLeader{-1}
+{
+    descriptors.fill(-1);
+    enabledAtStart.fill(0);
+    runningAtStart.fill(0);
+
+    openCounters(true);
+
+    if (groupLeader >= 0 && !groupCanBeScheduled())
+    {
+        closeCounters();
+        openCounters(false);
+    }
+}
+
+
+PerfCounters::~PerfCounters() noexcept
+{
+    closeCounters();
+}
+
+
+bool PerfCounters::available() const noexcept
+{
+    for (int descriptor : descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+bool PerfCounters::available(PerfEvent event) const noexcept
+{
+    return descriptors[indexOf(event)] >= 0;
+}
+
+
+void PerfCounters::start() noexcept
+{
+#ifdef __linux__
+    control(PERF_EVENT_IOC_RESET);
+
+    for (unsigned int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        std::uint64_t values[3];
+
+        if (descriptors[i] >= 0)
+        {
+            bool timesRead = readCounter(descriptors[i], values);
+            enabledAtStart[i] = timesRead ? values[1] : 0;
+            runningAtStart[i] = timesRead ? values[2] : 0;
+        }
+    }
+
+    control(PERF_EVENT_IOC_ENABLE);
+#endif
+}
+
+
+// Each count is scaled by the times enabled and running since start() was
+// called, not since the counter was opened, so that every sample is scaled
+// only by how it was shared during its own interval.  A counter that was
+// never scheduled onto the processor in that interval (because others had
+// all of the hardware counters the whole time) has no count at all.
+
+PerfSample PerfCounters::stop() noexcept
+{
+    PerfSample sample;
+
+#ifdef __linux__
+    control(PERF_EVENT_IOC_DISABLE);
+
+    for (unsigned int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        // The count, then the time enabled, then the time running.
+        std::uint64_t values[3];
+
+        if (descriptors[i] < 0 || !readCounter(descriptors[i], values))
+        {
+            continue;
+        }
+
+        std::uint64_t enabled = values[1] - enabledAtStart[i];
+        std::uint64_t running = values[2] - runningAtStart[i];
+
+        if (running == 0)
+        {
+            continue;
+        }
+
+        std::uint64_t count = values[0];
+
+        if (running < enabled)
+        {
+            count = static_cast<std::uint64_t>(
+                static_cast<double>(count) * enabled / running);
+        }
+
+        sample.setCount(static_cast<PerfEvent>(i), count);
+    }
+#endif
+
+    return sample;
+}
+
+
+// The first event that can be opened leads the group, and the rest join
+// it; an event that can't be opened is left out either way.
+
+void PerfCounters::openCounters(bool asGroup) noexcept
+{
+#ifdef __linux__
+    for (unsigned int i = 0; i < PERF_EVENT_COUNT; ++i)
+    {
+        descriptors[i] = openCounter(eventConfigs[i], asGroup ? groupLeader : -1);
+
+        if (asGroup && groupLeader < 0)
+        {
+            groupLeader = descriptors[i];
+        }
+    }
+#endif
+}
+
+
+void PerfCounters::closeCounters() noexcept
+{
+#ifdef __linux__
+    for (int& descriptor : descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            close(descriptor);
+            descriptor = -1;
+        }
+    }
+#endif
+
+    groupLeader = -1;
+}
+
+
+// A group that needs more counters than the processor has is never
+// scheduled at all, so its leader is never running, no matter how long
+// it's enabled.
+
+bool PerfCounters::groupCanBeScheduled() noexcept
+{
+#ifdef __linux__
+    start();
+
+    volatile unsigned int sum = 0;
+
+    for (unsigned int i = 0; i < 10000; ++i)
+    {
+        sum = sum + i;
+    }
+
+    control(PERF_EVENT_IOC_DISABLE);
+
+    std::uint64_t values[3];
+    return readCounter(groupLeader, values) && values[2] > 0;
+#else
+    return false;
+#endif
+}
+
+
+void PerfCounters::control(unsigned long request) noexcept
+{
+#ifdef __linux__
+    if (groupLeader >= 0)
+    {
+        ioctl(groupLeader, request, PERF_IOC_FLAG_GROUP);
+        return;
+    }
+
+    for (int descriptor : descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            ioctl(descriptor, request, 0);
+        }
+    }
+#endif
+}
@@ -0,0 +1,116 @@
+// PerfCounters.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// PerfCounters counts hardware events (cycles, instructions, cache misses,
+// and branch mispredictions) on the current thread between calls to its
+// start() and stop() member functions, which explain why one Set is faster
+// than another in a way that durations alone can't.  On Linux, they're
+// read from the processor's performance counters with perf_event_open();
+// each event that the kernel doesn't allow (as when perf_event_paranoid
+// is too high, or in a virtual machine without a virtual PMU) is simply
+// left out, so a PerfSample may have some events, all of them, or none.
+// Elsewhere, there are never any.
+//
+// The events are opened as one group, so that the kernel starts and stops
+// all of them at once, and they count exactly the same stretch of time.
+// A group is only ever counted as a whole, though, so when the processor
+// doesn't have enough counters for all of them at once, they're opened
+// separately instead; the kernel then takes turns counting them, and each
+// count is scaled up by how much of the time it was actually being counted.
+
+#ifndef PERFCOUNTERS_HPP
+#define PERFCOUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+
+
+
+enum class PerfEvent
+{
+    Cycles,
+    Instructions,
+    L1DataMisses,
+    LastLevelCacheMisses,
+    BranchMisses
+};
+
+
+constexpr unsigned int PERF_EVENT_COUNT = 5;
+
+
+// perfEventName() returns a short name for an event, such as "cycles" or
+// "llc_misses", suitable for the heading of a column.
+const char* perfEventName(PerfEvent event) noexcept;
+
+
+
+// A PerfSample holds the count of each event that was counted.
+class PerfSample
+{
+public:
+    PerfSample();
+
+    bool has(PerfEvent event) const noexcept;
+    std::uint64_t count(PerfEvent event) const noexcept;
+    void setCount(PerfEvent event, std::uint64_t count) noexcept;
+
+    // empty() returns true if no events were counted.
+    bool empty() const noexcept;
+
+private:
+    std::array<std::uint64_t, PERF_EVENT_COUNT> counts;
+    std::array<bool, PERF_EVENT_COUNT> present;
+};
+
+
+
+class PerfCounters
+{
+public:
+    // Opens a counter for every event that can be counted.
+    PerfCounters();
+    ~PerfCounters() noexcept;
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // available() returns true if the given event (or, without one, any
+    // event at all) can be counted.
+    bool available() const noexcept;
+    bool available(PerfEvent event) const noexcept;
+
+    // start() resets the counters and starts counting; stop() stops
+    // counting and returns the counts since start() was called.
+    void start() noexcept;
+    PerfSample stop() noexcept;
+
+private:
+    void openCounters(bool asGroup) noexcept;
+    void closeCounters() noexcept;
+    bool groupCanBeScheduled() noexcept;
+
+    // control() sends the given ioctl request to the whole group, or to
+    // each counter separately.
+    void control(unsigned long request) noexcept;
+
+    // The file descriptor of each event's counter, or -1 if it can't be
+    // counted.
+    std::array<int, PERF_EVENT_COUNT> descriptors;
+
+    // The descriptor of the counter that leads the group, or -1 if the
+    // counters were opened separately.
+    int groupLeader;
+
+    // The time each counter had been enabled and running when start() was
+    // last called.  Resetting a counter doesn't reset its times, so they
+    // have to be subtracted from the times read by stop().
+    std::array<std::uint64_t, PERF_EVENT_COUNT> enabledAtStart;
+    std::array<std::uint64_t, PERF_EVENT_COUNT> runningAtStart;
+};
+
+
+
+#endif // PERFCOUNTERS_HPP
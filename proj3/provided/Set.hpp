@@ -5,16 +5,23 @@
 //
 // The Set<ElementType> class template is an abstract base class
 // template for implementations of a "set" (i.e., a collection of
-// unique elements that allows you to add, search, and determine
+// unique elements that allows you to add, remove, search, and determine
 // a size).
+//
+// Every Set can also report statistics about itself (see SetStatistics.hpp).
+// Its lookups are counted by the LookupCounter it derives from, rather than
+// one it holds as a member, so that when lookups aren't being counted, the
+// empty counter takes up no space at all.
 
 #ifndef SET_HPP
 #define SET_HPP
 
+#include "SetStatistics.hpp"
+
 
 
 template <typename ElementType>
-class Set
+class Set : protected LookupCounter
 {
 public:
     // The destructor is declared here mainly so we can assure that it will
@@ -34,6 +41,22 @@ public:
     virtual void add(const ElementType& element) = 0;
 
 
+    // addAll() adds every element in the range [begin, end) to the set, as
+    // though each had been passed to add().  If presorted is true, the
+    // caller is promising that the elements are in ascending order
+    // (duplicates allowed), which implementations may use to build their
+    // data structure in a single pass; it's only a hint, so one that turns
+    // out to be wrong costs time but not correctness.  By default, this
+    // function simply calls add() once per element.
+    virtual void addAll(const ElementType* begin, const ElementType* end, bool presorted);
+
+
+    // remove() removes an element from the set, returning true if it was
+    // in the set.  If it wasn't, this function has no effect and returns
+    // false.
+    virtual bool remove(const ElementType& element) = 0;
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.
     virtual bool contains(const ElementType& element) const = 0;
@@ -41,9 +64,47 @@ public:
 
     // size() returns the number of elements in the set.
     virtual unsigned int size() const noexcept = 0;
+
+
+    // statistics() returns statistics about the set's structure and, when
+    // SET_STATISTICS is defined, about the lookups it has done.  By default,
+    // only the number of elements (and the lookup counts) are filled in.
+    virtual SetStatistics statistics() const;
+
+
+    // resetStatistics() starts counting lookups from zero again.
+    virtual void resetStatistics() noexcept;
 };
 
 
 
+template <typename ElementType>
+void Set<ElementType>::addAll(const ElementType* begin, const ElementType* end, bool presorted)
+{
+    for (const ElementType* element = begin; element != end; ++element)
+    {
+        add(*element);
+    }
+}
+
+
+template <typename ElementType>
+SetStatistics Set<ElementType>::statistics() const
+{
+    SetStatistics statistics;
+    statistics.elementCount = size();
+    addTo(statistics);
+    return statistics;
+}
+
+
+template <typename ElementType>
+void Set<ElementType>::resetStatistics() noexcept
+{
+    reset();
+}
+
+
+
 #endif // SET_HPP
 
@@ -0,0 +1,203 @@
+// SetStatistics.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// SetStatistics describe how hard a Set is working: the shape of its
+// structure (how many levels it has and how much memory it uses), which
+// statistics() can always report, and how much work its lookups have
+// done, which it can only report when the program is compiled with
+// SET_STATISTICS defined (e.g., with -DSET_STATISTICS).
+//
+// Lookups are counted with a LookupCounter, which each kind of Set keeps
+// alongside its structure.  Each call to contains() makes a
+// LookupCounter::Lookup, tells it about every element it compares against
+// and every node (or bucket, or slot) it visits, and the Lookup adds those
+// to the counter when it's destroyed.  Without SET_STATISTICS, both are
+// empty and every one of their member functions does nothing, so the
+// compiler removes them entirely and contains() costs what it always did.
+// With SET_STATISTICS, the counts are kept in atomics, since contains() is
+// called from several threads at once when spelling is checked in
+// parallel; that makes lookups slower, so the counts are only for seeing
+// how much work is done, not how long it takes.
+//
+// SET_STATISTICS changes the layout of LookupCounter, which every Set
+// derives from, so it has to be defined for every source file or none.
+// The SET_STATISTICS option in CMakeLists.txt (which "./build --statistics"
+// turns on) defines it for all of them; a.out.gtest.stats is always built
+// with it defined, so that the tests of the counts are run either way.
+
+#ifndef SETSTATISTICS_HPP
+#define SETSTATISTICS_HPP
+
+#include <atomic>
+#include <cstddef>
+
+
+
+#ifdef SET_STATISTICS
+constexpr bool SET_STATISTICS_ENABLED = true;
+#else
+constexpr bool SET_STATISTICS_ENABLED = false;
+#endif
+
+
+
+struct SetStatistics
+{
+    unsigned int elementCount = 0;
+
+    // The number of levels in the structure: the number of nodes on the
+    // longest path down a tree, or the number of levels of a skip list.
+    // It's 0 for structures that have no levels, such as hash tables.
+    unsigned int levels = 0;
+
+    // The bytes that the structure uses: the Set object itself, and the
+    // nodes, arrays, or tables it allocates (with the elements in them),
+    // but not memory that the elements allocate themselves, such as the
+    // characters of a long std::string.
+    std::size_t memoryBytes = 0;
+
+    // Whether lookups were counted (i.e., whether SET_STATISTICS was
+    // defined); when they weren't, the rest of these are 0.
+    bool countsLookups = false;
+
+    // The number of calls to contains(), the number of elements they
+    // compared against the one they were looking for, and the number of
+    // nodes, buckets, or slots they visited along the way (their "probes"),
+    // in total and in the longest single lookup.
+    unsigned long long lookups = 0;
+    unsigned long long comparisons = 0;
+    unsigned long long probes = 0;
+    unsigned int maxProbes = 0;
+
+    double comparisonsPerLookup() const noexcept
+    {
+        return lookups > 0 ? static_cast<double>(comparisons) / lookups : 0.0;
+    }
+
+    double probesPerLookup() const noexcept
+    {
+        return lookups > 0 ? static_cast<double>(probes) / lookups : 0.0;
+    }
+};
+
+
+
+class LookupCounter
+{
+public:
+    class Lookup
+    {
+    public:
+        // A Lookup made with nullptr (such as the search that add() does
+        // before adding an element) isn't counted.
+        explicit Lookup(const LookupCounter* counter) noexcept
+#ifdef SET_STATISTICS
+            : counter{counter}, comparisons{0}, probes{0}
+#endif
+        {
+        }
+
+        ~Lookup() noexcept
+        {
+#ifdef SET_STATISTICS
+            if (counter != nullptr)
+            {
+                counter->record(comparisons, probes);
+            }
+#endif
+        }
+
+        Lookup(const Lookup&) = delete;
+        Lookup& operator=(const Lookup&) = delete;
+
+        void compared(unsigned int count = 1) noexcept
+        {
+#ifdef SET_STATISTICS
+            comparisons += count;
+#endif
+        }
+
+        void probed(unsigned int count = 1) noexcept
+        {
+#ifdef SET_STATISTICS
+            probes += count;
+#endif
+        }
+
+#ifdef SET_STATISTICS
+    private:
+        const LookupCounter* counter;
+        unsigned int comparisons;
+        unsigned int probes;
+#endif
+    };
+
+
+public:
+    LookupCounter() noexcept = default;
+
+    // A copy of a set starts counting from zero.
+    LookupCounter(const LookupCounter&) noexcept
+    {
+    }
+
+    LookupCounter& operator=(const LookupCounter&) noexcept
+    {
+        return *this;
+    }
+
+
+    // addTo() fills in the lookup counts of the given statistics.
+    void addTo(SetStatistics& statistics) const noexcept
+    {
+#ifdef SET_STATISTICS
+        statistics.countsLookups = true;
+        statistics.lookups += lookups.load(std::memory_order_relaxed);
+        statistics.comparisons += comparisons.load(std::memory_order_relaxed);
+        statistics.probes += probes.load(std::memory_order_relaxed);
+
+        unsigned int max = maxProbes.load(std::memory_order_relaxed);
+        statistics.maxProbes = max > statistics.maxProbes ? max : statistics.maxProbes;
+#endif
+    }
+
+
+    void reset() noexcept
+    {
+#ifdef SET_STATISTICS
+        lookups.store(0, std::memory_order_relaxed);
+        comparisons.store(0, std::memory_order_relaxed);
+        probes.store(0, std::memory_order_relaxed);
+        maxProbes.store(0, std::memory_order_relaxed);
+#endif
+    }
+
+
+#ifdef SET_STATISTICS
+private:
+    mutable std::atomic<unsigned long long> lookups{0};
+    mutable std::atomic<unsigned long long> comparisons{0};
+    mutable std::atomic<unsigned long long> probes{0};
+    mutable std::atomic<unsigned int> maxProbes{0};
+
+    void record(unsigned int lookupComparisons, unsigned int lookupProbes) const noexcept
+    {
+        lookups.fetch_add(1, std::memory_order_relaxed);
+        comparisons.fetch_add(lookupComparisons, std::memory_order_relaxed);
+        probes.fetch_add(lookupProbes, std::memory_order_relaxed);
+
+        unsigned int max = maxProbes.load(std::memory_order_relaxed);
+
+        while (lookupProbes > max
+            && !maxProbes.compare_exchange_weak(max, lookupProbes, std::memory_order_relaxed))
+        {
+        }
+    }
+#endif
+};
+
+
+
+#endif // SETSTATISTICS_HPP
@@ -3,24 +3,29 @@
 // ICS 46 Winter 2019
 // Project #3: Set the Controls for the Heart of the Sun
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 #include "SpellCheckShell.hpp"
-#include "AVLSet.hpp"
+#include "DeletionIndex.hpp"
+#include "DictionaryImage.hpp"
 #include "EmptySet.hpp"
-#include "HashSet.hpp"
-#include "ListSet.hpp"
+#include "LevenshteinTrie.hpp"
+#include "MappedFile.hpp"
 #include "OutputSpellCheckerListener.hpp"
 #include "Set.hpp"
-#include "SkipListSet.hpp"
 #include "SpellChecker.hpp"
 #include "Stopwatch.hpp"
-#include "StringHashing.hpp"
 #include "TextFileReader.hpp"
 #include "WordChecker.hpp"
 #include "WordSetLoader.hpp"
+#include "WordSets.hpp"
 
 
 
@@ -47,39 +52,184 @@ namespace
     }
 
 
-    std::unique_ptr<Set<std::string>> makeWordSet(const std::string& setType)
+    constexpr unsigned long MAX_THREAD_COUNT = 256;
+
+
+    enum class OutputType
+    {
+        Display,
+        TimeOnly,
+        Statistics
+    };
+
+
+    enum class SuggestionStrategy
+    {
+        Edits,
+        DeletionIndex,
+        LevenshteinTrie
+    };
+
+
+    // The output type can be followed by options, separated by spaces:
+    //
+    //   * A number of threads to check spelling with (where 0 means one per
+    //     hardware thread).  Spelling is checked on one thread by default.
+    //
+    //   * EDITS, SYMSPELL, or RANKED, choosing whether suggestions are
+    //     found by trying edits of each misspelled word against the word
+    //     set (the default), by looking them up in a DeletionIndex, or by
+    //     searching a LevenshteinTrie (which returns the ten closest words,
+    //     closest first), where the index or trie is built alongside the
+    //     word set.
+
+    struct RunOptions
+    {
+        OutputType outputType;
+        unsigned int threadCount;
+        SuggestionStrategy suggestionStrategy;
+    };
+
+
+    OutputType makeOutputType(const std::string& outputType)
     {
-        if (setType == "AVL")
+        if (outputType == "DISPLAY")
         {
-            return std::make_unique<AVLSet<std::string>>();
+            return OutputType::Display;
         }
-        else if (setType == "EMPTY")
+        else if (outputType == "TIME")
+        {
+            return OutputType::TimeOnly;
+        }
+        else if (outputType == "STATS")
+        {
+            return OutputType::Statistics;
+        }
+        else
         {
-            return std::make_unique<EmptySet<std::string>>();
+            throw SpellCheckShell::ShellException{"Invalid output type: " + outputType};
         }
-        else if (setType == "HASH ZERO")
+    }
+
+
+    unsigned int makeThreadCount(const std::string& threadCount)
+    {
+        try
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsZero);
+            std::size_t end;
+            unsigned long count = std::stoul(threadCount, &end);
+
+            if (end == threadCount.length() && count <= MAX_THREAD_COUNT)
+            {
+                return static_cast<unsigned int>(count);
+            }
         }
-        else if (setType == "HASH SUM")
+        catch (std::logic_error&)
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsSum);
         }
-        else if (setType == "HASH PRODUCT")
+
+        throw SpellCheckShell::ShellException{"Invalid thread count: " + threadCount};
+    }
+
+
+    RunOptions makeRunOptions(const std::string& outputTypeLine)
+    {
+        std::istringstream words{outputTypeLine};
+        std::string word;
+        words >> word;
+
+        RunOptions options{makeOutputType(word), 1, SuggestionStrategy::Edits};
+
+        while (words >> word)
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsProduct);
+            if (word == "EDITS")
+            {
+                options.suggestionStrategy = SuggestionStrategy::Edits;
+            }
+            else if (word == "SYMSPELL")
+            {
+                options.suggestionStrategy = SuggestionStrategy::DeletionIndex;
+            }
+            else if (word == "RANKED")
+            {
+                options.suggestionStrategy = SuggestionStrategy::LevenshteinTrie;
+            }
+            else if (std::isdigit(static_cast<unsigned char>(word[0])))
+            {
+                options.threadCount = makeThreadCount(word);
+            }
+            else
+            {
+                throw SpellCheckShell::ShellException{"Invalid option: " + word};
+            }
         }
-        else if (setType == "LIST")
+
+        return options;
+    }
+
+
+    // loadWordSet() fills the word set from the word file; when the word set
+    // is a DictionaryImage, the "word file" is an image (made by the
+    // MAKE IMAGE tool), which is opened rather than loaded.  When the
+    // suggestions are to come from a SuggestionSource, one is built from
+    // the same words and returned; otherwise, nullptr is returned.
+    std::unique_ptr<SuggestionSource> loadWordSet(
+        const std::string& wordFilePath, Set<std::string>& wordSet,
+        SuggestionStrategy suggestionStrategy)
+    {
+        if (DictionaryImage* image = dynamic_cast<DictionaryImage*>(&wordSet))
         {
-            return std::make_unique<ListSet<std::string>>();
+            if (suggestionStrategy != SuggestionStrategy::Edits)
+            {
+                throw SpellCheckShell::ShellException{
+                    "Suggestion indexes need a word file, not an image"};
+            }
+
+            try
+            {
+                image->open(wordFilePath);
+            }
+            catch (DictionaryImage::ImageException& e)
+            {
+                throw SpellCheckShell::ShellException{e.reason()};
+            }
+
+            return nullptr;
         }
-        else if (setType == "SKIPLIST")
+        else if (suggestionStrategy == SuggestionStrategy::Edits)
         {
-            return std::make_unique<SkipListSet<std::string>>();
+            WordSetLoader{}.load(wordFilePath, wordSet);
+            return nullptr;
+        }
+
+        std::vector<std::string> words;
+        bool presorted = WordSetLoader{}.readWords(wordFilePath, words);
+
+        const std::string* begin = words.data();
+        const std::string* end = words.data() + words.size();
+
+        wordSet.addAll(begin, end, presorted);
+
+        if (suggestionStrategy == SuggestionStrategy::DeletionIndex)
+        {
+            return std::make_unique<DeletionIndex>(begin, end, presorted);
+        }
+        else
+        {
+            return std::make_unique<LevenshteinTrie>(begin, end);
+        }
+    }
+
+
+    WordChecker makeWordChecker(const Set<std::string>& wordSet, const SuggestionSource* suggestionSource)
+    {
+        if (suggestionSource != nullptr)
+        {
+            return WordChecker{wordSet, *suggestionSource};
         }
         else
         {
-            throw SpellCheckShell::ShellException{"Invalid search structure type: " + setType};
+            return WordChecker{wordSet};
         }
     }
 
@@ -108,33 +258,27 @@ namespace
     }
 
 
-    enum class OutputType
+    void checkSpelling(
+        SpellChecker& spellChecker, const WordChecker& wordChecker,
+        const std::string& textFilePath, unsigned int threadCount)
     {
-        Display,
-        TimeOnly
-    };
-
-
-    OutputType makeOutputType(const std::string& outputType)
-    {
-        if (outputType == "DISPLAY")
+        if (threadCount == 1)
         {
-            return OutputType::Display;
-        }
-        else if (outputType == "TIME")
-        {
-            return OutputType::TimeOnly;
+            TextFileReader reader{textFilePath};
+            spellChecker.run(wordChecker, reader);
         }
         else
         {
-            throw SpellCheckShell::ShellException{"Invalid output type: " + outputType};
+            MappedFile textFile{textFilePath};
+            spellChecker.runInParallel(wordChecker, textFile.contents(), threadCount);
         }
     }
 
 
     void runWithDisplay(
         Set<std::string>& wordSet,
-        const std::string& wordFilePath, const std::string& textFilePath)
+        const std::string& wordFilePath, const std::string& textFilePath,
+        const RunOptions& options)
     {
         SpellChecker spellChecker;
 
@@ -146,20 +290,20 @@ namespace
         std::cout << std::endl;
         std::cout << "Loading word set from " << wordFilePath << " ..." << std::endl;
 
-        WordSetLoader{}.load(wordFilePath, wordSet);
+        std::unique_ptr<SuggestionSource> suggestionSource =
+            loadWordSet(wordFilePath, wordSet, options.suggestionStrategy);
 
         std::cout << "Checking spelling in " << textFilePath << " ..." << std::endl;
 
-        WordChecker wordChecker{wordSet};
-        TextFileReader reader{textFilePath};
-
-        spellChecker.run(wordChecker, reader);
+        WordChecker wordChecker = makeWordChecker(wordSet, suggestionSource.get());
+        checkSpelling(spellChecker, wordChecker, textFilePath, options.threadCount);
     }
 
 
     void runTimingTest(
         Set<std::string>& wordSet,
-        const std::string& wordFilePath, const std::string& textFilePath)
+        const std::string& wordFilePath, const std::string& textFilePath,
+        const RunOptions& options)
     {
         std::cout << std::endl;
 
@@ -170,9 +314,11 @@ namespace
         std::cout << "Loading word set from " << wordFilePath
                   << " into search structure ..." << std::endl;
 
+        std::unique_ptr<SuggestionSource> suggestionSource;
+
         {
             stopwatch.start();
-            WordSetLoader{}.load(wordFilePath, wordSet);
+            suggestionSource = loadWordSet(wordFilePath, wordSet, options.suggestionStrategy);
             stopwatch.stop();
         }
 
@@ -183,9 +329,8 @@ namespace
 
         {
             stopwatch.start();
-            WordChecker wordChecker{wordSet};
-            TextFileReader reader{textFilePath};
-            spellChecker.run(wordChecker, reader);
+            WordChecker wordChecker = makeWordChecker(wordSet, suggestionSource.get());
+            checkSpelling(spellChecker, wordChecker, textFilePath, options.threadCount);
             stopwatch.stop();
         }
 
@@ -197,7 +342,7 @@ namespace
                   << " into empty set ..." << std::endl;
         {
             stopwatch.start();
-            WordSetLoader{}.load(wordFilePath, emptySet);
+            loadWordSet(wordFilePath, emptySet, SuggestionStrategy::Edits);
             stopwatch.stop();
         }
 
@@ -209,8 +354,7 @@ namespace
         {
             stopwatch.start();
             WordChecker wordChecker{emptySet};
-            TextFileReader reader{textFilePath};
-            spellChecker.run(wordChecker, reader);
+            checkSpelling(spellChecker, wordChecker, textFilePath, options.threadCount);
             stopwatch.stop();
         }
 
@@ -261,6 +405,88 @@ namespace
                      - (emptySetLoadDuration + emptySetSpellCheckDuration) << "usec";
 
         std::cout << std::endl;
+
+        if (suggestionSource != nullptr)
+        {
+            std::cout << std::endl;
+            std::cout << "Suggestion index: " << suggestionSource->memoryUsage()
+                      << " bytes" << std::endl;
+        }
+    }
+
+
+    // runStatistics() checks spelling just as runWithDisplay() does, but
+    // reports the word set's statistics instead of the misspellings.  The
+    // lookups are counted from the start of the spell check, so the ones
+    // that loading the word set does aren't included; the ones that
+    // finding suggestions does are.
+
+    void runStatistics(
+        Set<std::string>& wordSet,
+        const std::string& wordFilePath, const std::string& textFilePath,
+        const RunOptions& options)
+    {
+        std::cout << std::endl;
+        std::cout << "Loading word set from " << wordFilePath << " ..." << std::endl;
+
+        std::unique_ptr<SuggestionSource> suggestionSource =
+            loadWordSet(wordFilePath, wordSet, options.suggestionStrategy);
+
+        std::cout << "Checking spelling in " << textFilePath << " ..." << std::endl;
+
+        wordSet.resetStatistics();
+
+        {
+            SpellChecker spellChecker;
+            WordChecker wordChecker = makeWordChecker(wordSet, suggestionSource.get());
+            checkSpelling(spellChecker, wordChecker, textFilePath, options.threadCount);
+        }
+
+        SetStatistics statistics = wordSet.statistics();
+
+        std::cout << std::endl;
+        std::cout << std::endl;
+        std::cout << "STATISTICS" << std::endl;
+
+        std::cout << std::left << std::setw(24) << "Elements"
+                  << std::right << std::setw(14) << statistics.elementCount << std::endl;
+
+        std::cout << std::left << std::setw(24) << "Levels"
+                  << std::right << std::setw(14) << statistics.levels << std::endl;
+
+        std::cout << std::left << std::setw(24) << "Memory"
+                  << std::right << std::setw(14) << statistics.memoryBytes << " bytes" << std::endl;
+
+        if (statistics.elementCount > 0)
+        {
+            std::cout << std::left << std::setw(24) << "Memory per element"
+                      << std::right << std::fixed << std::setprecision(1) << std::setw(14)
+                      << static_cast<double>(statistics.memoryBytes) / statistics.elementCount
+                      << " bytes" << std::endl;
+        }
+
+        if (!statistics.countsLookups)
+        {
+            std::cout << std::endl;
+            std::cout << "Lookups aren't counted unless compiled with SET_STATISTICS defined"
+                      << std::endl;
+
+            return;
+        }
+
+        std::cout << std::left << std::setw(24) << "Lookups"
+                  << std::right << std::setw(14) << statistics.lookups << std::endl;
+
+        std::cout << std::left << std::setw(24) << "Comparisons per lookup"
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(14)
+                  << statistics.comparisonsPerLookup() << std::endl;
+
+        std::cout << std::left << std::setw(24) << "Probes per lookup"
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(14)
+                  << statistics.probesPerLookup() << std::endl;
+
+        std::cout << std::left << std::setw(24) << "Longest probe"
+                  << std::right << std::setw(14) << statistics.maxProbes << std::endl;
     }
 }
 
@@ -282,16 +508,20 @@ void SpellCheckShell::run()
     std::string textFilePath = readString();
     requireNonEmptyFileExists(textFilePath);
 
-    OutputType outputType = makeOutputType(readString());
+    RunOptions options = makeRunOptions(readString());
 
-    switch (outputType)
+    switch (options.outputType)
     {
     case OutputType::Display:
-        runWithDisplay(*wordSet, wordFilePath, textFilePath);
+        runWithDisplay(*wordSet, wordFilePath, textFilePath, options);
         break;
 
     case OutputType::TimeOnly:
-        runTimingTest(*wordSet, wordFilePath, textFilePath);
+        runTimingTest(*wordSet, wordFilePath, textFilePath, options);
+        break;
+
+    case OutputType::Statistics:
+        runStatistics(*wordSet, wordFilePath, textFilePath, options);
         break;
     }
 }
@@ -3,10 +3,231 @@
 // ICS 46 Winter 2019
 // Project #3: Set the Controls for the Heart of the Sun
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include "SpellChecker.hpp"
 
 
 
+namespace
+{
+    // The text is split into about this many chunks per thread, so that a
+    // thread that finishes early can pick up more work rather than sitting
+    // idle while others finish long chunks.
+    constexpr std::size_t CHUNKS_PER_THREAD = 8;
+
+    // No chunk is made smaller than this (except the last one), so that
+    // small texts aren't split into pieces too small to be worth a thread.
+    constexpr std::size_t MIN_CHUNK_SIZE = 4096;
+
+
+    struct Misspelling
+    {
+        std::string word;
+        std::string line;
+        std::vector<std::string> suggestions;
+    };
+
+
+    // The result of checking one chunk.  Once done is set (with the mutex
+    // in ChunkResults held), the chunk's misspellings, or the exception
+    // that stopped it from being checked, belong to the thread merging the
+    // results.
+    struct ChunkResult
+    {
+        std::vector<Misspelling> misspellings;
+        std::exception_ptr failure;
+        bool done = false;
+    };
+
+
+    // splitIntoChunks() splits the text into roughly equal chunks, each of
+    // which ends just after a newline (or at the end of the text), so that
+    // no line -- and, hence, no word -- is split between two chunks.
+
+    std::vector<std::string_view> splitIntoChunks(std::string_view text, std::size_t chunkCount)
+    {
+        std::size_t targetSize = std::max(MIN_CHUNK_SIZE, text.length() / chunkCount + 1);
+
+        std::vector<std::string_view> chunks;
+        std::size_t start = 0;
+
+        while (start < text.length())
+        {
+            std::size_t end = std::min(start + targetSize, text.length());
+
+            if (end < text.length())
+            {
+                std::size_t newline = text.find('\n', end - 1);
+                end = newline == std::string_view::npos ? text.length() : newline + 1;
+            }
+
+            chunks.push_back(text.substr(start, end - start));
+            start = end;
+        }
+
+        return chunks;
+    }
+
+
+    void checkChunk(
+        const WordChecker& wordChecker, std::string_view chunk,
+        std::vector<Misspelling>& misspellings)
+    {
+        for (TextFileReader reader{chunk}; !reader.noMoreWords(); reader.advanceToNextWord())
+        {
+            const std::string& word = reader.currentWord();
+
+            if (!wordChecker.wordExists(word))
+            {
+                misspellings.push_back(
+                    Misspelling{word, reader.currentLine(), wordChecker.findSuggestions(word)});
+            }
+        }
+    }
+
+
+    // A ChunkPool is a pool of threads that check chunks of text, each
+    // thread taking the next unchecked chunk whenever it finishes one, and
+    // hand the results to the thread that owns the pool, which can wait for
+    // them one chunk at a time, in order.  The pool's destructor stops the
+    // threads (once they've finished their current chunks) and waits for
+    // them to end, so they never outlive the chunks or the WordChecker.
+
+    class ChunkPool
+    {
+    public:
+        ChunkPool(
+            const WordChecker& wordChecker, const std::vector<std::string_view>& chunks,
+            unsigned int threadCount);
+
+        ~ChunkPool() noexcept;
+
+        ChunkPool(const ChunkPool&) = delete;
+        ChunkPool& operator=(const ChunkPool&) = delete;
+
+        // takeResult() waits until the given chunk has been checked, then
+        // returns its misspellings (or rethrows the exception that stopped
+        // it from being checked).
+        std::vector<Misspelling> takeResult(std::size_t chunkIndex);
+
+    private:
+        const WordChecker& wordChecker;
+        const std::vector<std::string_view>& chunks;
+
+        std::vector<ChunkResult> results;
+        std::mutex resultsMutex;
+        std::condition_variable chunkDone;
+
+        std::atomic<std::size_t> nextChunk;
+        std::atomic<bool> stopping;
+
+        std::vector<std::thread> threads;
+
+    private:
+        void work() noexcept;
+    };
+
+
+    ChunkPool::ChunkPool(
+        const WordChecker& wordChecker, const std::vector<std::string_view>& chunks,
+        unsigned int threadCount)
+        : wordChecker{wordChecker}, chunks{chunks}, results(chunks.size()),
+          nextChunk{0}, stopping{false}
+    {
+        threads.reserve(threadCount);
+
+        try
+        {
+            for (unsigned int i = 0; i < threadCount; ++i)
+            {
+                threads.emplace_back([this]() { work(); });
+            }
+        }
+        catch (...)
+        {
+            stopping = true;
+
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            throw;
+        }
+    }
+
+
+    ChunkPool::~ChunkPool() noexcept
+    {
+        stopping = true;
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+
+    std::vector<Misspelling> ChunkPool::takeResult(std::size_t chunkIndex)
+    {
+        ChunkResult& result = results[chunkIndex];
+
+        {
+            std::unique_lock<std::mutex> lock{resultsMutex};
+            chunkDone.wait(lock, [&]() { return result.done; });
+        }
+
+        if (result.failure)
+        {
+            std::rethrow_exception(result.failure);
+        }
+
+        return std::move(result.misspellings);
+    }
+
+
+    void ChunkPool::work() noexcept
+    {
+        while (!stopping)
+        {
+            std::size_t chunkIndex = nextChunk++;
+
+            if (chunkIndex >= chunks.size())
+            {
+                return;
+            }
+
+            std::vector<Misspelling> misspellings;
+            std::exception_ptr failure;
+
+            try
+            {
+                checkChunk(wordChecker, chunks[chunkIndex], misspellings);
+            }
+            catch (...)
+            {
+                failure = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{resultsMutex};
+                results[chunkIndex].misspellings = std::move(misspellings);
+                results[chunkIndex].failure = failure;
+                results[chunkIndex].done = true;
+            }
+
+            chunkDone.notify_all();
+        }
+    }
+}
+
+
+
 void SpellChecker::run(const WordChecker& wordChecker, TextFileReader& reader)
 {
     while (!reader.noMoreWords())
@@ -23,6 +244,39 @@ void SpellChecker::run(const WordChecker& wordChecker, TextFileReader& reader)
 }
 
 
+void SpellChecker::runInParallel(
+    const WordChecker& wordChecker, std::string_view text,
+    unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<std::string_view> chunks =
+        splitIntoChunks(text, std::size_t{threadCount} * CHUNKS_PER_THREAD);
+
+    if (threadCount == 1 || chunks.size() <= 1)
+    {
+        TextFileReader reader{text};
+        run(wordChecker, reader);
+        return;
+    }
+
+    ChunkPool pool{
+        wordChecker, chunks,
+        static_cast<unsigned int>(std::min<std::size_t>(threadCount, chunks.size()))};
+
+    for (std::size_t i = 0; i < chunks.size(); ++i)
+    {
+        for (const Misspelling& misspelling : pool.takeResult(i))
+        {
+            notifyMisspellingFound(misspelling.word, misspelling.line, misspelling.suggestions);
+        }
+    }
+}
+
+
 void SpellChecker::notifyMisspellingFound(
     const std::string& word, const std::string& line,
     const std::vector<std::string>& suggestions)
@@ -33,4 +287,3 @@ void SpellChecker::notifyMisspellingFound(
             listener->misspellingFound(word, line, suggestions);
         });
 }
-
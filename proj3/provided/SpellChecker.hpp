@@ -7,10 +7,22 @@
 // WordChecker to determine whether words are spelled correctly,
 // the given TextFileReader to determine which words to check,
 // and notifies any observers whenever misspellings are found.
+//
+// Alternatively, runInParallel() splits text that's already in memory into
+// pieces that end at line boundaries and checks them on a pool of threads.
+// Observers are still notified on the calling thread, one misspelling at a
+// time and in the order the misspellings appear in the text, so they see
+// exactly the notifications that run() would have given them.  Meanwhile,
+// the threads call wordExists() and findSuggestions() at the same time, so
+// the Set underneath the WordChecker must not change while the text is
+// being checked (all of the Sets are safe to read from several threads at
+// once, once they've been loaded, with one exception: a HashSet that's in
+// the middle of a resize, which WordSetLoader never leaves behind).
 
 #ifndef SPELLCHECKER_HPP
 #define SPELLCHECKER_HPP
 
+#include <string_view>
 #include <ics46/observable/Observable.hpp>
 #include "SpellCheckerListener.hpp"
 #include "TextFileReader.hpp"
@@ -23,6 +35,12 @@ class SpellChecker : public ics46::observable::Observable<SpellCheckerListener>
 public:
     void run(const WordChecker& wordChecker, TextFileReader& reader);
 
+    // A threadCount of 0 uses as many threads as the hardware can run at
+    // once; a threadCount of 1 checks the text without any extra threads.
+    void runInParallel(
+        const WordChecker& wordChecker, std::string_view text,
+        unsigned int threadCount);
+
 private:
     void notifyMisspellingFound(
         const std::string& word, const std::string& line,
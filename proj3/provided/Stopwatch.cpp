@@ -8,7 +8,13 @@
 
 
 Stopwatch::Stopwatch()
-    : running{false}, duration{0.0}
+    : running{false}, duration{0.0}, counters{nullptr}
+{
+}
+
+
+Stopwatch::Stopwatch(PerfCounters& counters)
+    : running{false}, duration{0.0}, counters{&counters}
 {
 }
 
@@ -17,6 +23,11 @@ void Stopwatch::start()
 {
     if (!running)
     {
+        if (counters != nullptr)
+        {
+            counters->start();
+        }
+
         startTime = std::chrono::high_resolution_clock::now();
         running = true;
     }
@@ -33,9 +44,13 @@ void Stopwatch::stop()
     {
         stopTime = std::chrono::high_resolution_clock::now();
 
+        if (counters != nullptr)
+        {
+            counts = counters->stop();
+        }
+
         duration =
-            std::chrono::duration_cast<std::chrono::microseconds>(stopTime - startTime)
-            .count();
+            std::chrono::duration<double, std::micro>(stopTime - startTime).count();
 
         running = false;
     }
@@ -51,3 +66,9 @@ double Stopwatch::lastDuration() const
     return duration;
 }
 
+
+const PerfSample& Stopwatch::lastCounts() const
+{
+    return counts;
+}
+
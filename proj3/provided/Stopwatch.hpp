@@ -4,12 +4,19 @@
 // Project #3: Set the Controls for the Heart of the Sun
 //
 // The Stopwatch class is used to measure CPU time consumption between
-// the time that its start() and stop() member functions are called.
+// the time that its start() and stop() member functions are called.  The
+// duration is in microseconds, including any fraction of one.
+//
+// A Stopwatch can also be given PerfCounters (see PerfCounters.hpp), which
+// it then starts and stops along with itself, so that the hardware events
+// behind each duration can be had from lastCounts().  When the counters
+// aren't available, lastCounts() is simply empty.
 
 #ifndef STOPWATCH_HPP
 #define STOPWATCH_HPP
 
 #include <chrono>
+#include "PerfCounters.hpp"
 
 
 
@@ -17,11 +24,13 @@ class Stopwatch
 {
 public:
     Stopwatch();
+    explicit Stopwatch(PerfCounters& counters);
 
     void start();
     void stop();
 
     double lastDuration() const;
+    const PerfSample& lastCounts() const;
 
 
     class NotRunningException { };
@@ -32,6 +41,9 @@ private:
     std::chrono::high_resolution_clock::time_point startTime;
     std::chrono::high_resolution_clock::time_point stopTime;
     double duration;
+
+    PerfCounters* counters;
+    PerfSample counts;
 };
 
 
@@ -3,8 +3,14 @@
 // ICS 46 Winter 2019
 // Project #3: Set the Controls for the Heart of the Sun
 
+#include <cstdint>
+#include <cstring>
 #include "StringHashing.hpp"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#endif
+
 
 
 // This hash function returns zero for all strings.  As you might imagine,
@@ -39,14 +45,192 @@ unsigned int hashStringAsSum(const std::string& word)
 
 unsigned int hashStringAsProduct(const std::string& word)
 {
-    unsigned int hash = 0;
+    return StringHashAsProduct{}(word);
+}
 
-    for (size_t i = 0; i < word.length(); ++i)
+
+
+// This hash function is the 32-bit FNV-1a hash: each character is combined
+// into the hash with an exclusive-or, followed by multiplication by a prime
+// chosen so that every input bit affects many output bits.  It's simple
+// and well-distributed, but processes only one character per step.
+
+unsigned int hashStringAsFnv1a(const std::string& word)
+{
+    return StringHashAsFnv1a{}(word);
+}
+
+
+
+namespace
+{
+    std::uint64_t readUnaligned64(const char* p)
     {
-        hash *= 37;
-        hash += static_cast<unsigned int>(word[i]);
+        std::uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
     }
 
-    return hash;
+
+    // multiplyMix() multiplies two 64-bit values into a 128-bit product and
+    // folds its halves together, which is the core step of wyhash.
+
+    std::uint64_t multiplyMix(std::uint64_t a, std::uint64_t b)
+    {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+        std::uint64_t aLow = a & 0xFFFFFFFFu, aHigh = a >> 32;
+        std::uint64_t bLow = b & 0xFFFFFFFFu, bHigh = b >> 32;
+
+        std::uint64_t lowLow = aLow * bLow;
+        std::uint64_t lowHigh = aLow * bHigh;
+        std::uint64_t highLow = aHigh * bLow;
+        std::uint64_t highHigh = aHigh * bHigh;
+
+        std::uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFu) + (highLow & 0xFFFFFFFFu);
+        std::uint64_t low = (lowLow & 0xFFFFFFFFu) | (middle << 32);
+        std::uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+
+        return low ^ high;
+#endif
+    }
 }
 
+
+// This hash function is in the style of wyhash: the string is consumed 8
+// bytes at a time, with each 8-byte block mixed into the hash by a single
+// 64x64-bit multiplication.  The 64-bit result is folded into 32 bits.
+
+unsigned int hashStringAsWymix(const std::string& word)
+{
+    constexpr std::uint64_t secret0 = 0xa0761d6478bd642full;
+    constexpr std::uint64_t secret1 = 0xe7037ed1a0b428dbull;
+    constexpr std::uint64_t secret2 = 0x8ebc6af09c88c6e3ull;
+
+    const char* p = word.data();
+    size_t remaining = word.length();
+    std::uint64_t hash = secret0;
+
+    while (remaining >= 8)
+    {
+        hash = multiplyMix(readUnaligned64(p) ^ secret1, hash ^ secret2);
+        p += 8;
+        remaining -= 8;
+    }
+
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, p, remaining);
+
+    hash = multiplyMix(tail ^ secret1, hash ^ secret2 ^ remaining);
+    hash = multiplyMix(hash ^ secret0, word.length() ^ secret1);
+
+    return static_cast<unsigned int>(hash ^ (hash >> 32));
+}
+
+
+
+namespace
+{
+    // The portable CRC32-C uses a table of the CRC of every byte value under
+    // the (bit-reflected) Castagnoli polynomial, built once.
+
+    struct Crc32cTable
+    {
+        std::uint32_t entries[256];
+
+        Crc32cTable()
+        {
+            for (std::uint32_t i = 0; i < 256; ++i)
+            {
+                std::uint32_t crc = i;
+
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78u : 0u);
+                }
+
+                entries[i] = crc;
+            }
+        }
+    };
+
+
+    std::uint32_t crc32cPortable(const char* p, size_t length)
+    {
+        static const Crc32cTable table;
+
+        std::uint32_t crc = 0xFFFFFFFFu;
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            crc = table.entries[(crc ^ static_cast<unsigned char>(p[i])) & 0xFF] ^ (crc >> 8);
+        }
+
+        return ~crc;
+    }
+
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    // When the processor supports SSE4.2, its crc32 instruction computes the
+    // same CRC 8 bytes at a time.  This function is compiled for SSE4.2 even
+    // though the rest of the program isn't, so it must only be called after
+    // checking that the processor supports it.
+
+    __attribute__((target("sse4.2")))
+    std::uint32_t crc32cHardware(const char* p, size_t length)
+    {
+        std::uint64_t crc = 0xFFFFFFFFu;
+
+        for (; length >= 8; p += 8, length -= 8)
+        {
+            crc = _mm_crc32_u64(crc, readUnaligned64(p));
+        }
+
+        std::uint32_t crc32 = static_cast<std::uint32_t>(crc);
+
+        for (; length > 0; ++p, --length)
+        {
+            crc32 = _mm_crc32_u8(crc32, static_cast<unsigned char>(*p));
+        }
+
+        return ~crc32;
+    }
+
+
+    bool hasHardwareCrc32c()
+    {
+        static const bool supported = __builtin_cpu_supports("sse4.2");
+        return supported;
+    }
+#else
+    std::uint32_t crc32cHardware(const char* p, size_t length)
+    {
+        return crc32cPortable(p, length);
+    }
+
+
+    bool hasHardwareCrc32c()
+    {
+        return false;
+    }
+#endif
+}
+
+
+// This hash function is the CRC32-C (Castagnoli) checksum of the string,
+// computed with the processor's crc32 instruction when it's available and
+// with a table-driven loop otherwise; both give the same result.
+
+unsigned int hashStringAsCrc32c(const std::string& word)
+{
+    if (hasHardwareCrc32c())
+    {
+        return crc32cHardware(word.data(), word.length());
+    }
+    else
+    {
+        return crc32cPortable(word.data(), word.length());
+    }
+}
@@ -8,6 +8,7 @@
 #ifndef STRINGHASHING_HPP
 #define STRINGHASHING_HPP
 
+#include <cstdint>
 #include <string>
 
 
@@ -16,7 +17,57 @@ unsigned int hashStringAsZero(const std::string& word);
 unsigned int hashStringAsSum(const std::string& word);
 unsigned int hashStringAsProduct(const std::string& word);
 
+unsigned int hashStringAsFnv1a(const std::string& word);
+unsigned int hashStringAsWymix(const std::string& word);
+unsigned int hashStringAsCrc32c(const std::string& word);
 
 
-#endif // STRINGHASHING_HPP
 
+// These function objects compute the same hashes as the functions with the
+// corresponding names, but their definitions are visible here in the header,
+// so that a hash table parameterized on one of these types (rather than on
+// a std::function) can have the hash inlined into its member functions.
+
+struct StringHashAsProduct
+{
+    unsigned int operator()(const std::string& word) const noexcept;
+};
+
+
+struct StringHashAsFnv1a
+{
+    unsigned int operator()(const std::string& word) const noexcept;
+};
+
+
+
+inline unsigned int StringHashAsProduct::operator()(const std::string& word) const noexcept
+{
+    unsigned int hash = 0;
+
+    for (size_t i = 0; i < word.length(); ++i)
+    {
+        hash *= 37;
+        hash += static_cast<unsigned int>(word[i]);
+    }
+
+    return hash;
+}
+
+
+inline unsigned int StringHashAsFnv1a::operator()(const std::string& word) const noexcept
+{
+    std::uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < word.length(); ++i)
+    {
+        hash ^= static_cast<unsigned char>(word[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+
+
+#endif // STRINGHASHING_HPP
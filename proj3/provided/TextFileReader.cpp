@@ -7,8 +7,44 @@
 #include "TextFileReader.hpp"
 
 
-TextFileReader::TextFileReader(const std::string& textFilePath)
-    : textFile{textFilePath}, eof{false}, line{}, lineIndex{0}, word{}
+
+namespace
+{
+    bool isWordCharacter(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c));
+    }
+
+
+    bool isWordPunctuation(char c)
+    {
+        return c == '-' || c == '\'';
+    }
+}
+
+
+
+TextFileReader::TextFileReader(const std::string& textFilePath, FileReadMode mode)
+    : mode{mode}, textFile{}, lineBuffer{}, mappedFile{}, text{}, mappedPosition{0},
+      eof{false}, line{}, lineIndex{0}, word{}
+{
+    if (mode == FileReadMode::Mapped)
+    {
+        mappedFile.emplace(textFilePath);
+        text = mappedFile->contents();
+    }
+    else
+    {
+        textFile.open(textFilePath);
+    }
+
+    advanceToNextWord();
+}
+
+
+TextFileReader::TextFileReader(std::string_view text)
+    : mode{FileReadMode::Mapped}, textFile{}, lineBuffer{}, mappedFile{}, text{text},
+      mappedPosition{0}, eof{false}, line{}, lineIndex{0}, word{}
 {
     advanceToNextWord();
 }
@@ -22,11 +58,11 @@ bool TextFileReader::noMoreWords() const
 
 void TextFileReader::advanceToNextWord()
 {
-    word = "";
+    word.clear();
 
     while (!eof)
     {
-        while (lineIndex < line.length() && !std::isalnum(line[lineIndex]))
+        while (lineIndex < line.length() && !isWordCharacter(line[lineIndex]))
         {
             ++lineIndex;
         }
@@ -37,13 +73,22 @@ void TextFileReader::advanceToNextWord()
             continue;
         }
 
+        std::size_t wordStart = lineIndex;
+
         while (lineIndex < line.length() &&
-            (std::isalnum(line[lineIndex]) || line[lineIndex] == '-' || line[lineIndex] == '\''))
+            (isWordCharacter(line[lineIndex]) || isWordPunctuation(line[lineIndex])))
+        {
+            ++lineIndex;
+        }
+
+        word.assign(line.data() + wordStart, lineIndex - wordStart);
+
+        for (char& c : word)
         {
-            word.push_back(std::toupper(line[lineIndex++]));
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
         }
 
-        if (!std::isalnum(word[word.length() - 1]))
+        if (!isWordCharacter(word[word.length() - 1]))
         {
             word.pop_back();
         }
@@ -58,27 +103,42 @@ void TextFileReader::advanceToNextWord()
 
 void TextFileReader::advanceToNextLine()
 {
-    if (std::getline(textFile, line))
+    lineIndex = 0;
+
+    if (mode == FileReadMode::Mapped)
     {
-        lineIndex = 0;
+        if (mappedPosition < text.length())
+        {
+            std::size_t lineEnd = text.find('\n', mappedPosition);
+
+            if (lineEnd == std::string_view::npos)
+            {
+                lineEnd = text.length();
+            }
+
+            line = text.substr(mappedPosition, lineEnd - mappedPosition);
+            mappedPosition = lineEnd + 1;
+            return;
+        }
     }
-    else
+    else if (std::getline(textFile, lineBuffer))
     {
-        eof = true;
-        line = "";
-        lineIndex = 0;
+        line = lineBuffer;
+        return;
     }
+
+    eof = true;
+    line = std::string_view{};
 }
 
 
 std::string TextFileReader::currentLine() const
 {
-    return line;
+    return std::string{line};
 }
 
 
-std::string TextFileReader::currentWord() const
+const std::string& TextFileReader::currentWord() const
 {
     return word;
 }
-
@@ -6,33 +6,62 @@
 // Reads an input file and makes it possible to consume it word by word,
 // with spaces and punctuation skipped (except for hyphens or apostrophes
 // within words).
+//
+// By default, the file is mapped into memory (see MappedFile.hpp) and
+// scanned in place, one line at a time; alternatively, it can be read
+// through a stream.  Either way, the current line is a view of the line,
+// not a copy of it, and the current word is kept in a single string whose
+// storage is reused from one word to the next, so that reading through
+// the file allocates memory rarely, if at all.
+//
+// A TextFileReader can also read text that is already in memory, such as
+// one piece of a larger file that has been split up so that its pieces can
+// be checked in parallel.
 
 #ifndef TEXTFILEREADER_HPP
 #define TEXTFILEREADER_HPP
 
+#include <cstddef>
 #include <fstream>
+#include <optional>
 #include <string>
+#include <string_view>
+#include "MappedFile.hpp"
 
 
 
 class TextFileReader
 {
 public:
-    TextFileReader(const std::string& textFilePath);
+    TextFileReader(const std::string& textFilePath, FileReadMode mode = FileReadMode::Mapped);
+
+    // Reads the given text, which must outlive the TextFileReader.
+    explicit TextFileReader(std::string_view text);
 
     bool noMoreWords() const;
     void advanceToNextWord();
 
     std::string currentLine() const;
-    std::string currentWord() const;
+    const std::string& currentWord() const;
 
 private:
+    FileReadMode mode;
+
+    // In FileReadMode::Stream, the file and the line most recently read.
     std::ifstream textFile;
+    std::string lineBuffer;
+
+    // In FileReadMode::Mapped, the file (unless the text was given rather
+    // than read from a file), its text, and the position in the text where
+    // the next line starts.
+    std::optional<MappedFile> mappedFile;
+    std::string_view text;
+    std::size_t mappedPosition;
 
     bool eof;
 
-    std::string line;
-    int lineIndex;
+    std::string_view line;
+    std::size_t lineIndex;
 
     std::string word;
 
@@ -43,4 +72,3 @@ private:
 
 
 #endif // TEXTFILEREADER_HPP
-
@@ -6,29 +6,141 @@
 #include <algorithm>
 #include <cctype>
 #include <fstream>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "MappedFile.hpp"
 #include "WordSetLoader.hpp"
 
 
 
-void WordSetLoader::load(const std::string& wordFilePath, Set<std::string>& wordSet)
+namespace
 {
-    std::ifstream wordFile{wordFilePath};
+    // Reserving room for one word per eight bytes of the file (a little
+    // shorter than an average line) usually avoids regrowing the vector.
+    constexpr std::size_t BYTES_PER_WORD_ESTIMATE = 8;
+
+
+    // toUpperAscii() is std::toupper() in the "C" locale (which is the one
+    // the program runs in), without the call through the locale machinery.
+    char toUpperAscii(char c)
+    {
+        return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
 
-    std::string word;
+    // Each of the readWords functions reads the words in a word file into
+    // the given vector, converted to uppercase, and returns true if they
+    // were in ascending order.
 
-    while (std::getline(wordFile, word))
+    bool readWordsFromStream(const std::string& wordFilePath, std::vector<std::string>& words)
     {
-        std::transform(
-            word.begin(), word.end(), word.begin(),
-            [](auto c) { return std::toupper(c); });
+        std::ifstream wordFile{wordFilePath};
+
+        wordFile.seekg(0, std::ios::end);
+        std::streamoff fileSize = wordFile.tellg();
+        wordFile.seekg(0, std::ios::beg);
+
+        words.reserve(
+            words.size() + (fileSize > 0 ? static_cast<std::size_t>(fileSize) / BYTES_PER_WORD_ESTIMATE : 0));
+
+        bool presorted = true;
+
+        std::string word;
+
+        while (std::getline(wordFile, word))
+        {
+            std::transform(
+                word.begin(), word.end(), word.begin(),
+                [](auto c) { return std::toupper(c); });
 
-        word.erase(
-            std::remove_if(
-                word.begin(), word.end(),
-                [](auto c) { return c == '\r' || c == '\n'; }),
-            word.end());
+            word.erase(
+                std::remove_if(
+                    word.begin(), word.end(),
+                    [](auto c) { return c == '\r' || c == '\n'; }),
+                word.end());
 
-        wordSet.add(word);
+            if (!words.empty() && word < words.back())
+            {
+                presorted = false;
+            }
+
+            words.push_back(std::move(word));
+        }
+
+        return presorted;
+    }
+
+
+    // In the mapped file, each line is a view of the file's contents, so
+    // the only string made for each word is the one stored in the vector,
+    // which is built directly in its final (uppercase) form.
+
+    bool readWordsFromMappedFile(const std::string& wordFilePath, std::vector<std::string>& words)
+    {
+        MappedFile wordFile{wordFilePath};
+        std::string_view contents = wordFile.contents();
+
+        words.reserve(words.size() + contents.length() / BYTES_PER_WORD_ESTIMATE);
+
+        bool presorted = true;
+
+        std::size_t lineStart = 0;
+
+        while (lineStart < contents.length())
+        {
+            std::size_t lineEnd = contents.find('\n', lineStart);
+
+            if (lineEnd == std::string_view::npos)
+            {
+                lineEnd = contents.length();
+            }
+
+            std::string_view line = contents.substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            std::string& word = words.emplace_back(line);
+
+            for (char& c : word)
+            {
+                c = toUpperAscii(c);
+            }
+
+            if (word.find('\r') != std::string::npos)
+            {
+                word.erase(std::remove(word.begin(), word.end(), '\r'), word.end());
+            }
+
+            if (words.size() > 1 && word < words[words.size() - 2])
+            {
+                presorted = false;
+            }
+        }
+
+        return presorted;
     }
 }
 
+
+
+WordSetLoader::WordSetLoader(FileReadMode mode)
+    : mode{mode}
+{
+}
+
+
+void WordSetLoader::load(const std::string& wordFilePath, Set<std::string>& wordSet)
+{
+    std::vector<std::string> words;
+    bool presorted = readWords(wordFilePath, words);
+
+    wordSet.addAll(words.data(), words.data() + words.size(), presorted);
+}
+
+
+bool WordSetLoader::readWords(const std::string& wordFilePath, std::vector<std::string>& words)
+{
+    return mode == FileReadMode::Mapped
+        ? readWordsFromMappedFile(wordFilePath, words)
+        : readWordsFromStream(wordFilePath, words);
+}
@@ -5,11 +5,21 @@
 //
 // A class that loads a word set from a file containing one word on each
 // line.  The words are then added to the given Set<std::string>.
+//
+// All of the words are read before any of them are added, so they can be
+// added with a single call to addAll(), which lets each kind of Set build
+// itself in whatever way is fastest.  Word files are normally in sorted
+// order, which the loader detects as it reads and passes along as a hint.
+//
+// The file is mapped into memory and scanned in place by default (see
+// MappedFile.hpp), or it can be read through a stream instead.
 
 #ifndef WORDSETLOADER_HPP
 #define WORDSETLOADER_HPP
 
 #include <string>
+#include <vector>
+#include "MappedFile.hpp"
 #include "Set.hpp"
 
 
@@ -17,7 +27,17 @@
 class WordSetLoader
 {
 public:
+    explicit WordSetLoader(FileReadMode mode = FileReadMode::Mapped);
+
     void load(const std::string& wordFilePath, Set<std::string>& wordSet);
+
+    // readWords() appends the words in a word file, converted to uppercase,
+    // to the given vector in the order they appear, returning true if they
+    // were in ascending order.  (This is the first half of load().)
+    bool readWords(const std::string& wordFilePath, std::vector<std::string>& words);
+
+private:
+    FileReadMode mode;
 };
 
 
@@ -0,0 +1,129 @@
+// WordSets.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include "WordSets.hpp"
+#include "AVLSet.hpp"
+#include "BloomFilterSet.hpp"
+#include "DictionaryImage.hpp"
+#include "EmptySet.hpp"
+#include "FlatHashSet.hpp"
+#include "HashSet.hpp"
+#include "ListSet.hpp"
+#include "RadixTreeSet.hpp"
+#include "SkipListSet.hpp"
+#include "SpellCheckShell.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    // A set type of "BLOOM", optionally followed by a false positive rate,
+    // and then by another set type (e.g., "BLOOM AVL" or "BLOOM 0.001 AVL")
+    // puts a BloomFilterSet in front of a set of the other type.
+    std::unique_ptr<Set<std::string>> makeBloomFilterSet(const std::string& setType)
+    {
+        std::string innerType = setType.substr(setType.find(' ') + 1);
+        double falsePositiveRate = BloomFilterSet<std::string>::DEFAULT_FALSE_POSITIVE_RATE;
+
+        if (std::isdigit(static_cast<unsigned char>(innerType[0])))
+        {
+            std::string rate = innerType.substr(0, innerType.find(' '));
+            innerType = innerType.substr(std::min(rate.length() + 1, innerType.length()));
+
+            try
+            {
+                std::size_t end;
+                falsePositiveRate = std::stod(rate, &end);
+
+                if (end != rate.length())
+                {
+                    throw std::invalid_argument{rate};
+                }
+            }
+            catch (std::logic_error&)
+            {
+                throw SpellCheckShell::ShellException{"Invalid false positive rate: " + rate};
+            }
+        }
+
+        if (innerType == "IMAGE")
+        {
+            throw SpellCheckShell::ShellException{"An image can't be put behind a Bloom filter"};
+        }
+
+        return std::make_unique<BloomFilterSet<std::string, StringHashAsFnv1a>>(
+            makeWordSet(innerType), StringHashAsFnv1a{}, falsePositiveRate);
+    }
+}
+
+
+
+std::unique_ptr<Set<std::string>> makeWordSet(const std::string& setType)
+{
+    if (setType.compare(0, 6, "BLOOM ") == 0)
+    {
+        return makeBloomFilterSet(setType);
+    }
+    else if (setType == "AVL")
+    {
+        return std::make_unique<AVLSet<std::string>>();
+    }
+    else if (setType == "IMAGE")
+    {
+        return std::make_unique<DictionaryImage>();
+    }
+    else if (setType == "EMPTY")
+    {
+        return std::make_unique<EmptySet<std::string>>();
+    }
+    else if (setType == "HASH ZERO")
+    {
+        return std::make_unique<HashSet<std::string>>(hashStringAsZero);
+    }
+    else if (setType == "HASH SUM")
+    {
+        return std::make_unique<HashSet<std::string>>(hashStringAsSum);
+    }
+    else if (setType == "HASH PRODUCT")
+    {
+        return std::make_unique<HashSet<std::string, StringHashAsProduct>>(StringHashAsProduct{});
+    }
+    else if (setType == "HASH FNV1A")
+    {
+        return std::make_unique<HashSet<std::string, StringHashAsFnv1a>>(StringHashAsFnv1a{});
+    }
+    else if (setType == "HASH WYMIX")
+    {
+        return std::make_unique<HashSet<std::string>>(hashStringAsWymix);
+    }
+    else if (setType == "HASH CRC32C")
+    {
+        return std::make_unique<HashSet<std::string>>(hashStringAsCrc32c);
+    }
+    else if (setType == "HASH FLAT")
+    {
+        return std::make_unique<FlatHashSet<std::string, StringHashAsProduct>>(StringHashAsProduct{});
+    }
+    else if (setType == "LIST")
+    {
+        return std::make_unique<ListSet<std::string>>();
+    }
+    else if (setType == "SKIPLIST")
+    {
+        return std::make_unique<SkipListSet<std::string>>();
+    }
+    else if (setType == "TRIE")
+    {
+        return std::make_unique<RadixTreeSet>();
+    }
+    else
+    {
+        throw SpellCheckShell::ShellException{"Invalid search structure type: " + setType};
+    }
+}
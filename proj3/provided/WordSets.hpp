@@ -0,0 +1,26 @@
+// WordSets.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Makes the kind of word set named by a search structure type, as it's
+// given to the SpellCheckShell (e.g., "AVL", "HASH FLAT", or
+// "BLOOM 0.001 TRIE"), so that the shell and the benchmark can offer the
+// same ones.
+
+#ifndef WORDSETS_HPP
+#define WORDSETS_HPP
+
+#include <memory>
+#include <string>
+#include "Set.hpp"
+
+
+
+// makeWordSet() returns a new, empty word set of the given type, throwing
+// a SpellCheckShell::ShellException if there's no such type.
+std::unique_ptr<Set<std::string>> makeWordSet(const std::string& setType);
+
+
+
+#endif // WORDSETS_HPP
@@ -0,0 +1,67 @@
+// MakeImageTool.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads a word file the same way the WordSetLoader does and writes its
+// distinct words into a DictionaryImage, which the SpellCheckShell can
+// then use (with the IMAGE search structure) instead of the word file.
+// The image is reopened afterward, to make sure every word can be found.
+//
+// Input: the path to the word file, then the path of the image to write.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DictionaryImage.hpp"
+#include "Stopwatch.hpp"
+#include "Tools.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+void runMakeImageTool()
+{
+    std::string wordFilePath = readLine();
+    std::string imagePath = readLine();
+
+    std::vector<std::string> words;
+    WordSetLoader{}.readWords(wordFilePath, words);
+
+    Stopwatch stopwatch;
+
+    stopwatch.start();
+    DictionaryImage::write(imagePath, words.data(), words.data() + words.size());
+    stopwatch.stop();
+
+    double writeDuration = stopwatch.lastDuration();
+
+    stopwatch.start();
+    DictionaryImage image{imagePath};
+    stopwatch.stop();
+
+    double openDuration = stopwatch.lastDuration();
+
+    unsigned int missing = 0;
+
+    for (const std::string& word : words)
+    {
+        if (!image.contains(word))
+        {
+            ++missing;
+        }
+    }
+
+    std::cout << "Read " << words.size() << " words from " << wordFilePath << std::endl;
+    std::cout << "Wrote " << image.size() << " distinct words to " << imagePath
+              << " (" << image.imageSize() << " bytes)" << std::endl;
+    std::cout << std::fixed << std::setprecision(0)
+              << "Writing took " << writeDuration << "usec; opening took "
+              << openDuration << "usec" << std::endl;
+
+    if (missing > 0)
+    {
+        std::cout << "ERROR: " << missing << " words could not be found in the image" << std::endl;
+    }
+}
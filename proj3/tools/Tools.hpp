@@ -0,0 +1,27 @@
+// Tools.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Declarations of the tools that toolmain can run.  As with the
+// experiments, each one reads whatever further input it needs (such as the
+// paths to files) from the standard input, one line at a time.
+
+#ifndef TOOLS_HPP
+#define TOOLS_HPP
+
+#include <string>
+
+
+
+// readLine() returns the next line of the standard input.
+std::string readLine();
+
+
+// Builds a DictionaryImage from a word file, then checks that the image
+// can be opened and contains every word.
+void runMakeImageTool();
+
+
+
+#endif // TOOLS_HPP
@@ -0,0 +1,60 @@
+// toolmain.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Runs one of the tools declared in Tools.hpp.  The first line of the
+// standard input names the tool to run; the tool reads whatever else it
+// needs after that.
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include "DictionaryImage.hpp"
+#include "Tools.hpp"
+
+
+
+std::string readLine()
+{
+    std::string line;
+    std::getline(std::cin, line);
+    return line;
+}
+
+
+
+int main()
+{
+    const std::map<std::string, std::function<void()>> tools{
+        {"MAKE IMAGE", runMakeImageTool}
+    };
+
+    std::string name = readLine();
+    auto tool = tools.find(name);
+
+    if (tool == tools.end())
+    {
+        std::cout << "ERROR: Unknown tool: " << name << std::endl;
+        std::cout << "Tools:" << std::endl;
+
+        for (const auto& t : tools)
+        {
+            std::cout << "    " << t.first << std::endl;
+        }
+
+        return 0;
+    }
+
+    try
+    {
+        tool->second();
+    }
+    catch (DictionaryImage::ImageException& e)
+    {
+        std::cout << "ERROR: " << e.reason() << std::endl;
+    }
+
+    return 0;
+}